@@ -768,7 +768,7 @@ static int create_thread_res(av_render_thread_res_t *res, const char *name,
         }
         res->wait_bits = wait_bits;
         res->render_body = body;
-        int ret = media_lib_thread_create_from_scheduler(&res->thread, name, render_thread, res);
+        int ret = media_lib_thread_create_pooled(&res->thread, name, render_thread, res);
         BREAK_ON_FAIL(ret);
         return 0;
     } while (0);
@@ -878,7 +878,6 @@ static void render_thread(void *arg)
     // Consume all data
     render_consume_all(res);
     _SET_BITS(res->render->event_group, res->wait_bits);
-    media_lib_thread_destroy(NULL);
 }
 
 static bool audio_need_decode_in_sync(av_render_t *render, av_render_audio_info_t *audio_info)
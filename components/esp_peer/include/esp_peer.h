@@ -94,6 +94,9 @@ typedef struct {
     esp_peer_audio_codec_t  codec;       /*!< Audio codec */
     uint32_t                sample_rate; /*!< Audio sample rate */
     uint8_t                 channel;     /*!< Audio channel */
+    uint8_t                 ptime;       /*!< Packetization time (unit ms) for send, 20, 40 or 60, default: 20 if set to 0
+                                              Larger than 20ms only applied to G711 (OPUS not handled yet), `esp_webrtc` aggregates
+                                              captured frames and advertises it through `a=ptime` in SDP */
 } esp_peer_audio_stream_info_t;
 
 /**
@@ -271,6 +274,15 @@ typedef struct {
      * @return          Status code indicating success or failure.
      */
     int (*on_channel_close)(esp_peer_data_channel_info_t *ch, void *ctx);
+
+    /**
+     * @brief  Key frame request callback, triggered when RTCP PLI or FIR received from peer
+     * @note   Optional, only called by implementation which parses RTCP feedback
+     *         The prebuilt default implementation (`libpeer_default`) does not parse PLI/FIR and never calls it
+     * @param[in]  ctx  User context
+     * @return          Status code indicating success or failure.
+     */
+    int (*on_key_frame_request)(void *ctx);
 } esp_peer_cfg_t;
 
 /**
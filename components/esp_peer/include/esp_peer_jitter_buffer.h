@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_peer_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Frame jitter buffer handle
+ */
+typedef struct esp_peer_jitter_buffer *esp_peer_jitter_buffer_handle_t;
+
+/**
+ * @brief  Frame jitter buffer delay mode
+ */
+typedef enum {
+    ESP_PEER_JITTER_MODE_FIXED,     /*!< Use fixed target delay */
+    ESP_PEER_JITTER_MODE_ADAPTIVE,  /*!< Target delay tracks measured frame jitter plus configured margin */
+} esp_peer_jitter_mode_t;
+
+/**
+ * @brief  Frame jitter buffer configuration
+ */
+typedef struct {
+    esp_peer_jitter_mode_t  mode;         /*!< Delay mode */
+    uint16_t                fixed_delay;  /*!< Target delay for fixed mode (unit ms) */
+    uint16_t                min_delay;    /*!< Lower bound of target delay for adaptive mode (unit ms) */
+    uint16_t                max_delay;    /*!< Upper bound of target delay for adaptive mode (unit ms)
+                                               default: 400ms if set to 0 */
+    uint16_t                margin;       /*!< Extra delay added to measured jitter for adaptive mode (unit ms) */
+    uint16_t                max_frames;   /*!< Maximum frames held in buffer, default: 32 if set to 0 */
+} esp_peer_jitter_buffer_cfg_t;
+
+/**
+ * @brief  Frame jitter buffer statistics
+ */
+typedef struct {
+    uint32_t  assembled;     /*!< Frames received into buffer */
+    uint32_t  released;      /*!< Frames released for playback */
+    uint32_t  late;          /*!< Frames arrived after their playout time */
+    uint32_t  dropped;       /*!< Frames dropped for buffer overflow */
+    uint16_t  jitter;        /*!< Measured jitter (95th percentile of relative transit delay, unit ms) */
+    uint16_t  target_delay;  /*!< Current target delay (unit ms) */
+} esp_peer_jitter_buffer_stats_t;
+
+/**
+ * @brief  Frame jitter buffer release callback
+ *
+ * @param[in]  pts   Frame presentation timestamp (unit ms)
+ * @param[in]  data  Frame data (valid only inside callback)
+ * @param[in]  size  Frame size
+ * @param[in]  ctx   User context
+ */
+typedef void (*esp_peer_jitter_buffer_on_frame_t)(uint32_t pts, uint8_t *data, int size, void *ctx);
+
+/**
+ * @brief  Create frame jitter buffer
+ *
+ * @note  Frame jitter buffer works on assembled frames output from peer, it holds each frame until
+ *        `pts + base transit + target delay` so that playback is not disturbed by bursty arrival
+ *        Reordering and retransmission are handled by the packet jitter buffer inside peer, which waits at most
+ *        its fixed `cache_timeout` before output, so this buffer does not extend the time for NACK recovery
+ *
+ * @param[in]   cfg     Jitter buffer configuration
+ * @param[out]  handle  Jitter buffer handle to store
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_jitter_buffer_create(esp_peer_jitter_buffer_cfg_t *cfg, esp_peer_jitter_buffer_handle_t *handle);
+
+/**
+ * @brief  Put received frame into jitter buffer
+ *
+ * @note  Frame data is copied, oldest frame is dropped when buffer is full
+ *
+ * @param[in]  handle  Jitter buffer handle
+ * @param[in]  pts     Frame presentation timestamp (unit ms)
+ * @param[in]  data    Frame data
+ * @param[in]  size    Frame size
+ * @param[in]  now     Arrival time (unit ms)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_jitter_buffer_put(esp_peer_jitter_buffer_handle_t handle, uint32_t pts, const uint8_t *data, int size,
+                               uint32_t now);
+
+/**
+ * @brief  Release frames whose playout time reached
+ *
+ * @param[in]  handle    Jitter buffer handle
+ * @param[in]  now       Current time (unit ms)
+ * @param[in]  on_frame  Callback for each released frame
+ * @param[in]  ctx       User context
+ *
+ * @return
+ *       - >= 0                      Time until next frame due (unit ms), 0xFFFF if buffer is empty
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_jitter_buffer_poll(esp_peer_jitter_buffer_handle_t handle, uint32_t now,
+                                esp_peer_jitter_buffer_on_frame_t on_frame, void *ctx);
+
+/**
+ * @brief  Get jitter buffer statistics
+ *
+ * @param[in]   handle  Jitter buffer handle
+ * @param[out]  stats   Statistics to store
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_jitter_buffer_get_stats(esp_peer_jitter_buffer_handle_t handle, esp_peer_jitter_buffer_stats_t *stats);
+
+/**
+ * @brief  Drop all buffered frames and restart delay measurement
+ *
+ * @param[in]  handle  Jitter buffer handle
+ */
+void esp_peer_jitter_buffer_reset(esp_peer_jitter_buffer_handle_t handle);
+
+/**
+ * @brief  Destroy jitter buffer
+ *
+ * @param[in]  handle  Jitter buffer handle
+ */
+void esp_peer_jitter_buffer_destroy(esp_peer_jitter_buffer_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_peer_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_PEER_RTX_CACHE_MAX_STREAM (4)  /*!< Maximum RTP streams (SSRC) tracked by one cache */
+
+/**
+ * @brief  Retransmission cache handle
+ */
+typedef struct esp_peer_rtx_cache *esp_peer_rtx_cache_handle_t;
+
+/**
+ * @brief  Retransmission cache configuration
+ */
+typedef struct {
+    uint32_t  cache_size;  /*!< Byte budget for cached RTP packets, default: 200kB if set to 0 */
+    uint16_t  slot_num;    /*!< Index slots per stream, rounded up to power of 2, default: 512 if set to 0
+                                Packet whose sequence number conflicts with newer one in same slot is evicted */
+    uint16_t  max_age;     /*!< Maximum time to keep one packet (unit ms), default: 1000ms if set to 0 */
+} esp_peer_rtx_cache_cfg_t;
+
+/**
+ * @brief  Retransmission cache statistics for one RTP stream
+ */
+typedef struct {
+    uint32_t  ssrc;            /*!< SSRC of the stream */
+    uint32_t  inserted;        /*!< Packets inserted */
+    uint32_t  evicted_age;     /*!< Packets evicted for exceeding max age */
+    uint32_t  evicted_budget;  /*!< Packets evicted for byte budget or entry limit */
+    uint32_t  evicted_slot;    /*!< Packets evicted for index slot reused by newer sequence */
+    uint32_t  nack_hit;        /*!< NACKed packets found in cache */
+    uint32_t  nack_miss;       /*!< NACKed packets already evicted */
+    uint32_t  cached_packets;  /*!< Packets currently cached */
+    uint32_t  cached_bytes;    /*!< Bytes currently cached */
+} esp_peer_rtx_cache_stats_t;
+
+/**
+ * @brief  Callback for each NACKed packet found in cache
+ *
+ * @param[in]  rtp   RTP packet data (valid only inside callback)
+ * @param[in]  size  RTP packet size
+ * @param[in]  ctx   User context
+ */
+typedef void (*esp_peer_rtx_cache_on_packet_t)(const uint8_t *rtp, int size, void *ctx);
+
+/**
+ * @brief  Create retransmission cache
+ *
+ * @note  Packets are stored in one byte ring in sending order, each stream keeps an index ring
+ *        addressed by sequence number so that lookup cost does not depend on cached packet number
+ *
+ * @param[in]   cfg     Cache configuration
+ * @param[out]  handle  Cache handle to store
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_rtx_cache_create(esp_peer_rtx_cache_cfg_t *cfg, esp_peer_rtx_cache_handle_t *handle);
+
+/**
+ * @brief  Add sent RTP packet into cache
+ *
+ * @note  Oldest packets are evicted when byte budget is exhausted
+ *
+ * @param[in]  handle  Cache handle
+ * @param[in]  rtp     RTP packet (not encrypted)
+ * @param[in]  size    RTP packet size
+ * @param[in]  now     Current time (unit ms)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or packet larger than cache
+ *       - ESP_PEER_ERR_OVER_LIMITED Too many streams
+ */
+int esp_peer_rtx_cache_add(esp_peer_rtx_cache_handle_t handle, const uint8_t *rtp, int size, uint32_t now);
+
+/**
+ * @brief  Lookup cached packet by SSRC and sequence number and copy it out
+ *
+ * @note  Packet is copied while cache is locked so that it stays intact even if other thread adds packets
+ *
+ * @param[in]      handle  Cache handle
+ * @param[in]      ssrc    SSRC of the stream
+ * @param[in]      seq     RTP sequence number
+ * @param[in]      now     Current time (unit ms)
+ * @param[out]     rtp     Buffer to store cached packet
+ * @param[in,out]  size    Input buffer size, output cached packet size
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE          On success
+ *       - ESP_PEER_ERR_INVALID_ARG   Invalid argument
+ *       - ESP_PEER_ERR_NOT_EXISTS    Packet not cached or already evicted
+ *       - ESP_PEER_ERR_OVER_LIMITED  Buffer too small, `size` is set to required size
+ */
+int esp_peer_rtx_cache_get(esp_peer_rtx_cache_handle_t handle, uint32_t ssrc, uint16_t seq, uint32_t now,
+                           uint8_t *rtp, int *size);
+
+/**
+ * @brief  Process RTCP packet and resolve generic NACK (RFC4585) against cache
+ *
+ * @note  Compound RTCP is supported, other RTCP packet types are skipped
+ *        NACK hit and miss are accounted into per-stream statistics
+ *
+ * @param[in]  handle     Cache handle
+ * @param[in]  rtcp       RTCP packet (decrypted)
+ * @param[in]  size       RTCP packet size
+ * @param[in]  now        Current time (unit ms)
+ * @param[in]  on_packet  Callback for each cached packet requested (can be NULL)
+ * @param[in]  ctx        User context for callback
+ *
+ * @return
+ *       - >= 0                      Number of requested packets found in cache
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_rtx_cache_on_rtcp(esp_peer_rtx_cache_handle_t handle, const uint8_t *rtcp, int size, uint32_t now,
+                               esp_peer_rtx_cache_on_packet_t on_packet, void *ctx);
+
+/**
+ * @brief  Get statistics of cached streams
+ *
+ * @param[in]      handle  Cache handle
+ * @param[out]     stats   Array to store statistics
+ * @param[in,out]  num     Input array size, output actual stream number
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_rtx_cache_get_stats(esp_peer_rtx_cache_handle_t handle, esp_peer_rtx_cache_stats_t *stats, uint8_t *num);
+
+/**
+ * @brief  Destroy retransmission cache
+ *
+ * @param[in]  handle  Cache handle
+ */
+void esp_peer_rtx_cache_destroy(esp_peer_rtx_cache_handle_t handle);
+
+/**
+ * @brief  Register retransmission cache for default peer implementation
+ *
+ * @note  Nothing is registered by default. When registered, each connection of default peer creates one cache,
+ *        outgoing RTP packets are cached before SRTP protection and incoming NACKs are resolved against it
+ *        This costs one lock and one packet copy for every sent RTP packet plus `cache_size` bytes per connection,
+ *        while retransmission itself is still served by the peer send pool, so register only for NACK diagnosis
+ *        Per-stream statistics are printed when connection closed
+ *        Only affect connections created after registration
+ *
+ * @param[in]  cfg  Cache configuration, set to NULL to unregister
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE  On success
+ */
+int esp_peer_rtx_cache_register(esp_peer_rtx_cache_cfg_t *cfg);
+
+/**
+ * @brief  Get registered retransmission cache configuration
+ *
+ * @return
+ *       - NULL    Not registered
+ *       - Others  Registered configuration
+ */
+const esp_peer_rtx_cache_cfg_t *esp_peer_rtx_cache_get_registered(void);
+
+#ifdef __cplusplus
+}
+#endif
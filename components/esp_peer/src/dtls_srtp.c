@@ -25,16 +25,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
 #include "dtls_srtp.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #define TAG "DTLS"
 
 #define DTLS_SIGN_ONCE
+#define DTLS_USE_CID
+#define DTLS_USE_RESUME
 #define DTLS_MTU_SIZE 1500
+#define DTLS_RECORD_HEADER_SIZE 13
+#define DTLS_RECORD_TYPE_CID    25  /*!< tls12_cid (RFC 9146), real content type is inside encrypted payload */
 // #define DUMP_DTLS_KEY
 
 #define BREAK_ON_FAIL(ret) \
@@ -45,12 +52,72 @@
 extern void measure_start(const char *tag);
 extern void measure_stop(const char *tag);
 
+typedef struct {
+    mbedtls_ssl_srtp_profile profile;
+    uint8_t                  key_len;
+    uint8_t                  salt_len;
+    void                     (*set_rtp_policy)(srtp_crypto_policy_t *p);
+    void                     (*set_rtcp_policy)(srtp_crypto_policy_t *p);
+} dtls_srtp_profile_info_t;
+
+static void dtls_srtp_set_null_sha1_32(srtp_crypto_policy_t *p)
+{
+    srtp_crypto_policy_set_null_cipher_hmac_sha1_80(p);
+    p->auth_tag_len = 4;
+}
+
+// Client offers in this order
+// mbedtls use_srtp only knows AES-CM and NULL profiles, AEAD profiles (RFC 7714) can not be negotiated
+static const dtls_srtp_profile_info_t profile_info[] = {
+    { MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80, 16, 14,
+      srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80, srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80 },
+    // RTCP always use 80 bits tag (RFC 5764)
+    { MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_32, 16, 14,
+      srtp_crypto_policy_set_aes_cm_128_hmac_sha1_32, srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80 },
+    { MBEDTLS_TLS_SRTP_NULL_HMAC_SHA1_80, 16, 14,
+      srtp_crypto_policy_set_null_cipher_hmac_sha1_80, srtp_crypto_policy_set_null_cipher_hmac_sha1_80 },
+    { MBEDTLS_TLS_SRTP_NULL_HMAC_SHA1_32, 16, 14,
+      dtls_srtp_set_null_sha1_32, srtp_crypto_policy_set_null_cipher_hmac_sha1_80 },
+};
+
 static const mbedtls_ssl_srtp_profile default_profiles[] = {
     MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80, MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_32,
     MBEDTLS_TLS_SRTP_NULL_HMAC_SHA1_80, MBEDTLS_TLS_SRTP_NULL_HMAC_SHA1_32,
     MBEDTLS_TLS_SRTP_UNSET
 };
 
+#if defined(DTLS_USE_CID) && defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+#define DTLS_CID_SUPPORTED
+#endif
+
+// Resumed session is matched to peer by certificate fingerprint, so peer certificate must be kept in session
+#if defined(DTLS_USE_RESUME) && defined(MBEDTLS_SSL_CACHE_C) && defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+#define DTLS_RESUME_SUPPORTED
+#define DTLS_SESSION_CACHE_NUM     4
+#define DTLS_SESSION_CACHE_TIMEOUT 3600  /*!< Unit second */
+
+typedef struct {
+    char                  fingerprint[DTLS_SRTP_FINGERPRINT_LENGTH];
+    mbedtls_ssl_session   session;
+    bool                  valid;
+} dtls_session_entry_t;
+
+static bool                      session_cache_inited = false;
+static mbedtls_ssl_cache_context server_session_cache;
+static dtls_session_entry_t      client_sessions[DTLS_SESSION_CACHE_NUM];
+static uint8_t                   client_session_pos;
+static media_lib_mutex_handle_t  client_session_lock;  /*!< Guards client sessions and one-time cache init */
+#endif
+
+// Live instances, used to apply remote fingerprint from SDP which only knows owner context
+typedef struct dtls_srtp_node {
+    dtls_srtp_t           *dtls_srtp;
+    struct dtls_srtp_node *next;
+} dtls_srtp_node_t;
+
+static media_lib_mutex_handle_t instance_lock;
+static dtls_srtp_node_t        *instance_list;
+
 static bool already_signed = false;
 #ifdef DTLS_SIGN_ONCE
 static mbedtls_ctr_drbg_context signed_ctr_drbg;
@@ -59,6 +126,122 @@ static mbedtls_pk_context signed_pkey;
 static mbedtls_entropy_context signed_entropy;
 #endif
 
+static uint32_t dtls_srtp_cur_time(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void dtls_srtp_open_rtx_cache(dtls_srtp_t *dtls_srtp)
+{
+    const esp_peer_rtx_cache_cfg_t *registered = esp_peer_rtx_cache_get_registered();
+    if (registered) {
+        esp_peer_rtx_cache_cfg_t cfg = *registered;
+        if (esp_peer_rtx_cache_create(&cfg, &dtls_srtp->rtx_cache) != ESP_PEER_ERR_NONE) {
+            ESP_LOGW(TAG, "Fail to create retransmission cache");
+        }
+    }
+}
+
+static void dtls_srtp_close_rtx_cache(dtls_srtp_t *dtls_srtp)
+{
+    if (dtls_srtp->rtx_cache == NULL) {
+        return;
+    }
+    esp_peer_rtx_cache_stats_t stats[ESP_PEER_RTX_CACHE_MAX_STREAM];
+    uint8_t num = ESP_PEER_RTX_CACHE_MAX_STREAM;
+    esp_peer_rtx_cache_get_stats(dtls_srtp->rtx_cache, stats, &num);
+    for (int i = 0; i < num; i++) {
+        ESP_LOGI(TAG, "RTX ssrc:%x inserted:%d nack hit:%d miss:%d evicted age:%d budget:%d slot:%d",
+                 (unsigned int)stats[i].ssrc, (int)stats[i].inserted, (int)stats[i].nack_hit,
+                 (int)stats[i].nack_miss, (int)stats[i].evicted_age, (int)stats[i].evicted_budget,
+                 (int)stats[i].evicted_slot);
+    }
+    esp_peer_rtx_cache_destroy(dtls_srtp->rtx_cache);
+    dtls_srtp->rtx_cache = NULL;
+}
+
+static bool dtls_srtp_lock(dtls_srtp_t *dtls_srtp, bool write)
+{
+    // Lock order is read lock then write lock, state is only changed with both locks held
+    // Once connected application data records only touch input or output side of SSL context,
+    // so read and write can run concurrently, otherwise handshake or alert may use both sides
+    if (write) {
+        media_lib_mutex_lock(dtls_srtp->write_lock, MEDIA_LIB_MAX_LOCK_TIME);
+        if (dtls_srtp->state == DTLS_SRTP_STATE_CONNECTED) {
+            return false;
+        }
+        media_lib_mutex_unlock(dtls_srtp->write_lock);
+        media_lib_mutex_lock(dtls_srtp->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        media_lib_mutex_lock(dtls_srtp->write_lock, MEDIA_LIB_MAX_LOCK_TIME);
+        return true;
+    }
+    media_lib_mutex_lock(dtls_srtp->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // With connection ID every record is tls12_cid, its type is unknown before decrypt, so no split
+    if (dtls_srtp->state == DTLS_SRTP_STATE_CONNECTED && dtls_srtp->cid_negotiated == false) {
+        // Receive callback takes write lock if record may trigger alert or retransmission
+        dtls_srtp->read_lock_only = true;
+        return false;
+    }
+    media_lib_mutex_lock(dtls_srtp->write_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    return true;
+}
+
+static void dtls_srtp_unlock(dtls_srtp_t *dtls_srtp, bool write, bool both)
+{
+    if (write == false && dtls_srtp->read_lock_only) {
+        dtls_srtp->read_lock_only = false;
+    } else if (write == false && dtls_srtp->read_lock_upgraded) {
+        dtls_srtp->read_lock_upgraded = false;
+        both = true;
+    }
+    if (both) {
+        media_lib_mutex_unlock(dtls_srtp->write_lock);
+        media_lib_mutex_unlock(dtls_srtp->lock);
+    } else {
+        media_lib_mutex_unlock(write ? dtls_srtp->write_lock : dtls_srtp->lock);
+    }
+}
+
+static void dtls_srtp_set_state(dtls_srtp_t *dtls_srtp, dtls_srtp_state_t state)
+{
+    media_lib_mutex_lock(dtls_srtp->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    media_lib_mutex_lock(dtls_srtp->write_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    dtls_srtp->state = state;
+    media_lib_mutex_unlock(dtls_srtp->write_lock);
+    media_lib_mutex_unlock(dtls_srtp->lock);
+}
+
+static bool dtls_srtp_app_data_only(const unsigned char *buf, int len)
+{
+    // Walk DTLS record headers in datagram, plain application data records only touch input side
+    int pos = 0;
+    while (pos + DTLS_RECORD_HEADER_SIZE <= len) {
+        if (buf[pos] == DTLS_RECORD_TYPE_CID) {
+            // Header is 13 + CID length, payload may turn out alert or handshake message after decrypt
+            // SSL read can not be stopped before processing it, so handle same as non application data
+            return false;
+        }
+        if (buf[pos] != MBEDTLS_SSL_MSG_APPLICATION_DATA) {
+            return false;
+        }
+        pos += DTLS_RECORD_HEADER_SIZE + ((buf[pos + 11] << 8) | buf[pos + 12]);
+    }
+    return true;
+}
+
+static int dtls_srtp_bio_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    dtls_srtp_t *dtls_srtp = (dtls_srtp_t *)ctx;
+    int ret = dtls_srtp->udp_recv(ctx, buf, len);
+    if (ret > 0 && dtls_srtp->read_lock_only && dtls_srtp_app_data_only(buf, ret) == false) {
+        // Handshake or alert record may make SSL read send data, serialize with write path before parsing
+        media_lib_mutex_lock(dtls_srtp->write_lock, MEDIA_LIB_MAX_LOCK_TIME);
+        dtls_srtp->read_lock_only = false;
+        dtls_srtp->read_lock_upgraded = true;
+    }
+    return ret;
+}
+
 static void dtls_srtp_x509_digest(const mbedtls_x509_crt *crt, char *buf)
 {
     unsigned char digest[32];
@@ -76,6 +259,179 @@ static void dtls_srtp_x509_digest(const mbedtls_x509_crt *crt, char *buf)
     *(--buf) = '\0';
 }
 
+static void dtls_srtp_conf_cid(dtls_srtp_t *dtls_srtp)
+{
+#ifdef DTLS_CID_SUPPORTED
+    mbedtls_ssl_conf_cid(&dtls_srtp->conf, DTLS_SRTP_CID_LENGTH, MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+#endif
+}
+
+static void dtls_srtp_set_cid(dtls_srtp_t *dtls_srtp)
+{
+#ifdef DTLS_CID_SUPPORTED
+    mbedtls_ctr_drbg_random(&dtls_srtp->ctr_drbg, dtls_srtp->own_cid, DTLS_SRTP_CID_LENGTH);
+    mbedtls_ssl_set_cid(&dtls_srtp->ssl, MBEDTLS_SSL_CID_ENABLED, dtls_srtp->own_cid, DTLS_SRTP_CID_LENGTH);
+#endif
+}
+
+static void dtls_srtp_save_session_info(dtls_srtp_t *dtls_srtp)
+{
+    dtls_srtp->cid_negotiated = false;
+    dtls_srtp->session_fingerprint[0] = '\0';
+#ifdef DTLS_CID_SUPPORTED
+    int enabled = MBEDTLS_SSL_CID_DISABLED;
+    unsigned char peer_cid[MBEDTLS_SSL_CID_OUT_LEN_MAX];
+    size_t peer_cid_len = 0;
+    if (mbedtls_ssl_get_peer_cid(&dtls_srtp->ssl, &enabled, peer_cid, &peer_cid_len) == 0 &&
+        enabled == MBEDTLS_SSL_CID_ENABLED) {
+        dtls_srtp->cid_negotiated = true;
+        ESP_LOGI(TAG, "Connection ID negotiated peer cid len %d", (int)peer_cid_len);
+    }
+#endif
+#if defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+    const mbedtls_x509_crt *peer_cert = mbedtls_ssl_get_peer_cert(&dtls_srtp->ssl);
+    if (peer_cert) {
+        dtls_srtp_x509_digest(peer_cert, dtls_srtp->session_fingerprint);
+    }
+#endif
+}
+
+static void dtls_srtp_add_instance(dtls_srtp_t *dtls_srtp)
+{
+    if (media_lib_mutex_create_once(&instance_lock) != 0) {
+        return;
+    }
+    dtls_srtp_node_t *node = (dtls_srtp_node_t *)media_lib_calloc(1, sizeof(dtls_srtp_node_t));
+    if (node == NULL) {
+        return;
+    }
+    node->dtls_srtp = dtls_srtp;
+    media_lib_mutex_lock(instance_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    node->next = instance_list;
+    instance_list = node;
+    media_lib_mutex_unlock(instance_lock);
+}
+
+static void dtls_srtp_remove_instance(dtls_srtp_t *dtls_srtp)
+{
+    if (instance_lock == NULL) {
+        return;
+    }
+    media_lib_mutex_lock(instance_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    dtls_srtp_node_t **link = &instance_list;
+    while (*link) {
+        dtls_srtp_node_t *node = *link;
+        if (node->dtls_srtp == dtls_srtp) {
+            *link = node->next;
+            media_lib_free(node);
+            break;
+        }
+        link = &node->next;
+    }
+    media_lib_mutex_unlock(instance_lock);
+}
+
+static void dtls_srtp_get_remote_digest(dtls_srtp_t *dtls_srtp, char *digest)
+{
+    digest[0] = '\0';
+    if (instance_lock == NULL) {
+        return;
+    }
+    media_lib_mutex_lock(instance_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // SDP fingerprint may carry hash name prefix like "sha-256 "
+    const char *remote = strrchr(dtls_srtp->remote_fingerprint, ' ');
+    strcpy(digest, remote ? remote + 1 : dtls_srtp->remote_fingerprint);
+    media_lib_mutex_unlock(instance_lock);
+}
+
+static bool dtls_srtp_same_peer(dtls_srtp_t *dtls_srtp)
+{
+    char remote[DTLS_SRTP_FINGERPRINT_LENGTH];
+    dtls_srtp_get_remote_digest(dtls_srtp, remote);
+    return remote[0] && dtls_srtp->session_fingerprint[0] &&
+           strcasecmp(remote, dtls_srtp->session_fingerprint) == 0;
+}
+
+static void dtls_srtp_conf_resume(dtls_srtp_t *dtls_srtp)
+{
+#ifdef DTLS_RESUME_SUPPORTED
+    // Instances may be created from different threads, init shared caches only once under lock
+    if (media_lib_mutex_create_once(&client_session_lock) != 0) {
+        return;
+    }
+    media_lib_mutex_lock(client_session_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (session_cache_inited == false) {
+        mbedtls_ssl_cache_init(&server_session_cache);
+        mbedtls_ssl_cache_set_max_entries(&server_session_cache, DTLS_SESSION_CACHE_NUM);
+#if defined(MBEDTLS_HAVE_TIME)
+        mbedtls_ssl_cache_set_timeout(&server_session_cache, DTLS_SESSION_CACHE_TIMEOUT);
+#endif
+        for (int i = 0; i < DTLS_SESSION_CACHE_NUM; i++) {
+            mbedtls_ssl_session_init(&client_sessions[i].session);
+        }
+        session_cache_inited = true;
+    }
+    media_lib_mutex_unlock(client_session_lock);
+    if (dtls_srtp->role == DTLS_SRTP_ROLE_SERVER) {
+        // Server side lookup by session ID, peer offers ID only when it cached session for our fingerprint
+        mbedtls_ssl_conf_session_cache(&dtls_srtp->conf, &server_session_cache, mbedtls_ssl_cache_get,
+                                       mbedtls_ssl_cache_set);
+    }
+#endif
+}
+
+static bool dtls_srtp_load_session(dtls_srtp_t *dtls_srtp)
+{
+    bool loaded = false;
+#ifdef DTLS_RESUME_SUPPORTED
+    char remote[DTLS_SRTP_FINGERPRINT_LENGTH];
+    dtls_srtp_get_remote_digest(dtls_srtp, remote);
+    if (remote[0] == '\0' || client_session_lock == NULL) {
+        return false;
+    }
+    media_lib_mutex_lock(client_session_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (int i = 0; i < DTLS_SESSION_CACHE_NUM; i++) {
+        dtls_session_entry_t *entry = &client_sessions[i];
+        if (entry->valid && strcasecmp(remote, entry->fingerprint) == 0) {
+            // Server falls back to full handshake if it does not know the session any more
+            loaded = (mbedtls_ssl_set_session(&dtls_srtp->ssl, &entry->session) == 0);
+            break;
+        }
+    }
+    media_lib_mutex_unlock(client_session_lock);
+#endif
+    return loaded;
+}
+
+static void dtls_srtp_store_session(dtls_srtp_t *dtls_srtp)
+{
+#ifdef DTLS_RESUME_SUPPORTED
+    if (dtls_srtp->session_fingerprint[0] == '\0' || client_session_lock == NULL) {
+        return;
+    }
+    media_lib_mutex_lock(client_session_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    dtls_session_entry_t *entry = NULL;
+    for (int i = 0; i < DTLS_SESSION_CACHE_NUM; i++) {
+        if (client_sessions[i].valid &&
+            strcasecmp(client_sessions[i].fingerprint, dtls_srtp->session_fingerprint) == 0) {
+            entry = &client_sessions[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        entry = &client_sessions[client_session_pos];
+        client_session_pos = (client_session_pos + 1) % DTLS_SESSION_CACHE_NUM;
+    }
+    mbedtls_ssl_session_free(&entry->session);
+    mbedtls_ssl_session_init(&entry->session);
+    entry->valid = (mbedtls_ssl_get_session(&dtls_srtp->ssl, &entry->session) == 0);
+    if (entry->valid) {
+        strcpy(entry->fingerprint, dtls_srtp->session_fingerprint);
+    }
+    media_lib_mutex_unlock(client_session_lock);
+#endif
+}
+
 static int check_srtp(bool init)
 {
     static int init_count = 0;
@@ -213,6 +569,7 @@ dtls_srtp_t *dtls_srtp_init(dtls_srtp_cfg_t *cfg)
     do {
         BREAK_ON_FAIL(ret);
         media_lib_mutex_create(&dtls_srtp->lock);
+        media_lib_mutex_create(&dtls_srtp->write_lock);
         dtls_srtp->role = cfg->role;
         dtls_srtp->state = DTLS_SRTP_STATE_INIT;
         dtls_srtp->ctx = cfg->ctx;
@@ -237,6 +594,8 @@ dtls_srtp_t *dtls_srtp_init(dtls_srtp_cfg_t *cfg)
         if (dtls_srtp->role == DTLS_SRTP_ROLE_SERVER) {
             ret = mbedtls_ssl_config_defaults(&dtls_srtp->conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
                                             MBEDTLS_SSL_PRESET_DEFAULT);
+            // Request client certificate, its fingerprint identifies peer to keep session by connection ID
+            mbedtls_ssl_conf_authmode(&dtls_srtp->conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
             mbedtls_ssl_cookie_init(&dtls_srtp->cookie_ctx);
             mbedtls_ssl_cookie_setup(&dtls_srtp->cookie_ctx, mbedtls_ctr_drbg_random, &dtls_srtp->ctr_drbg);
             mbedtls_ssl_conf_dtls_cookies(&dtls_srtp->conf, mbedtls_ssl_cookie_write, mbedtls_ssl_cookie_check,
@@ -252,9 +611,13 @@ dtls_srtp_t *dtls_srtp_init(dtls_srtp_cfg_t *cfg)
         BREAK_ON_FAIL(ret);
 
         mbedtls_ssl_conf_srtp_mki_value_supported(&dtls_srtp->conf, MBEDTLS_SSL_DTLS_SRTP_MKI_UNSUPPORTED);
+        dtls_srtp_conf_cid(dtls_srtp);
+        dtls_srtp_conf_resume(dtls_srtp);
         ret = mbedtls_ssl_setup(&dtls_srtp->ssl, &dtls_srtp->conf);
         BREAK_ON_FAIL(ret);
         mbedtls_ssl_set_mtu(&dtls_srtp->ssl, DTLS_MTU_SIZE);
+        dtls_srtp_open_rtx_cache(dtls_srtp);
+        dtls_srtp_add_instance(dtls_srtp);
         return dtls_srtp;
     } while (0);
     dtls_srtp_deinit(dtls_srtp);
@@ -266,11 +629,33 @@ char *dtls_srtp_get_local_fingerprint(dtls_srtp_t *dtls_srtp)
     return dtls_srtp->local_fingerprint;
 }
 
+int dtls_srtp_set_remote_fingerprint(void *ctx, const char *fingerprint, int len)
+{
+    if (ctx == NULL || fingerprint == NULL || len < 0 || instance_lock == NULL) {
+        return -1;
+    }
+    if (len >= DTLS_SRTP_FINGERPRINT_LENGTH) {
+        len = DTLS_SRTP_FINGERPRINT_LENGTH - 1;
+    }
+    int ret = -1;
+    media_lib_mutex_lock(instance_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (dtls_srtp_node_t *node = instance_list; node; node = node->next) {
+        if (node->dtls_srtp->ctx == ctx) {
+            memcpy(node->dtls_srtp->remote_fingerprint, fingerprint, len);
+            node->dtls_srtp->remote_fingerprint[len] = '\0';
+            ret = 0;
+        }
+    }
+    media_lib_mutex_unlock(instance_lock);
+    return ret;
+}
+
 void dtls_srtp_deinit(dtls_srtp_t *dtls_srtp)
 {
     if (dtls_srtp->state == DTLS_SRTP_STATE_NONE) {
         return;
     }
+    dtls_srtp_remove_instance(dtls_srtp);
     mbedtls_ssl_free(&dtls_srtp->ssl);
     mbedtls_ssl_config_free(&dtls_srtp->conf);
 
@@ -294,11 +679,29 @@ void dtls_srtp_deinit(dtls_srtp_t *dtls_srtp)
     }
     if (dtls_srtp->lock) {
         media_lib_mutex_destroy(dtls_srtp->lock);
+        dtls_srtp->lock = NULL;
+    }
+    if (dtls_srtp->write_lock) {
+        media_lib_mutex_destroy(dtls_srtp->write_lock);
+        dtls_srtp->write_lock = NULL;
     }
+    dtls_srtp_close_rtx_cache(dtls_srtp);
     check_srtp(false);
     dtls_srtp->state = DTLS_SRTP_STATE_NONE;
 }
 
+static const dtls_srtp_profile_info_t *dtls_srtp_get_profile_info(dtls_srtp_t *dtls_srtp)
+{
+    mbedtls_dtls_srtp_info negotiation;
+    mbedtls_ssl_get_dtls_srtp_negotiation_result(&dtls_srtp->ssl, &negotiation);
+    for (int i = 0; i < sizeof(profile_info) / sizeof(profile_info[0]); i++) {
+        if (profile_info[i].profile == negotiation.chosen_dtls_srtp_profile) {
+            return &profile_info[i];
+        }
+    }
+    return NULL;
+}
+
 static void dtls_srtp_key_derivation(void *context, mbedtls_ssl_key_export_type secret_type,
                                      const unsigned char *secret, size_t secret_len,
                                      const unsigned char client_random[32], const unsigned char server_random[32],
@@ -309,6 +712,15 @@ static void dtls_srtp_key_derivation(void *context, mbedtls_ssl_key_export_type
     const char *dtls_srtp_label = "EXTRACTOR-dtls_srtp";
     unsigned char randbytes[64];
     uint8_t key_material[DTLS_SRTP_KEY_MATERIAL_LENGTH];
+    const dtls_srtp_profile_info_t *info = dtls_srtp_get_profile_info(dtls_srtp);
+    if (info == NULL) {
+        ESP_LOGE(TAG, "No SRTP profile negotiated");
+        return;
+    }
+    // Key material layout: client key | server key | client salt | server salt
+    int key_len = info->key_len;
+    int salt_len = info->salt_len;
+    int material_len = 2 * (key_len + salt_len);
 
     memcpy(randbytes, client_random, 32);
     memcpy(randbytes + 32, server_random, 32);
@@ -324,21 +736,23 @@ static void dtls_srtp_key_derivation(void *context, mbedtls_ssl_key_export_type
 #endif
     // Export keying material
     if ((ret = mbedtls_ssl_tls_prf(tls_prf_type, secret, secret_len, dtls_srtp_label, randbytes, sizeof(randbytes),
-                                   key_material, sizeof(key_material)))
+                                   key_material, material_len))
         != 0) {
         ESP_LOGE(TAG, "Fail to export key material ret %d", ret);
         return;
     }
     memset(&dtls_srtp->remote_policy, 0, sizeof(dtls_srtp->remote_policy));
-    srtp_crypto_policy_set_rtp_default(&dtls_srtp->remote_policy.rtp);
-    srtp_crypto_policy_set_rtcp_default(&dtls_srtp->remote_policy.rtcp);
+    info->set_rtp_policy(&dtls_srtp->remote_policy.rtp);
+    info->set_rtcp_policy(&dtls_srtp->remote_policy.rtcp);
 
-    memcpy(dtls_srtp->remote_policy_key, key_material, SRTP_MASTER_KEY_LENGTH);
-    memcpy(dtls_srtp->remote_policy_key + SRTP_MASTER_KEY_LENGTH,
-           key_material + SRTP_MASTER_KEY_LENGTH + SRTP_MASTER_KEY_LENGTH, SRTP_MASTER_SALT_LENGTH);
+    // All offered profiles use 16 bytes key and 14 bytes salt, same size as policy key buffers
+    unsigned char *remote_key = dtls_srtp->remote_policy_key;
+    unsigned char *local_key = dtls_srtp->local_policy_key;
+    memcpy(remote_key, key_material, key_len);
+    memcpy(remote_key + key_len, key_material + key_len + key_len, salt_len);
 
     dtls_srtp->remote_policy.ssrc.type = ssrc_any_inbound;
-    dtls_srtp->remote_policy.key = dtls_srtp->remote_policy_key;
+    dtls_srtp->remote_policy.key = remote_key;
     dtls_srtp->remote_policy.next = NULL;
     srtp_t *send_session = (dtls_srtp->role == DTLS_SRTP_ROLE_SERVER) ? &dtls_srtp->srtp_in : &dtls_srtp->srtp_out;
     ret = srtp_create(send_session, &dtls_srtp->remote_policy);
@@ -348,16 +762,14 @@ static void dtls_srtp_key_derivation(void *context, mbedtls_ssl_key_export_type
     }
     // derive outbounds keys
     memset(&dtls_srtp->local_policy, 0, sizeof(dtls_srtp->local_policy));
-    srtp_crypto_policy_set_rtp_default(&dtls_srtp->local_policy.rtp);
-    srtp_crypto_policy_set_rtcp_default(&dtls_srtp->local_policy.rtcp);
+    info->set_rtp_policy(&dtls_srtp->local_policy.rtp);
+    info->set_rtcp_policy(&dtls_srtp->local_policy.rtcp);
 
-    memcpy(dtls_srtp->local_policy_key, key_material + SRTP_MASTER_KEY_LENGTH, SRTP_MASTER_KEY_LENGTH);
-    memcpy(dtls_srtp->local_policy_key + SRTP_MASTER_KEY_LENGTH,
-           key_material + SRTP_MASTER_KEY_LENGTH + SRTP_MASTER_KEY_LENGTH + SRTP_MASTER_SALT_LENGTH,
-           SRTP_MASTER_SALT_LENGTH);
+    memcpy(local_key, key_material + key_len, key_len);
+    memcpy(local_key + key_len, key_material + key_len + key_len + salt_len, salt_len);
 
     dtls_srtp->local_policy.ssrc.type = ssrc_any_outbound;
-    dtls_srtp->local_policy.key = dtls_srtp->local_policy_key;
+    dtls_srtp->local_policy.key = local_key;
     dtls_srtp->local_policy.next = NULL;
     srtp_t *recv_session = (dtls_srtp->role == DTLS_SRTP_ROLE_SERVER) ? &dtls_srtp->srtp_out : &dtls_srtp->srtp_in;
     ret = srtp_create(recv_session, &dtls_srtp->local_policy);
@@ -365,17 +777,17 @@ static void dtls_srtp_key_derivation(void *context, mbedtls_ssl_key_export_type
         ESP_LOGE(TAG, "Fail to create out SRTP session ret %d", ret);
         return;
     }
-    ESP_LOGI(TAG, "SRTP connected OK");
-    dtls_srtp->state = DTLS_SRTP_STATE_CONNECTED;
+    ESP_LOGI(TAG, "SRTP connected OK profile 0x%04x", (unsigned int)info->profile);
+    dtls_srtp_set_state(dtls_srtp, DTLS_SRTP_STATE_CONNECTED);
 }
 
 static int dtls_srtp_do_handshake(dtls_srtp_t *dtls_srtp)
 {
     int ret;
-    static mbedtls_timing_delay_context timer;
-    mbedtls_ssl_set_timer_cb(&dtls_srtp->ssl, &timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+    mbedtls_ssl_set_timer_cb(&dtls_srtp->ssl, &dtls_srtp->timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
     mbedtls_ssl_set_export_keys_cb(&dtls_srtp->ssl, dtls_srtp_key_derivation, dtls_srtp);
-    mbedtls_ssl_set_bio(&dtls_srtp->ssl, dtls_srtp, dtls_srtp->udp_send, dtls_srtp->udp_recv, NULL);
+    mbedtls_ssl_set_bio(&dtls_srtp->ssl, dtls_srtp, dtls_srtp->udp_send, dtls_srtp_bio_recv, NULL);
+    dtls_srtp_set_cid(dtls_srtp);
 
     do {
         ret = mbedtls_ssl_handshake(&dtls_srtp->ssl);
@@ -407,6 +819,9 @@ static int dtls_srtp_handshake_server(dtls_srtp_t *dtls_srtp)
 
 static int dtls_srtp_handshake_client(dtls_srtp_t *dtls_srtp)
 {
+    if (dtls_srtp_load_session(dtls_srtp)) {
+        ESP_LOGI(TAG, "Try to resume cached session");
+    }
     int ret = dtls_srtp_do_handshake(dtls_srtp);
     if (ret != 0) {
         ESP_LOGE(TAG, "CLient handshake fail ret -0x%.4x", (unsigned int)-ret);
@@ -427,13 +842,26 @@ static int dtls_srtp_handshake_client(dtls_srtp_t *dtls_srtp)
 int dtls_srtp_handshake(dtls_srtp_t *dtls_srtp)
 {
     int ret;
+    if (dtls_srtp->session_kept) {
+        dtls_srtp->session_kept = false;
+        if (dtls_srtp->state == DTLS_SRTP_STATE_CONNECTED) {
+            ESP_LOGI(TAG, "Reuse DTLS session by connection ID");
+            return 0;
+        }
+    }
+    uint32_t start_time = dtls_srtp_cur_time();
     if (dtls_srtp->role == DTLS_SRTP_ROLE_SERVER) {
         ret = dtls_srtp_handshake_server(dtls_srtp);
     } else {
         ret = dtls_srtp_handshake_client(dtls_srtp);
     }
     if (ret == 0) {
-        ESP_LOGI(TAG, "%s handshake success", dtls_srtp->role == DTLS_SRTP_ROLE_SERVER ? "Server" : "Client");
+        ESP_LOGI(TAG, "%s handshake success cost %dms", dtls_srtp->role == DTLS_SRTP_ROLE_SERVER ? "Server" : "Client",
+                 (int)(dtls_srtp_cur_time() - start_time));
+        dtls_srtp_save_session_info(dtls_srtp);
+        if (dtls_srtp->role == DTLS_SRTP_ROLE_CLIENT) {
+            dtls_srtp_store_session(dtls_srtp);
+        }
     }
     mbedtls_dtls_srtp_info dtls_srtp_negotiation_result;
     mbedtls_ssl_get_dtls_srtp_negotiation_result(&dtls_srtp->ssl, &dtls_srtp_negotiation_result);
@@ -442,6 +870,14 @@ int dtls_srtp_handshake(dtls_srtp_t *dtls_srtp)
 
 void dtls_srtp_reset_session(dtls_srtp_t *dtls_srtp, dtls_srtp_role_t role)
 {
+    dtls_srtp->session_kept = false;
+    if (dtls_srtp->state == DTLS_SRTP_STATE_CONNECTED && dtls_srtp->cid_negotiated && role == dtls_srtp->role &&
+        dtls_srtp_same_peer(dtls_srtp)) {
+        // Records are addressed by connection ID, same peer can continue on new transport path
+        dtls_srtp->session_kept = true;
+        return;
+    }
+    dtls_srtp->cid_negotiated = false;
     if (dtls_srtp->state == DTLS_SRTP_STATE_CONNECTED) {
         srtp_dealloc(dtls_srtp->srtp_in);
         dtls_srtp->srtp_in = NULL;
@@ -456,6 +892,7 @@ void dtls_srtp_reset_session(dtls_srtp_t *dtls_srtp, dtls_srtp_role_t role)
         if (role == DTLS_SRTP_ROLE_SERVER) {
             mbedtls_ssl_config_defaults(&dtls_srtp->conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
                                         MBEDTLS_SSL_PRESET_DEFAULT);
+            mbedtls_ssl_conf_authmode(&dtls_srtp->conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
 
             mbedtls_ssl_cookie_init(&dtls_srtp->cookie_ctx);
             mbedtls_ssl_cookie_setup(&dtls_srtp->cookie_ctx, mbedtls_ctr_drbg_random, &dtls_srtp->ctr_drbg);
@@ -469,12 +906,14 @@ void dtls_srtp_reset_session(dtls_srtp_t *dtls_srtp, dtls_srtp_role_t role)
         }
         mbedtls_ssl_conf_dtls_srtp_protection_profiles(&dtls_srtp->conf, default_profiles);
         mbedtls_ssl_conf_srtp_mki_value_supported(&dtls_srtp->conf, MBEDTLS_SSL_DTLS_SRTP_MKI_UNSUPPORTED);
+        dtls_srtp->role = role;
+        dtls_srtp_conf_cid(dtls_srtp);
+        dtls_srtp_conf_resume(dtls_srtp);
         mbedtls_ssl_conf_dtls_anti_replay(&dtls_srtp->conf, MBEDTLS_SSL_ANTI_REPLAY_DISABLED);
         mbedtls_ssl_setup(&dtls_srtp->ssl, &dtls_srtp->conf);
         mbedtls_ssl_set_mtu(&dtls_srtp->ssl, DTLS_MTU_SIZE);
-        dtls_srtp->role = role;
     }
-    dtls_srtp->state = DTLS_SRTP_STATE_INIT;
+    dtls_srtp_set_state(dtls_srtp, DTLS_SRTP_STATE_INIT);
 }
 
 dtls_srtp_role_t dtls_srtp_get_role(dtls_srtp_t *dtls_srtp)
@@ -486,7 +925,7 @@ int dtls_srtp_write(dtls_srtp_t *dtls_srtp, const unsigned char *buf, size_t len
 {
     int ret;
     int consume = 0;
-    media_lib_mutex_lock(dtls_srtp->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    bool both = dtls_srtp_lock(dtls_srtp, true);
     while (len) {
         measure_start("ssl_write");
         ret = mbedtls_ssl_write(&dtls_srtp->ssl, buf, len);
@@ -502,7 +941,7 @@ int dtls_srtp_write(dtls_srtp_t *dtls_srtp, const unsigned char *buf, size_t len
             break;
         }
     }
-    media_lib_mutex_unlock(dtls_srtp->lock);
+    dtls_srtp_unlock(dtls_srtp, true, both);
     return consume;
 }
 
@@ -510,7 +949,7 @@ int dtls_srtp_read(dtls_srtp_t *dtls_srtp, unsigned char *buf, size_t len)
 {
     int ret = 0;
     int read_bytes = 0;
-    media_lib_mutex_lock(dtls_srtp->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    bool both = dtls_srtp_lock(dtls_srtp, false);
     while (read_bytes < len) {
         measure_start("ssl_read");
         ret = mbedtls_ssl_read(&dtls_srtp->ssl, buf + read_bytes, len - read_bytes);
@@ -534,7 +973,7 @@ int dtls_srtp_read(dtls_srtp_t *dtls_srtp, unsigned char *buf, size_t len)
     if (ret != -1 && read_bytes) {
         ret = read_bytes;
     }
-    media_lib_mutex_unlock(dtls_srtp->lock);
+    dtls_srtp_unlock(dtls_srtp, false, both);
     return ret;
 }
 
@@ -559,12 +998,20 @@ int dtls_srtp_decrypt_rtcp_packet(dtls_srtp_t *dtls_srtp, uint8_t *packet, int *
     size_t size = *bytes;
     int ret = srtp_unprotect_rtcp(dtls_srtp->srtp_in, packet, size, packet, &size);
     *bytes = size;
+    if (ret == srtp_err_status_ok && dtls_srtp->rtx_cache) {
+        // Retransmission is still done by peer, only resolve NACK for cache accounting
+        esp_peer_rtx_cache_on_rtcp(dtls_srtp->rtx_cache, packet, *bytes, dtls_srtp_cur_time(), NULL, NULL);
+    }
     return ret;
 }
 
 void dtls_srtp_encrypt_rtp_packet(dtls_srtp_t *dtls_srtp, uint8_t *packet, int buf_size, int *bytes)
 {
     size_t size = buf_size;
+    // Only set when user registered cache, keep send path free of extra copy by default
+    if (dtls_srtp->rtx_cache) {
+        esp_peer_rtx_cache_add(dtls_srtp->rtx_cache, packet, *bytes, dtls_srtp_cur_time());
+    }
     srtp_protect(dtls_srtp->srtp_out, packet, *bytes, packet, &size, 0);
     *bytes = size;
 }
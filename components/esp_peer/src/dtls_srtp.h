@@ -36,6 +36,7 @@
 #include <mbedtls/timing.h>
 #include <srtp.h>
 #include "media_lib_os.h"
+#include "esp_peer_rtx_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,7 @@ extern "C" {
 #define SRTP_MASTER_SALT_LENGTH       14
 #define DTLS_SRTP_KEY_MATERIAL_LENGTH 60
 #define DTLS_SRTP_FINGERPRINT_LENGTH  160
+#define DTLS_SRTP_CID_LENGTH          8
 
 /**
  * @brief  DTLS role
@@ -87,9 +89,18 @@ typedef struct {
     unsigned char            local_policy_key[SRTP_MASTER_KEY_LENGTH + SRTP_MASTER_SALT_LENGTH];
     char                     local_fingerprint[DTLS_SRTP_FINGERPRINT_LENGTH];
     char                     remote_fingerprint[DTLS_SRTP_FINGERPRINT_LENGTH];
-    media_lib_mutex_handle_t lock;
+    media_lib_mutex_handle_t lock;          /*!< Lock for read path, taken before write lock when both needed */
     int                      (*udp_send)(void *ctx, const unsigned char *buf, size_t len);
     int                      (*udp_recv)(void *ctx, unsigned char *buf, size_t len);
+    esp_peer_rtx_cache_handle_t rtx_cache;
+    media_lib_mutex_handle_t    write_lock;  /*!< Lock for write path */
+    bool                        cid_negotiated;  /*!< Connection ID (RFC 9146) negotiated in current session */
+    bool                        session_kept;    /*!< Session kept on reset, skip next handshake */
+    unsigned char               own_cid[DTLS_SRTP_CID_LENGTH];
+    char                        session_fingerprint[DTLS_SRTP_FINGERPRINT_LENGTH];  /*!< Peer certificate fingerprint of current session */
+    bool                        read_lock_only;      /*!< Read path holds only read lock, never set when connection ID negotiated */
+    bool                        read_lock_upgraded;  /*!< Read path also took write lock for non application data record */
+    mbedtls_timing_delay_context timer;  /*!< Handshake retransmission timer, one per instance so that peers can handshake concurrently */
 } dtls_srtp_t;
 
 /**
@@ -135,9 +146,29 @@ dtls_srtp_t* dtls_srtp_init(dtls_srtp_cfg_t *cfg);
  */
 char *dtls_srtp_get_local_fingerprint(dtls_srtp_t *dtls_srtp);
 
+/**
+ * @brief  Set remote fingerprint from SDP for instances created with context
+ *
+ * @note  Peer implementation does not pass remote fingerprint itself, so it is fed from signaling path
+ *        Fingerprint is used to find cached session and keep session across transport path change
+ *
+ * @param[in]  ctx          Context set in `dtls_srtp_cfg_t` when instance created
+ * @param[in]  fingerprint  Value of SDP `a=fingerprint` attribute like "sha-256 AB:CD:..."
+ * @param[in]  len          Length of fingerprint
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  No instance created with context
+ */
+int dtls_srtp_set_remote_fingerprint(void *ctx, const char *fingerprint, int len);
+
 /**
  * @brief  Do handshake for DTLS
  *
+ * @note  Sessions are cached when mbedtls supports session cache, client offers cached session of peer whose
+ *        certificate fingerprint equals `remote_fingerprint`, so that reconnect to known peer (ICE restart)
+ *        only needs abbreviated handshake, it falls back to full handshake if server does not resume
+ *
  * @param[in]  dtls_srtp  DTLS SRTP instance
  *
  * @return
@@ -149,6 +180,10 @@ int dtls_srtp_handshake(dtls_srtp_t *dtls_srtp);
 /**
  * @brief  Reset session to use defined role
  *
+ * @note  When connection ID is negotiated, role is unchanged and `remote_fingerprint` matches peer certificate
+ *        of current session, the session and SRTP keys are kept so that transport path change (roaming,
+ *        new DHCP lease) does not need a new handshake
+ *
  * @param[in]  dtls_srtp  DTLS SRTP instance
  * @param[in]  role       DTLS role
  *
@@ -184,6 +219,11 @@ int dtls_srtp_write(dtls_srtp_t *dtls_srtp, const uint8_t *buf, size_t len);
 /**
  * @brief  Read data through DTLS
  *
+ * @note  Once connected read runs concurrently with `dtls_srtp_write` while only application data records
+ *        arrive, other records take write lock as well since they may make SSL send alert or retransmission
+ *        When connection ID is negotiated records are tls12_cid whose real type is known only after decrypt,
+ *        so read and write are serialized for the whole session
+ *
  * @param[in]  dtls_srtp  DTLS SRTP instance
  * @param[in]  buf        Buffer to read
  * @param[in]  len        Data length to read
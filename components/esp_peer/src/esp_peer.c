@@ -82,12 +82,34 @@ int esp_peer_update_ice_info(esp_peer_handle_t handle, esp_peer_role_t role, esp
     return ESP_PEER_ERR_NOT_SUPPORT;
 }
 
+static void peer_update_remote_fingerprint(peer_wrapper_t *peer, esp_peer_msg_t *msg)
+{
+    static const char attr[] = "a=fingerprint:";
+    int attr_len = sizeof(attr) - 1;
+    const char *sdp = (const char *)msg->data;
+    for (int i = 0; i + attr_len <= msg->size; i++) {
+        if (memcmp(sdp + i, attr, attr_len) == 0) {
+            int start = i + attr_len;
+            int end = start;
+            while (end < msg->size && sdp[end] != '\r' && sdp[end] != '\n' && sdp[end] != '\0') {
+                end++;
+            }
+            // DTLS instance of default peer is created with peer handle as context
+            dtls_srtp_set_remote_fingerprint(peer->handle, sdp + start, end - start);
+            return;
+        }
+    }
+}
+
 int esp_peer_send_msg(esp_peer_handle_t handle, esp_peer_msg_t *msg)
 {
     if (handle == NULL) {
         return ESP_PEER_ERR_INVALID_ARG;
     }
     peer_wrapper_t *peer = (peer_wrapper_t *)handle;
+    if (msg && msg->type == ESP_PEER_MSG_TYPE_SDP && msg->data) {
+        peer_update_remote_fingerprint(peer, msg);
+    }
     if (peer->ops.send_msg) {
         return peer->ops.send_msg(peer->handle, msg);
     }
@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <string.h>
+#include "esp_peer_jitter_buffer.h"
+#include "media_lib_os.h"
+
+#define JITTER_DEFAULT_MAX_DELAY  (400)
+#define JITTER_DEFAULT_MAX_FRAMES (32)
+#define JITTER_WINDOW             (128)
+#define JITTER_MAX_RANK           (JITTER_WINDOW / 20 + 1)
+#define JITTER_DECREASE_SHIFT     (4)
+#define JITTER_EMPTY_WAIT         (0xFFFF)
+
+typedef struct {
+    uint32_t  pts;
+    uint8_t  *data;
+    int       size;
+} jitter_frame_t;
+
+struct esp_peer_jitter_buffer {
+    esp_peer_jitter_buffer_cfg_t    cfg;
+    media_lib_mutex_handle_t        lock;
+    jitter_frame_t                 *frames;
+    uint16_t                        head;
+    uint16_t                        count;
+    bool                            has_ref;
+    uint32_t                        ref_transit;
+    int32_t                         transit[JITTER_WINDOW];
+    uint16_t                        transit_pos;
+    uint16_t                        transit_num;
+    int32_t                         base_transit;
+    esp_peer_jitter_buffer_stats_t  stats;
+};
+
+static uint16_t jitter_clamp(struct esp_peer_jitter_buffer *jb, uint32_t delay)
+{
+    if (delay < jb->cfg.min_delay) {
+        return jb->cfg.min_delay;
+    }
+    if (delay > jb->cfg.max_delay) {
+        return jb->cfg.max_delay;
+    }
+    return (uint16_t)delay;
+}
+
+static void jitter_init_target(struct esp_peer_jitter_buffer *jb)
+{
+    if (jb->cfg.mode == ESP_PEER_JITTER_MODE_ADAPTIVE) {
+        jb->stats.target_delay = jitter_clamp(jb, jb->cfg.margin);
+    } else {
+        jb->stats.target_delay = jb->cfg.fixed_delay;
+    }
+}
+
+static uint32_t jitter_percentile(struct esp_peer_jitter_buffer *jb)
+{
+    // Get 95th percentile by keeping the largest 5% of relative delays in window
+    int32_t top[JITTER_MAX_RANK];
+    int rank = jb->transit_num / 20 + 1;
+    int top_num = 0;
+    for (int i = 0; i < jb->transit_num; i++) {
+        int32_t v = jb->transit[i] - jb->base_transit;
+        if (top_num == rank && v <= top[top_num - 1]) {
+            continue;
+        }
+        int j = (top_num < rank) ? top_num++ : top_num - 1;
+        while (j > 0 && top[j - 1] < v) {
+            top[j] = top[j - 1];
+            j--;
+        }
+        top[j] = v;
+    }
+    return top_num ? (uint32_t)top[top_num - 1] : 0;
+}
+
+static int32_t jitter_update(struct esp_peer_jitter_buffer *jb, uint32_t pts, uint32_t now)
+{
+    if (jb->has_ref == false) {
+        jb->ref_transit = now - pts;
+        jb->has_ref = true;
+    }
+    // Transit delay relative to first frame, so that clock offset of peer does not matter
+    int32_t transit = (int32_t)(now - pts - jb->ref_transit);
+    jb->transit[jb->transit_pos] = transit;
+    jb->transit_pos = (jb->transit_pos + 1) % JITTER_WINDOW;
+    if (jb->transit_num < JITTER_WINDOW) {
+        jb->transit_num++;
+    }
+    // Fastest frame in window is treated as no jitter, also follow clock drift when it leaves window
+    int32_t base = transit;
+    for (int i = 0; i < jb->transit_num; i++) {
+        if (jb->transit[i] < base) {
+            base = jb->transit[i];
+        }
+    }
+    jb->base_transit = base;
+    uint32_t jitter = jitter_percentile(jb);
+    jb->stats.jitter = jitter > 0xFFFF ? 0xFFFF : (uint16_t)jitter;
+    if (jb->cfg.mode == ESP_PEER_JITTER_MODE_ADAPTIVE) {
+        uint16_t target = jitter_clamp(jb, jitter + jb->cfg.margin);
+        if (target >= jb->stats.target_delay) {
+            jb->stats.target_delay = target;
+        } else {
+            // Decrease slowly to avoid oscillation when jitter is bursty
+            uint16_t diff = jb->stats.target_delay - target;
+            jb->stats.target_delay -= (diff >> JITTER_DECREASE_SHIFT) ? (diff >> JITTER_DECREASE_SHIFT) : 1;
+        }
+    }
+    return transit - base;
+}
+
+static uint32_t jitter_playout_time(struct esp_peer_jitter_buffer *jb, uint32_t pts)
+{
+    return pts + jb->ref_transit + (uint32_t)jb->base_transit + jb->stats.target_delay;
+}
+
+static void jitter_clear_frames(struct esp_peer_jitter_buffer *jb)
+{
+    while (jb->count) {
+        media_lib_free(jb->frames[jb->head].data);
+        jb->head = (jb->head + 1) % jb->cfg.max_frames;
+        jb->count--;
+    }
+}
+
+int esp_peer_jitter_buffer_create(esp_peer_jitter_buffer_cfg_t *cfg, esp_peer_jitter_buffer_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    struct esp_peer_jitter_buffer *jb = media_lib_calloc(1, sizeof(struct esp_peer_jitter_buffer));
+    if (jb == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    jb->cfg = *cfg;
+    if (jb->cfg.max_delay == 0) {
+        jb->cfg.max_delay = JITTER_DEFAULT_MAX_DELAY;
+    }
+    if (jb->cfg.min_delay > jb->cfg.max_delay) {
+        jb->cfg.min_delay = jb->cfg.max_delay;
+    }
+    if (jb->cfg.max_frames == 0) {
+        jb->cfg.max_frames = JITTER_DEFAULT_MAX_FRAMES;
+    }
+    jb->frames = media_lib_calloc(jb->cfg.max_frames, sizeof(jitter_frame_t));
+    media_lib_mutex_create(&jb->lock);
+    if (jb->frames == NULL || jb->lock == NULL) {
+        esp_peer_jitter_buffer_destroy(jb);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    jitter_init_target(jb);
+    *handle = jb;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_jitter_buffer_put(esp_peer_jitter_buffer_handle_t handle, uint32_t pts, const uint8_t *data, int size,
+                               uint32_t now)
+{
+    struct esp_peer_jitter_buffer *jb = (struct esp_peer_jitter_buffer *)handle;
+    if (jb == NULL || data == NULL || size <= 0) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    uint8_t *frame_data = media_lib_malloc(size);
+    if (frame_data == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    memcpy(frame_data, data, size);
+    media_lib_mutex_lock(jb->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    jb->stats.assembled++;
+    if (jitter_update(jb, pts, now) > jb->stats.target_delay) {
+        jb->stats.late++;
+    }
+    if (jb->count == jb->cfg.max_frames) {
+        media_lib_free(jb->frames[jb->head].data);
+        jb->head = (jb->head + 1) % jb->cfg.max_frames;
+        jb->count--;
+        jb->stats.dropped++;
+    }
+    jitter_frame_t *frame = &jb->frames[(jb->head + jb->count) % jb->cfg.max_frames];
+    frame->pts = pts;
+    frame->data = frame_data;
+    frame->size = size;
+    jb->count++;
+    media_lib_mutex_unlock(jb->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_jitter_buffer_poll(esp_peer_jitter_buffer_handle_t handle, uint32_t now,
+                                esp_peer_jitter_buffer_on_frame_t on_frame, void *ctx)
+{
+    struct esp_peer_jitter_buffer *jb = (struct esp_peer_jitter_buffer *)handle;
+    if (jb == NULL || on_frame == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    while (1) {
+        media_lib_mutex_lock(jb->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        if (jb->count == 0) {
+            media_lib_mutex_unlock(jb->lock);
+            return JITTER_EMPTY_WAIT;
+        }
+        jitter_frame_t frame = jb->frames[jb->head];
+        int32_t wait = (int32_t)(jitter_playout_time(jb, frame.pts) - now);
+        if (wait > 0) {
+            media_lib_mutex_unlock(jb->lock);
+            return wait > JITTER_EMPTY_WAIT ? JITTER_EMPTY_WAIT : wait;
+        }
+        jb->head = (jb->head + 1) % jb->cfg.max_frames;
+        jb->count--;
+        jb->stats.released++;
+        media_lib_mutex_unlock(jb->lock);
+        // Release outside lock so that slow consumer does not block receiving
+        on_frame(frame.pts, frame.data, frame.size, ctx);
+        media_lib_free(frame.data);
+    }
+}
+
+int esp_peer_jitter_buffer_get_stats(esp_peer_jitter_buffer_handle_t handle, esp_peer_jitter_buffer_stats_t *stats)
+{
+    struct esp_peer_jitter_buffer *jb = (struct esp_peer_jitter_buffer *)handle;
+    if (jb == NULL || stats == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(jb->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    *stats = jb->stats;
+    media_lib_mutex_unlock(jb->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+void esp_peer_jitter_buffer_reset(esp_peer_jitter_buffer_handle_t handle)
+{
+    struct esp_peer_jitter_buffer *jb = (struct esp_peer_jitter_buffer *)handle;
+    if (jb == NULL) {
+        return;
+    }
+    media_lib_mutex_lock(jb->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    jitter_clear_frames(jb);
+    jb->head = 0;
+    jb->has_ref = false;
+    jb->transit_pos = 0;
+    jb->transit_num = 0;
+    jb->base_transit = 0;
+    jitter_init_target(jb);
+    media_lib_mutex_unlock(jb->lock);
+}
+
+void esp_peer_jitter_buffer_destroy(esp_peer_jitter_buffer_handle_t handle)
+{
+    struct esp_peer_jitter_buffer *jb = (struct esp_peer_jitter_buffer *)handle;
+    if (jb == NULL) {
+        return;
+    }
+    if (jb->frames) {
+        jitter_clear_frames(jb);
+        media_lib_free(jb->frames);
+    }
+    if (jb->lock) {
+        media_lib_mutex_destroy(jb->lock);
+    }
+    media_lib_free(jb);
+}
@@ -0,0 +1,390 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <string.h>
+#include "esp_peer_rtx_cache.h"
+#include "media_lib_os.h"
+
+#define RTX_DEFAULT_CACHE_SIZE (200 * 1024)
+#define RTX_DEFAULT_SLOT_NUM   (512)
+#define RTX_DEFAULT_MAX_AGE    (1000)
+#define RTX_MAX_SLOT_NUM       (16384)
+#define RTP_HEADER_SIZE        (12)
+#define RTCP_PT_RTPFB          (205)
+#define RTCP_FMT_GENERIC_NACK  (1)
+
+#define READ_U16(p) (((uint16_t)(p)[0] << 8) | (p)[1])
+#define READ_U32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (p)[3])
+
+typedef enum {
+    RTX_EVICT_AGE,
+    RTX_EVICT_BUDGET,
+} rtx_evict_reason_t;
+
+typedef struct {
+    uint32_t  offset;
+    uint32_t  time;
+    uint16_t  size;
+    uint16_t  seq;
+    uint8_t   stream;
+    bool      valid;
+} rtx_entry_t;
+
+typedef struct {
+    esp_peer_rtx_cache_stats_t  stats;
+    uint16_t                   *index;  /*!< Entry position + 1 indexed by sequence, 0 for empty */
+} rtx_stream_t;
+
+struct esp_peer_rtx_cache {
+    esp_peer_rtx_cache_cfg_t  cfg;
+    media_lib_mutex_handle_t  lock;
+    uint8_t                  *data;
+    uint32_t                  write_pos;
+    rtx_entry_t              *entries;
+    uint16_t                  entry_num;
+    uint16_t                  head;
+    uint16_t                  count;
+    uint16_t                  slot_mask;
+    uint8_t                   stream_num;
+    rtx_stream_t              streams[ESP_PEER_RTX_CACHE_MAX_STREAM];
+};
+
+static esp_peer_rtx_cache_cfg_t registered_cfg;
+static bool                     registered;
+
+static rtx_stream_t *rtx_find_stream(struct esp_peer_rtx_cache *cache, uint32_t ssrc)
+{
+    for (int i = 0; i < cache->stream_num; i++) {
+        if (cache->streams[i].stats.ssrc == ssrc) {
+            return &cache->streams[i];
+        }
+    }
+    return NULL;
+}
+
+static rtx_stream_t *rtx_add_stream(struct esp_peer_rtx_cache *cache, uint32_t ssrc)
+{
+    if (cache->stream_num >= ESP_PEER_RTX_CACHE_MAX_STREAM) {
+        return NULL;
+    }
+    rtx_stream_t *stream = &cache->streams[cache->stream_num];
+    stream->index = (uint16_t *)media_lib_calloc(cache->slot_mask + 1, sizeof(uint16_t));
+    if (stream->index == NULL) {
+        return NULL;
+    }
+    stream->stats.ssrc = ssrc;
+    cache->stream_num++;
+    return stream;
+}
+
+static void rtx_invalidate(struct esp_peer_rtx_cache *cache, rtx_entry_t *entry)
+{
+    rtx_stream_t *stream = &cache->streams[entry->stream];
+    stream->stats.cached_packets--;
+    stream->stats.cached_bytes -= entry->size;
+    entry->valid = false;
+}
+
+static void rtx_evict_head(struct esp_peer_rtx_cache *cache, rtx_evict_reason_t reason)
+{
+    rtx_entry_t *entry = &cache->entries[cache->head];
+    if (entry->valid) {
+        rtx_stream_t *stream = &cache->streams[entry->stream];
+        uint16_t *slot = &stream->index[entry->seq & cache->slot_mask];
+        if (*slot == cache->head + 1) {
+            *slot = 0;
+        }
+        rtx_invalidate(cache, entry);
+        if (reason == RTX_EVICT_AGE) {
+            stream->stats.evicted_age++;
+        } else {
+            stream->stats.evicted_budget++;
+        }
+    }
+    cache->head = (cache->head + 1) % cache->entry_num;
+    cache->count--;
+    if (cache->count == 0) {
+        cache->write_pos = 0;
+    }
+}
+
+static void rtx_evict_aged(struct esp_peer_rtx_cache *cache, uint32_t now)
+{
+    while (cache->count && now - cache->entries[cache->head].time > cache->cfg.max_age) {
+        rtx_evict_head(cache, RTX_EVICT_AGE);
+    }
+}
+
+static bool rtx_alloc_data(struct esp_peer_rtx_cache *cache, uint32_t size, uint32_t *offset)
+{
+    if (cache->count == cache->entry_num) {
+        return false;
+    }
+    if (cache->count == 0) {
+        *offset = 0;
+        return true;
+    }
+    // Data is written in sending order, free space is after write position until head packet
+    uint32_t head_pos = cache->entries[cache->head].offset;
+    if (cache->write_pos > head_pos) {
+        if (cache->write_pos + size <= cache->cfg.cache_size) {
+            *offset = cache->write_pos;
+            return true;
+        }
+        if (size <= head_pos) {
+            // Skip tail space and wrap to start
+            *offset = 0;
+            return true;
+        }
+    } else if (cache->write_pos < head_pos && cache->write_pos + size <= head_pos) {
+        *offset = cache->write_pos;
+        return true;
+    }
+    return false;
+}
+
+static rtx_entry_t *rtx_lookup(struct esp_peer_rtx_cache *cache, rtx_stream_t *stream, uint16_t seq, uint32_t now)
+{
+    uint16_t pos = stream->index[seq & cache->slot_mask];
+    if (pos == 0) {
+        return NULL;
+    }
+    rtx_entry_t *entry = &cache->entries[pos - 1];
+    if (entry->valid == false || entry->seq != seq || now - entry->time > cache->cfg.max_age) {
+        return NULL;
+    }
+    return entry;
+}
+
+int esp_peer_rtx_cache_create(esp_peer_rtx_cache_cfg_t *cfg, esp_peer_rtx_cache_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    struct esp_peer_rtx_cache *cache = media_lib_calloc(1, sizeof(struct esp_peer_rtx_cache));
+    if (cache == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    cache->cfg = *cfg;
+    if (cache->cfg.cache_size == 0) {
+        cache->cfg.cache_size = RTX_DEFAULT_CACHE_SIZE;
+    }
+    if (cache->cfg.max_age == 0) {
+        cache->cfg.max_age = RTX_DEFAULT_MAX_AGE;
+    }
+    uint32_t slot_num = cache->cfg.slot_num ? cache->cfg.slot_num : RTX_DEFAULT_SLOT_NUM;
+    if (slot_num > RTX_MAX_SLOT_NUM) {
+        slot_num = RTX_MAX_SLOT_NUM;
+    }
+    uint32_t pow2 = 1;
+    while (pow2 < slot_num) {
+        pow2 <<= 1;
+    }
+    cache->cfg.slot_num = (uint16_t)pow2;
+    cache->slot_mask = (uint16_t)(pow2 - 1);
+    // Allow two streams (audio and video) fill their slots at same time
+    cache->entry_num = (uint16_t)(pow2 * 2 > 0xFFFE ? 0xFFFE : pow2 * 2);
+    cache->data = media_lib_malloc(cache->cfg.cache_size);
+    cache->entries = media_lib_calloc(cache->entry_num, sizeof(rtx_entry_t));
+    media_lib_mutex_create(&cache->lock);
+    if (cache->data == NULL || cache->entries == NULL || cache->lock == NULL) {
+        esp_peer_rtx_cache_destroy(cache);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    *handle = cache;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_rtx_cache_add(esp_peer_rtx_cache_handle_t handle, const uint8_t *rtp, int size, uint32_t now)
+{
+    struct esp_peer_rtx_cache *cache = (struct esp_peer_rtx_cache *)handle;
+    if (cache == NULL || rtp == NULL || size < RTP_HEADER_SIZE || size > cache->cfg.cache_size || size > 0xFFFF) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if ((rtp[0] >> 6) != 2) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    uint16_t seq = READ_U16(rtp + 2);
+    uint32_t ssrc = READ_U32(rtp + 8);
+    int ret = ESP_PEER_ERR_NONE;
+    media_lib_mutex_lock(cache->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    do {
+        rtx_evict_aged(cache, now);
+        rtx_stream_t *stream = rtx_find_stream(cache, ssrc);
+        if (stream == NULL) {
+            stream = rtx_add_stream(cache, ssrc);
+            if (stream == NULL) {
+                ret = ESP_PEER_ERR_OVER_LIMITED;
+                break;
+            }
+        }
+        uint16_t *slot = &stream->index[seq & cache->slot_mask];
+        if (*slot) {
+            rtx_entry_t *old = &cache->entries[*slot - 1];
+            if (old->valid && old->seq == seq) {
+                // Retransmission of cached packet, keep original one
+                break;
+            }
+            if (old->valid) {
+                rtx_invalidate(cache, old);
+                stream->stats.evicted_slot++;
+            }
+            *slot = 0;
+        }
+        uint32_t offset = 0;
+        while (rtx_alloc_data(cache, size, &offset) == false) {
+            rtx_evict_head(cache, RTX_EVICT_BUDGET);
+        }
+        uint16_t pos = (cache->head + cache->count) % cache->entry_num;
+        rtx_entry_t *entry = &cache->entries[pos];
+        entry->offset = offset;
+        entry->time = now;
+        entry->size = (uint16_t)size;
+        entry->seq = seq;
+        entry->stream = (uint8_t)(stream - cache->streams);
+        entry->valid = true;
+        memcpy(cache->data + offset, rtp, size);
+        cache->write_pos = offset + size;
+        cache->count++;
+        *slot = pos + 1;
+        stream->stats.inserted++;
+        stream->stats.cached_packets++;
+        stream->stats.cached_bytes += size;
+    } while (0);
+    media_lib_mutex_unlock(cache->lock);
+    return ret;
+}
+
+int esp_peer_rtx_cache_get(esp_peer_rtx_cache_handle_t handle, uint32_t ssrc, uint16_t seq, uint32_t now,
+                           uint8_t *rtp, int *size)
+{
+    struct esp_peer_rtx_cache *cache = (struct esp_peer_rtx_cache *)handle;
+    if (cache == NULL || rtp == NULL || size == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int ret = ESP_PEER_ERR_NOT_EXISTS;
+    media_lib_mutex_lock(cache->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    rtx_stream_t *stream = rtx_find_stream(cache, ssrc);
+    rtx_entry_t *entry = stream ? rtx_lookup(cache, stream, seq, now) : NULL;
+    if (entry) {
+        // Copy under lock, ring space can be reused by concurrent add once unlocked
+        if (entry->size > *size) {
+            ret = ESP_PEER_ERR_OVER_LIMITED;
+        } else {
+            memcpy(rtp, cache->data + entry->offset, entry->size);
+            ret = ESP_PEER_ERR_NONE;
+        }
+        *size = entry->size;
+    }
+    media_lib_mutex_unlock(cache->lock);
+    return ret;
+}
+
+static int rtx_on_nack(struct esp_peer_rtx_cache *cache, rtx_stream_t *stream, uint16_t seq, uint32_t now,
+                       esp_peer_rtx_cache_on_packet_t on_packet, void *ctx)
+{
+    rtx_entry_t *entry = rtx_lookup(cache, stream, seq, now);
+    if (entry == NULL) {
+        stream->stats.nack_miss++;
+        return 0;
+    }
+    stream->stats.nack_hit++;
+    if (on_packet) {
+        on_packet(cache->data + entry->offset, entry->size, ctx);
+    }
+    return 1;
+}
+
+int esp_peer_rtx_cache_on_rtcp(esp_peer_rtx_cache_handle_t handle, const uint8_t *rtcp, int size, uint32_t now,
+                               esp_peer_rtx_cache_on_packet_t on_packet, void *ctx)
+{
+    struct esp_peer_rtx_cache *cache = (struct esp_peer_rtx_cache *)handle;
+    if (cache == NULL || rtcp == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int found = 0;
+    media_lib_mutex_lock(cache->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    while (size >= 4) {
+        int len = (READ_U16(rtcp + 2) + 1) * 4;
+        if (len > size) {
+            break;
+        }
+        uint8_t fmt = rtcp[0] & 0x1F;
+        if (rtcp[1] == RTCP_PT_RTPFB && fmt == RTCP_FMT_GENERIC_NACK && len >= 12) {
+            rtx_stream_t *stream = rtx_find_stream(cache, READ_U32(rtcp + 8));
+            for (int i = 12; stream && i + 4 <= len; i += 4) {
+                // Each FCI holds lost packet id and bitmask of following 16 lost packets
+                uint16_t pid = READ_U16(rtcp + i);
+                uint16_t blp = READ_U16(rtcp + i + 2);
+                found += rtx_on_nack(cache, stream, pid, now, on_packet, ctx);
+                for (int j = 0; j < 16; j++) {
+                    if (blp & (1 << j)) {
+                        found += rtx_on_nack(cache, stream, (uint16_t)(pid + j + 1), now, on_packet, ctx);
+                    }
+                }
+            }
+        }
+        rtcp += len;
+        size -= len;
+    }
+    media_lib_mutex_unlock(cache->lock);
+    return found;
+}
+
+int esp_peer_rtx_cache_get_stats(esp_peer_rtx_cache_handle_t handle, esp_peer_rtx_cache_stats_t *stats, uint8_t *num)
+{
+    struct esp_peer_rtx_cache *cache = (struct esp_peer_rtx_cache *)handle;
+    if (cache == NULL || stats == NULL || num == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(cache->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (*num > cache->stream_num) {
+        *num = cache->stream_num;
+    }
+    for (int i = 0; i < *num; i++) {
+        stats[i] = cache->streams[i].stats;
+    }
+    media_lib_mutex_unlock(cache->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+void esp_peer_rtx_cache_destroy(esp_peer_rtx_cache_handle_t handle)
+{
+    struct esp_peer_rtx_cache *cache = (struct esp_peer_rtx_cache *)handle;
+    if (cache == NULL) {
+        return;
+    }
+    for (int i = 0; i < cache->stream_num; i++) {
+        media_lib_free(cache->streams[i].index);
+    }
+    if (cache->data) {
+        media_lib_free(cache->data);
+    }
+    if (cache->entries) {
+        media_lib_free(cache->entries);
+    }
+    if (cache->lock) {
+        media_lib_mutex_destroy(cache->lock);
+    }
+    media_lib_free(cache);
+}
+
+int esp_peer_rtx_cache_register(esp_peer_rtx_cache_cfg_t *cfg)
+{
+    if (cfg == NULL) {
+        registered = false;
+        return ESP_PEER_ERR_NONE;
+    }
+    registered_cfg = *cfg;
+    registered = true;
+    return ESP_PEER_ERR_NONE;
+}
+
+const esp_peer_rtx_cache_cfg_t *esp_peer_rtx_cache_get_registered(void)
+{
+    return registered ? &registered_cfg : NULL;
+}
@@ -31,6 +31,8 @@ int media_lib_mutex_create(media_lib_mutex_handle_t *mutex);
 
 int media_lib_mutex_destroy(media_lib_mutex_handle_t mutex);
 
+int media_lib_mutex_create_once(media_lib_mutex_handle_t *mutex);
+
 int media_lib_mutex_lock(media_lib_mutex_handle_t mutex, uint32_t timeout);
 
 int media_lib_mutex_unlock(media_lib_mutex_handle_t mutex);
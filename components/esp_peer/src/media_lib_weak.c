@@ -5,6 +5,7 @@
  * See LICENSE file for details.
  */
 
+#include <stdbool.h>
 #include "media_lib_os.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
@@ -56,6 +57,25 @@ int WEAK media_lib_mutex_destroy(media_lib_mutex_handle_t mutex)
     return 0;
 }
 
+int WEAK media_lib_mutex_create_once(media_lib_mutex_handle_t *mutex)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    if (__atomic_load_n(mutex, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    media_lib_mutex_handle_t lock = NULL;
+    if (media_lib_mutex_create(&lock) != 0) {
+        return -1;
+    }
+    media_lib_mutex_handle_t expected = NULL;
+    if (__atomic_compare_exchange_n(mutex, &expected, lock, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false) {
+        media_lib_mutex_destroy(lock);
+    }
+    return 0;
+}
+
 int WEAK media_lib_mutex_lock(media_lib_mutex_handle_t mutex, uint32_t timeout)
 {
     if (mutex == NULL) {
@@ -33,15 +33,42 @@
 #include "esp_crt_bundle.h"
 #endif
 #include "esp_http_client.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
 
 static const char *TAG = "HTTPS_CLIENT";
 
+#define HTTPS_ORIGIN_MAX_LEN (128)
+#define HTTPS_NOW_MS()       (uint32_t)(esp_timer_get_time() / 1000)
+
 typedef struct {
     const char *location;
     const char *auth;
     const char *cookie;
 } http_resp_keep_t;
 
+typedef struct {
+    esp_http_client_handle_t client;
+    char                     origin[HTTPS_ORIGIN_MAX_LEN];
+    uint32_t                 last_used;
+    bool                     in_use;
+} https_pool_conn_t;
+
+typedef struct {
+    https_pool_cfg_t         cfg;
+    https_pool_conn_t        conns[HTTPS_POOL_MAX_CONN_LIMIT];
+    https_pool_stats_t       stats;
+    media_lib_mutex_handle_t lock;
+} https_pool_t;
+
+static https_pool_t https_pool = {
+    .cfg = {
+        .max_conn = DEFAULT_HTTPS_POOL_MAX_CONN,
+        .idle_timeout_ms = DEFAULT_HTTPS_POOL_IDLE_TIMEOUT,
+        .session_resume = true,
+    },
+};
+
 typedef struct {
     http_header_t    header;
     http_body_t      body;
@@ -49,12 +76,53 @@ typedef struct {
     uint8_t         *data;
     int              fill_size;
     int              size;
+    int              max_size;
+    bool             overflow;
+    bool             header_sent;
     void            *ctx;
 } http_info_t;
 
+static int http_body_reserve(http_info_t *info, esp_http_client_handle_t client, int len)
+{
+    int need = info->fill_size + len;
+    if (need > info->max_size) {
+        return -1;
+    }
+    // Keep one extra byte for string terminator
+    need++;
+    if (need <= info->size) {
+        return 0;
+    }
+    // Reserve whole content at once if known, otherwise grow by double
+    int new_size = info->size * 2;
+    if (esp_http_client_is_chunked_response(client) == false) {
+        int content_len = (int)esp_http_client_get_content_length(client);
+        if (content_len + 1 > new_size) {
+            new_size = content_len + 1;
+        }
+    }
+    if (new_size < need) {
+        new_size = need;
+    }
+    if (new_size > info->max_size + 1) {
+        new_size = info->max_size + 1;
+    }
+    uint8_t *data = realloc(info->data, new_size);
+    if (data == NULL) {
+        return -1;
+    }
+    info->data = data;
+    info->size = new_size;
+    return 0;
+}
+
 esp_err_t _http_event_handler(esp_http_client_event_t *evt)
 {
     http_info_t *info = evt->user_data;
+    if (info == NULL) {
+        // Pooled connection closed when no request attached
+        return ESP_OK;
+    }
     switch (evt->event_id) {
         default:
             break;
@@ -66,6 +134,7 @@ esp_err_t _http_event_handler(esp_http_client_event_t *evt)
             break;
         case HTTP_EVENT_HEADER_SENT:
             ESP_LOGD(TAG, "HTTP_EVENT_HEADER_SENT");
+            info->header_sent = true;
             break;
         case HTTP_EVENT_ON_HEADER:
             if (info->header) {
@@ -83,23 +152,22 @@ esp_err_t _http_event_handler(esp_http_client_event_t *evt)
             break;
         case HTTP_EVENT_ON_DATA:
             ESP_LOGD(TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
-            if (!esp_http_client_is_chunked_response(evt->client)) {
-                int content_len = esp_http_client_get_content_length(evt->client);
-                if (info->data == NULL && content_len) {
-                    info->data = malloc(content_len);
-                    if (info->data) {
-                        info->size = content_len;
-                    }
-                }
-                if (evt->data_len && info->fill_size + evt->data_len <= info->size) {
-                    memcpy(info->data + info->fill_size, evt->data, evt->data_len);
-                    info->fill_size += evt->data_len;
-                }
+            if (evt->data_len <= 0 || info->overflow) {
+                break;
+            }
+            // Chunked data is already decoded by `esp_http_client`
+            if (http_body_reserve(info, evt->client, evt->data_len) != 0) {
+                ESP_LOGE(TAG, "Body exceed limit %d or no memory", info->max_size);
+                info->overflow = true;
+                break;
             }
+            memcpy(info->data + info->fill_size, evt->data, evt->data_len);
+            info->fill_size += evt->data_len;
             break;
         case HTTP_EVENT_ON_FINISH:
             ESP_LOGD(TAG, "HTTP_EVENT_ON_FINISH");
-            if (info->fill_size && info->body) {
+            if (info->fill_size && info->body && info->overflow == false) {
+                info->data[info->fill_size] = '\0';
                 http_resp_t resp = {
                     .data = (char *)info->data,
                     .size = info->fill_size,
@@ -181,6 +249,167 @@ static void free_resp_header(http_resp_keep_t *resp)
     }
 }
 
+static void https_pool_lock(void)
+{
+    media_lib_mutex_create_once(&https_pool.lock);
+    media_lib_mutex_lock(https_pool.lock, MEDIA_LIB_MAX_LOCK_TIME);
+}
+
+static void https_pool_unlock(void)
+{
+    media_lib_mutex_unlock(https_pool.lock);
+}
+
+static bool https_get_origin(const char *url, char *origin, int size)
+{
+    url_component_t c;
+    if (parse_url(url, &c) == false) {
+        return false;
+    }
+    int len = snprintf(origin, size, "%.*s://%.*s:%d", c.scheme_len, c.scheme_start,
+                       c.host_len, c.host_start, c.port);
+    return (len > 0 && len < size);
+}
+
+static void https_pool_close_conn(https_pool_conn_t *conn)
+{
+    esp_http_client_cleanup(conn->client);
+    memset(conn, 0, sizeof(https_pool_conn_t));
+}
+
+static void https_pool_evict_idle(uint32_t now)
+{
+    for (int i = 0; i < HTTPS_POOL_MAX_CONN_LIMIT; i++) {
+        https_pool_conn_t *conn = &https_pool.conns[i];
+        if (conn->client == NULL || conn->in_use) {
+            continue;
+        }
+        if (i >= https_pool.cfg.max_conn || now - conn->last_used >= https_pool.cfg.idle_timeout_ms) {
+            https_pool_close_conn(conn);
+            https_pool.stats.evicted++;
+        }
+    }
+}
+
+static esp_http_client_handle_t https_pool_acquire(const char *origin, bool *reused)
+{
+    esp_http_client_handle_t client = NULL;
+    *reused = false;
+    https_pool_lock();
+    https_pool_evict_idle(HTTPS_NOW_MS());
+    for (int i = 0; i < https_pool.cfg.max_conn; i++) {
+        https_pool_conn_t *conn = &https_pool.conns[i];
+        if (conn->client && conn->in_use == false && strcmp(conn->origin, origin) == 0) {
+            conn->in_use = true;
+            client = conn->client;
+            https_pool.stats.reused++;
+            *reused = true;
+            break;
+        }
+    }
+    https_pool_unlock();
+    return client;
+}
+
+static void https_pool_release(const char *origin, esp_http_client_handle_t client, bool reusable)
+{
+    https_pool_conn_t *slot = NULL;
+    https_pool_lock();
+    for (int i = 0; i < HTTPS_POOL_MAX_CONN_LIMIT; i++) {
+        if (https_pool.conns[i].client == client) {
+            slot = &https_pool.conns[i];
+            break;
+        }
+    }
+    if (slot == NULL && reusable) {
+        // Take an empty slot or the least recently used idle one
+        for (int i = 0; i < https_pool.cfg.max_conn; i++) {
+            https_pool_conn_t *conn = &https_pool.conns[i];
+            if (conn->client == NULL) {
+                slot = conn;
+                break;
+            }
+            if (conn->in_use == false && (slot == NULL || conn->last_used < slot->last_used)) {
+                slot = conn;
+            }
+        }
+        if (slot && slot->client) {
+            https_pool_close_conn(slot);
+            https_pool.stats.evicted++;
+        }
+    }
+    if (slot == NULL || reusable == false) {
+        if (slot) {
+            memset(slot, 0, sizeof(https_pool_conn_t));
+        }
+        esp_http_client_cleanup(client);
+    } else {
+        esp_http_client_set_user_data(client, NULL);
+        slot->client = client;
+        strncpy(slot->origin, origin, HTTPS_ORIGIN_MAX_LEN - 1);
+        slot->last_used = HTTPS_NOW_MS();
+        slot->in_use = false;
+    }
+    https_pool_unlock();
+}
+
+static void https_reset_request(esp_http_client_handle_t client, https_request_t *req)
+{
+    // Pooled client keep headers and post field, clear them before next request
+    esp_http_client_set_post_field(client, NULL, 0);
+    esp_http_client_delete_header(client, "Content-Type");
+    esp_http_client_delete_header(client, "Authorization");
+    esp_http_client_delete_header(client, "Cookie");
+    if (req->headers == NULL) {
+        return;
+    }
+    for (int i = 0; req->headers[i]; i++) {
+        char *h = strdup(req->headers[i]);
+        if (h == NULL) {
+            continue;
+        }
+        char *dot = strchr(h, ':');
+        if (dot) {
+            *dot = 0;
+            esp_http_client_delete_header(client, h);
+        }
+        free(h);
+    }
+}
+
+int https_pool_set_cfg(https_pool_cfg_t *cfg)
+{
+    if (cfg == NULL || cfg->max_conn > HTTPS_POOL_MAX_CONN_LIMIT) {
+        return -1;
+    }
+    https_pool_lock();
+    https_pool.cfg = *cfg;
+    https_pool_evict_idle(HTTPS_NOW_MS());
+    https_pool_unlock();
+    return 0;
+}
+
+void https_pool_flush(void)
+{
+    https_pool_lock();
+    for (int i = 0; i < HTTPS_POOL_MAX_CONN_LIMIT; i++) {
+        https_pool_conn_t *conn = &https_pool.conns[i];
+        if (conn->client && conn->in_use == false) {
+            https_pool_close_conn(conn);
+        }
+    }
+    https_pool_unlock();
+}
+
+void https_pool_get_stats(https_pool_stats_t *stats)
+{
+    if (stats) {
+        https_pool_lock();
+        *stats = https_pool.stats;
+        https_pool_unlock();
+    }
+}
+
 int https_request_advance(https_request_cfg_t *cfg, https_request_t *req)
 {
     https_request_cfg_t default_cfg = {
@@ -199,6 +428,7 @@ int https_request_advance(https_request_cfg_t *cfg, https_request_t *req)
     http_info_t info = {
         .body = req->body_cb,
         .header = req->header_cb,
+        .max_size = cfg->max_body_size ? cfg->max_body_size : DEFAULT_HTTPS_MAX_BODY_SIZE,
         .ctx = req->ctx,
     };
     esp_http_client_config_t http_config = {
@@ -216,24 +446,46 @@ int https_request_advance(https_request_cfg_t *cfg, https_request_t *req)
         .keep_alive_interval = cfg->keep_alive_interval,
         .keep_alive_count = cfg->keep_alive_count,
         .user_data = &info,
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .save_client_session = https_pool.cfg.session_resume,
+#endif
     };
-    esp_http_client_handle_t client = esp_http_client_init(&http_config);
-    if (client == NULL) {
-        ESP_LOGE(TAG, "Fail to init client");
-        return -1;
+    char origin[HTTPS_ORIGIN_MAX_LEN];
+    bool use_pool = https_pool.cfg.max_conn && https_get_origin(req->url, origin, sizeof(origin));
+    bool reused = false;
+    bool reusable = false;
+    esp_http_client_handle_t client = NULL;
+    if (use_pool) {
+        client = https_pool_acquire(origin, &reused);
+    }
+    if (client) {
+        esp_http_client_set_user_data(client, &info);
+        esp_http_client_set_timeout_ms(client, http_config.timeout_ms);
+    } else {
+        client = esp_http_client_init(&http_config);
+        if (client == NULL) {
+            ESP_LOGE(TAG, "Fail to init client");
+            return -1;
+        }
+        https_pool_lock();
+        https_pool.stats.created++;
+        https_pool_unlock();
     }
     // POST
     int err = 0;
+    bool idempotent = false;
     char *last_url = (char*)req->url;
     esp_http_client_set_url(client, req->url);
     if (strcmp(req->method, "POST") == 0) {
         esp_http_client_set_method(client, HTTP_METHOD_POST);
     } else if (strcmp(req->method, "DELETE") == 0) {
         esp_http_client_set_method(client, HTTP_METHOD_DELETE);
+        idempotent = true;
     } else if (strcmp(req->method, "PATCH") == 0) {
         esp_http_client_set_method(client, HTTP_METHOD_PATCH);
     } else if (strcmp(req->method, "GET") == 0) {
         esp_http_client_set_method(client, HTTP_METHOD_GET);
+        idempotent = true;
     } else {
         err = -1;
         goto _exit;
@@ -277,13 +529,24 @@ RETRY_PERFORM:
         info.data = NULL;
     }
     info.fill_size = 0;
+    info.size = 0;
+    info.overflow = false;
+    info.header_sent = false;
     free_resp_header(&info.resp_keep);
 
     err = esp_http_client_perform(client);
+    if (err != ESP_OK && reused && (idempotent || info.header_sent == false)) {
+        // Kept connection may already closed by server, retry once with new connection
+        // POST/PATCH is not idempotent, only resend it when nothing was written to avoid duplicated resource
+        ESP_LOGD(TAG, "Kept connection fail, reconnect to %s", last_url);
+        reused = false;
+        esp_http_client_close(client);
+        goto RETRY_PERFORM;
+    }
     if (err == ESP_OK) {
         ESP_LOGI(TAG, "HTTP Status = %d, content_length = %lld",
                  esp_http_client_get_status_code(client),
-                 esp_http_client_get_content_length(client));
+                 (long long)esp_http_client_get_content_length(client));
         int status_code = esp_http_client_get_status_code(client);
         if (status_code >= 301 && status_code < 400) {
             // Handle redirection
@@ -300,11 +563,19 @@ RETRY_PERFORM:
                     goto RETRY_PERFORM;
                 }
             }
+        } else if (info.overflow) {
+            ESP_LOGE(TAG, "HTTP %s response body too large", req->method);
+            err = -1;
+        }
+        if (req->status) {
+            *req->status = status_code;
         }
     } else {
         ESP_LOGE(TAG, "HTTP %s request failed: %s", req->method, esp_err_to_name(err));
     }
 _exit:
+    // Only keep connection which still connect to original origin
+    reusable = use_pool && err == ESP_OK && (last_url == req->url || is_same_origin(last_url, req->url));
     if (last_url != req->url) {
         free(last_url);
     }
@@ -313,7 +584,12 @@ _exit:
     if (info.data) {
         free(info.data);
     }
-    esp_http_client_cleanup(client);
+    if (use_pool) {
+        https_reset_request(client, req);
+        https_pool_release(origin, client, reusable);
+    } else {
+        esp_http_client_cleanup(client);
+    }
     return err;
 }
 
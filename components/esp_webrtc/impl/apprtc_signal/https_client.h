@@ -25,6 +25,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,10 @@ extern "C" {
 #define DEFAULT_HTTPS_KEEP_ALIVE_COUNT    3
 #define DEFAULT_HTTPS_KEEP_ALIVE_IDLE     5
 #define DEFAULT_HTTPS_KEEP_ALIVE_INTERVAL 3
+#define DEFAULT_HTTPS_MAX_BODY_SIZE       (64 * 1024)
+#define DEFAULT_HTTPS_POOL_MAX_CONN       2
+#define DEFAULT_HTTPS_POOL_IDLE_TIMEOUT   (15000)
+#define HTTPS_POOL_MAX_CONN_LIMIT         (4)
 
 /**
  * @brief  Https response data
@@ -77,8 +82,32 @@ typedef struct {
     uint8_t   keep_alive_count;    /*!< Keep alive count */
     uint16_t  keep_alive_idle;     /*!< Keep alive idle */
     uint16_t  keep_alive_interval; /*!< Keep alive send interval */
+    uint32_t  max_body_size;       /*!< Maximum response body size to buffer, request fails if exceeded (0 to use default) */
 } https_request_cfg_t;
 
+/**
+ * @brief  HTTPS connection pool configuration
+ *
+ * @note  Connections are kept per origin (scheme, host and port) after request finished,
+ *        so that following requests to the same origin can skip TCP and TLS handshake
+ *        If a kept connection fails, GET and DELETE are resent once on a new connection,
+ *        POST and PATCH are only resent when nothing was written yet to avoid duplicated resource
+ */
+typedef struct {
+    uint8_t   max_conn;         /*!< Maximum connections kept in pool (limited to `HTTPS_POOL_MAX_CONN_LIMIT`), 0 to disable pool */
+    uint32_t  idle_timeout_ms;  /*!< Idle connection is closed after this time (unit milliseconds) */
+    bool      session_resume;   /*!< Resume TLS session use session ticket when connection need rebuild */
+} https_pool_cfg_t;
+
+/**
+ * @brief  HTTPS connection pool statistics
+ */
+typedef struct {
+    uint32_t  created;  /*!< Connections newly created */
+    uint32_t  reused;   /*!< Requests served by kept connection */
+    uint32_t  evicted;  /*!< Connections closed due to idle timeout or pool full */
+} https_pool_stats_t;
+
 /**
  * @brief  HTTP request information
  */
@@ -88,8 +117,9 @@ typedef struct {
     char         **headers;    /*!< HTTP headers Arrays of "Type: Info" */
     char          *data;       /*!< Content data to send (special for post) */
     http_header_t  header_cb;  /*!< Response header callback */
-    http_body_t    body_cb;    /*!< Response body callback */
+    http_body_t    body_cb;    /*!< Response body callback, called once with whole body */
     void          *ctx;        /*!< Callback context */
+    int           *status;     /*!< Output of final HTTP status code (optional) */
 } https_request_t;
 
 /**
@@ -143,6 +173,34 @@ int https_post(const char *url, char **headers, char *data, http_header_t header
  */
 int https_request_advance(https_request_cfg_t *cfg, https_request_t *req);
 
+/**
+ * @brief  Set https connection pool configuration
+ *
+ * @note  Pool is enabled by default using `DEFAULT_HTTPS_POOL_MAX_CONN` and `DEFAULT_HTTPS_POOL_IDLE_TIMEOUT`
+ *        Kept connections over new `max_conn` are closed
+ *
+ * @param[in]  cfg  Pool configuration
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Invalid argument
+ */
+int https_pool_set_cfg(https_pool_cfg_t *cfg);
+
+/**
+ * @brief  Close all idle connections in https connection pool
+ *
+ * @note  Call it when signaling finished to release TLS resources
+ */
+void https_pool_flush(void);
+
+/**
+ * @brief  Get https connection pool statistics
+ *
+ * @param[out]  stats  Pool statistics
+ */
+void https_pool_get_stats(https_pool_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
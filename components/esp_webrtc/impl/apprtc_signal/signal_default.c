@@ -46,6 +46,8 @@
 #include <cJSON.h>
 
 #include "https_client.h"
+#include "tls_transport.h"
+#include "webrtc_utils_json.h"
 
 #define TAG "APPRTC_SIG"
 
@@ -265,94 +267,80 @@ static int on_connect(void *user)
     return 0;
 }
 
-/* The custom on_text handler for this instance of the websocket code. */
-static int on_text(void *user, const char *text, size_t len)
+static void notify_msg(wss_sig_t *sg, esp_peer_signaling_msg_type_t type, webrtc_utils_json_field_t *field)
+{
+    if (field->value.str == NULL || field->is_str == false ||
+        webrtc_utils_json_unescape(&field->value) != ESP_OK) {
+        return;
+    }
+    esp_peer_signaling_msg_t msg = {
+        .type = type,
+        .data = (uint8_t *)field->value.str,
+        .size = field->value.len,
+    };
+    sg->cfg.on_msg(&msg, sg->cfg.ctx);
+}
+
+/* The custom on_text handler for this instance of the websocket code.
+ * Message is parsed in place (string values are unescaped into the input buffer) to avoid building JSON trees.
+ */
+static int on_text(void *user, char *text, size_t len)
 {
     if (len == 0) {
         return 0;
     }
     // printf("on_text(user, ws, '%.*s', %zd)\n", (int) len, text, len);
     wss_sig_t *sg = user;
-    if (sg->cfg.on_msg) {
-        cJSON *_json = cJSON_Parse(text);
-        cJSON *msg = NULL;
-        do {
-            if (_json == NULL) {
-                break;
-            }
-            msg = cJSON_GetObjectItem(_json, "msg");
-            // Json string in json
-            cJSON *method;
-            if (msg == NULL) {
-                method = cJSON_GetObjectItem(_json, "type");
-                if (method == NULL) {
-                    break;
-                }
-                msg = _json;
-            } else {
-                msg = cJSON_Parse(msg->valuestring);
-                method = cJSON_GetObjectItem(msg, "type");
-                if (method == NULL) {
-                    break;
-                }
-            }
-            if (strcmp(method->valuestring, "offer") == 0) {
-                cJSON *sdp = cJSON_GetObjectItem(msg, "sdp");
-                if (sdp) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_SDP,
-                        .data = (uint8_t *)sdp->valuestring,
-                        .size = strlen(sdp->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "answer") == 0) {
-                cJSON *sdp = cJSON_GetObjectItem(msg, "sdp");
-                if (sdp) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_SDP,
-                        .data = (uint8_t *)sdp->valuestring,
-                        .size = strlen(sdp->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "bye") == 0) {
-                // Peer closed
-                esp_peer_signaling_msg_t msg = {
-                    .type = ESP_PEER_SIGNALING_MSG_BYE,
-                };
-                sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                // When peer leave change rule to caller directly
-                ESP_LOGI(TAG, "Peer leaved become controlling now");
-                sg->ice_info.is_initiator = true;
-            } else if (strcmp(method->valuestring, "candidate") == 0) {
-                cJSON *candidate = cJSON_GetObjectItem(msg, "candidate");
-                if (candidate) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_CANDIDATE,
-                        .data = (uint8_t *)candidate->valuestring,
-                        .size = strlen(candidate->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "customized") == 0) {
-                cJSON *custom_data = cJSON_GetObjectItem(msg, "data");
-                if (custom_data) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_CUSTOMIZED,
-                        .data = (uint8_t *)custom_data->valuestring,
-                        .size = strlen(custom_data->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            }
-        } while (0);
-        if (msg == NULL) {
+    if (sg->cfg.on_msg == NULL) {
+        return 0;
+    }
+    enum {
+        FIELD_TYPE,
+        FIELD_SDP,
+        FIELD_CANDIDATE,
+        FIELD_DATA,
+        FIELD_MSG,
+        FIELD_MAX,
+    };
+    webrtc_utils_json_field_t fields[FIELD_MAX] = {
+        [FIELD_TYPE] = { .key = "type" },
+        [FIELD_SDP] = { .key = "sdp" },
+        [FIELD_CANDIDATE] = { .key = "candidate" },
+        [FIELD_DATA] = { .key = "data" },
+        [FIELD_MSG] = { .key = "msg" },
+    };
+    if (webrtc_utils_json_find(text, (int)len, fields, FIELD_MAX) != ESP_OK) {
+        ESP_LOGE(TAG, "Bad json input");
+        return 0;
+    }
+    webrtc_utils_json_field_t *msg = &fields[FIELD_MSG];
+    if (msg->value.str) {
+        // Json string in json, unescape it in place then parse inner object
+        if (msg->is_str == false || webrtc_utils_json_unescape(&msg->value) != ESP_OK ||
+            webrtc_utils_json_find(msg->value.str, msg->value.len, fields, FIELD_MSG) != ESP_OK) {
             ESP_LOGE(TAG, "Bad json input");
-        } else if (msg != _json) {
-            cJSON_Delete(msg);
+            return 0;
         }
-        cJSON_Delete(_json);
+    }
+    webrtc_utils_json_field_t *method = &fields[FIELD_TYPE];
+    if (method->value.str == NULL || method->is_str == false) {
+        return 0;
+    }
+    if (webrtc_utils_json_equal(&method->value, "offer") || webrtc_utils_json_equal(&method->value, "answer")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_SDP, &fields[FIELD_SDP]);
+    } else if (webrtc_utils_json_equal(&method->value, "bye")) {
+        // Peer closed
+        esp_peer_signaling_msg_t msg = {
+            .type = ESP_PEER_SIGNALING_MSG_BYE,
+        };
+        sg->cfg.on_msg(&msg, sg->cfg.ctx);
+        // When peer leave change rule to caller directly
+        ESP_LOGI(TAG, "Peer leaved become controlling now");
+        sg->ice_info.is_initiator = true;
+    } else if (webrtc_utils_json_equal(&method->value, "candidate")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_CANDIDATE, &fields[FIELD_CANDIDATE]);
+    } else if (webrtc_utils_json_equal(&method->value, "customized")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_CUSTOMIZED, &fields[FIELD_DATA]);
     }
     return 0;
 }
@@ -394,7 +382,8 @@ static void websocket_event_handler(void *ctx, esp_event_base_t base, int32_t ev
             }
             break;
         case WEBSOCKET_EVENT_DATA:
-            on_text(ctx, data->data_ptr, data->data_len);
+            // Receive buffer is owned by websocket client and rewritten on next read, safe to parse in place
+            on_text(ctx, (char *)data->data_ptr, data->data_len);
             break;
         case WEBSOCKET_EVENT_ERROR:
             ESP_LOGI(TAG, "WEBSOCKET_EVENT_ERROR");
@@ -417,8 +406,21 @@ int create_wss(wss_sig_t *sg)
     char origin[128];
     snprintf(origin, 128, "Origin: %s\r\n", sg->client_info.base_url);
 
+    // Connect through media_lib_tls so that websocket reconnect resumes TLS session
+    media_lib_tls_cfg_t tls_cfg = {
+#ifdef CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+        .crt_bundle_attach = esp_crt_bundle_attach,
+#endif
+        .timeout_ms = 10000,
+        .resume_session = true,
+    };
+    esp_transport_handle_t tls_transport = NULL;
+    if (strncmp(sg->client_info.wss_url, "wss://", 6) == 0) {
+        tls_transport = tls_transport_create(&tls_cfg);
+    }
     esp_websocket_client_config_t ws_cfg = {
         .uri = sg->client_info.wss_url,
+        .ext_transport = tls_transport,
         .headers = origin,
 #ifdef CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
         .crt_bundle_attach = esp_crt_bundle_attach,
@@ -431,6 +433,7 @@ int create_wss(wss_sig_t *sg)
         .buffer_size = 20 * 1024,
     };
     ESP_LOGI(TAG, "Connecting to %s...", ws_cfg.uri);
+    // External transport is owned and destroyed by websocket client
     wss->ws = esp_websocket_client_init(&ws_cfg);
     do {
         if (wss->ws == NULL) {
@@ -686,6 +689,7 @@ int wss_signal_stop(esp_peer_signaling_handle_t h)
         destroy_wss(sg->wss_client);
     }
     stop_reload_ice_timer(sg);
+    https_pool_flush();
     free_client_info(&sg->client_info);
     free_ice_info(&sg->ice_info);
     free(sg);
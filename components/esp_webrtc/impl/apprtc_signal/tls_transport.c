@@ -0,0 +1,170 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include <sys/select.h>
+#include "esp_log.h"
+#include "esp_tls.h"
+#include "tls_transport.h"
+
+#define TAG "TLS_TRANSPORT"
+
+typedef struct {
+    media_lib_tls_cfg_handle_t cfg;
+    media_lib_tls_handle_t     tls;
+} tls_transport_t;
+
+static int tls_transport_poll(esp_transport_handle_t t, int timeout_ms, bool read)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    if (ctx->tls == NULL) {
+        return -1;
+    }
+    int fd = media_lib_tls_getsockfd(ctx->tls);
+    if (fd < 0) {
+        return -1;
+    }
+    fd_set fds;
+    fd_set err_fds;
+    FD_ZERO(&fds);
+    FD_ZERO(&err_fds);
+    FD_SET(fd, &fds);
+    FD_SET(fd, &err_fds);
+    struct timeval timeout = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int ret = select(fd + 1, read ? &fds : NULL, read ? NULL : &fds, &err_fds, timeout_ms < 0 ? NULL : &timeout);
+    if (ret > 0 && FD_ISSET(fd, &err_fds)) {
+        return -1;
+    }
+    return ret;
+}
+
+static int tls_transport_poll_read(esp_transport_handle_t t, int timeout_ms)
+{
+    return tls_transport_poll(t, timeout_ms, true);
+}
+
+static int tls_transport_poll_write(esp_transport_handle_t t, int timeout_ms)
+{
+    return tls_transport_poll(t, timeout_ms, false);
+}
+
+static int tls_transport_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    if (ctx->tls) {
+        media_lib_tls_delete(ctx->tls);
+    }
+    ctx->tls = media_lib_tls_new_with_cfg(host, strlen(host), port, ctx->cfg);
+    if (ctx->tls == NULL) {
+        ESP_LOGE(TAG, "Fail to connect %s:%d", host, port);
+        return -1;
+    }
+    return 0;
+}
+
+static int tls_transport_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    if (ctx->tls == NULL) {
+        return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+    int poll = -1;
+    if (timeout_ms >= 0 && media_lib_tls_get_bytes_avail(ctx->tls) <= 0) {
+        poll = tls_transport_poll_read(t, timeout_ms);
+        if (poll == 0) {
+            return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+        }
+        if (poll < 0) {
+            return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+        }
+    }
+    int ret = media_lib_tls_read(ctx->tls, buffer, len);
+    if (ret == 0) {
+        return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    }
+    if (ret == ESP_TLS_ERR_SSL_WANT_READ || ret == ESP_TLS_ERR_SSL_TIMEOUT) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    return ret < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : ret;
+}
+
+static int tls_transport_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    if (ctx->tls == NULL) {
+        return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+    int poll = tls_transport_poll_write(t, timeout_ms);
+    if (poll <= 0) {
+        return poll == 0 ? ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT : ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+    int ret = media_lib_tls_write(ctx->tls, buffer, len);
+    if (ret == ESP_TLS_ERR_SSL_WANT_WRITE) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    return ret < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : ret;
+}
+
+static int tls_transport_close(esp_transport_handle_t t)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    if (ctx->tls) {
+        media_lib_tls_delete(ctx->tls);
+        ctx->tls = NULL;
+    }
+    return 0;
+}
+
+static int tls_transport_destroy(esp_transport_handle_t t)
+{
+    tls_transport_t *ctx = esp_transport_get_context_data(t);
+    tls_transport_close(t);
+    media_lib_tls_cfg_unref(ctx->cfg);
+    free(ctx);
+    return 0;
+}
+
+esp_transport_handle_t tls_transport_create(const media_lib_tls_cfg_t *cfg)
+{
+    media_lib_tls_cfg_handle_t tls_cfg = media_lib_tls_cfg_create(cfg);
+    if (tls_cfg == NULL) {
+        return NULL;
+    }
+    tls_transport_t *ctx = calloc(1, sizeof(tls_transport_t));
+    esp_transport_handle_t t = ctx ? esp_transport_init() : NULL;
+    if (t == NULL) {
+        free(ctx);
+        media_lib_tls_cfg_unref(tls_cfg);
+        return NULL;
+    }
+    ctx->cfg = tls_cfg;
+    esp_transport_set_context_data(t, ctx);
+    esp_transport_set_func(t, tls_transport_connect, tls_transport_read, tls_transport_write, tls_transport_close,
+                           tls_transport_poll_read, tls_transport_poll_write, tls_transport_destroy);
+    esp_transport_set_default_port(t, 443);
+    return t;
+}
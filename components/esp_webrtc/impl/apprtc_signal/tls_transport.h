@@ -0,0 +1,50 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#pragma once
+
+#include "esp_transport.h"
+#include "media_lib_tls.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Create TLS transport based on `media_lib_tls` shared configuration
+ *
+ * @note  Connection created by this transport resumes TLS session from client session cache,
+ *        so that reconnect to the same server can skip full handshake
+ *        Buffers referenced by `cfg` must stay valid until the transport is destroyed
+ *
+ * @param[in]  cfg  TLS client configuration
+ *
+ * @return
+ *       - NULL    Not enough memory or `media_lib_tls` extended functions not registered
+ *       - Others  Transport handle, can be used as parent transport of websocket
+ */
+esp_transport_handle_t tls_transport_create(const media_lib_tls_cfg_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
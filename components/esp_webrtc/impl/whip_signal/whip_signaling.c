@@ -39,7 +39,11 @@
 }
 
 #define MAX_SERVER_SUPPORT        (4)
+#define MAX_PENDING_CANDIDATE     (8)
+#define MAX_SENT_CANDIDATE        (16)
+#define CANDIDATE_ID_SIZE         (40)  /*!< Foundation (at most 32 chars) and component id */
 #define GET_PARAM_VALUE(str, key) get_param_value(str, key, sizeof(key) - 1)
+#define STR_SAME(a, b)            (strncmp(a, b, sizeof(b) - 1) == 0)
 
 typedef struct {
     esp_peer_signaling_cfg_t       cfg;
@@ -48,6 +52,13 @@ typedef struct {
     int                            remote_sdp_size;
     bool                           local_sdp_sent;
     char                          *location;
+    char                          *etag;
+    char                          *frag_head;
+    char                           sent_candidates[MAX_SENT_CANDIDATE][CANDIDATE_ID_SIZE];  /*!< Identity of candidates server knows */
+    uint8_t                        sent_num;
+    uint8_t                        sent_pos;
+    char                          *pending_candidates[MAX_PENDING_CANDIDATE];
+    uint8_t                        pending_num;
     esp_peer_ice_server_cfg_t     *ice_servers[MAX_SERVER_SUPPORT];
     uint8_t                        server_num;
 } whip_signaling_t;
@@ -141,7 +152,7 @@ static char *get_param_value(char *s, char *param, int param_size)
 
 static int extract_ice_info(whip_signaling_t *sig, char *link)
 {
-    if (sig->server_num > MAX_SERVER_SUPPORT) {
+    if (sig->server_num >= MAX_SERVER_SUPPORT) {
         return ESP_PEER_ERR_OVER_LIMITED;
     }
     // Check if this Link header is for an ICE server
@@ -188,6 +199,20 @@ static void whip_sdp_header(const char *key, const char *value, void *ctx)
     if (strcasecmp(key, "Link") == 0) {
         extract_ice_info(sig, (char *)value);
     }
+    if (strcasecmp(key, "ETag") == 0) {
+        SAFE_FREE(sig->etag);
+        sig->etag = strdup(value);
+    }
+}
+
+static void whip_patch_header(const char *key, const char *value, void *ctx)
+{
+    whip_signaling_t *sig = (whip_signaling_t *)ctx;
+    // Server may update ETag after ICE restart
+    if (value && strcasecmp(key, "ETag") == 0) {
+        SAFE_FREE(sig->etag);
+        sig->etag = strdup(value);
+    }
 }
 
 static char *get_auth_header(esp_peer_signaling_whip_cfg_t *whip_cfg)
@@ -217,11 +242,250 @@ static char *get_auth_header(esp_peer_signaling_whip_cfg_t *whip_cfg)
     return auth;
 }
 
+static char *get_sdp_line(const char *sdp, const char *prefix)
+{
+    const char *line = strstr(sdp, prefix);
+    if (line == NULL) {
+        return NULL;
+    }
+    int len = strcspn(line, "\r\n");
+    char *v = malloc(len + 1);
+    if (v) {
+        memcpy(v, line, len);
+        v[len] = '\0';
+    }
+    return v;
+}
+
+static int build_frag_head(whip_signaling_t *sig, const char *sdp)
+{
+    // RFC8840 sdpfrag: session level ICE credentials then first media with its mid (all media are bundled)
+    char *ufrag = get_sdp_line(sdp, "a=ice-ufrag:");
+    char *pwd = get_sdp_line(sdp, "a=ice-pwd:");
+    const char *media = strstr(sdp, "\nm=");
+    char *m_line = media ? get_sdp_line(media + 1, "m=") : NULL;
+    char *mid = media ? get_sdp_line(media + 1, "a=mid:") : NULL;
+    int ret = ESP_PEER_ERR_NO_MEM;
+    if (ufrag && pwd && m_line && mid) {
+        int len = strlen(ufrag) + strlen(pwd) + strlen(m_line) + strlen(mid) + 9;
+        sig->frag_head = malloc(len);
+        if (sig->frag_head) {
+            snprintf(sig->frag_head, len, "%s\r\n%s\r\n%s\r\n%s\r\n", ufrag, pwd, m_line, mid);
+            ret = ESP_PEER_ERR_NONE;
+        }
+    } else {
+        ESP_LOGW(TAG, "Local SDP lack ICE credential or media, trickle ICE disabled");
+        ret = ESP_PEER_ERR_INVALID_ARG;
+    }
+    SAFE_FREE(ufrag);
+    SAFE_FREE(pwd);
+    SAFE_FREE(m_line);
+    SAFE_FREE(mid);
+    return ret;
+}
+
+static int whip_patch_candidate(whip_signaling_t *sig, const char *candidate, int len)
+{
+    if (sig->frag_head == NULL) {
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    // Candidate may come with or without "a=" prefix
+    bool has_prefix = STR_SAME(candidate, "a=");
+    int frag_size = strlen(sig->frag_head) + len + 5;
+    char *frag = malloc(frag_size);
+    if (frag == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    snprintf(frag, frag_size, "%s%s%.*s\r\n", sig->frag_head, has_prefix ? "" : "a=", len, candidate);
+
+    char content_type[] = "Content-Type: application/trickle-ice-sdpfrag";
+    char *auth = get_auth_header(sig->whip_cfg);
+    char *if_match = NULL;
+    if (sig->etag) {
+        int match_size = strlen(sig->etag) + sizeof("If-Match: ");
+        if_match = malloc(match_size);
+        if (if_match) {
+            snprintf(if_match, match_size, "If-Match: %s", sig->etag);
+        }
+    }
+    char *header[4] = { content_type };
+    int n = 1;
+    if (auth) {
+        header[n++] = auth;
+    }
+    if (if_match) {
+        header[n++] = if_match;
+    }
+    int status = 0;
+    https_request_t req = {
+        .method = "PATCH",
+        .url = sig->location,
+        .headers = header,
+        .data = frag,
+        .header_cb = whip_patch_header,
+        .ctx = sig,
+        .status = &status,
+    };
+    int ret = https_request_advance(NULL, &req);
+    SAFE_FREE(if_match);
+    SAFE_FREE(auth);
+    SAFE_FREE(frag);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Fail to patch candidate to %s", sig->location);
+        return ESP_PEER_ERR_FAIL;
+    }
+    if (status == 412) {
+        // ETag mismatch means ICE session changed on server side
+        ESP_LOGE(TAG, "ICE session mismatch, ICE restart required");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    if (status == 405 || status == 501) {
+        ESP_LOGW(TAG, "Server not support trickle ICE");
+        SAFE_FREE(sig->frag_head);
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static void whip_patch_candidate_notify(whip_signaling_t *sig, const char *candidate, int len)
+{
+    int ret = whip_patch_candidate(sig, candidate, len);
+    if (ret == ESP_PEER_ERR_WRONG_STATE && sig->frag_head && sig->cfg.on_error) {
+        sig->cfg.on_error(ret, sig->cfg.ctx);
+    }
+}
+
+static bool get_candidate_id(const char *candidate, int len, char *id)
+{
+    // Candidate is identified by foundation and component: "a=candidate:<foundation> <component> ..."
+    const char *end = candidate + len;
+    if (STR_SAME(candidate, "a=")) {
+        candidate += 2;
+    }
+    if (end - candidate <= 10 || !STR_SAME(candidate, "candidate:")) {
+        return false;
+    }
+    candidate += 10;
+    int spaces = 0, n = 0;
+    while (candidate < end && n < CANDIDATE_ID_SIZE - 1) {
+        if (*candidate == ' ' && ++spaces == 2) {
+            break;
+        }
+        id[n++] = *candidate++;
+    }
+    id[n] = '\0';
+    return spaces == 2;
+}
+
+static bool whip_candidate_sent(whip_signaling_t *sig, const char *id)
+{
+    for (int i = 0; i < sig->sent_num; i++) {
+        if (strcmp(sig->sent_candidates[i], id) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void whip_mark_candidate_sent(whip_signaling_t *sig, const char *id)
+{
+    if (whip_candidate_sent(sig, id)) {
+        return;
+    }
+    // Forget oldest one when full, at worst it is patched again which server tolerates
+    strcpy(sig->sent_candidates[sig->sent_pos], id);
+    sig->sent_pos = (sig->sent_pos + 1) % MAX_SENT_CANDIDATE;
+    if (sig->sent_num < MAX_SENT_CANDIDATE) {
+        sig->sent_num++;
+    }
+}
+
+static void whip_add_candidate(whip_signaling_t *sig, const char *candidate, int len)
+{
+    char id[CANDIDATE_ID_SIZE];
+    bool has_id = get_candidate_id(candidate, len, id);
+    if (has_id && whip_candidate_sent(sig, id)) {
+        return;
+    }
+    if (sig->location) {
+        if (has_id) {
+            whip_mark_candidate_sent(sig, id);
+        }
+        whip_patch_candidate_notify(sig, candidate, len);
+        return;
+    }
+    // Resource not created yet, send after offer is accepted unless offer already carries it
+    if (sig->pending_num >= MAX_PENDING_CANDIDATE) {
+        ESP_LOGW(TAG, "Too many pending candidates, drop it");
+        return;
+    }
+    char *pending = malloc(len + 1);
+    if (pending) {
+        memcpy(pending, candidate, len);
+        pending[len] = '\0';
+        sig->pending_candidates[sig->pending_num++] = pending;
+    }
+}
+
+static void whip_flush_pending(whip_signaling_t *sig)
+{
+    for (int i = 0; i < sig->pending_num; i++) {
+        if (sig->location) {
+            whip_add_candidate(sig, sig->pending_candidates[i], strlen(sig->pending_candidates[i]));
+        }
+        SAFE_FREE(sig->pending_candidates[i]);
+    }
+    sig->pending_num = 0;
+}
+
+static void process_sdp_candidates(const char *sdp, int size, bool patch_new, whip_signaling_t *sig)
+{
+    // Candidates in SDP are matched by identity, gathering order and candidates sent alone do not matter
+    const char *end = sdp + size;
+    while (sdp < end) {
+        const char *line_end = sdp;
+        while (line_end < end && *line_end != '\r' && *line_end != '\n' && *line_end) {
+            line_end++;
+        }
+        if (line_end - sdp > 12 && STR_SAME(sdp, "a=candidate:")) {
+            char id[CANDIDATE_ID_SIZE];
+            if (patch_new) {
+                whip_add_candidate(sig, sdp, line_end - sdp);
+            } else if (get_candidate_id(sdp, line_end - sdp, id)) {
+                whip_mark_candidate_sent(sig, id);
+            }
+        }
+        if (line_end >= end || *line_end == '\0') {
+            break;
+        }
+        sdp = line_end + 1;
+    }
+}
+
+static void whip_notify_ice_servers(whip_signaling_t *sig)
+{
+    esp_peer_ice_server_cfg_t servers[MAX_SERVER_SUPPORT];
+    for (int i = 0; i < sig->server_num; i++) {
+        servers[i] = *sig->ice_servers[i];
+    }
+    esp_peer_signaling_ice_info_t ice_info = {
+        .is_initiator = true,
+        .server_info = servers[0],
+        .server_lists = servers,
+        .server_num = sig->server_num,
+    };
+    sig->cfg.on_ice_info(&ice_info, sig->cfg.ctx);
+}
+
 static int whip_signaling_send_msg(esp_peer_signaling_handle_t h, esp_peer_signaling_msg_t *msg)
 {
     whip_signaling_t *sig = (whip_signaling_t *)h;
     if (msg->type == ESP_PEER_SIGNALING_MSG_BYE) {
 
+    } else if (msg->type == ESP_PEER_SIGNALING_MSG_CANDIDATE) {
+        if (msg->data && msg->size) {
+            whip_add_candidate(sig, (char *)msg->data, msg->size);
+        }
     } else if (msg->type == ESP_PEER_SIGNALING_MSG_SDP) {
         if (sig->local_sdp_sent == false) {
             char content_type[] = "Content-Type: application/sdp";
@@ -234,14 +498,12 @@ static int whip_signaling_send_msg(esp_peer_signaling_handle_t h, esp_peer_signa
                 return ESP_PEER_ERR_FAIL;
             }
             sig->local_sdp_sent = true;
+            build_frag_head(sig, (char *)msg->data);
+            // Candidates in offer are known by server, pending ones among them are not patched again
+            process_sdp_candidates((char *)msg->data, msg->size, false, sig);
             if (sig->server_num) {
-                // Update ice_info
-                esp_peer_signaling_ice_info_t ice_info = {
-                    .is_initiator = true,
-                    .server_info = *sig->ice_servers[0],
-                };
-                // TODO support more servers?
-                sig->cfg.on_ice_info(&ice_info, sig->cfg.ctx);
+                // Update ice_info with all servers
+                whip_notify_ice_servers(sig);
             }
             // Try to extractor stun lists
             esp_peer_signaling_msg_t sdp_msg = {
@@ -251,20 +513,10 @@ static int whip_signaling_send_msg(esp_peer_signaling_handle_t h, esp_peer_signa
             };
             sig->cfg.on_msg(&sdp_msg, sig->cfg.ctx);
             SAFE_FREE(sig->remote_sdp);
+            whip_flush_pending(sig);
         } else if (sig->location) {
-            char *sdp = strstr((char *)msg->data, "a=group:BUNDLE");
-            if (sdp) {
-                // Patch for SDP
-                char content_type[] = "Content-Type: application/trickle-ice-sdpfrag";
-                char *auth = get_auth_header(sig->whip_cfg);
-                char *header[] = { content_type, auth, NULL };
-                int ret = https_send_request("PATCH", header, sig->location, sdp, NULL, NULL, h);
-                SAFE_FREE(auth);
-                if (ret != 0) {
-                    ESP_LOGE(TAG, "Fail to post data to %s", sig->location);
-                    return ESP_PEER_ERR_NONE;
-                }
-            }
+            // Updated SDP with more candidates, trickle new ones only
+            process_sdp_candidates((char *)msg->data, msg->size, true, sig);
         }
     }
     return ESP_PEER_ERR_NONE;
@@ -280,8 +532,14 @@ static int whip_signaling_stop(esp_peer_signaling_handle_t h)
                            sig->location, NULL, NULL, NULL, NULL);
         SAFE_FREE(auth);
     }
+    https_pool_flush();
     sig->cfg.on_close(sig->cfg.ctx);
     SAFE_FREE(sig->location);
+    SAFE_FREE(sig->etag);
+    SAFE_FREE(sig->frag_head);
+    for (int i = 0; i < sig->pending_num; i++) {
+        SAFE_FREE(sig->pending_candidates[i]);
+    }
     for (int i = 0; i < sig->server_num; i++) {
         SAFE_FREE(sig->ice_servers[i]->stun_url);
         SAFE_FREE(sig->ice_servers[i]->user);
@@ -34,8 +34,11 @@ extern "C" {
  * @brief  Signaling ICE information
  */
 typedef struct {
-    esp_peer_ice_server_cfg_t server_info;  /*!< STUN/Relay server information (optional if set by user directly) */
-    bool                      is_initiator; /*!< ICE roles, when as initiator also means being a controlling role */
+    esp_peer_ice_server_cfg_t  server_info;   /*!< STUN/Relay server information (optional if set by user directly) */
+    bool                       is_initiator;  /*!< ICE roles, when as initiator also means being a controlling role */
+    esp_peer_ice_server_cfg_t *server_lists;  /*!< Full STUN/Relay server list (optional), take precedence over `server_info`
+                                                   Only valid during callback, receiver need keep its own copy */
+    uint8_t                    server_num;    /*!< Number of servers in `server_lists` */
 } esp_peer_signaling_ice_info_t;
 
 /**
@@ -97,6 +100,15 @@ typedef struct {
     void* extra_cfg;   /*!< Extra configuration for special signaling server */
     int   extra_size;  /*!< Size of extra configuration */
     void* ctx;         /*!< User context */
+
+    /**
+     * @brief  Event callback for signaling error (optional, can be NULL)
+     * @note  Placed last so that configurations built against older layout keep field offsets
+     * @param[in]  err  Error code, `ESP_PEER_ERR_WRONG_STATE` means ICE session changed on server and ICE restart is required
+     * @param[in]  ctx  User context
+     * @return          Status code indicating success or failure.
+     */
+    int (*on_error)(int err, void* ctx);
 } esp_peer_signaling_cfg_t;
 
  /**
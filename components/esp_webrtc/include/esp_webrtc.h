@@ -25,6 +25,7 @@
 #pragma once
 
 #include "esp_peer.h"
+#include "esp_peer_jitter_buffer.h"
 #include "esp_peer_signaling.h"
 #include "esp_capture.h"
 #include "av_render.h"
@@ -130,6 +131,7 @@ typedef enum {
     ESP_WEBRTC_EVENT_DATA_CHANNEL_DISCONNECTED = 5, /*!< Data channel disconnected event */
     ESP_WEBRTC_EVENT_DATA_CHANNEL_OPENED       = 6, /*!< Data channel opened event, suitable for one data channel only */
     ESP_WEBRTC_EVENT_DATA_CHANNEL_CLOSED       = 7, /*!< Data channel closed event, suitable for one data channel only */
+    ESP_WEBRTC_EVENT_SIGNALING_ERROR           = 8, /*!< Signaling error event, ICE restart is required when server ICE session changed */
 } esp_webrtc_event_type_t;
 
 /**
@@ -151,6 +153,85 @@ typedef struct {
     av_render_handle_t   player;  /*!< Player handle */
 } esp_webrtc_media_provider_t;
 
+/**
+ * @brief  WebRTC extra video layer for fan-out mode
+ */
+typedef struct {
+    uint8_t   sink_idx; /*!< Capture sink index used to encode this layer (must not be 0) */
+    uint16_t  width;    /*!< Video width of this layer */
+    uint16_t  height;   /*!< Video height of this layer */
+    uint8_t   fps;      /*!< Video frame rate of this layer */
+} esp_webrtc_video_layer_t;
+
+/**
+ * @brief  WebRTC rate control information
+ *
+ * @note  Frame rate and resolution are only suggestion, user decide whether to apply them
+ */
+typedef struct {
+    uint32_t  target_bitrate; /*!< Estimated target bitrate for video (unit bps) */
+    uint8_t   fps;            /*!< Suggested video frame rate */
+    uint16_t  width;          /*!< Suggested video width */
+    uint16_t  height;         /*!< Suggested video height */
+} esp_webrtc_rate_control_t;
+
+/**
+ * @brief  WebRTC rate control configuration
+ */
+typedef struct {
+    uint32_t  min_bitrate;   /*!< Minimum video bitrate (unit bps) */
+    uint32_t  max_bitrate;   /*!< Maximum video bitrate (unit bps), normally the encoder bitrate for configured resolution */
+    uint32_t  start_bitrate; /*!< Bitrate at start of connection (unit bps), use `max_bitrate` if set to 0 */
+    /**
+     * @brief  Callback when rate control information changed
+     *         User should update encoder bitrate of capture sink, and optionally change frame rate or resolution
+     */
+    int (*on_rate_control)(esp_webrtc_rate_control_t *ctrl, void *ctx);
+    void *ctx;               /*!< User context */
+} esp_webrtc_rate_control_cfg_t;
+
+/**
+ * @brief  WebRTC key frame request configuration
+ */
+typedef struct {
+    uint16_t  min_interval; /*!< Minimum interval between two forced key frames (unit ms), default: 1000ms if set to 0
+                                 Requests during interval are merged into one issued when interval elapsed */
+    /**
+     * @brief  Callback to force encoder output key frame (IDR) for video layer
+     *         User should forward it to encoder of related capture sink
+     */
+    int (*on_key_frame)(uint8_t layer, void *ctx);
+    void *ctx;              /*!< User context */
+} esp_webrtc_key_frame_cfg_t;
+
+/**
+ * @brief  WebRTC key frame request statistics
+ */
+typedef struct {
+    uint32_t  received;   /*!< Key frame requests received (from peer, new viewer or layer switch) */
+    uint32_t  honored;    /*!< Key frames forced to encoder */
+    uint32_t  suppressed; /*!< Requests merged or dropped by rate limit */
+} esp_webrtc_key_frame_stats_t;
+
+/**
+ * @brief  WebRTC send pacer configuration
+ */
+typedef struct {
+    uint16_t  pacing_factor; /*!< Video pacing rate as percentage of target bitrate, default: 250 if set to 0 */
+    uint32_t  bitrate;       /*!< Target bitrate (unit bps), ignored when rate control is set */
+    uint16_t  max_delay;     /*!< Maximum time to hold one video frame (unit ms), default: 200ms if set to 0 */
+} esp_webrtc_pacer_cfg_t;
+
+/**
+ * @brief  WebRTC send pacer statistics (since last query)
+ */
+typedef struct {
+    uint32_t  audio_avg_delay; /*!< Average queue delay of audio frames from capture to send (unit ms), lowest seen delay taken as 0 */
+    uint32_t  audio_max_delay; /*!< Maximum queue delay of audio frames (unit ms) */
+    uint32_t  video_avg_delay; /*!< Average queue delay of video frames (unit ms) */
+    uint32_t  video_max_delay; /*!< Maximum queue delay of video frames (unit ms) */
+} esp_webrtc_pacer_stats_t;
+
 /**
  * @brief  WebRTC event handler
  *
@@ -202,6 +283,218 @@ int esp_webrtc_set_media_provider(esp_webrtc_handle_t rtc_handle, esp_webrtc_med
  */
 int esp_webrtc_set_no_auto_capture(esp_webrtc_handle_t rtc_handle, bool no_auto_capture);
 
+/**
+ * @brief  Set WebRTC to work in fan-out mode
+ *
+ * @note  WebRTC instances in fan-out mode with same capture handle share capture sink 0
+ *        Each frame is encoded once and sent to all connected peers, each peer still keeps its own
+ *        SRTP context, send queue and congestion state
+ *        Used for multiple viewers watching same source, it must be set before peer connection created
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  enable      Enable fan-out or not
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Peer connection already created
+ */
+int esp_webrtc_set_fanout(esp_webrtc_handle_t rtc_handle, bool enable);
+
+/**
+ * @brief  Set to use shared loop
+ *
+ * @note  In shared loop mode peer main loop and media sending run in one reactor thread shared by all
+ *        WebRTC instances which enabled it, instead of dedicated `pc_task` and `pc_send` threads per instance
+ *        Instances are serviced in rotating order so that one busy peer can not starve others
+ *        Reactor thread is created with `pc_task` schedule setting, its stack must fit DTLS handshake
+ *        It must be set before peer connection created
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  enable      Enable shared loop or not
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Peer connection already created
+ */
+int esp_webrtc_set_shared_loop(esp_webrtc_handle_t rtc_handle, bool enable);
+
+/**
+ * @brief  Set GOP cache for fan-out mode
+ *
+ * @note  Shared encoder keeps running when a new viewer joins, without cache it has to wait for next key frame
+ *        With cache, frames since last key frame (SPS/PPS/IDR and following ones) are kept for each running layer
+ *        and flushed to the new viewer first, so video shows up immediately without key frame request
+ *        Cache is dropped when it exceeds `cache_size` and rebuilt from next key frame, set it larger than one GOP
+ *        Only take effect in fan-out mode, it must be set before peer connection created
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  cache_size  Byte budget of cache for one layer, 0 to disable
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Peer connection already created
+ */
+int esp_webrtc_set_gop_cache(esp_webrtc_handle_t rtc_handle, uint32_t cache_size);
+
+/**
+ * @brief  Set extra video layers for fan-out mode
+ *
+ * @note  Base layer (layer 0) uses `video_info` in peer configuration and capture sink 0
+ *        Each extra layer is encoded by its own capture sink with same codec, only when some peer selected it
+ *        Layers are shared by all fan-out instances of same capture, configuration from first connected one is used
+ *        It must be called after `esp_webrtc_set_fanout` and before peer connection created
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  layers      Extra video layers
+ * @param[in]  layer_num   Number of extra layers (at most 2)
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Not in fan-out mode or peer connection already created
+ */
+int esp_webrtc_set_video_layers(esp_webrtc_handle_t rtc_handle, esp_webrtc_video_layer_t *layers, uint8_t layer_num);
+
+/**
+ * @brief  Select video layer sent to this peer
+ *
+ * @note  Can be switched at any time (for example according to rate control result)
+ *        After switch, video is sent from next key frame of the new layer
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  layer       Layer index, 0 for base layer
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument or layer not exists
+ */
+int esp_webrtc_select_video_layer(esp_webrtc_handle_t rtc_handle, uint8_t layer);
+
+/**
+ * @brief  Set rate control for video sending
+ *
+ * @note  Bandwidth is estimated by loss based control and delay gradient based control
+ *        Loss is counted from frames rejected by peer send pool, delay is measured from capture time until
+ *        the frame is taken by pacer (pacer hold time excluded)
+ *        It only reflects local send backlog, not a network estimator: receiver loss and delay (RTCP feedback)
+ *        are not available from peer, so congestion which does not back up the local send pool is not detected
+ *        `on_rate_control` is called at most once per second when target changes obviously
+ *        It must be set before peer connection created
+ *        For fan-out mode each peer has its own estimation, user should apply the lowest one to shared encoder
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  cfg         Rate control configuration, set to NULL to disable
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_NO_MEM       Not enough memory
+ *      - ESP_PEER_ERR_WRONG_STATE  Peer connection already created
+ */
+int esp_webrtc_set_rate_control(esp_webrtc_handle_t rtc_handle, esp_webrtc_rate_control_cfg_t *cfg);
+
+/**
+ * @brief  Set key frame request handler
+ *
+ * @note  Key frame is requested when peer sends PLI/FIR (if peer implementation reports it),
+ *        when connection established, when new viewer joined or switched layer in fan-out mode
+ *        The prebuilt default peer never reports PLI/FIR (`on_key_frame_request` is not called),
+ *        so with it only the connection and fan-out triggers apply
+ *        Requests are rate limited and merged so that PLI storm not turn stream into all key frames
+ *        In fan-out mode requests from all viewers of one layer are coalesced into one within `min_interval`
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  cfg         Key frame configuration, set to NULL to disable
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_set_key_frame_handler(esp_webrtc_handle_t rtc_handle, esp_webrtc_key_frame_cfg_t *cfg);
+
+/**
+ * @brief  Get key frame request statistics
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[out]  stats       Key frame statistics
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_get_key_frame_stats(esp_webrtc_handle_t rtc_handle, esp_webrtc_key_frame_stats_t *stats);
+
+/**
+ * @brief  Set send pacer
+ *
+ * @note  Audio frames are always sent firstly, video frames are held until pacing budget allows
+ *        Budget is refilled at `pacing_factor` percent of target bitrate, so big key frame is followed by
+ *        a pause of video instead of bursting all frames into peer send queue
+ *        Pacing is per frame only: a released video frame is handed to peer as a whole and packetized there,
+ *        so audio captured meanwhile still queues behind packets of that frame
+ *        Pacer is not applied in fan-out mode, shared frames are sent to all viewers as soon as captured
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  cfg         Pacer configuration, set to NULL to disable
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Media already sending
+ */
+int esp_webrtc_set_pacer(esp_webrtc_handle_t rtc_handle, esp_webrtc_pacer_cfg_t *cfg);
+
+/**
+ * @brief  Get send pacer statistics
+ *
+ * @note  Statistics are cleared after `esp_webrtc_query`
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[out]  stats       Pacer statistics
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_get_pacer_stats(esp_webrtc_handle_t rtc_handle, esp_webrtc_pacer_stats_t *stats);
+
+/**
+ * @brief  Set receive frame jitter buffer
+ *
+ * @note  Received audio and video frames are held in separate jitter buffers before sent to player
+ *        In adaptive mode target delay follows measured frame jitter plus configured margin within configured bounds
+ *        NACK recovery is still bounded by `cache_timeout` of the peer packet jitter buffer
+ *        Need set before peer connection created, set to NULL to disable (frames are rendered once received)
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  cfg         Jitter buffer configuration
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Peer connection already created
+ *      - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_webrtc_set_jitter_buffer(esp_webrtc_handle_t rtc_handle, esp_peer_jitter_buffer_cfg_t *cfg);
+
+/**
+ * @brief  Get receive jitter buffer statistics
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[out]  audio       Audio jitter buffer statistics (can be NULL)
+ * @param[out]  video       Video jitter buffer statistics (can be NULL)
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_WRONG_STATE  Jitter buffer not set
+ */
+int esp_webrtc_get_jitter_stats(esp_webrtc_handle_t rtc_handle, esp_peer_jitter_buffer_stats_t *audio,
+                                esp_peer_jitter_buffer_stats_t *video);
+
 /**
  * @brief  WebRTC set event handler
  *
@@ -227,6 +520,26 @@ int esp_webrtc_set_event_handler(esp_webrtc_handle_t rtc_handle, esp_webrtc_even
  */
 int esp_webrtc_enable_peer_connection(esp_webrtc_handle_t rtc_handle, bool enable);
 
+/**
+ * @brief  Set pre-warm for peer connection
+ *
+ * @note  When enabled and peer connection is disabled by `esp_webrtc_enable_peer_connection`,
+ *        peer connection is prepared ahead of time: DTLS certificate generated, RTP buffers allocated
+ *        and ICE candidates gathered (only for controlling role), local SDP is held until connection enabled
+ *        Candidates are gathered again every `refresh_interval` to keep server binding valid
+ *        Thus enable peer connection only need exchange SDP and finish DTLS handshake
+ *
+ * @param[in]  rtc_handle        WebRTC handle
+ * @param[in]  enable            Enable pre-warm or not
+ * @param[in]  refresh_interval  Interval to gather candidates again (unit ms), default: 60000ms if set to 0
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - Others                    Fail to create peer connection
+ */
+int esp_webrtc_set_prewarm(esp_webrtc_handle_t rtc_handle, bool enable, uint32_t refresh_interval);
+
 /**
  * @brief  Start WebRTC
  *
@@ -290,6 +603,8 @@ int esp_webrtc_stop(esp_webrtc_handle_t rtc_handle);
 /**
  * @brief  Close WebRTC
  *
+ * @note  When last instance closed, pooled threads kept for reuse are released by `media_lib_thread_pool_clear`
+ *
  * @param[in]  rtc_handle  WebRTC handle
  *
  * @return
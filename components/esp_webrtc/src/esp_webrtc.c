@@ -35,8 +35,20 @@
 #include "esp_codec_dev.h"
 #include "esp_webrtc_defaults.h"
 #include "esp_capture_sink.h"
+#include "esp_webrtc_fanout.h"
+#include "esp_webrtc_bwe.h"
+#include "esp_webrtc_reactor.h"
 
 #define AUDIO_FRAME_INTERVAL (20)
+#define AUDIO_MAX_PTIME      (60)
+#define PREWARM_DEFAULT_REFRESH (60000)
+#define RATE_REPORT_INTERVAL    (1000)
+#define RATE_MIN_FPS            (5)
+#define PACER_DEFAULT_FACTOR    (250)
+#define PACER_DEFAULT_MAX_DELAY (200)
+#define PACER_MAX_BURST_TIME    (40)
+#define KEY_FRAME_MIN_INTERVAL  (1000)
+#define PC_POLL_INTERVAL        (10)
 #define STR_SAME(a, b)       (strncmp(a, b, sizeof(b) - 1) == 0)
 #define GOTO_LABEL_ON_NULL(label, ptr, code) if (ptr == NULL) {   \
     ret = code;                                                   \
@@ -51,6 +63,7 @@
 #define PC_PAUSED_BIT    (1 << 1)
 #define PC_RESUME_BIT    (1 << 2)
 #define PC_SEND_QUIT_BIT (1 << 3)
+#define PC_WAKEUP_BIT    (1 << 4)
 
 #define SET_WAIT_BITS(bit) media_lib_event_group_set_bits(rtc->wait_event, bit)
 #define WAIT_FOR_BITS(bit)                                                          \
@@ -80,11 +93,61 @@ typedef struct {
     bool                          pending_connect;
     esp_peer_signaling_ice_info_t ice_info;
     bool                          ice_info_loaded;
+    esp_peer_ice_server_cfg_t    *signal_servers;
+    uint8_t                       signal_server_num;
     bool                          signaling_connected;
     bool                          no_auto_capture;
+    bool                          fanout;
+    webrtc_fanout_handle_t        fanout_handle;
+    esp_webrtc_video_layer_t      video_layers[WEBRTC_FANOUT_MAX_LAYER - 1];
+    uint8_t                       video_layer_num;
+    uint8_t                       video_layer;
+    bool                          prewarm;
+    uint32_t                      prewarm_refresh;
+    uint32_t                      prewarm_time;
+    esp_peer_msg_t                prewarm_msg;
+    uint32_t                      prewarm_msg_time;
+    uint32_t                      connect_start_time;
+    bool                          connect_prewarmed;
+    esp_webrtc_rate_control_cfg_t rate_cfg;
+    webrtc_bwe_handle_t           bwe;
+    esp_webrtc_rate_control_t     rate_ctrl;
+    uint32_t                      rate_report_time;
+    uint32_t                      rate_sent_size;
+    uint16_t                      rate_sent_num;
+    uint16_t                      rate_drop_num;
+    bool                          pacer_enable;
+    esp_webrtc_pacer_cfg_t        pacer_cfg;
+    int32_t                       pacer_budget;
+    uint32_t                      pacer_time;
+    esp_capture_stream_frame_t    pacer_video;
+    uint32_t                      pacer_video_time;
+    esp_webrtc_pacer_stats_t      pacer_stats;
+    uint32_t                      pacer_audio_num;
+    int32_t                       pacer_audio_base;
+    bool                          pacer_audio_base_valid;
+    uint32_t                      pacer_video_num;
+    esp_webrtc_key_frame_cfg_t    key_frame_cfg;
+    esp_webrtc_key_frame_stats_t  key_frame_stats;
+    uint32_t                      key_frame_time;
+    bool                          key_frame_pending;
+    media_lib_mutex_handle_t      key_frame_lock;
+    esp_peer_jitter_buffer_handle_t aud_jitter;
+    esp_peer_jitter_buffer_handle_t vid_jitter;
+    uint32_t                      pc_wakeup_num;
+    uint32_t                      pc_event_num;
+    bool                          shared_loop;
+    webrtc_reactor_client_handle_t reactor_client;
+    uint32_t                      send_time;
+    uint32_t                      gop_cache_size;
+    uint32_t                      first_video_time;
 
     uint8_t *aud_fifo;
     uint32_t aud_fifo_size;
+    uint32_t aud_fifo_fill;
+    uint32_t aud_fifo_pts;
+    uint8_t  aud_fifo_num;
+    uint8_t  aud_ptime;
     // For debug only
     uint32_t vid_send_pts;
     uint32_t aud_send_pts;
@@ -102,71 +165,405 @@ typedef struct {
 static const char *TAG = "webrtc";
 
 bool webrtc_tracing = false;
+static int webrtc_instance_num;
+
+static uint32_t get_cur_time(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void pc_wakeup(webrtc_t *rtc)
+{
+    // Control API need main loop to run at once, media send does not wake it to keep wakeup rate bounded
+    if (rtc->reactor_client) {
+        webrtc_reactor_wakeup(rtc->reactor_client);
+    } else if (rtc->wait_event) {
+        SET_WAIT_BITS(PC_WAKEUP_BIT);
+    }
+}
+
+static void pc_pause(webrtc_t *rtc)
+{
+    rtc->pause = true;
+    if (rtc->reactor_client) {
+        webrtc_reactor_pause(rtc->reactor_client, true);
+        return;
+    }
+    pc_wakeup(rtc);
+    WAIT_FOR_BITS(PC_PAUSED_BIT);
+}
+
+static void pc_resume(webrtc_t *rtc)
+{
+    rtc->pause = false;
+    if (rtc->reactor_client) {
+        webrtc_reactor_pause(rtc->reactor_client, false);
+        return;
+    }
+    SET_WAIT_BITS(PC_RESUME_BIT);
+}
+
+static void clear_prewarm_msg(webrtc_t *rtc)
+{
+    SAFE_FREE(rtc->prewarm_msg.data);
+    rtc->prewarm_msg.size = 0;
+}
+
+static bool key_frame_issue(webrtc_t *rtc, uint32_t now, esp_webrtc_key_frame_cfg_t *cfg, uint8_t *layer)
+{
+    // Called with key frame lock held, callback is invoked by caller after unlock
+    rtc->key_frame_pending = false;
+    rtc->key_frame_time = now;
+    if (rtc->fanout_handle &&
+        webrtc_fanout_key_frame_request(rtc->fanout_handle, rtc->video_layer, rtc->key_frame_cfg.min_interval, now) == false) {
+        // Shared encoder already asked by other viewer, that key frame serves this one too
+        rtc->key_frame_stats.suppressed++;
+        return false;
+    }
+    rtc->key_frame_stats.honored++;
+    *cfg = rtc->key_frame_cfg;
+    *layer = rtc->video_layer;
+    return true;
+}
+
+static void key_frame_request(webrtc_t *rtc)
+{
+    if (rtc->rtc_cfg.peer_cfg.video_info.codec == ESP_PEER_VIDEO_CODEC_NONE) {
+        return;
+    }
+    esp_webrtc_key_frame_cfg_t cfg;
+    uint8_t layer = 0;
+    bool issue = false;
+    bool pending = false;
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (rtc->key_frame_cfg.on_key_frame) {
+        rtc->key_frame_stats.received++;
+        uint32_t now = get_cur_time();
+        if (rtc->key_frame_time && now - rtc->key_frame_time < rtc->key_frame_cfg.min_interval) {
+            // Merge into one pending request, issued after interval elapsed
+            rtc->key_frame_stats.suppressed++;
+            rtc->key_frame_pending = true;
+            pending = true;
+        } else {
+            issue = key_frame_issue(rtc, now, &cfg, &layer);
+        }
+    }
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    if (issue) {
+        cfg.on_key_frame(layer, cfg.ctx);
+    } else if (pending) {
+        pc_wakeup(rtc);
+    }
+}
+
+static uint32_t key_frame_check_pending(webrtc_t *rtc)
+{
+    esp_webrtc_key_frame_cfg_t cfg;
+    uint8_t layer = 0;
+    bool issue = false;
+    uint32_t wait = UINT32_MAX;
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (rtc->key_frame_pending) {
+        uint32_t now = get_cur_time();
+        uint32_t elapse = now - rtc->key_frame_time;
+        if (elapse < rtc->key_frame_cfg.min_interval) {
+            wait = rtc->key_frame_cfg.min_interval - elapse;
+        } else {
+            // Pending request was counted as suppressed, now it is honored
+            rtc->key_frame_stats.suppressed--;
+            issue = key_frame_issue(rtc, now, &cfg, &layer);
+        }
+    }
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    if (issue) {
+        cfg.on_key_frame(layer, cfg.ctx);
+    }
+    return wait;
+}
+
+static void rate_control_suggest(webrtc_t *rtc, uint32_t bitrate, esp_webrtc_rate_control_t *ctrl)
+{
+    esp_peer_video_stream_info_t *info = &rtc->rtc_cfg.peer_cfg.video_info;
+    ctrl->target_bitrate = bitrate;
+    ctrl->fps = info->fps;
+    ctrl->width = info->width;
+    ctrl->height = info->height;
+    // Reduce frame rate firstly then resolution to keep bits for each frame
+    if (bitrate < rtc->rate_cfg.max_bitrate / 2 && ctrl->fps > RATE_MIN_FPS) {
+        ctrl->fps = MAX(ctrl->fps * 2 / 3, RATE_MIN_FPS);
+    }
+    if (bitrate < rtc->rate_cfg.max_bitrate / 4) {
+        ctrl->width = (ctrl->width / 2) & ~15;
+        ctrl->height = (ctrl->height / 2) & ~15;
+    }
+}
+
+static void rate_control_reset(webrtc_t *rtc)
+{
+    if (rtc->bwe == NULL) {
+        return;
+    }
+    webrtc_bwe_reset(rtc->bwe);
+    rtc->rate_report_time = get_cur_time();
+    rtc->rate_sent_size = 0;
+    rtc->rate_sent_num = 0;
+    rtc->rate_drop_num = 0;
+    memset(&rtc->rate_ctrl, 0, sizeof(esp_webrtc_rate_control_t));
+}
+
+static void rate_control_on_video(webrtc_t *rtc, esp_capture_stream_frame_t *video_frame, int send_ret)
+{
+    if (rtc->bwe == NULL) {
+        return;
+    }
+    uint32_t now = get_cur_time();
+    if (send_ret == ESP_PEER_ERR_NONE) {
+        rtc->rate_sent_num++;
+        rtc->rate_sent_size += video_frame->size;
+        // Delay grows when frames queued up before leaving, measure until pacer takes the frame
+        // Pacer hold time follows target bitrate, feeding it back would keep lowering the target
+        uint32_t enqueue_time = (video_frame == &rtc->pacer_video) ? rtc->pacer_video_time : now;
+        webrtc_bwe_on_delay(rtc->bwe, video_frame->pts, enqueue_time);
+    } else {
+        // Frame rejected by send pool is treated as lost
+        rtc->rate_drop_num++;
+    }
+    uint32_t elapse = now - rtc->rate_report_time;
+    if (elapse < RATE_REPORT_INTERVAL) {
+        return;
+    }
+    int total = rtc->rate_sent_num + rtc->rate_drop_num;
+    uint8_t fraction_lost = total ? (uint8_t)MIN(rtc->rate_drop_num * 256 / total, 255) : 0;
+    uint32_t sent_bitrate = (uint32_t)((uint64_t)rtc->rate_sent_size * 8 * 1000 / elapse);
+    webrtc_bwe_on_loss_report(rtc->bwe, fraction_lost, sent_bitrate, now);
+    rtc->rate_report_time = now;
+    rtc->rate_sent_size = 0;
+    rtc->rate_sent_num = 0;
+    rtc->rate_drop_num = 0;
+
+    esp_webrtc_rate_control_t ctrl;
+    rate_control_suggest(rtc, webrtc_bwe_get_target(rtc->bwe), &ctrl);
+    uint32_t last = rtc->rate_ctrl.target_bitrate;
+    uint32_t diff = ctrl.target_bitrate > last ? ctrl.target_bitrate - last : last - ctrl.target_bitrate;
+    // Only notify when target changed more than 10% or suggestion changed
+    if (diff * 10 < last && ctrl.fps == rtc->rate_ctrl.fps && ctrl.width == rtc->rate_ctrl.width) {
+        return;
+    }
+    ESP_LOGI(TAG, "Rate control target %d bps fps %d %dx%d loss %d/256 sent %d bps",
+             (int)ctrl.target_bitrate, ctrl.fps, ctrl.width, ctrl.height, fraction_lost, (int)sent_bitrate);
+    rtc->rate_ctrl = ctrl;
+    if (rtc->rate_cfg.on_rate_control) {
+        rtc->rate_cfg.on_rate_control(&ctrl, rtc->rate_cfg.ctx);
+    }
+}
+
+static bool audio_aggregate(webrtc_t *rtc, esp_capture_stream_frame_t *audio_frame, esp_peer_audio_frame_t *send_frame)
+{
+    // G711 is sample based, consecutive frames concatenate into one packet of ptime
+    uint32_t need = rtc->aud_fifo_fill + audio_frame->size;
+    if (need > rtc->aud_fifo_size) {
+        uint8_t *fifo = realloc(rtc->aud_fifo, need);
+        if (fifo == NULL) {
+            // Drop pending part, send current frame alone
+            rtc->aud_fifo_fill = 0;
+            rtc->aud_fifo_num = 0;
+            return true;
+        }
+        rtc->aud_fifo = fifo;
+        rtc->aud_fifo_size = need;
+    }
+    if (rtc->aud_fifo_num == 0) {
+        rtc->aud_fifo_pts = audio_frame->pts;
+    }
+    memcpy(rtc->aud_fifo + rtc->aud_fifo_fill, audio_frame->data, audio_frame->size);
+    rtc->aud_fifo_fill += audio_frame->size;
+    rtc->aud_fifo_num++;
+    if (rtc->aud_fifo_num * AUDIO_FRAME_INTERVAL < rtc->aud_ptime) {
+        return false;
+    }
+    send_frame->pts = rtc->aud_fifo_pts;
+    send_frame->data = rtc->aud_fifo;
+    send_frame->size = rtc->aud_fifo_fill;
+    rtc->aud_fifo_fill = 0;
+    rtc->aud_fifo_num = 0;
+    return true;
+}
+
+static void send_audio_frame(webrtc_t *rtc, esp_capture_stream_frame_t *audio_frame)
+{
+    esp_peer_audio_frame_t audio_send_frame = {
+        .pts = audio_frame->pts,
+        .data = audio_frame->data,
+        .size = audio_frame->size,
+    };
+    if (rtc->aud_ptime > AUDIO_FRAME_INTERVAL && audio_aggregate(rtc, audio_frame, &audio_send_frame) == false) {
+        return;
+    }
+    esp_peer_send_audio(rtc->pc, &audio_send_frame);
+    rtc->aud_send_pts = audio_frame->pts;
+    rtc->aud_send_num++;
+    rtc->aud_send_size += audio_send_frame.size;
+    if (webrtc_tracing) {
+        printf("A\n");
+    }
+}
+
+static void send_video_frame(webrtc_t *rtc, esp_capture_stream_frame_t *video_frame)
+{
+    int ret = ESP_PEER_ERR_NONE;
+    if (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel) {
+        esp_peer_data_frame_t data_frame = {
+            .type = ESP_PEER_DATA_CHANNEL_DATA,
+            .data = video_frame->data,
+            .size = video_frame->size,
+        };
+        ret = esp_peer_send_data(rtc->pc, &data_frame);
+    } else {
+        esp_peer_video_frame_t video_send_frame = {
+            .pts = video_frame->pts,
+            .data = video_frame->data,
+            .size = video_frame->size,
+        };
+        // Call the video send callback if provided (for SEI injection, etc.)
+        bool should_send = true;
+        if (rtc->rtc_cfg.peer_cfg.on_video_send) {
+            int ret = rtc->rtc_cfg.peer_cfg.on_video_send(&video_send_frame, rtc->rtc_cfg.peer_cfg.ctx);
+            if (ret != ESP_CAPTURE_ERR_OK) {
+                should_send = false;
+            }
+        }
+        if (should_send) {
+            ret = esp_peer_send_video(rtc->pc, &video_send_frame);
+        }
+    }
+    if (rtc->first_video_time && ret == ESP_PEER_ERR_NONE) {
+        ESP_LOGI(TAG, "First video frame sent %d ms after connected", (int)(get_cur_time() - rtc->first_video_time));
+        rtc->first_video_time = 0;
+    }
+    rate_control_on_video(rtc, video_frame, ret);
+    rtc->vid_send_pts = video_frame->pts;
+    rtc->vid_send_num++;
+    rtc->vid_send_size += video_frame->size;
+    if (webrtc_tracing) {
+        printf("V\n");
+    }
+}
+
+static void fanout_on_frame(esp_capture_stream_frame_t *frame, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    if (frame->stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO) {
+        if (rtc->rtc_cfg.peer_cfg.audio_info.codec) {
+            send_audio_frame(rtc, frame);
+        }
+    } else if (frame->stream_type == ESP_CAPTURE_STREAM_TYPE_VIDEO) {
+        if (rtc->rtc_cfg.peer_cfg.video_info.codec) {
+            send_video_frame(rtc, frame);
+        }
+    }
+}
+
+static void pacer_update_stats(uint32_t delay, uint32_t *num, uint32_t *avg_delay, uint32_t *max_delay)
+{
+    (*num)++;
+    // Running average since last query
+    *avg_delay = (*avg_delay * (*num - 1) + delay) / *num;
+    if (delay > *max_delay) {
+        *max_delay = delay;
+    }
+}
+
+static uint32_t pacer_audio_delay(webrtc_t *rtc, uint32_t pts, uint32_t now)
+{
+    // Capture clock and local clock differ by a constant, smallest offset seen is taken as no queue delay
+    int32_t offset = (int32_t)(now - pts);
+    if (rtc->pacer_audio_base_valid == false || offset < rtc->pacer_audio_base) {
+        rtc->pacer_audio_base = offset;
+        rtc->pacer_audio_base_valid = true;
+    }
+    return (uint32_t)(offset - rtc->pacer_audio_base);
+}
+
+static void pacer_refill(webrtc_t *rtc, uint32_t now)
+{
+    uint32_t target = rtc->bwe ? webrtc_bwe_get_target(rtc->bwe) : rtc->pacer_cfg.bitrate;
+    // Bytes allowed per millisecond
+    uint32_t rate = (uint32_t)((uint64_t)target * rtc->pacer_cfg.pacing_factor / 100 / 8000);
+    int64_t budget = rtc->pacer_budget + (int64_t)(now - rtc->pacer_time) * rate;
+    int32_t max_burst = (int32_t)(rate * PACER_MAX_BURST_TIME);
+    // Limit burst after idle, also limit debt since frames forced out after max delay still debit budget
+    if (budget > max_burst) {
+        budget = max_burst;
+    } else if (budget < -max_burst) {
+        budget = -max_burst;
+    }
+    rtc->pacer_budget = (int32_t)budget;
+    rtc->pacer_time = now;
+}
+
+static void pacer_release_video(webrtc_t *rtc)
+{
+    if (rtc->pacer_video.data) {
+        esp_capture_sink_release_frame(rtc->capture_path, &rtc->pacer_video);
+        rtc->pacer_video.data = NULL;
+    }
+}
 
 static void _media_send(void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
+    uint32_t now = get_cur_time();
+    if (rtc->pacer_enable) {
+        pacer_refill(rtc, now);
+    }
+    // Audio has highest priority, always sent ahead of video
     if (rtc->rtc_cfg.peer_cfg.audio_info.codec) {
         esp_capture_stream_frame_t audio_frame = {
             .stream_type = ESP_CAPTURE_STREAM_TYPE_AUDIO,
         };
         // Get and send all audio frame without wait
         while (esp_capture_sink_acquire_frame(rtc->capture_path, &audio_frame, true) == ESP_CAPTURE_ERR_OK) {
-            esp_peer_audio_frame_t audio_send_frame = {
-                .pts = audio_frame.pts,
-                .data = audio_frame.data,
-                .size = audio_frame.size,
-            };
-            esp_peer_send_audio(rtc->pc, &audio_send_frame);
+            send_audio_frame(rtc, &audio_frame);
             esp_capture_sink_release_frame(rtc->capture_path, &audio_frame);
-            rtc->aud_send_pts = audio_frame.pts;
-            rtc->aud_send_num++;
-            rtc->aud_send_size += audio_frame.size;
-            if (webrtc_tracing) {
-                printf("A\n");
+            if (rtc->pacer_enable) {
+                rtc->pacer_budget -= audio_frame.size;
+                pacer_update_stats(pacer_audio_delay(rtc, audio_frame.pts, now), &rtc->pacer_audio_num,
+                                   &rtc->pacer_stats.audio_avg_delay, &rtc->pacer_stats.audio_max_delay);
             }
         }
     }
-    if (rtc->rtc_cfg.peer_cfg.video_info.codec) {
+    if (rtc->rtc_cfg.peer_cfg.video_info.codec == ESP_PEER_VIDEO_CODEC_NONE) {
+        return;
+    }
+    if (rtc->pacer_enable == false) {
         esp_capture_stream_frame_t video_frame = {
             .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
         };
         int ret = esp_capture_sink_acquire_frame(rtc->capture_path, &video_frame, true);
         if (ret == ESP_CAPTURE_ERR_OK) {
-            if (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel) {
-                esp_peer_data_frame_t data_frame = {
-                    .type = ESP_PEER_DATA_CHANNEL_DATA,
-                    .data = video_frame.data,
-                    .size = video_frame.size,
-                };
-                esp_peer_send_data(rtc->pc, &data_frame);
-            } else {
-                esp_peer_video_frame_t video_send_frame = {
-                    .pts = video_frame.pts,
-                    .data = video_frame.data,
-                    .size = video_frame.size,
-                };
-                // Call the video send callback if provided (for SEI injection, etc.)
-                bool should_send = true;
-                if (rtc->rtc_cfg.peer_cfg.on_video_send) {
-                    ret = rtc->rtc_cfg.peer_cfg.on_video_send(&video_send_frame, rtc->rtc_cfg.peer_cfg.ctx);
-                    if (ret != ESP_CAPTURE_ERR_OK) {
-                        should_send = false;
-                    }
-                }
-                if (should_send) {
-                    esp_peer_send_video(rtc->pc, &video_send_frame);
-                }
-            }
+            send_video_frame(rtc, &video_frame);
             esp_capture_sink_release_frame(rtc->capture_path, &video_frame);
-            rtc->vid_send_pts = video_frame.pts;
-            rtc->vid_send_num++;
-            rtc->vid_send_size += video_frame.size;
-            if (webrtc_tracing) {
-                printf("V\n");
-            }
         }
+        return;
+    }
+    // Hold video frame until budget paid off so that big frames not burst into peer send queue
+    if (rtc->pacer_video.data == NULL) {
+        rtc->pacer_video.stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO;
+        if (esp_capture_sink_acquire_frame(rtc->capture_path, &rtc->pacer_video, true) != ESP_CAPTURE_ERR_OK) {
+            rtc->pacer_video.data = NULL;
+            return;
+        }
+        rtc->pacer_video_time = now;
+    }
+    uint32_t delay = now - rtc->pacer_video_time;
+    if (rtc->pacer_budget < 0 && delay < rtc->pacer_cfg.max_delay) {
+        return;
     }
+    send_video_frame(rtc, &rtc->pacer_video);
+    rtc->pacer_budget -= rtc->pacer_video.size;
+    pacer_update_stats(delay, &rtc->pacer_video_num,
+                       &rtc->pacer_stats.video_avg_delay, &rtc->pacer_stats.video_max_delay);
+    pacer_release_video(rtc);
 }
 
 void media_send_task(void *arg)
@@ -176,17 +573,35 @@ void media_send_task(void *arg)
         _media_send(arg);
         media_lib_thread_sleep(AUDIO_FRAME_INTERVAL);
     }
+    pacer_release_video(rtc);
     SET_WAIT_BITS(PC_SEND_QUIT_BIT);
-    media_lib_thread_destroy(NULL);
 }
 
 static int start_stream(webrtc_t *rtc)
 {
+    rate_control_reset(rtc);
+    rtc->pacer_budget = 0;
+    rtc->pacer_audio_base_valid = false;
+    rtc->pacer_time = get_cur_time();
+    rtc->first_video_time = rtc->pacer_time;
+    if (rtc->fanout_handle) {
+        int ret = webrtc_fanout_set_active(rtc->fanout_handle, rtc, true, !rtc->no_auto_capture);
+        // Shared encoder is running already, new viewer need key frame to start decoding unless GOP cached
+        if (webrtc_fanout_gop_ready(rtc->fanout_handle, rtc) == false) {
+            key_frame_request(rtc);
+        }
+        return ret;
+    }
     int ret = esp_capture_start(rtc->media_provider.capture);
-    if (ret == ESP_CAPTURE_ERR_OK) {
+    if (ret == ESP_CAPTURE_ERR_OK && rtc->reactor_client) {
+        // Sending is driven by shared reactor, no dedicated send thread
+        rtc->send_time = get_cur_time();
+        rtc->send_going = true;
+        pc_wakeup(rtc);
+    } else if (ret == ESP_CAPTURE_ERR_OK) {
         media_lib_thread_handle_t handle = NULL;
         rtc->send_going = true;
-        ret = media_lib_thread_create_from_scheduler(&handle, "pc_send", media_send_task, rtc);
+        ret = media_lib_thread_create_pooled(&handle, "pc_send", media_send_task, rtc);
         if (ret != 0) {
             rtc->send_going = false;
         }
@@ -198,9 +613,27 @@ static int start_stream(webrtc_t *rtc)
 
 static int stop_stream(webrtc_t *rtc)
 {
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    rtc->key_frame_pending = false;
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    rtc->aud_fifo_fill = 0;
+    rtc->aud_fifo_num = 0;
+    // Not render frames of last connection
+    esp_peer_jitter_buffer_reset(rtc->aud_jitter);
+    esp_peer_jitter_buffer_reset(rtc->vid_jitter);
+    if (rtc->fanout_handle) {
+        webrtc_fanout_set_active(rtc->fanout_handle, rtc, false, !rtc->no_auto_capture);
+        av_render_reset(rtc->play_handle);
+        return 0;
+    }
     if (rtc->send_going) {
         rtc->send_going = false;
-        WAIT_FOR_BITS(PC_SEND_QUIT_BIT);
+        if (rtc->reactor_client) {
+            webrtc_reactor_sync(rtc->reactor_client);
+            pacer_release_video(rtc);
+        } else {
+            WAIT_FOR_BITS(PC_SEND_QUIT_BIT);
+        }
     }
     if (rtc->no_auto_capture == false) {
         esp_capture_stop(rtc->media_provider.capture);
@@ -233,6 +666,11 @@ static int pc_on_state(esp_peer_state_t state, void *ctx)
     }
 
     if (state == ESP_PEER_STATE_CONNECTED) {
+        if (rtc->connect_start_time) {
+            ESP_LOGI(TAG, "Time to media %d ms pre-warmed:%d",
+                     (int)(get_cur_time() - rtc->connect_start_time), rtc->connect_prewarmed);
+            rtc->connect_start_time = 0;
+        }
         start_stream(rtc);
         pc_notify_app(rtc, ESP_WEBRTC_EVENT_CONNECTED);
     } else if (state == ESP_PEER_STATE_DISCONNECTED) {
@@ -253,11 +691,223 @@ static int pc_on_state(esp_peer_state_t state, void *ctx)
     return 0;
 }
 
+static uint8_t audio_ptime_align(webrtc_t *rtc, int ptime)
+{
+    // Only G711 is aggregated, its frames concatenate into one packet directly
+    // OPUS also allows 40/60ms, but it needs encoder frame size change or code 3 packet (RFC 6716) so is kept at 20ms
+    if (rtc->rtc_cfg.peer_cfg.audio_info.codec != ESP_PEER_AUDIO_CODEC_G711A &&
+        rtc->rtc_cfg.peer_cfg.audio_info.codec != ESP_PEER_AUDIO_CODEC_G711U) {
+        return AUDIO_FRAME_INTERVAL;
+    }
+    if (ptime > AUDIO_MAX_PTIME) {
+        ptime = AUDIO_MAX_PTIME;
+    }
+    ptime -= ptime % AUDIO_FRAME_INTERVAL;
+    return ptime < AUDIO_FRAME_INTERVAL ? AUDIO_FRAME_INTERVAL : (uint8_t)ptime;
+}
+
+static int sdp_next_line(const char *sdp, int size, int pos, int *len)
+{
+    int end = pos;
+    while (end < size && sdp[end] != '\n') {
+        end++;
+    }
+    *len = end - pos;
+    return end < size ? end + 1 : size;
+}
+
+static int sdp_get_audio_attr(const char *sdp, int size, const char *attr)
+{
+    int attr_len = strlen(attr);
+    bool in_audio = false;
+    int pos = 0, len;
+    while (pos < size) {
+        const char *line = sdp + pos;
+        pos = sdp_next_line(sdp, size, pos, &len);
+        if (len > 2 && line[0] == 'm' && line[1] == '=') {
+            in_audio = (len > 7 && memcmp(line, "m=audio", 7) == 0);
+        } else if (in_audio && len > attr_len && memcmp(line, attr, attr_len) == 0) {
+            return atoi(line + attr_len);
+        }
+    }
+    return 0;
+}
+
+static char *sdp_add_audio_ptime(const char *sdp, int size, uint8_t ptime, int *new_size)
+{
+    // Append attribute at end of audio media section
+    bool in_audio = false;
+    int insert = -1;
+    int pos = 0, len;
+    while (pos < size) {
+        const char *line = sdp + pos;
+        int next = sdp_next_line(sdp, size, pos, &len);
+        if (len > 2 && line[0] == 'm' && line[1] == '=') {
+            if (in_audio) {
+                insert = pos;
+                break;
+            }
+            in_audio = (len > 7 && memcmp(line, "m=audio", 7) == 0);
+        } else if (in_audio && len > 8 && memcmp(line, "a=ptime:", 8) == 0) {
+            return NULL;
+        }
+        pos = next;
+    }
+    if (in_audio && insert < 0) {
+        insert = size;
+    }
+    if (insert < 0) {
+        return NULL;
+    }
+    char attr[24];
+    // Audio section at end of SDP may miss final line break
+    bool need_crlf = (insert == size && size > 0 && sdp[size - 1] != '\n');
+    int attr_len = snprintf(attr, sizeof(attr), "%sa=ptime:%d\r\n", need_crlf ? "\r\n" : "", ptime);
+    char *out = (char *)malloc(size + attr_len + 1);
+    if (out == NULL) {
+        return NULL;
+    }
+    memcpy(out, sdp, insert);
+    memcpy(out + insert, attr, attr_len);
+    memcpy(out + insert + attr_len, sdp + insert, size - insert);
+    *new_size = size + attr_len;
+    out[*new_size] = 0;
+    return out;
+}
+
+static void audio_ptime_negotiate(webrtc_t *rtc, const char *sdp, int size)
+{
+    int ptime = audio_ptime_align(rtc, rtc->rtc_cfg.peer_cfg.audio_info.ptime);
+    // Not send packet longer than remote preferred or allowed
+    int remote = sdp_get_audio_attr(sdp, size, "a=maxptime:");
+    if (remote > 0 && remote < ptime) {
+        ptime = remote;
+    }
+    remote = sdp_get_audio_attr(sdp, size, "a=ptime:");
+    if (remote > 0 && remote < ptime) {
+        ptime = remote;
+    }
+    rtc->aud_ptime = audio_ptime_align(rtc, ptime);
+    if (rtc->aud_ptime != AUDIO_FRAME_INTERVAL) {
+        ESP_LOGI(TAG, "Audio ptime %dms", rtc->aud_ptime);
+    }
+}
+
 static int pc_on_msg(esp_peer_msg_t *info, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
-    ESP_LOGI(TAG, "Send client sdp: %s\n", info->data);
-    return esp_peer_signaling_send_msg(rtc->signaling, (esp_peer_signaling_msg_t *)info);
+    esp_peer_msg_t ptime_msg;
+    char *ptime_sdp = NULL;
+    if (info->type == ESP_PEER_MSG_TYPE_SDP && rtc->aud_ptime > AUDIO_FRAME_INTERVAL) {
+        ptime_msg = *info;
+        ptime_sdp = sdp_add_audio_ptime((char *)info->data, info->size, rtc->aud_ptime, &ptime_msg.size);
+        if (ptime_sdp) {
+            ptime_msg.data = (uint8_t *)ptime_sdp;
+            info = &ptime_msg;
+        }
+    }
+    int ret = 0;
+    if (rtc->prewarm && rtc->pending_connect) {
+        // Hold local SDP until connection enabled
+        clear_prewarm_msg(rtc);
+        // Trickled candidate can not be held, drop SDP so that connection is created again when enabled
+        if (info->type == ESP_PEER_MSG_TYPE_SDP) {
+            rtc->prewarm_msg.data = (uint8_t *)malloc(info->size + 1);
+            if (rtc->prewarm_msg.data) {
+                memcpy(rtc->prewarm_msg.data, info->data, info->size);
+                rtc->prewarm_msg.data[info->size] = 0;
+                rtc->prewarm_msg.type = info->type;
+                rtc->prewarm_msg.size = info->size;
+                rtc->prewarm_msg_time = get_cur_time();
+                ESP_LOGI(TAG, "Pre-warmed local sdp ready");
+            }
+        }
+    } else {
+        ESP_LOGI(TAG, "Send client sdp: %s\n", info->data);
+        ret = esp_peer_signaling_send_msg(rtc->signaling, (esp_peer_signaling_msg_t *)info);
+    }
+    SAFE_FREE(ptime_sdp);
+    return ret;
+}
+
+static int prewarm_peer(webrtc_t *rtc);
+
+static void jitter_on_audio(uint32_t pts, uint8_t *data, int size, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    av_render_audio_data_t audio_data = {
+        .pts = pts,
+        .data = data,
+        .size = size,
+    };
+    av_render_add_audio_data(rtc->play_handle, &audio_data);
+}
+
+static void jitter_on_video(uint32_t pts, uint8_t *data, int size, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    av_render_video_data_t video_data = {
+        .pts = pts,
+        .data = data,
+        .size = size,
+    };
+    av_render_add_video_data(rtc->play_handle, &video_data);
+}
+
+static uint32_t jitter_release(webrtc_t *rtc)
+{
+    if (rtc->aud_jitter == NULL) {
+        return UINT32_MAX;
+    }
+    uint32_t now = get_cur_time();
+    int aud_wait = esp_peer_jitter_buffer_poll(rtc->aud_jitter, now, jitter_on_audio, rtc);
+    int vid_wait = esp_peer_jitter_buffer_poll(rtc->vid_jitter, now, jitter_on_video, rtc);
+    return (uint32_t)MIN(aud_wait, vid_wait);
+}
+
+static void pc_wait_event(webrtc_t *rtc, uint32_t timeout)
+{
+    uint32_t bits = media_lib_event_group_wait_bits(rtc->wait_event, PC_WAKEUP_BIT, timeout);
+    media_lib_event_group_clr_bits(rtc->wait_event, PC_WAKEUP_BIT);
+    rtc->pc_wakeup_num++;
+    if (bits & PC_WAKEUP_BIT) {
+        rtc->pc_event_num++;
+    }
+}
+
+static uint32_t pc_run_once(webrtc_t *rtc)
+{
+    esp_peer_main_loop(rtc->pc);
+    // Sockets belong to peer core and are only polled inside main loop, keep same inbound poll period as before
+    uint32_t wait = PC_POLL_INTERVAL;
+    wait = MIN(wait, key_frame_check_pending(rtc));
+    wait = MIN(wait, jitter_release(rtc));
+    if (rtc->prewarm && rtc->pending_connect && rtc->prewarm_time) {
+        uint32_t elapse = get_cur_time() - rtc->prewarm_time;
+        if (elapse > rtc->prewarm_refresh) {
+            // Gather again before server binding or relay allocation expired
+            prewarm_peer(rtc);
+        } else {
+            wait = MIN(wait, rtc->prewarm_refresh - elapse + 1);
+        }
+    }
+    return wait;
+}
+
+static uint32_t pc_reactor_run(void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    uint32_t wait = pc_run_once(rtc);
+    if (rtc->send_going) {
+        uint32_t elapse = get_cur_time() - rtc->send_time;
+        if (elapse >= AUDIO_FRAME_INTERVAL) {
+            rtc->send_time += elapse;
+            _media_send(rtc);
+            elapse = 0;
+        }
+        wait = MIN(wait, AUDIO_FRAME_INTERVAL - elapse);
+    }
+    return wait;
 }
 
 static void pc_task(void *arg)
@@ -270,11 +920,12 @@ static void pc_task(void *arg)
             WAIT_FOR_BITS(PC_RESUME_BIT);
             continue;
         }
-        esp_peer_main_loop(rtc->pc);
-        media_lib_thread_sleep(10);
+        uint32_t wait = pc_run_once(rtc);
+        if (wait && rtc->running && rtc->pause == false) {
+            pc_wait_event(rtc, wait);
+        }
     }
     SET_WAIT_BITS(PC_EXIT_BIT);
-    media_lib_thread_destroy(NULL);
 }
 
 static av_render_video_codec_t get_video_dec_codec(esp_peer_video_codec_t codec)
@@ -353,6 +1004,10 @@ static int pc_on_audio_data(esp_peer_audio_frame_t *info, void *ctx)
     rtc->aud_recv_pts = info->pts;
     rtc->aud_recv_num++;
     rtc->aud_recv_size += info->size;
+    if (rtc->aud_jitter) {
+        esp_peer_jitter_buffer_put(rtc->aud_jitter, info->pts, info->data, info->size, get_cur_time());
+        return 0;
+    }
     av_render_audio_data_t audio_data = {
         .pts = info->pts,
         .data = info->data,
@@ -370,6 +1025,10 @@ static int pc_on_video_data(esp_peer_video_frame_t *info, void *ctx)
     }
     rtc->vid_recv_num++;
     rtc->vid_recv_size += info->size;
+    if (rtc->vid_jitter) {
+        esp_peer_jitter_buffer_put(rtc->vid_jitter, info->pts, info->data, info->size, get_cur_time());
+        return 0;
+    }
     av_render_video_data_t video_data = {
         .pts = info->pts,
         .data = info->data,
@@ -410,18 +1069,41 @@ static int pc_on_data(esp_peer_data_frame_t *frame, void *ctx)
     return 0;
 }
 
-static void free_server_cfg(webrtc_t *rtc)
+static void free_server_list(esp_peer_ice_server_cfg_t *server_cfg, int server_num)
 {
-    if (rtc->rtc_cfg.peer_cfg.server_lists == NULL) {
-        return;
-    }
-    esp_peer_ice_server_cfg_t *server_cfg = rtc->rtc_cfg.peer_cfg.server_lists;
-    for (int i = 0; i < rtc->rtc_cfg.peer_cfg.server_num; i++) {
+    for (int i = 0; i < server_num; i++) {
         SAFE_FREE(server_cfg[i].stun_url);
         SAFE_FREE(server_cfg[i].user);
         SAFE_FREE(server_cfg[i].psw);
     }
-    SAFE_FREE(rtc->rtc_cfg.peer_cfg.server_lists);
+    free(server_cfg);
+}
+
+static esp_peer_ice_server_cfg_t *dup_server_list(esp_peer_ice_server_cfg_t *cfg, int server_num)
+{
+    esp_peer_ice_server_cfg_t *dst = calloc(1, server_num * sizeof(esp_peer_ice_server_cfg_t));
+    if (dst == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < server_num; i++) {
+        if (cfg[i].stun_url == NULL ||
+            (dst[i].stun_url = strdup(cfg[i].stun_url)) == NULL ||
+            (cfg[i].user && (dst[i].user = strdup(cfg[i].user)) == NULL) ||
+            (cfg[i].psw && (dst[i].psw = strdup(cfg[i].psw)) == NULL)) {
+            free_server_list(dst, server_num);
+            return NULL;
+        }
+    }
+    return dst;
+}
+
+static void free_server_cfg(webrtc_t *rtc)
+{
+    if (rtc->rtc_cfg.peer_cfg.server_lists == NULL) {
+        return;
+    }
+    free_server_list(rtc->rtc_cfg.peer_cfg.server_lists, rtc->rtc_cfg.peer_cfg.server_num);
+    rtc->rtc_cfg.peer_cfg.server_lists = NULL;
     rtc->rtc_cfg.peer_cfg.server_num = 0;
 }
 
@@ -488,6 +1170,17 @@ static esp_capture_format_id_t get_capture_video_codec(esp_peer_audio_codec_t vi
 
 static int pc_close(webrtc_t *rtc)
 {
+    // Detach firstly so that no more frame sent to closing peer
+    if (rtc->fanout_handle) {
+        webrtc_fanout_detach(rtc->fanout_handle, rtc);
+        rtc->fanout_handle = NULL;
+    }
+    if (rtc->reactor_client) {
+        rtc->running = false;
+        webrtc_reactor_detach(rtc->reactor_client);
+        rtc->reactor_client = NULL;
+        rtc->pause = false;
+    }
     if (rtc->pc) {
         esp_peer_disconnect(rtc->pc);
         bool still_running = rtc->running;
@@ -498,11 +1191,14 @@ static int pc_close(webrtc_t *rtc)
         }
         rtc->running = false;
         if (still_running) {
+            pc_wakeup(rtc);
             WAIT_FOR_BITS(PC_EXIT_BIT);
         }
         esp_peer_close(rtc->pc);
         rtc->pc = NULL;
     }
+    clear_prewarm_msg(rtc);
+    rtc->prewarm_time = 0;
     if (rtc->wait_event) {
         media_lib_event_group_destroy(rtc->wait_event);
         rtc->wait_event = NULL;
@@ -510,6 +1206,13 @@ static int pc_close(webrtc_t *rtc)
     return ESP_PEER_ERR_NONE;
 }
 
+static int pc_on_key_frame_request(void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    key_frame_request(rtc);
+    return 0;
+}
+
 static int pc_on_channel_open(esp_peer_data_channel_info_t *ch, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
@@ -553,10 +1256,15 @@ static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int s
         .on_channel_open = pc_on_channel_open,
         .on_channel_close = pc_on_channel_close,
         .on_data = pc_on_data,
+        .on_key_frame_request = pc_on_key_frame_request,
         .role = rtc->ice_role,
         .ctx = rtc,
     };
     memcpy(&peer_cfg.audio_info, &rtc->rtc_cfg.peer_cfg.audio_info, sizeof(esp_peer_audio_stream_info_t));
+    rtc->aud_ptime = audio_ptime_align(rtc, rtc->rtc_cfg.peer_cfg.audio_info.ptime);
+    if (rtc->aud_ptime != rtc->rtc_cfg.peer_cfg.audio_info.ptime && rtc->rtc_cfg.peer_cfg.audio_info.ptime) {
+        ESP_LOGW(TAG, "Audio ptime %d not supported use %d", rtc->rtc_cfg.peer_cfg.audio_info.ptime, rtc->aud_ptime);
+    }
     if (rtc->rtc_cfg.peer_cfg.enable_data_channel == false || rtc->rtc_cfg.peer_cfg.video_over_data_channel == false) {
         memcpy(&peer_cfg.video_info, &rtc->rtc_cfg.peer_cfg.video_info, sizeof(esp_peer_video_stream_info_t));
     }
@@ -571,8 +1279,22 @@ static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int s
     }
     // Set running flag
     rtc->running = true;
-    media_lib_thread_handle_t thread;
-    media_lib_thread_create_from_scheduler(&thread, "pc_task", pc_task, rtc);
+    if (rtc->shared_loop) {
+        ret = webrtc_reactor_attach(pc_reactor_run, rtc, &rtc->reactor_client);
+        if (ret != ESP_PEER_ERR_NONE) {
+            ESP_LOGE(TAG, "Fail to attach reactor ret %d", ret);
+            rtc->running = false;
+            return ret;
+        }
+    } else {
+        media_lib_thread_handle_t thread;
+        ret = media_lib_thread_create_pooled(&thread, "pc_task", pc_task, rtc);
+        if (ret != 0) {
+            ESP_LOGE(TAG, "Fail to create peer task ret %d", ret);
+            rtc->running = false;
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
     esp_capture_sink_cfg_t sink_cfg = {
         .audio_info = {
             .format_id = get_capture_audio_codec(peer_cfg.audio_info.codec),
@@ -596,6 +1318,31 @@ static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int s
     if (peer_cfg.video_dir == ESP_PEER_MEDIA_DIR_RECV_ONLY) {
         sink_cfg.video_info.format_id = ESP_CAPTURE_FMT_ID_NONE;
     }
+    if (rtc->fanout) {
+        // Extra layers use same codec as base layer with smaller resolution
+        webrtc_fanout_layer_cfg_t layers[WEBRTC_FANOUT_MAX_LAYER - 1] = {};
+        for (int i = 0; i < rtc->video_layer_num; i++) {
+            layers[i].sink_idx = rtc->video_layers[i].sink_idx;
+            layers[i].sink_cfg.video_info = sink_cfg.video_info;
+            layers[i].sink_cfg.video_info.width = rtc->video_layers[i].width;
+            layers[i].sink_cfg.video_info.height = rtc->video_layers[i].height;
+            layers[i].sink_cfg.video_info.fps = rtc->video_layers[i].fps;
+        }
+        // Share one encoded sink output with other fan-out peers
+        ret = webrtc_fanout_attach(rtc->media_provider.capture, &sink_cfg, layers, rtc->video_layer_num,
+                                   fanout_on_frame, rtc, &rtc->fanout_handle);
+        if (ret != ESP_PEER_ERR_NONE) {
+            ESP_LOGE(TAG, "Fail to attach fan-out ret %d", ret);
+            return ret;
+        }
+        if (rtc->video_layer) {
+            webrtc_fanout_select_layer(rtc->fanout_handle, rtc, rtc->video_layer);
+        }
+        if (rtc->gop_cache_size) {
+            webrtc_fanout_set_gop_cache(rtc->fanout_handle, rtc->gop_cache_size);
+        }
+        return ret;
+    }
     esp_capture_sink_setup(rtc->media_provider.capture, 0, &sink_cfg, &rtc->capture_path);
     esp_capture_sink_enable(rtc->capture_path, ESP_CAPTURE_RUN_MODE_ALWAYS);
     return ret;
@@ -605,7 +1352,9 @@ static int start_peer_connection(webrtc_t *rtc, esp_peer_signaling_ice_info_t *i
 {
     rtc->ice_role = info->is_initiator ? ESP_PEER_ROLE_CONTROLLING : ESP_PEER_ROLE_CONTROLLED;
     int ret;
-    if (info->server_info.stun_url) {
+    if (info->server_lists && info->server_num) {
+        ret = pc_start(rtc, info->server_lists, info->server_num);
+    } else if (info->server_info.stun_url) {
         ret = pc_start(rtc, &info->server_info, 1);
     } else {
         ret = pc_start(rtc, rtc->rtc_cfg.peer_cfg.server_lists, rtc->rtc_cfg.peer_cfg.server_num);
@@ -613,16 +1362,87 @@ static int start_peer_connection(webrtc_t *rtc, esp_peer_signaling_ice_info_t *i
     return ret;
 }
 
+static int prewarm_peer(webrtc_t *rtc)
+{
+    if (rtc->prewarm == false || rtc->pending_connect == false || rtc->ice_info_loaded == false) {
+        return ESP_PEER_ERR_NONE;
+    }
+    int ret = ESP_PEER_ERR_NONE;
+    if (rtc->pc == NULL) {
+        // Open peer ahead of time so that RTP buffers allocated and ICE agent ready
+        ret = start_peer_connection(rtc, &rtc->ice_info);
+        if (ret != ESP_PEER_ERR_NONE) {
+            return ret;
+        }
+    }
+    rtc->prewarm_time = get_cur_time();
+    // Only offerer can gather before remote SDP received, local SDP is held in `pc_on_msg`
+    if (rtc->signaling_connected && rtc->ice_role == ESP_PEER_ROLE_CONTROLLING) {
+        ret = esp_peer_new_connection(rtc->pc);
+    }
+    return ret;
+}
+
+static bool send_prewarm_msg(webrtc_t *rtc)
+{
+    if (rtc->prewarm_msg.data == NULL) {
+        return false;
+    }
+    // Pause main loop so that held SDP not changed during sending
+    if (rtc->running && rtc->pause == false) {
+        pc_pause(rtc);
+    }
+    int ret = -1;
+    // SDP must be generated after latest gathering and not expired
+    if (rtc->prewarm_msg_time >= rtc->prewarm_time &&
+        get_cur_time() - rtc->prewarm_time <= rtc->prewarm_refresh) {
+        ESP_LOGI(TAG, "Send pre-warmed sdp: %s\n", rtc->prewarm_msg.data);
+        ret = esp_peer_signaling_send_msg(rtc->signaling, (esp_peer_signaling_msg_t *)&rtc->prewarm_msg);
+    }
+    clear_prewarm_msg(rtc);
+    return (ret == 0);
+}
+
 static int signal_ice_received(esp_peer_signaling_ice_info_t *info, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
+    esp_peer_ice_server_cfg_t *old_servers = NULL;
+    uint8_t old_server_num = 0;
     rtc->ice_info_loaded = true;
     rtc->ice_info = *info;
+    if (info->server_lists && info->server_num) {
+        // Server list is only valid during callback, keep a copy for later connection
+        esp_peer_ice_server_cfg_t *servers = dup_server_list(info->server_lists, info->server_num);
+        if (servers == NULL) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        old_servers = rtc->signal_servers;
+        old_server_num = rtc->signal_server_num;
+        rtc->signal_servers = servers;
+        rtc->signal_server_num = info->server_num;
+        rtc->ice_info.server_lists = servers;
+    }
+    int ret = ESP_PEER_ERR_NONE;
     if (rtc->pending_connect) {
-        ESP_LOGI(TAG, "Pending connection until user enable");
-        return ESP_PEER_ERR_NONE;
+        if (rtc->prewarm) {
+            // Pre-warmed peer use latest ICE servers and gather again
+            if (rtc->pc) {
+                ret = start_peer_connection(rtc, &rtc->ice_info);
+            }
+            if (ret == ESP_PEER_ERR_NONE) {
+                ret = prewarm_peer(rtc);
+            }
+        } else {
+            ESP_LOGI(TAG, "Pending connection until user enable");
+        }
+    } else {
+        ret = start_peer_connection(rtc, &rtc->ice_info);
+    }
+    // Release old list after peer updated to new one
+    if (old_servers) {
+        free_server_list(old_servers, old_server_num);
     }
-    return start_peer_connection(rtc, info);
+    return ret;
 }
 
 static int signal_connected(void *ctx)
@@ -630,12 +1450,16 @@ static int signal_connected(void *ctx)
     webrtc_t *rtc = (webrtc_t *)ctx;
     rtc->signaling_connected = true;
     if (rtc->rtc_cfg.peer_cfg.no_auto_reconnect && rtc->pending_connect) {
+        if (rtc->prewarm) {
+            return prewarm_peer(rtc);
+        }
         printf("Signaling connected, pending for use not enable\n");
         return 0;
     }
     if (rtc->pc) {
         // Create offer so that fetch ice candidate
         esp_peer_new_connection(rtc->pc);
+        pc_wakeup(rtc);
     }
     return 0;
 }
@@ -649,8 +1473,7 @@ static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
         if (rtc->running) {
             // Wait for main loop paused
             if (rtc->pause == false) {
-                rtc->pause = true;
-                WAIT_FOR_BITS(PC_PAUSED_BIT);
+                pc_pause(rtc);
             }
             esp_peer_disconnect(rtc->pc);
             rtc->recv_vid_info.codec = ESP_PEER_VIDEO_CODEC_NONE;
@@ -660,8 +1483,7 @@ static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
                 ret = esp_peer_new_connection(rtc->pc);
                 if (rtc->pause) {
                     // resume main loop
-                    rtc->pause = false;
-                    SET_WAIT_BITS(PC_RESUME_BIT);
+                    pc_resume(rtc);
                 }
             }
         }
@@ -686,8 +1508,12 @@ static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
         };
         if (STR_SAME(sdp, "candidate:")) {
             peer_msg.type = ESP_PEER_MSG_TYPE_CANDIDATE;
+        } else if (msg->type == ESP_PEER_SIGNALING_MSG_SDP) {
+            audio_ptime_negotiate(rtc, sdp, msg->size);
         }
-        return esp_peer_send_msg(rtc->pc, &peer_msg);
+        int ret = esp_peer_send_msg(rtc->pc, &peer_msg);
+        pc_wakeup(rtc);
+        return ret;
     }
 }
 
@@ -700,6 +1526,14 @@ static int signal_closed(void *ctx)
     return 0;
 }
 
+static int signal_error(int err, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    ESP_LOGE(TAG, "Signaling error %d", err);
+    pc_notify_app(rtc, ESP_WEBRTC_EVENT_SIGNALING_ERROR);
+    return 0;
+}
+
 int esp_webrtc_open(esp_webrtc_cfg_t *cfg, esp_webrtc_handle_t *handle)
 {
     if (cfg == NULL || cfg->signaling_impl == NULL || cfg->peer_impl == NULL) {
@@ -709,6 +1543,11 @@ int esp_webrtc_open(esp_webrtc_cfg_t *cfg, esp_webrtc_handle_t *handle)
     if (rtc == NULL) {
         return ESP_PEER_ERR_NO_MEM;
     }
+    media_lib_mutex_create(&rtc->key_frame_lock);
+    if (rtc->key_frame_lock == NULL) {
+        free(rtc);
+        return ESP_PEER_ERR_NO_MEM;
+    }
     // TODO deep copy of other settings
     rtc->rtc_cfg = *cfg;
     rtc->rtc_cfg.peer_cfg.server_num = 0;
@@ -728,6 +1567,7 @@ int esp_webrtc_open(esp_webrtc_cfg_t *cfg, esp_webrtc_handle_t *handle)
         }
         rtc->rtc_cfg.signaling_cfg.extra_cfg = signaling_cfg;
     }
+    __atomic_add_fetch(&webrtc_instance_num, 1, __ATOMIC_ACQ_REL);
     *handle = rtc;
     return ESP_PEER_ERR_NONE;
 }
@@ -741,6 +1581,8 @@ int esp_webrtc_enable_peer_connection(esp_webrtc_handle_t handle, bool enable)
     rtc->pending_connect = !enable;
     int ret = ESP_PEER_ERR_NONE;
     if (rtc->pending_connect == false) {
+        rtc->connect_start_time = get_cur_time();
+        rtc->connect_prewarmed = (rtc->pc != NULL);
         if (rtc->pc == NULL) {
             // Create peer connection firstly
             if (rtc->ice_info_loaded == false) {
@@ -756,11 +1598,13 @@ int esp_webrtc_enable_peer_connection(esp_webrtc_handle_t handle, bool enable)
         }
         // Signaling already connected
         if (rtc->signaling_connected) {
-            ret = esp_peer_new_connection(rtc->pc);
+            // Only need exchange SDP and do handshake if candidates already gathered
+            if (send_prewarm_msg(rtc) == false) {
+                ret = esp_peer_new_connection(rtc->pc);
+            }
             // Let mainloop resume
             if (rtc->pause) {
-                rtc->pause = false;
-                SET_WAIT_BITS(PC_RESUME_BIT);
+                pc_resume(rtc);
             }
         }
     } else {
@@ -768,10 +1612,279 @@ int esp_webrtc_enable_peer_connection(esp_webrtc_handle_t handle, bool enable)
         rtc->recv_vid_info.codec = ESP_PEER_VIDEO_CODEC_NONE;
         stop_stream(rtc);
         pc_close(rtc);
+        // Warm up again for next call
+        prewarm_peer(rtc);
+    }
+    return ret;
+}
+
+int esp_webrtc_set_prewarm(esp_webrtc_handle_t handle, bool enable, uint32_t refresh_interval)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    static bool cert_generated = false;
+    rtc->prewarm_refresh = refresh_interval ? refresh_interval : PREWARM_DEFAULT_REFRESH;
+    if (enable == rtc->prewarm) {
+        return ESP_PEER_ERR_NONE;
+    }
+    rtc->prewarm = enable;
+    if (enable) {
+        // DTLS key and certificate generation is the most time costly part, do it only once
+        if (cert_generated == false) {
+            cert_generated = (esp_peer_pre_generate_cert() == ESP_PEER_ERR_NONE);
+        }
+        return prewarm_peer(rtc);
+    }
+    if (rtc->pending_connect && rtc->pc) {
+        // Release pre-warmed peer
+        pc_close(rtc);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_fanout(esp_webrtc_handle_t handle, bool enable)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->pc) {
+        ESP_LOGE(TAG, "Fan-out must be set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    rtc->fanout = enable;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_shared_loop(esp_webrtc_handle_t handle, bool enable)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->pc) {
+        ESP_LOGE(TAG, "Shared loop must be set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    rtc->shared_loop = enable;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_gop_cache(esp_webrtc_handle_t handle, uint32_t cache_size)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->pc) {
+        ESP_LOGE(TAG, "GOP cache must be set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    rtc->gop_cache_size = cache_size;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_video_layers(esp_webrtc_handle_t handle, esp_webrtc_video_layer_t *layers, uint8_t layer_num)
+{
+    if (handle == NULL || (layer_num && layers == NULL) || layer_num >= WEBRTC_FANOUT_MAX_LAYER) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->fanout == false || rtc->pc) {
+        ESP_LOGE(TAG, "Video layers need fan-out mode and set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    for (int i = 0; i < layer_num; i++) {
+        if (layers[i].sink_idx == 0 || layers[i].width == 0 || layers[i].height == 0) {
+            return ESP_PEER_ERR_INVALID_ARG;
+        }
+        rtc->video_layers[i] = layers[i];
+    }
+    rtc->video_layer_num = layer_num;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_select_video_layer(esp_webrtc_handle_t handle, uint8_t layer)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (layer > rtc->video_layer_num) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    bool changed = (rtc->video_layer != layer);
+    rtc->video_layer = layer;
+    if (rtc->fanout_handle) {
+        int ret = webrtc_fanout_select_layer(rtc->fanout_handle, rtc, layer);
+        if (ret == ESP_PEER_ERR_NONE && changed && webrtc_fanout_gop_ready(rtc->fanout_handle, rtc) == false) {
+            // Switch only happen on key frame of new layer
+            key_frame_request(rtc);
+        }
+        return ret;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_rate_control(esp_webrtc_handle_t handle, esp_webrtc_rate_control_cfg_t *cfg)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->pc) {
+        // Avoid race with send thread
+        ESP_LOGE(TAG, "Rate control must be set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    if (rtc->bwe) {
+        webrtc_bwe_close(rtc->bwe);
+        rtc->bwe = NULL;
+    }
+    if (cfg == NULL) {
+        memset(&rtc->rate_cfg, 0, sizeof(esp_webrtc_rate_control_cfg_t));
+        return ESP_PEER_ERR_NONE;
+    }
+    webrtc_bwe_cfg_t bwe_cfg = {
+        .min_bitrate = cfg->min_bitrate,
+        .max_bitrate = cfg->max_bitrate,
+        .start_bitrate = cfg->start_bitrate,
+    };
+    int ret = webrtc_bwe_open(&bwe_cfg, &rtc->bwe);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return ret;
+    }
+    rtc->rate_cfg = *cfg;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_key_frame_handler(esp_webrtc_handle_t handle, esp_webrtc_key_frame_cfg_t *cfg)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (cfg && cfg->on_key_frame == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (cfg == NULL) {
+        memset(&rtc->key_frame_cfg, 0, sizeof(esp_webrtc_key_frame_cfg_t));
+        rtc->key_frame_pending = false;
+    } else {
+        rtc->key_frame_cfg = *cfg;
+        if (rtc->key_frame_cfg.min_interval == 0) {
+            rtc->key_frame_cfg.min_interval = KEY_FRAME_MIN_INTERVAL;
+        }
+    }
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_get_key_frame_stats(esp_webrtc_handle_t handle, esp_webrtc_key_frame_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    *stats = rtc->key_frame_stats;
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+static void jitter_destroy(webrtc_t *rtc)
+{
+    esp_peer_jitter_buffer_destroy(rtc->aud_jitter);
+    rtc->aud_jitter = NULL;
+    esp_peer_jitter_buffer_destroy(rtc->vid_jitter);
+    rtc->vid_jitter = NULL;
+}
+
+int esp_webrtc_set_jitter_buffer(esp_webrtc_handle_t handle, esp_peer_jitter_buffer_cfg_t *cfg)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->pc) {
+        ESP_LOGE(TAG, "Jitter buffer must be set before peer connection created");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    jitter_destroy(rtc);
+    if (cfg == NULL) {
+        return ESP_PEER_ERR_NONE;
+    }
+    int ret = esp_peer_jitter_buffer_create(cfg, &rtc->aud_jitter);
+    if (ret == ESP_PEER_ERR_NONE) {
+        ret = esp_peer_jitter_buffer_create(cfg, &rtc->vid_jitter);
+    }
+    if (ret != ESP_PEER_ERR_NONE) {
+        jitter_destroy(rtc);
     }
     return ret;
 }
 
+int esp_webrtc_get_jitter_stats(esp_webrtc_handle_t handle, esp_peer_jitter_buffer_stats_t *audio,
+                                esp_peer_jitter_buffer_stats_t *video)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->aud_jitter == NULL) {
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    if (audio) {
+        esp_peer_jitter_buffer_get_stats(rtc->aud_jitter, audio);
+    }
+    if (video) {
+        esp_peer_jitter_buffer_get_stats(rtc->vid_jitter, video);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_pacer(esp_webrtc_handle_t handle, esp_webrtc_pacer_cfg_t *cfg)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->send_going) {
+        ESP_LOGE(TAG, "Pacer must be set before media sending");
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    if (cfg == NULL) {
+        rtc->pacer_enable = false;
+        return ESP_PEER_ERR_NONE;
+    }
+    if (cfg->bitrate == 0 && rtc->bwe == NULL) {
+        ESP_LOGE(TAG, "Pacer need bitrate or rate control");
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtc->pacer_cfg = *cfg;
+    if (rtc->pacer_cfg.pacing_factor == 0) {
+        rtc->pacer_cfg.pacing_factor = PACER_DEFAULT_FACTOR;
+    }
+    if (rtc->pacer_cfg.max_delay == 0) {
+        rtc->pacer_cfg.max_delay = PACER_DEFAULT_MAX_DELAY;
+    }
+    rtc->pacer_enable = true;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_get_pacer_stats(esp_webrtc_handle_t handle, esp_webrtc_pacer_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    *stats = rtc->pacer_stats;
+    return ESP_PEER_ERR_NONE;
+}
+
 int esp_webrtc_set_event_handler(esp_webrtc_handle_t handle, esp_webrtc_event_handler_t handler, void *ctx)
 {
     if (handle == NULL || handler == NULL) {
@@ -825,7 +1938,8 @@ int esp_webrtc_start(esp_webrtc_handle_t handle)
         .on_connected = signal_connected,
         .on_msg = signal_new_msg,
         .on_close = signal_closed,
-        .ctx = rtc
+        .ctx = rtc,
+        .on_error = signal_error,
     };
     int ret = esp_peer_signaling_start(&sig_cfg, rtc->rtc_cfg.signaling_impl, &rtc->signaling);
     if (ret != ESP_PEER_ERR_NONE) {
@@ -855,7 +1969,9 @@ int esp_webrtc_send_custom_data(esp_webrtc_handle_t handle, esp_webrtc_custom_da
             .data = data,
             .size = size,
         };
-        return esp_peer_send_data(rtc->pc, &data_frame);
+        int ret = esp_peer_send_data(rtc->pc, &data_frame);
+        pc_wakeup(rtc);
+        return ret;
     }
     return ESP_PEER_ERR_INVALID_ARG;
 }
@@ -903,6 +2019,40 @@ int esp_webrtc_query(esp_webrtc_handle_t handle)
                 (int)rtc->aud_recv_pts, (int)rtc->aud_recv_num, (int)rtc->aud_recv_size,
                 (int)rtc->vid_recv_num, (int)rtc->vid_recv_size);
     }
+    if (rtc->reactor_client) {
+        uint32_t wakeup_num, run_num;
+        webrtc_reactor_get_stats(&wakeup_num, &run_num);
+        ESP_LOGI(TAG, "Shared loop wakeup %d client run %d", (int)wakeup_num, (int)run_num);
+    } else {
+        ESP_LOGI(TAG, "Main loop wakeup %d by event %d", (int)rtc->pc_wakeup_num, (int)rtc->pc_event_num);
+    }
+    if (rtc->gop_cache_size && rtc->fanout_handle) {
+        ESP_LOGI(TAG, "GOP cache flushed to new viewers %d", (int)webrtc_fanout_get_gop_flushed(rtc->fanout_handle));
+    }
+    media_lib_mutex_lock(rtc->key_frame_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (rtc->key_frame_cfg.on_key_frame) {
+        ESP_LOGI(TAG, "Key frame request received %d honored %d suppressed %d",
+                 (int)rtc->key_frame_stats.received, (int)rtc->key_frame_stats.honored,
+                 (int)rtc->key_frame_stats.suppressed);
+    }
+    media_lib_mutex_unlock(rtc->key_frame_lock);
+    if (rtc->pacer_enable) {
+        ESP_LOGI(TAG, "Pacer delay A:%d/%dms V:%d/%dms budget %d",
+                 (int)rtc->pacer_stats.audio_avg_delay, (int)rtc->pacer_stats.audio_max_delay,
+                 (int)rtc->pacer_stats.video_avg_delay, (int)rtc->pacer_stats.video_max_delay,
+                 (int)rtc->pacer_budget);
+        memset(&rtc->pacer_stats, 0, sizeof(esp_webrtc_pacer_stats_t));
+        rtc->pacer_audio_num = 0;
+        rtc->pacer_video_num = 0;
+    }
+    if (rtc->aud_jitter) {
+        esp_peer_jitter_buffer_stats_t aud, vid;
+        esp_peer_jitter_buffer_get_stats(rtc->aud_jitter, &aud);
+        esp_peer_jitter_buffer_get_stats(rtc->vid_jitter, &vid);
+        ESP_LOGI(TAG, "Jitter A:%d/%dms late %d drop %d V:%d/%dms frames %d late %d drop %d",
+                 aud.jitter, aud.target_delay, (int)aud.late, (int)aud.dropped,
+                 vid.jitter, vid.target_delay, (int)vid.assembled, (int)vid.late, (int)vid.dropped);
+    }
     esp_peer_query(rtc->pc);
     printf("\n");
     // Clear send and receive info
@@ -914,6 +2064,8 @@ int esp_webrtc_query(esp_webrtc_handle_t handle)
     rtc->aud_recv_size = 0;
     rtc->vid_recv_num = 0;
     rtc->vid_recv_size = 0;
+    rtc->pc_wakeup_num = 0;
+    rtc->pc_event_num = 0;
     return ESP_PEER_ERR_NONE;
 }
 
@@ -942,9 +2094,22 @@ int esp_webrtc_close(esp_webrtc_handle_t handle)
     webrtc_t *rtc = (webrtc_t *)handle;
     esp_webrtc_stop(handle);
     free_server_cfg(rtc);
+    if (rtc->signal_servers) {
+        free_server_list(rtc->signal_servers, rtc->signal_server_num);
+        rtc->signal_servers = NULL;
+    }
     SAFE_FREE(rtc->rtc_cfg.peer_cfg.extra_cfg);
     SAFE_FREE(rtc->rtc_cfg.signaling_cfg.extra_cfg);
     SAFE_FREE(rtc->aud_fifo);
+    if (rtc->bwe) {
+        webrtc_bwe_close(rtc->bwe);
+    }
+    jitter_destroy(rtc);
+    media_lib_mutex_destroy(rtc->key_frame_lock);
     free(rtc);
+    if (__atomic_sub_fetch(&webrtc_instance_num, 1, __ATOMIC_ACQ_REL) == 0) {
+        // Release pooled main loop and send threads kept for reuse once no instance left
+        media_lib_thread_pool_clear();
+    }
     return ESP_PEER_ERR_NONE;
 }
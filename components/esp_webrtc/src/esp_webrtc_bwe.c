@@ -0,0 +1,291 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "esp_peer_types.h"
+#include "esp_webrtc_bwe.h"
+
+#define TREND_WINDOW_SIZE    (20)
+#define TREND_MAX_DELTAS     (60)
+#define TREND_GAIN           (4.0f)
+#define TREND_SMOOTH_ALPHA   (0.9f)
+#define THRESHOLD_INIT       (12.5f)
+#define THRESHOLD_MIN        (6.0f)
+#define THRESHOLD_MAX        (600.0f)
+#define THRESHOLD_K_UP       (0.0087f)
+#define THRESHOLD_K_DOWN     (0.039f)
+#define OVERUSE_COUNT        (2)
+#define DECREASE_INTERVAL    (300)
+#define DELAY_DECREASE_RATIO (0.85f)
+#define DELAY_INCREASE_RATIO (0.08f)
+#define LOSS_HIGH            (0.1f)
+#define LOSS_LOW             (0.02f)
+#define LOSS_INCREASE_RATIO  (1.05f)
+#define SENT_RATE_HEADROOM   (1.5f)
+
+typedef enum {
+    BWE_USAGE_NORMAL,
+    BWE_USAGE_OVER,
+    BWE_USAGE_UNDER,
+} bwe_usage_t;
+
+struct webrtc_bwe_t {
+    webrtc_bwe_cfg_t cfg;
+    // Delay gradient trend line
+    bool             has_prev;
+    uint32_t         prev_send;
+    uint32_t         prev_arrival;
+    uint32_t         first_arrival;
+    float            acc_delay;
+    float            smoothed_delay;
+    float            trend_x[TREND_WINDOW_SIZE];
+    float            trend_y[TREND_WINDOW_SIZE];
+    uint8_t          trend_num;
+    uint8_t          trend_pos;
+    uint16_t         num_deltas;
+    float            threshold;
+    uint32_t         last_threshold_update;
+    uint8_t          overuse_count;
+    bwe_usage_t      usage;
+    // Rate control
+    uint32_t         sent_bitrate;
+    float            delay_rate;
+    float            loss_rate;
+    uint32_t         last_increase;
+    uint32_t         last_decrease;
+};
+
+static float clamp_rate(struct webrtc_bwe_t *bwe, float rate)
+{
+    if (rate < bwe->cfg.min_bitrate) {
+        return bwe->cfg.min_bitrate;
+    }
+    if (rate > bwe->cfg.max_bitrate) {
+        return bwe->cfg.max_bitrate;
+    }
+    return rate;
+}
+
+static float limit_by_sent_rate(struct webrtc_bwe_t *bwe, float rate)
+{
+    // Not probe far above what really sent, otherwise target grows without any verify
+    if (bwe->sent_bitrate) {
+        float limit = bwe->sent_bitrate * SENT_RATE_HEADROOM + 10000;
+        if (rate > limit) {
+            rate = limit;
+        }
+    }
+    return rate;
+}
+
+static float trend_slope(struct webrtc_bwe_t *bwe)
+{
+    float sum_x = 0, sum_y = 0;
+    for (int i = 0; i < bwe->trend_num; i++) {
+        sum_x += bwe->trend_x[i];
+        sum_y += bwe->trend_y[i];
+    }
+    float avg_x = sum_x / bwe->trend_num;
+    float avg_y = sum_y / bwe->trend_num;
+    float num = 0, den = 0;
+    for (int i = 0; i < bwe->trend_num; i++) {
+        float dx = bwe->trend_x[i] - avg_x;
+        num += dx * (bwe->trend_y[i] - avg_y);
+        den += dx * dx;
+    }
+    return den == 0 ? 0 : num / den;
+}
+
+static void update_threshold(struct webrtc_bwe_t *bwe, float modified_trend, uint32_t now)
+{
+    if (bwe->last_threshold_update == 0) {
+        bwe->last_threshold_update = now;
+    }
+    float abs_trend = modified_trend < 0 ? -modified_trend : modified_trend;
+    // Ignore sudden spike so that threshold not raised by single burst
+    if (abs_trend > bwe->threshold + 15.0f) {
+        bwe->last_threshold_update = now;
+        return;
+    }
+    float k = abs_trend < bwe->threshold ? THRESHOLD_K_DOWN : THRESHOLD_K_UP;
+    uint32_t dt = now - bwe->last_threshold_update;
+    if (dt > 100) {
+        dt = 100;
+    }
+    bwe->threshold += k * (abs_trend - bwe->threshold) * dt;
+    if (bwe->threshold < THRESHOLD_MIN) {
+        bwe->threshold = THRESHOLD_MIN;
+    } else if (bwe->threshold > THRESHOLD_MAX) {
+        bwe->threshold = THRESHOLD_MAX;
+    }
+    bwe->last_threshold_update = now;
+}
+
+static void detect_usage(struct webrtc_bwe_t *bwe, uint32_t now)
+{
+    if (bwe->trend_num < TREND_WINDOW_SIZE) {
+        return;
+    }
+    float deltas = bwe->num_deltas < TREND_MAX_DELTAS ? bwe->num_deltas : TREND_MAX_DELTAS;
+    float modified_trend = deltas * trend_slope(bwe) * TREND_GAIN;
+    if (modified_trend > bwe->threshold) {
+        // Require continuous overuse to avoid reacting on jitter
+        if (++bwe->overuse_count >= OVERUSE_COUNT) {
+            bwe->usage = BWE_USAGE_OVER;
+        }
+    } else {
+        bwe->overuse_count = 0;
+        bwe->usage = modified_trend < -bwe->threshold ? BWE_USAGE_UNDER : BWE_USAGE_NORMAL;
+    }
+    update_threshold(bwe, modified_trend, now);
+}
+
+static void update_delay_rate(struct webrtc_bwe_t *bwe, uint32_t now)
+{
+    if (bwe->usage == BWE_USAGE_OVER) {
+        if (now - bwe->last_decrease >= DECREASE_INTERVAL) {
+            float base = bwe->sent_bitrate ? bwe->sent_bitrate : bwe->delay_rate;
+            float rate = base * DELAY_DECREASE_RATIO;
+            if (rate < bwe->delay_rate) {
+                bwe->delay_rate = rate;
+            }
+            bwe->last_decrease = now;
+        }
+        bwe->last_increase = now;
+    } else if (bwe->usage == BWE_USAGE_NORMAL) {
+        uint32_t dt = now - bwe->last_increase;
+        if (dt > 1000) {
+            dt = 1000;
+        }
+        float rate = bwe->delay_rate * (1.0f + DELAY_INCREASE_RATIO * dt / 1000.0f);
+        bwe->delay_rate = limit_by_sent_rate(bwe, rate);
+        if (bwe->delay_rate < bwe->cfg.min_bitrate) {
+            bwe->delay_rate = bwe->cfg.min_bitrate;
+        }
+        bwe->last_increase = now;
+    } else {
+        // Under use means queue draining, hold rate until it become normal
+        bwe->last_increase = now;
+    }
+    bwe->delay_rate = clamp_rate(bwe, bwe->delay_rate);
+}
+
+int webrtc_bwe_open(webrtc_bwe_cfg_t *cfg, webrtc_bwe_handle_t *h)
+{
+    if (cfg == NULL || h == NULL || cfg->max_bitrate == 0 || cfg->min_bitrate > cfg->max_bitrate) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    struct webrtc_bwe_t *bwe = calloc(1, sizeof(struct webrtc_bwe_t));
+    if (bwe == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    bwe->cfg = *cfg;
+    if (bwe->cfg.start_bitrate == 0) {
+        bwe->cfg.start_bitrate = bwe->cfg.max_bitrate;
+    }
+    webrtc_bwe_reset(bwe);
+    *h = bwe;
+    return ESP_PEER_ERR_NONE;
+}
+
+void webrtc_bwe_on_delay(webrtc_bwe_handle_t bwe, uint32_t send_time, uint32_t arrival_time)
+{
+    if (bwe == NULL) {
+        return;
+    }
+    if (bwe->has_prev == false) {
+        bwe->has_prev = true;
+        bwe->first_arrival = arrival_time;
+        bwe->last_increase = arrival_time;
+        bwe->last_decrease = arrival_time;
+    } else {
+        // Delay variation between two groups
+        int32_t delta = (int32_t)(arrival_time - bwe->prev_arrival) - (int32_t)(send_time - bwe->prev_send);
+        bwe->acc_delay += delta;
+        bwe->smoothed_delay = TREND_SMOOTH_ALPHA * bwe->smoothed_delay + (1 - TREND_SMOOTH_ALPHA) * bwe->acc_delay;
+        bwe->trend_x[bwe->trend_pos] = (float)(arrival_time - bwe->first_arrival);
+        bwe->trend_y[bwe->trend_pos] = bwe->smoothed_delay;
+        bwe->trend_pos = (bwe->trend_pos + 1) % TREND_WINDOW_SIZE;
+        if (bwe->trend_num < TREND_WINDOW_SIZE) {
+            bwe->trend_num++;
+        }
+        if (bwe->num_deltas < TREND_MAX_DELTAS) {
+            bwe->num_deltas++;
+        }
+        detect_usage(bwe, arrival_time);
+        update_delay_rate(bwe, arrival_time);
+    }
+    bwe->prev_send = send_time;
+    bwe->prev_arrival = arrival_time;
+}
+
+void webrtc_bwe_on_loss_report(webrtc_bwe_handle_t bwe, uint8_t fraction_lost, uint32_t sent_bitrate, uint32_t now)
+{
+    if (bwe == NULL) {
+        return;
+    }
+    bwe->sent_bitrate = sent_bitrate;
+    float loss = fraction_lost / 256.0f;
+    if (loss > LOSS_HIGH) {
+        bwe->loss_rate = bwe->loss_rate * (1.0f - 0.5f * loss);
+    } else if (loss < LOSS_LOW) {
+        bwe->loss_rate = limit_by_sent_rate(bwe, bwe->loss_rate * LOSS_INCREASE_RATIO);
+        if (bwe->loss_rate < bwe->cfg.min_bitrate) {
+            bwe->loss_rate = bwe->cfg.min_bitrate;
+        }
+    }
+    bwe->loss_rate = clamp_rate(bwe, bwe->loss_rate);
+}
+
+uint32_t webrtc_bwe_get_target(webrtc_bwe_handle_t bwe)
+{
+    if (bwe == NULL) {
+        return 0;
+    }
+    float rate = bwe->loss_rate < bwe->delay_rate ? bwe->loss_rate : bwe->delay_rate;
+    return (uint32_t)rate;
+}
+
+void webrtc_bwe_reset(webrtc_bwe_handle_t bwe)
+{
+    if (bwe == NULL) {
+        return;
+    }
+    webrtc_bwe_cfg_t cfg = bwe->cfg;
+    memset(bwe, 0, sizeof(struct webrtc_bwe_t));
+    bwe->cfg = cfg;
+    bwe->threshold = THRESHOLD_INIT;
+    bwe->delay_rate = clamp_rate(bwe, cfg.start_bitrate);
+    bwe->loss_rate = bwe->delay_rate;
+}
+
+void webrtc_bwe_close(webrtc_bwe_handle_t bwe)
+{
+    if (bwe) {
+        free(bwe);
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Bandwidth estimator handle
+ */
+typedef struct webrtc_bwe_t *webrtc_bwe_handle_t;
+
+/**
+ * @brief  Bandwidth estimator configuration
+ */
+typedef struct {
+    uint32_t  min_bitrate;    /*!< Minimum target bitrate (unit bps) */
+    uint32_t  max_bitrate;    /*!< Maximum target bitrate (unit bps) */
+    uint32_t  start_bitrate;  /*!< Initial target bitrate (unit bps), use `max_bitrate` if set to 0 */
+} webrtc_bwe_cfg_t;
+
+/**
+ * @brief  Open bandwidth estimator
+ *
+ * @note  Estimator combines loss based control (from loss report) and delay based control
+ *        (trend of one-way delay variation), final target is the smaller one
+ *        Result only as good as inputs, when fed with local send pool rejects and local queue delay
+ *        it tracks sender backlog rather than network capacity
+ *
+ * @param[in]   cfg  Estimator configuration
+ * @param[out]  bwe  Estimator handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int webrtc_bwe_open(webrtc_bwe_cfg_t *cfg, webrtc_bwe_handle_t *bwe);
+
+/**
+ * @brief  Feed delay sample of one packet group (one frame)
+ *
+ * @param[in]  bwe           Estimator handle
+ * @param[in]  send_time     Send time of group (unit ms)
+ * @param[in]  arrival_time  Arrival time of group (unit ms)
+ */
+void webrtc_bwe_on_delay(webrtc_bwe_handle_t bwe, uint32_t send_time, uint32_t arrival_time);
+
+/**
+ * @brief  Feed loss report
+ *
+ * @note  Report is expected about every second, same meaning as RTCP receiver report
+ *
+ * @param[in]  bwe            Estimator handle
+ * @param[in]  fraction_lost  Lost fraction since last report in Q8 (0-255)
+ * @param[in]  sent_bitrate   Actually sent bitrate since last report (unit bps)
+ * @param[in]  now            Current time (unit ms)
+ */
+void webrtc_bwe_on_loss_report(webrtc_bwe_handle_t bwe, uint8_t fraction_lost, uint32_t sent_bitrate, uint32_t now);
+
+/**
+ * @brief  Get current target bitrate
+ *
+ * @param[in]  bwe  Estimator handle
+ *
+ * @return
+ *       - 0       Invalid argument
+ *       - Others  Target bitrate (unit bps)
+ */
+uint32_t webrtc_bwe_get_target(webrtc_bwe_handle_t bwe);
+
+/**
+ * @brief  Reset estimator to start bitrate, called when new connection build up
+ *
+ * @param[in]  bwe  Estimator handle
+ */
+void webrtc_bwe_reset(webrtc_bwe_handle_t bwe);
+
+/**
+ * @brief  Close bandwidth estimator
+ *
+ * @param[in]  bwe  Estimator handle
+ */
+void webrtc_bwe_close(webrtc_bwe_handle_t bwe);
+
+#ifdef __cplusplus
+}
+#endif
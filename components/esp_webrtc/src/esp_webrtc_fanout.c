@@ -0,0 +1,609 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "media_lib_os.h"
+#include "esp_peer_types.h"
+#include "esp_webrtc_fanout.h"
+
+#define TAG "WEBRTC_FANOUT"
+
+#define FANOUT_SEND_INTERVAL  (20)
+#define FANOUT_QUIT_BIT       (1 << 0)
+#define FANOUT_STOPPED_BIT    (1 << 1)
+#define FANOUT_GOP_MAX_FRAMES (64)
+
+typedef struct {
+    webrtc_fanout_frame_cb_t on_frame;
+    void                    *ctx;
+    bool                     active;
+    uint8_t                  layer;
+    bool                     wait_key;
+} fanout_sub_t;
+
+typedef struct {
+    uint32_t pts;
+    uint32_t offset;
+    int      size;
+} fanout_gop_frame_t;
+
+typedef struct {
+    fanout_gop_frame_t *frames;
+    uint8_t            *data;
+    uint32_t            capacity;
+    uint32_t            fill;
+    uint16_t            frame_num;
+    bool                valid;
+} fanout_gop_t;
+
+typedef struct {
+    webrtc_fanout_frame_cb_t on_frame;
+    void                    *ctx;
+    uint16_t                 flush_num;
+} fanout_target_t;
+
+typedef struct {
+    esp_capture_sink_handle_t sink;
+    uint8_t                   active_num;
+    fanout_gop_t              gop;
+    uint32_t                  key_req_time;
+    bool                      key_requested;
+} fanout_layer_t;
+
+struct webrtc_fanout_t {
+    esp_capture_handle_t          capture;
+    fanout_layer_t                layers[WEBRTC_FANOUT_MAX_LAYER];
+    uint8_t                       layer_num;
+    fanout_sub_t                  subs[WEBRTC_FANOUT_MAX_SUBSCRIBER];
+    uint8_t                       sub_num;
+    uint8_t                       active_num;
+    bool                          running;
+    bool                          stopping;      /*!< Last subscriber gone, send task and capture not stopped yet */
+    bool                          auto_capture;
+    uint32_t                      gop_size;
+    uint32_t                      gop_flushed;
+    media_lib_mutex_handle_t      lock;
+    media_lib_mutex_handle_t      dispatch_lock;
+    media_lib_event_grp_handle_t  event;
+    struct webrtc_fanout_t       *next;
+};
+
+static struct webrtc_fanout_t  *fanout_list;
+static media_lib_mutex_handle_t fanout_list_lock;
+
+static bool fanout_is_key_frame(esp_capture_stream_frame_t *frame)
+{
+    // Search H264 NAL with start code, frame without start code (like MJPEG) is always key frame
+    bool has_nal = false;
+    for (int i = 0; i + 3 < frame->size; i++) {
+        if (frame->data[i] == 0 && frame->data[i + 1] == 0 && frame->data[i + 2] == 1) {
+            uint8_t nal_type = frame->data[i + 3] & 0x1F;
+            if (nal_type == 5 || nal_type == 7) {
+                return true;
+            }
+            // Parameter sets always lead key frame, no need to scan slice payload
+            if (nal_type == 1) {
+                return false;
+            }
+            has_nal = true;
+            i += 3;
+        }
+    }
+    return has_nal == false;
+}
+
+static void fanout_gop_free(fanout_gop_t *gop)
+{
+    // Index and data share one allocation
+    if (gop->frames) {
+        free(gop->frames);
+    }
+    memset(gop, 0, sizeof(fanout_gop_t));
+}
+
+static void fanout_gop_store(struct webrtc_fanout_t *fanout, fanout_gop_t *gop,
+                             esp_capture_stream_frame_t *frame, bool key_frame)
+{
+    if (fanout->gop_size == 0) {
+        return;
+    }
+    // Cache is only read by send task, so resize here instead of in `webrtc_fanout_set_gop_cache`
+    if (gop->capacity != fanout->gop_size) {
+        fanout_gop_free(gop);
+    }
+    if (gop->frames == NULL) {
+        gop->frames = malloc(sizeof(fanout_gop_frame_t) * FANOUT_GOP_MAX_FRAMES + fanout->gop_size);
+        if (gop->frames == NULL) {
+            ESP_LOGE(TAG, "No memory for GOP cache %d", (int)fanout->gop_size);
+            fanout->gop_size = 0;
+            return;
+        }
+        gop->data = (uint8_t *)(gop->frames + FANOUT_GOP_MAX_FRAMES);
+        gop->capacity = fanout->gop_size;
+    }
+    if (key_frame) {
+        gop->fill = 0;
+        gop->frame_num = 0;
+        gop->valid = true;
+    }
+    if (gop->valid == false) {
+        return;
+    }
+    // Partial GOP can not be decoded, wait for next key frame
+    if (gop->frame_num == FANOUT_GOP_MAX_FRAMES || gop->fill + frame->size > gop->capacity) {
+        gop->valid = false;
+        return;
+    }
+    fanout_gop_frame_t *cached = &gop->frames[gop->frame_num++];
+    cached->pts = frame->pts;
+    cached->offset = gop->fill;
+    cached->size = frame->size;
+    memcpy(gop->data + gop->fill, frame->data, frame->size);
+    gop->fill += frame->size;
+}
+
+static void fanout_gop_flush(fanout_gop_t *gop, fanout_target_t *target)
+{
+    // Send from last key frame so that new viewer can decode immediately
+    for (int i = 0; i < target->flush_num; i++) {
+        esp_capture_stream_frame_t frame = {
+            .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+            .pts = gop->frames[i].pts,
+            .data = gop->data + gop->frames[i].offset,
+            .size = gop->frames[i].size,
+        };
+        target->on_frame(&frame, target->ctx);
+    }
+    ESP_LOGI(TAG, "Flush %d cached frames to %p", target->flush_num, target->ctx);
+}
+
+static void fanout_dispatch(struct webrtc_fanout_t *fanout, esp_capture_stream_frame_t *frame, int layer)
+{
+    bool is_video = (frame->stream_type == ESP_CAPTURE_STREAM_TYPE_VIDEO);
+    int key_frame = -1;
+    fanout_gop_t *gop = &fanout->layers[layer].gop;
+    fanout_target_t targets[WEBRTC_FANOUT_MAX_SUBSCRIBER];
+    int target_num = 0;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (int i = 0; i < WEBRTC_FANOUT_MAX_SUBSCRIBER; i++) {
+        fanout_sub_t *sub = &fanout->subs[i];
+        if (sub->active == false) {
+            continue;
+        }
+        fanout_target_t *target = &targets[target_num];
+        target->flush_num = 0;
+        if (is_video) {
+            if (sub->layer != layer) {
+                continue;
+            }
+            if (sub->wait_key) {
+                if (key_frame < 0) {
+                    key_frame = fanout_is_key_frame(frame);
+                }
+                if (key_frame == 0) {
+                    if (gop->valid == false || gop->frame_num == 0) {
+                        continue;
+                    }
+                    target->flush_num = gop->frame_num;
+                    fanout->gop_flushed++;
+                }
+                sub->wait_key = false;
+            }
+        }
+        target->on_frame = sub->on_frame;
+        target->ctx = sub->ctx;
+        target_num++;
+    }
+    // Callbacks run without fanout lock, deactivated subscriber wait on dispatch lock until they finish
+    media_lib_mutex_lock(fanout->dispatch_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    media_lib_mutex_unlock(fanout->lock);
+    // One encoded frame is shared by all subscribers, each peer packetize and encrypt into its own send queue
+    for (int i = 0; i < target_num; i++) {
+        if (targets[i].flush_num) {
+            // Cached frames only change in this task after dispatch, safe to read without lock
+            fanout_gop_flush(gop, &targets[i]);
+        }
+        targets[i].on_frame(frame, targets[i].ctx);
+    }
+    media_lib_mutex_unlock(fanout->dispatch_lock);
+    if (is_video && fanout->gop_size) {
+        if (key_frame < 0) {
+            key_frame = fanout_is_key_frame(frame);
+        }
+        media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        fanout_gop_store(fanout, gop, frame, key_frame == 1);
+        media_lib_mutex_unlock(fanout->lock);
+    }
+}
+
+static void fanout_send_task(void *arg)
+{
+    struct webrtc_fanout_t *fanout = (struct webrtc_fanout_t *)arg;
+    ESP_LOGI(TAG, "Fan-out send started");
+    while (__atomic_load_n(&fanout->running, __ATOMIC_ACQUIRE)) {
+        esp_capture_sink_handle_t base_sink = fanout->layers[0].sink;
+        esp_capture_stream_frame_t audio_frame = {
+            .stream_type = ESP_CAPTURE_STREAM_TYPE_AUDIO,
+        };
+        while (esp_capture_sink_acquire_frame(base_sink, &audio_frame, true) == ESP_CAPTURE_ERR_OK) {
+            fanout_dispatch(fanout, &audio_frame, 0);
+            esp_capture_sink_release_frame(base_sink, &audio_frame);
+        }
+        for (int i = 0; i < fanout->layer_num; i++) {
+            fanout_layer_t *layer = &fanout->layers[i];
+            // Base layer carries audio so it always runs, extra layer only runs when selected
+            media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+            bool layer_active = (i == 0 || layer->active_num);
+            media_lib_mutex_unlock(fanout->lock);
+            if (layer_active == false) {
+                continue;
+            }
+            esp_capture_stream_frame_t video_frame = {
+                .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+            };
+            if (esp_capture_sink_acquire_frame(layer->sink, &video_frame, true) == ESP_CAPTURE_ERR_OK) {
+                fanout_dispatch(fanout, &video_frame, i);
+                esp_capture_sink_release_frame(layer->sink, &video_frame);
+            }
+        }
+        media_lib_thread_sleep(FANOUT_SEND_INTERVAL);
+    }
+    media_lib_event_group_set_bits(fanout->event, FANOUT_QUIT_BIT);
+}
+
+static fanout_sub_t *fanout_get_sub(struct webrtc_fanout_t *fanout, void *ctx)
+{
+    for (int i = 0; i < WEBRTC_FANOUT_MAX_SUBSCRIBER; i++) {
+        if (fanout->subs[i].on_frame && fanout->subs[i].ctx == ctx) {
+            return &fanout->subs[i];
+        }
+    }
+    return NULL;
+}
+
+static void fanout_layer_ref(struct webrtc_fanout_t *fanout, uint8_t idx, bool add)
+{
+    fanout_layer_t *layer = &fanout->layers[idx];
+    if (add) {
+        layer->active_num++;
+    } else if (layer->active_num) {
+        layer->active_num--;
+    }
+    // Only encode extra layer when someone watching
+    if (idx > 0 && fanout->running) {
+        if (add && layer->active_num == 1) {
+            esp_capture_sink_enable(layer->sink, ESP_CAPTURE_RUN_MODE_ALWAYS);
+        } else if (add == false && layer->active_num == 0) {
+            esp_capture_sink_enable(layer->sink, ESP_CAPTURE_RUN_MODE_DISABLE);
+            layer->gop.valid = false;
+        }
+    }
+}
+
+static void fanout_destroy(struct webrtc_fanout_t *fanout)
+{
+    for (int i = 0; i < WEBRTC_FANOUT_MAX_LAYER; i++) {
+        fanout_gop_free(&fanout->layers[i].gop);
+    }
+    if (fanout->lock) {
+        media_lib_mutex_destroy(fanout->lock);
+    }
+    if (fanout->dispatch_lock) {
+        media_lib_mutex_destroy(fanout->dispatch_lock);
+    }
+    if (fanout->event) {
+        media_lib_event_group_destroy(fanout->event);
+    }
+    free(fanout);
+}
+
+static int fanout_setup_sinks(struct webrtc_fanout_t *fanout, esp_capture_sink_cfg_t *sink_cfg,
+                              webrtc_fanout_layer_cfg_t *layers, uint8_t layer_num)
+{
+    if (esp_capture_sink_setup(fanout->capture, 0, sink_cfg, &fanout->layers[0].sink) != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Fail to setup capture sink");
+        return ESP_PEER_ERR_FAIL;
+    }
+    fanout->layer_num = 1;
+    for (int i = 0; i < layer_num && fanout->layer_num < WEBRTC_FANOUT_MAX_LAYER; i++) {
+        esp_capture_sink_cfg_t layer_cfg = layers[i].sink_cfg;
+        // Audio only from base layer
+        layer_cfg.audio_info.format_id = ESP_CAPTURE_FMT_ID_NONE;
+        fanout_layer_t *layer = &fanout->layers[fanout->layer_num];
+        if (esp_capture_sink_setup(fanout->capture, layers[i].sink_idx, &layer_cfg, &layer->sink) != ESP_CAPTURE_ERR_OK) {
+            ESP_LOGE(TAG, "Fail to setup capture sink %d for layer %d", layers[i].sink_idx, fanout->layer_num);
+            return ESP_PEER_ERR_FAIL;
+        }
+        ESP_LOGI(TAG, "Layer %d use sink %d %dx%d", fanout->layer_num, layers[i].sink_idx,
+                 (int)layer_cfg.video_info.width, (int)layer_cfg.video_info.height);
+        fanout->layer_num++;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int webrtc_fanout_attach(esp_capture_handle_t capture, esp_capture_sink_cfg_t *sink_cfg,
+                         webrtc_fanout_layer_cfg_t *layers, uint8_t layer_num,
+                         webrtc_fanout_frame_cb_t on_frame, void *ctx, webrtc_fanout_handle_t *h)
+{
+    if (capture == NULL || sink_cfg == NULL || on_frame == NULL || h == NULL || (layer_num && layers == NULL)) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_create_once(&fanout_list_lock);
+    if (fanout_list_lock == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    // Hold list lock until subscriber added so that concurrent detach can not destroy it
+    media_lib_mutex_lock(fanout_list_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    struct webrtc_fanout_t *fanout = fanout_list;
+    while (fanout && fanout->capture != capture) {
+        fanout = fanout->next;
+    }
+    if (fanout == NULL) {
+        fanout = calloc(1, sizeof(struct webrtc_fanout_t));
+        if (fanout == NULL) {
+            media_lib_mutex_unlock(fanout_list_lock);
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        media_lib_mutex_create(&fanout->lock);
+        media_lib_mutex_create(&fanout->dispatch_lock);
+        media_lib_event_group_create(&fanout->event);
+        if (fanout->lock == NULL || fanout->dispatch_lock == NULL || fanout->event == NULL) {
+            fanout_destroy(fanout);
+            media_lib_mutex_unlock(fanout_list_lock);
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        fanout->capture = capture;
+        if (fanout_setup_sinks(fanout, sink_cfg, layers, layer_num) != ESP_PEER_ERR_NONE) {
+            fanout_destroy(fanout);
+            media_lib_mutex_unlock(fanout_list_lock);
+            return ESP_PEER_ERR_FAIL;
+        }
+        fanout->next = fanout_list;
+        fanout_list = fanout;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    int ret = ESP_PEER_ERR_OVER_LIMITED;
+    if (fanout_get_sub(fanout, ctx)) {
+        ret = ESP_PEER_ERR_NONE;
+    } else {
+        for (int i = 0; i < WEBRTC_FANOUT_MAX_SUBSCRIBER; i++) {
+            if (fanout->subs[i].on_frame == NULL) {
+                memset(&fanout->subs[i], 0, sizeof(fanout_sub_t));
+                fanout->subs[i].on_frame = on_frame;
+                fanout->subs[i].ctx = ctx;
+                fanout->sub_num++;
+                ret = ESP_PEER_ERR_NONE;
+                break;
+            }
+        }
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    media_lib_mutex_unlock(fanout_list_lock);
+    if (ret == ESP_PEER_ERR_NONE) {
+        *h = fanout;
+        ESP_LOGI(TAG, "Attached %p subscribers %d", ctx, fanout->sub_num);
+    }
+    return ret;
+}
+
+int webrtc_fanout_set_active(webrtc_fanout_handle_t fanout, void *ctx, bool active, bool auto_capture)
+{
+    if (fanout == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int ret = ESP_PEER_ERR_NONE;
+    bool wait_quit = false;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // Stop runs without lock, start only after it finished so that it never stops capture of new subscriber
+    while (fanout->stopping) {
+        media_lib_mutex_unlock(fanout->lock);
+        media_lib_event_group_wait_bits(fanout->event, FANOUT_STOPPED_BIT, MEDIA_LIB_MAX_LOCK_TIME);
+        media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+    fanout_sub_t *sub = fanout_get_sub(fanout, ctx);
+    if (sub == NULL || sub->active == active) {
+        media_lib_mutex_unlock(fanout->lock);
+        return sub ? ESP_PEER_ERR_NONE : ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (active) {
+        if (fanout->active_num == 0) {
+            fanout->auto_capture = auto_capture;
+            esp_capture_sink_enable(fanout->layers[0].sink, ESP_CAPTURE_RUN_MODE_ALWAYS);
+            for (int i = 1; i < fanout->layer_num; i++) {
+                esp_capture_sink_enable(fanout->layers[i].sink, ESP_CAPTURE_RUN_MODE_DISABLE);
+            }
+            if (auto_capture) {
+                ret = esp_capture_start(fanout->capture);
+            }
+            if (ret == ESP_CAPTURE_ERR_OK) {
+                media_lib_thread_handle_t thread = NULL;
+                __atomic_store_n(&fanout->running, true, __ATOMIC_RELEASE);
+                ret = media_lib_thread_create_pooled(&thread, "pc_send", fanout_send_task, fanout);
+                if (ret != 0) {
+                    __atomic_store_n(&fanout->running, false, __ATOMIC_RELEASE);
+                }
+            }
+        }
+        if (ret == ESP_PEER_ERR_NONE) {
+            sub->active = true;
+            // New subscriber can only decode from key frame
+            sub->wait_key = true;
+            fanout->active_num++;
+            fanout_layer_ref(fanout, sub->layer, true);
+        }
+    } else {
+        sub->active = false;
+        fanout->active_num--;
+        fanout_layer_ref(fanout, sub->layer, false);
+        if (fanout->active_num == 0 && fanout->running) {
+            __atomic_store_n(&fanout->running, false, __ATOMIC_RELEASE);
+            fanout->stopping = true;
+            media_lib_event_group_clr_bits(fanout->event, FANOUT_STOPPED_BIT);
+            wait_quit = true;
+        }
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    if (active == false) {
+        // Wait for frame callbacks in progress, subscriber is not called after return
+        media_lib_mutex_lock(fanout->dispatch_lock, MEDIA_LIB_MAX_LOCK_TIME);
+        media_lib_mutex_unlock(fanout->dispatch_lock);
+    }
+    if (wait_quit) {
+        media_lib_event_group_wait_bits(fanout->event, FANOUT_QUIT_BIT, MEDIA_LIB_MAX_LOCK_TIME);
+        media_lib_event_group_clr_bits(fanout->event, FANOUT_QUIT_BIT);
+        if (fanout->auto_capture) {
+            esp_capture_stop(fanout->capture);
+        } else {
+            for (int i = 0; i < fanout->layer_num; i++) {
+                esp_capture_sink_enable(fanout->layers[i].sink, ESP_CAPTURE_RUN_MODE_DISABLE);
+            }
+        }
+        // Encoder restarts from key frame, cached frames are stale
+        media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        for (int i = 0; i < fanout->layer_num; i++) {
+            fanout->layers[i].gop.valid = false;
+        }
+        fanout->stopping = false;
+        media_lib_event_group_set_bits(fanout->event, FANOUT_STOPPED_BIT);
+        media_lib_mutex_unlock(fanout->lock);
+    }
+    return ret;
+}
+
+int webrtc_fanout_select_layer(webrtc_fanout_handle_t fanout, void *ctx, uint8_t layer)
+{
+    if (fanout == NULL || layer >= fanout->layer_num) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout_sub_t *sub = fanout_get_sub(fanout, ctx);
+    if (sub == NULL) {
+        media_lib_mutex_unlock(fanout->lock);
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (sub->layer != layer) {
+        if (sub->active) {
+            fanout_layer_ref(fanout, layer, true);
+            fanout_layer_ref(fanout, sub->layer, false);
+            // Resolution changed, receiver need start from key frame of new layer
+            sub->wait_key = true;
+        }
+        ESP_LOGI(TAG, "Subscriber %p switch to layer %d", ctx, layer);
+        sub->layer = layer;
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int webrtc_fanout_set_gop_cache(webrtc_fanout_handle_t fanout, uint32_t cache_size)
+{
+    if (fanout == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // Cache is shared by all subscribers, keep the largest one requested, reallocated by send task
+    if (cache_size > fanout->gop_size) {
+        fanout->gop_size = cache_size;
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+bool webrtc_fanout_gop_ready(webrtc_fanout_handle_t fanout, void *ctx)
+{
+    if (fanout == NULL) {
+        return false;
+    }
+    bool ready = false;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout_sub_t *sub = fanout_get_sub(fanout, ctx);
+    if (sub) {
+        fanout_gop_t *gop = &fanout->layers[sub->layer].gop;
+        ready = gop->valid && gop->frame_num > 0;
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return ready;
+}
+
+uint32_t webrtc_fanout_get_gop_flushed(webrtc_fanout_handle_t fanout)
+{
+    if (fanout == NULL) {
+        return 0;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    uint32_t flushed = fanout->gop_flushed;
+    media_lib_mutex_unlock(fanout->lock);
+    return flushed;
+}
+
+bool webrtc_fanout_key_frame_request(webrtc_fanout_handle_t fanout, uint8_t layer, uint32_t min_interval, uint32_t now)
+{
+    if (fanout == NULL || layer >= fanout->layer_num) {
+        return true;
+    }
+    bool forward = true;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout_layer_t *l = &fanout->layers[layer];
+    if (l->key_requested && now - l->key_req_time < min_interval) {
+        forward = false;
+    } else {
+        l->key_requested = true;
+        l->key_req_time = now;
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return forward;
+}
+
+void webrtc_fanout_detach(webrtc_fanout_handle_t fanout, void *ctx)
+{
+    if (fanout == NULL) {
+        return;
+    }
+    webrtc_fanout_set_active(fanout, ctx, false, fanout->auto_capture);
+    media_lib_mutex_lock(fanout_list_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout_sub_t *sub = fanout_get_sub(fanout, ctx);
+    if (sub) {
+        memset(sub, 0, sizeof(fanout_sub_t));
+        fanout->sub_num--;
+    }
+    bool destroy = (fanout->sub_num == 0);
+    media_lib_mutex_unlock(fanout->lock);
+    if (destroy) {
+        struct webrtc_fanout_t **p = &fanout_list;
+        while (*p && *p != fanout) {
+            p = &(*p)->next;
+        }
+        if (*p) {
+            *p = fanout->next;
+        }
+    }
+    media_lib_mutex_unlock(fanout_list_lock);
+    if (destroy) {
+        fanout_destroy(fanout);
+    }
+}
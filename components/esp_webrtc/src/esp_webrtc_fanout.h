@@ -0,0 +1,189 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_capture.h"
+#include "esp_capture_sink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WEBRTC_FANOUT_MAX_SUBSCRIBER (4)
+#define WEBRTC_FANOUT_MAX_LAYER      (3)
+
+/**
+ * @brief  Fan-out handle, one for each shared capture
+ */
+typedef struct webrtc_fanout_t *webrtc_fanout_handle_t;
+
+/**
+ * @brief  Extra video layer configuration
+ */
+typedef struct {
+    uint8_t                 sink_idx;  /*!< Capture sink index for this layer */
+    esp_capture_sink_cfg_t  sink_cfg;  /*!< Sink configuration (video only) */
+} webrtc_fanout_layer_cfg_t;
+
+/**
+ * @brief  Frame callback for subscriber
+ *
+ * @note  Frame is only valid during callback, it is shared by all subscribers so must not be modified
+ *        Callback runs in send thread without fan-out lock held, so it can call fan-out APIs
+ */
+typedef void (*webrtc_fanout_frame_cb_t)(esp_capture_stream_frame_t *frame, void *ctx);
+
+/**
+ * @brief  Attach to fan-out of capture
+ *
+ * @note  First subscriber setups capture sink 0 use `sink_cfg` as base layer and sinks for extra layers,
+ *        later ones reuse them
+ *        Audio is only taken from base layer
+ *
+ * @param[in]   capture    Capture handle
+ * @param[in]   sink_cfg   Sink configuration of base layer
+ * @param[in]   layers     Extra video layers (can be NULL)
+ * @param[in]   layer_num  Number of extra video layers
+ * @param[in]   on_frame   Frame callback
+ * @param[in]   ctx       Subscriber context (also used as subscriber identity)
+ * @param[out]  fanout    Fan-out handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE          On success
+ *       - ESP_PEER_ERR_INVALID_ARG   Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM        Not enough memory
+ *       - ESP_PEER_ERR_OVER_LIMITED  Too many subscribers
+ */
+int webrtc_fanout_attach(esp_capture_handle_t capture, esp_capture_sink_cfg_t *sink_cfg,
+                         webrtc_fanout_layer_cfg_t *layers, uint8_t layer_num,
+                         webrtc_fanout_frame_cb_t on_frame, void *ctx, webrtc_fanout_handle_t *fanout);
+
+/**
+ * @brief  Set subscriber to receive frames or not
+ *
+ * @note  Send thread starts when first subscriber become active and stops when all inactive
+ *        When set inactive, it waits for frame callback in progress so no more callback after return
+ *
+ * @param[in]  fanout        Fan-out handle
+ * @param[in]  ctx           Subscriber context
+ * @param[in]  active        Receive frames or not
+ * @param[in]  auto_capture  Start and stop capture together with send thread
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - Others                    Fail to start capture or send thread
+ */
+int webrtc_fanout_set_active(webrtc_fanout_handle_t fanout, void *ctx, bool active, bool auto_capture);
+
+/**
+ * @brief  Select video layer for subscriber
+ *
+ * @note  Extra layer is encoded only when some active subscriber selected it
+ *        After switch, video is sent from next key frame of new layer
+ *
+ * @param[in]  fanout  Fan-out handle
+ * @param[in]  ctx     Subscriber context
+ * @param[in]  layer   Layer index (0 for base layer)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or layer not exists
+ */
+int webrtc_fanout_select_layer(webrtc_fanout_handle_t fanout, void *ctx, uint8_t layer);
+
+/**
+ * @brief  Set GOP cache size for fan-out
+ *
+ * @note  Each running layer keeps frames from its last key frame in cache, a subscriber waiting for key frame
+ *        gets cached frames flushed first so that it can decode immediately
+ *        Cache is dropped when it overflows and rebuilt from next key frame
+ *        Cache is shared by all subscribers, the largest size requested is used
+ *
+ * @param[in]  fanout      Fan-out handle
+ * @param[in]  cache_size  Byte budget for one layer, 0 to keep current setting
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int webrtc_fanout_set_gop_cache(webrtc_fanout_handle_t fanout, uint32_t cache_size);
+
+/**
+ * @brief  Check whether decodable GOP is cached for subscriber's layer
+ *
+ * @param[in]  fanout  Fan-out handle
+ * @param[in]  ctx     Subscriber context
+ *
+ * @return
+ *       - true   Subscriber can start from cached frames, no need to request key frame
+ *       - false  No valid cache
+ */
+bool webrtc_fanout_gop_ready(webrtc_fanout_handle_t fanout, void *ctx);
+
+/**
+ * @brief  Get times GOP cache flushed to new subscribers
+ *
+ * @param[in]  fanout  Fan-out handle
+ *
+ * @return
+ *       - Flushed count
+ */
+uint32_t webrtc_fanout_get_gop_flushed(webrtc_fanout_handle_t fanout);
+
+/**
+ * @brief  Check whether key frame request of one subscriber should be forwarded to encoder
+ *
+ * @note  Encoder of each layer is shared, one key frame serves all subscribers of the layer
+ *        Requests for the same layer within `min_interval` after the forwarded one are coalesced,
+ *        so that N viewers joining or reporting loss together not force N key frames
+ *
+ * @param[in]  fanout        Fan-out handle
+ * @param[in]  layer         Video layer index
+ * @param[in]  min_interval  Coalesce interval (unit ms)
+ * @param[in]  now           Current time (unit ms)
+ *
+ * @return
+ *       - true   Forward request to encoder
+ *       - false  Coalesced into key frame already requested by other subscriber
+ */
+bool webrtc_fanout_key_frame_request(webrtc_fanout_handle_t fanout, uint8_t layer, uint32_t min_interval, uint32_t now);
+
+/**
+ * @brief  Detach from fan-out
+ *
+ * @note  After return no more frame callback for this subscriber
+ *        Fan-out is destroyed when last subscriber detached
+ *
+ * @param[in]  fanout  Fan-out handle
+ * @param[in]  ctx     Subscriber context
+ */
+void webrtc_fanout_detach(webrtc_fanout_handle_t fanout, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,339 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "esp_peer_types.h"
+#include "esp_webrtc_reactor.h"
+
+#define TAG "WEBRTC_REACTOR"
+
+#define REACTOR_WAKEUP_BIT (1 << 0)
+#define REACTOR_QUIT_BIT   (1 << 1)
+#define REACTOR_IDLE_BIT   (1 << 2)
+#define REACTOR_MAX_DUE    (0x7FFFFFFF)
+
+typedef struct webrtc_reactor webrtc_reactor_t;
+
+struct webrtc_reactor_client_t {
+    webrtc_reactor_run_cb_t  run;
+    void                    *ctx;
+    webrtc_reactor_t        *reactor;  /*!< Owner reactor, set while attached */
+    bool                     paused;
+    bool                     woken;    /*!< Set by any thread without lock, accessed atomically */
+    uint32_t                 due;
+};
+
+struct webrtc_reactor {
+    struct webrtc_reactor_client_t  clients[WEBRTC_REACTOR_MAX_CLIENT];
+    uint8_t                         client_num;
+    uint8_t                         start_idx;
+    bool                            running;
+    struct webrtc_reactor_client_t *cur_client;  /*!< Client whose run callback is executing */
+    media_lib_mutex_handle_t        lock;
+    media_lib_event_grp_handle_t    event;
+    uint32_t                        wakeup_num;
+    uint32_t                        run_num;
+};
+
+static webrtc_reactor_t         *reactor;
+static media_lib_mutex_handle_t  reactor_lock;  /*!< Guards creation and teardown of reactor */
+static __thread bool             in_reactor;    /*!< Current thread is reactor thread */
+
+static uint32_t reactor_cur_time(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static uint32_t reactor_run_client(webrtc_reactor_t *r, struct webrtc_reactor_client_t *client)
+{
+    // Run callback without reactor lock, it may wait for locks held by threads which call wakeup or pause
+    r->cur_client = client;
+    media_lib_event_group_clr_bits(r->event, REACTOR_IDLE_BIT);
+    media_lib_mutex_unlock(r->lock);
+    uint32_t next = client->run(client->ctx);
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    r->cur_client = NULL;
+    media_lib_event_group_set_bits(r->event, REACTOR_IDLE_BIT);
+    r->run_num++;
+    return next;
+}
+
+static uint32_t reactor_run_clients(webrtc_reactor_t *r)
+{
+    uint32_t now = reactor_cur_time();
+    uint32_t wait = WEBRTC_REACTOR_MAX_WAIT;
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // Rotate first client of each pass so that no connection always get serviced ahead of others
+    for (int i = 0; i < WEBRTC_REACTOR_MAX_CLIENT; i++) {
+        struct webrtc_reactor_client_t *client = &r->clients[(r->start_idx + i) % WEBRTC_REACTOR_MAX_CLIENT];
+        if (client->run == NULL || client->paused) {
+            continue;
+        }
+        bool woken = __atomic_exchange_n(&client->woken, false, __ATOMIC_ACQ_REL);
+        if (woken || (int32_t)(now - client->due) >= 0) {
+            // Detach waits until callback returned, so slot is still owned by client after run
+            uint32_t next = reactor_run_client(r, client);
+            now = reactor_cur_time();
+            client->due = now + (next > REACTOR_MAX_DUE ? REACTOR_MAX_DUE : next);
+        }
+        int32_t remain = (int32_t)(client->due - now);
+        if (remain <= 0 || __atomic_load_n(&client->woken, __ATOMIC_ACQUIRE)) {
+            wait = 0;
+        } else if ((uint32_t)remain < wait) {
+            wait = (uint32_t)remain;
+        }
+    }
+    r->start_idx = (r->start_idx + 1) % WEBRTC_REACTOR_MAX_CLIENT;
+    media_lib_mutex_unlock(r->lock);
+    return wait;
+}
+
+static void reactor_task(void *arg)
+{
+    webrtc_reactor_t *r = (webrtc_reactor_t *)arg;
+    in_reactor = true;
+    ESP_LOGI(TAG, "Reactor started");
+    while (__atomic_load_n(&r->running, __ATOMIC_ACQUIRE)) {
+        // Clear before pass, wakeup during pass keeps bit set so that no wait afterwards
+        media_lib_event_group_clr_bits(r->event, REACTOR_WAKEUP_BIT);
+        uint32_t wait = reactor_run_clients(r);
+        if (wait && __atomic_load_n(&r->running, __ATOMIC_ACQUIRE)) {
+            media_lib_event_group_wait_bits(r->event, REACTOR_WAKEUP_BIT, wait);
+            __atomic_add_fetch(&r->wakeup_num, 1, __ATOMIC_RELAXED);
+        }
+    }
+    // Thread may be reused from pool for other work
+    in_reactor = false;
+    media_lib_event_group_set_bits(r->event, REACTOR_QUIT_BIT);
+}
+
+static void reactor_wait_idle(webrtc_reactor_t *r, struct webrtc_reactor_client_t *client)
+{
+    // Called with reactor lock held, return once run callback of client finished
+    // Called from run callback on reactor thread, waiting for itself would never return
+    if (in_reactor) {
+        return;
+    }
+    while (r->cur_client == client) {
+        media_lib_mutex_unlock(r->lock);
+        media_lib_event_group_wait_bits(r->event, REACTOR_IDLE_BIT, MEDIA_LIB_MAX_LOCK_TIME);
+        media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+}
+
+static void reactor_destroy(webrtc_reactor_t *r)
+{
+    if (r->lock) {
+        media_lib_mutex_destroy(r->lock);
+    }
+    if (r->event) {
+        media_lib_event_group_destroy(r->event);
+    }
+    free(r);
+}
+
+static bool reactor_own_client(webrtc_reactor_t *r, webrtc_reactor_client_handle_t client)
+{
+    // Stale handle may still be used after detach, never touch it unless it is a slot of current reactor
+    return r && client >= r->clients && client < r->clients + WEBRTC_REACTOR_MAX_CLIENT;
+}
+
+int webrtc_reactor_attach(webrtc_reactor_run_cb_t run, void *ctx, webrtc_reactor_client_handle_t *client)
+{
+    if (run == NULL || client == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (media_lib_mutex_create_once(&reactor_lock) != ESP_OK) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    media_lib_mutex_lock(reactor_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (reactor == NULL) {
+        webrtc_reactor_t *r = calloc(1, sizeof(webrtc_reactor_t));
+        if (r == NULL) {
+            media_lib_mutex_unlock(reactor_lock);
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        media_lib_mutex_create(&r->lock);
+        media_lib_event_group_create(&r->event);
+        if (r->lock == NULL || r->event == NULL) {
+            reactor_destroy(r);
+            media_lib_mutex_unlock(reactor_lock);
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        reactor = r;
+    }
+    webrtc_reactor_t *r = reactor;
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    struct webrtc_reactor_client_t *slot = NULL;
+    for (int i = 0; i < WEBRTC_REACTOR_MAX_CLIENT; i++) {
+        if (r->clients[i].run == NULL) {
+            slot = &r->clients[i];
+            break;
+        }
+    }
+    int ret = ESP_PEER_ERR_NONE;
+    if (slot) {
+        memset(slot, 0, sizeof(struct webrtc_reactor_client_t));
+        slot->run = run;
+        slot->ctx = ctx;
+        slot->reactor = r;
+        slot->woken = true;
+        r->client_num++;
+        if (r->running == false) {
+            media_lib_thread_handle_t thread = NULL;
+            r->running = true;
+            // Reuse main loop thread setting, reactor runs same work as per connection main loop
+            if (media_lib_thread_create_pooled(&thread, "pc_task", reactor_task, r) != 0) {
+                r->running = false;
+                memset(slot, 0, sizeof(struct webrtc_reactor_client_t));
+                r->client_num--;
+                ret = ESP_PEER_ERR_FAIL;
+            }
+        }
+    } else {
+        ret = ESP_PEER_ERR_OVER_LIMITED;
+    }
+    media_lib_mutex_unlock(r->lock);
+    if (ret == ESP_PEER_ERR_NONE) {
+        *client = slot;
+        media_lib_event_group_set_bits(r->event, REACTOR_WAKEUP_BIT);
+        ESP_LOGI(TAG, "Attached %p clients %d", ctx, r->client_num);
+    } else if (r->client_num == 0) {
+        reactor = NULL;
+        reactor_destroy(r);
+    }
+    media_lib_mutex_unlock(reactor_lock);
+    return ret;
+}
+
+void webrtc_reactor_wakeup(webrtc_reactor_client_handle_t client)
+{
+    // Lock free so that it is cheap on every sent frame, caller keeps client attached during the call
+    if (client == NULL) {
+        return;
+    }
+    webrtc_reactor_t *r = client->reactor;
+    if (r == NULL) {
+        return;
+    }
+    __atomic_store_n(&client->woken, true, __ATOMIC_RELEASE);
+    // Reactor thread checks woken flag after run callback, no need to signal itself
+    if (in_reactor == false) {
+        media_lib_event_group_set_bits(r->event, REACTOR_WAKEUP_BIT);
+    }
+}
+
+void webrtc_reactor_pause(webrtc_reactor_client_handle_t client, bool pause)
+{
+    if (client == NULL || client->reactor == NULL) {
+        return;
+    }
+    webrtc_reactor_t *r = client->reactor;
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    client->paused = pause;
+    if (pause) {
+        reactor_wait_idle(r, client);
+    }
+    media_lib_mutex_unlock(r->lock);
+    if (pause == false) {
+        webrtc_reactor_wakeup(client);
+    }
+}
+
+void webrtc_reactor_sync(webrtc_reactor_client_handle_t client)
+{
+    if (client == NULL || client->reactor == NULL) {
+        return;
+    }
+    webrtc_reactor_t *r = client->reactor;
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    reactor_wait_idle(r, client);
+    media_lib_mutex_unlock(r->lock);
+}
+
+void webrtc_reactor_get_stats(uint32_t *wakeup_num, uint32_t *run_num)
+{
+    *wakeup_num = 0;
+    *run_num = 0;
+    if (reactor_lock == NULL) {
+        return;
+    }
+    // Detach never called from reactor thread, so reactor is alive while it queries itself
+    bool locked = (in_reactor == false);
+    if (locked) {
+        media_lib_mutex_lock(reactor_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+    webrtc_reactor_t *r = reactor;
+    if (r) {
+        *wakeup_num = __atomic_load_n(&r->wakeup_num, __ATOMIC_RELAXED);
+        media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        *run_num = r->run_num;
+        media_lib_mutex_unlock(r->lock);
+    }
+    if (locked) {
+        media_lib_mutex_unlock(reactor_lock);
+    }
+}
+
+void webrtc_reactor_detach(webrtc_reactor_client_handle_t client)
+{
+    if (client == NULL || reactor_lock == NULL) {
+        return;
+    }
+    // Keep global lock until reactor destroyed, so that attach in between can not start another thread
+    media_lib_mutex_lock(reactor_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    webrtc_reactor_t *r = reactor;
+    if (reactor_own_client(r, client) == false) {
+        media_lib_mutex_unlock(reactor_lock);
+        return;
+    }
+    media_lib_mutex_lock(r->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // No more run callback for this client once detach returned
+    reactor_wait_idle(r, client);
+    if (client->run) {
+        memset(client, 0, sizeof(struct webrtc_reactor_client_t));
+        r->client_num--;
+    }
+    bool quit = (r->client_num == 0);
+    bool was_running = r->running;
+    if (quit) {
+        __atomic_store_n(&r->running, false, __ATOMIC_RELEASE);
+    }
+    media_lib_mutex_unlock(r->lock);
+    if (quit) {
+        if (was_running) {
+            media_lib_event_group_set_bits(r->event, REACTOR_WAKEUP_BIT);
+            media_lib_event_group_wait_bits(r->event, REACTOR_QUIT_BIT, MEDIA_LIB_MAX_LOCK_TIME);
+        }
+        reactor = NULL;
+        reactor_destroy(r);
+        ESP_LOGI(TAG, "Reactor stopped");
+    }
+    media_lib_mutex_unlock(reactor_lock);
+}
@@ -0,0 +1,124 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WEBRTC_REACTOR_MAX_CLIENT (8)
+#define WEBRTC_REACTOR_MAX_WAIT   (0xFFFFFFFF)
+
+/**
+ * @brief  Reactor client handle
+ */
+typedef struct webrtc_reactor_client_t *webrtc_reactor_client_handle_t;
+
+/**
+ * @brief  Run callback of reactor client
+ *
+ * @note  Called from reactor thread without reactor lock held, so it may take locks also held by threads calling
+ *        wakeup or pause, it must not block for long since it delays other clients
+ *
+ * @param[in]  ctx  Client context
+ *
+ * @return
+ *       - Time until client need to run again (unit ms), WEBRTC_REACTOR_MAX_WAIT to wait for wakeup only
+ */
+typedef uint32_t (*webrtc_reactor_run_cb_t)(void *ctx);
+
+/**
+ * @brief  Attach client to shared reactor
+ *
+ * @note  One reactor thread services all attached clients, it is created when first client attached
+ *        Clients are run in rotating order so that no client always goes first, each client runs at most once
+ *        per scheduling pass and only when its deadline reached or it is woken up
+ *
+ * @param[in]   run     Run callback
+ * @param[in]   ctx     Client context
+ * @param[out]  client  Client handle to store
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE          On success
+ *       - ESP_PEER_ERR_INVALID_ARG   Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM        Not enough memory
+ *       - ESP_PEER_ERR_OVER_LIMITED  Too many clients
+ */
+int webrtc_reactor_attach(webrtc_reactor_run_cb_t run, void *ctx, webrtc_reactor_client_handle_t *client);
+
+/**
+ * @brief  Wakeup client so that it runs in next scheduling pass
+ *
+ * @note  Lock free and can be called from any thread, client must stay attached during the call
+ *
+ * @param[in]  client  Client handle
+ */
+void webrtc_reactor_wakeup(webrtc_reactor_client_handle_t client);
+
+/**
+ * @brief  Pause or resume client
+ *
+ * @note  After pause returns client is not running and will not run until resumed
+ *        When called from run callback of client itself, it takes effect after callback returns
+ *
+ * @param[in]  client  Client handle
+ * @param[in]  pause   Pause or resume
+ */
+void webrtc_reactor_pause(webrtc_reactor_client_handle_t client, bool pause);
+
+/**
+ * @brief  Wait until running callback of client returned
+ *
+ * @note  Return immediately when called from reactor thread
+ *
+ * @param[in]  client  Client handle
+ */
+void webrtc_reactor_sync(webrtc_reactor_client_handle_t client);
+
+/**
+ * @brief  Get reactor statistics
+ *
+ * @param[out]  wakeup_num  Reactor thread wakeup count
+ * @param[out]  run_num     Client run count
+ */
+void webrtc_reactor_get_stats(uint32_t *wakeup_num, uint32_t *run_num);
+
+/**
+ * @brief  Detach client from reactor
+ *
+ * @note  After return no more run callback for this client and handle must not be used any more
+ *        Reactor thread quits when last client detached, so it must not be called from run callback
+ *
+ * @param[in]  client  Client handle
+ */
+void webrtc_reactor_detach(webrtc_reactor_client_handle_t client);
+
+#ifdef __cplusplus
+}
+#endif
@@ -185,6 +185,159 @@ int media_lib_aes_set_key(media_lib_aes_handle_t ctx, uint8_t *key, uint8_t key_
  */
 int media_lib_aes_crypt_cbc(media_lib_aes_handle_t ctx, bool decrypt_mode, uint8_t iv[16], uint8_t *input, size_t size, uint8_t *output);
 
+/**
+ * @brief     AES-CTR streaming encryption/decryption
+ *
+ * @note      Key is set by `media_lib_aes_set_key`, encryption and decryption are the same operation
+ *            Data can be fed in any size, counter state is kept in `nc_off`, `nonce_counter` and `stream_block`
+ * @param     ctx: AES instance
+ * @param     size: Data size
+ * @param     nc_off: Offset in current stream block (set to 0 when start)
+ * @param     nonce_counter: Nonce and counter block (updated after each call)
+ * @param     stream_block: Saved stream block for resuming (updated after each call)
+ * @param     input: Input data
+ * @param     output: Output data
+ *
+ *  @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Encrypt/decrypt fail
+ */
+int media_lib_aes_crypt_ctr(media_lib_aes_handle_t ctx, size_t size, size_t *nc_off, uint8_t nonce_counter[16],
+                            uint8_t stream_block[16], const uint8_t *input, uint8_t *output);
+
+/**
+ * @brief     AES-GCM initialize wrapper
+ *
+ * @param[out]  ctx: AES-GCM instance pointer
+ */
+void media_lib_gcm_init(media_lib_gcm_handle_t *ctx);
+
+/**
+ * @brief     AES-GCM resource free wrapper
+ *
+ * @param     ctx: AES-GCM instance
+ */
+void media_lib_gcm_free(media_lib_gcm_handle_t ctx);
+
+/**
+ * @brief     AES-GCM set key
+ *
+ * @param     ctx: AES-GCM instance
+ * @param     key: AES key
+ * @param     key_bits: Bitlength of key (128 or 256)
+ *
+ *  @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Set key fail
+ */
+int media_lib_gcm_set_key(media_lib_gcm_handle_t ctx, const uint8_t *key, uint16_t key_bits);
+
+/**
+ * @brief     AES-GCM start one message
+ *
+ * @param     ctx: AES-GCM instance
+ * @param     decrypt_mode: Set `true` for decryption, `false` for encryption
+ * @param     iv: Initialization vector
+ * @param     iv_len: IV length (12 bytes for SRTP)
+ * @param     aad: Additional authenticated data (RTP header for SRTP)
+ * @param     aad_len: Additional data length
+ *
+ *  @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Start fail
+ */
+int media_lib_gcm_start(media_lib_gcm_handle_t ctx, bool decrypt_mode, const uint8_t *iv, size_t iv_len,
+                        const uint8_t *aad, size_t aad_len);
+
+/**
+ * @brief     AES-GCM encrypt/decrypt data, can be called multiple times for one message
+ *
+ * @param     ctx: AES-GCM instance
+ * @param     input: Input data
+ * @param     size: Data size
+ * @param     output: Output data (same size as input)
+ *
+ *  @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Encrypt/decrypt fail
+ */
+int media_lib_gcm_update(media_lib_gcm_handle_t ctx, const uint8_t *input, size_t size, uint8_t *output);
+
+/**
+ * @brief     AES-GCM finish message and get authentication tag
+ *
+ * @note      For decryption caller compares the tag with received one
+ *
+ * @param     ctx: AES-GCM instance
+ * @param     tag: Tag output
+ * @param     tag_len: Tag length (16 bytes for SRTP)
+ *
+ *  @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Finish fail
+ */
+int media_lib_gcm_finish(media_lib_gcm_handle_t ctx, uint8_t *tag, size_t tag_len);
+
+/**
+ * @brief     HMAC-SHA1 initialize wrapper
+ *
+ * @param[out]  ctx: HMAC-SHA1 instance pointer
+ */
+void media_lib_hmac_sha1_init(media_lib_hmac_sha1_handle_t *ctx);
+
+/**
+ * @brief     HMAC-SHA1 resource free wrapper
+ *
+ * @param     ctx: HMAC-SHA1 instance
+ */
+void media_lib_hmac_sha1_free(media_lib_hmac_sha1_handle_t ctx);
+
+/**
+ * @brief     HMAC-SHA1 start with key
+ *
+ * @param     ctx: HMAC-SHA1 instance
+ * @param     key: HMAC key
+ * @param     key_len: Key length
+ *
+ * @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Start fail
+ */
+int media_lib_hmac_sha1_start(media_lib_hmac_sha1_handle_t ctx, const uint8_t *key, size_t key_len);
+
+/**
+ * @brief     HMAC-SHA1 add input data
+ *
+ * @param     ctx: HMAC-SHA1 instance
+ * @param     input: Input data
+ * @param     len: Input data length
+ *
+ * @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Update fail
+ */
+int media_lib_hmac_sha1_update(media_lib_hmac_sha1_handle_t ctx, const uint8_t *input, size_t len);
+
+/**
+ * @brief     Get HMAC-SHA1 output, instance can be started again with new key after finish
+ *
+ * @param     ctx: HMAC-SHA1 instance
+ * @param     output: HMAC-SHA1 value
+ *
+ * @return
+ *              - 0: On success
+ *              - ESP_ERR_NOT_SUPPORTED: Wrapper function not registered
+ *              - Others: Finish fail
+ */
+int media_lib_hmac_sha1_finish(media_lib_hmac_sha1_handle_t ctx, uint8_t output[20]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,11 +38,32 @@ extern "C" {
  * @brief      Configuration for thread schedule
  */
 typedef struct {
-    uint8_t  priority;    /*!< Thread priority */
-    uint8_t  core_id;     /*!< CPU core id for thread to run */
-    uint32_t stack_size;  /*!< Thread reserve stack size */
+    uint8_t  priority;      /*!< Thread priority */
+    uint8_t  core_id;       /*!< CPU core id for thread to run */
+    uint32_t stack_size;    /*!< Thread reserve stack size */
+    bool     stack_in_ext;  /*!< Allow stack in external RAM (PSRAM), only take effect when platform supported */
 } media_lib_thread_cfg_t;
 
+/**
+ * @brief      Stack usage recorded for thread created by scheduler
+ */
+typedef struct {
+    uint32_t stack_size;    /*!< Stack size used when thread created */
+    uint32_t peak_used;     /*!< Maximum stack usage ever measured (high-water mark) */
+    bool     stack_in_ext;  /*!< Stack is allowed to put in external RAM */
+    bool     running;       /*!< Thread is still running */
+} media_lib_thread_stack_info_t;
+
+/**
+ * @brief      Statistics of pooled thread workers
+ */
+typedef struct {
+    uint32_t created;     /*!< Workers created since boot */
+    uint32_t reused;      /*!< Runs served by existing idle worker */
+    uint16_t worker_num;  /*!< Workers currently alive */
+    uint16_t idle_num;    /*!< Workers currently waiting for work */
+} media_lib_thread_pool_stats_t;
+
 /**
  * @brief      Callback to get thread schedule parameter
  */
@@ -149,9 +170,10 @@ int media_lib_thread_create(media_lib_thread_handle_t *handle, const char *name,
 void media_lib_thread_set_schedule_cb(media_lib_thread_sched_param_cb cb);
 
 /**
- * @brief      Create thread using schedule callback
+ * @brief      Create thread using schedule callback and loaded schedule profile
  *             NOTES: When callback is not set or not overwrote, it will use default setting
                       Default stack size is 4K, priority is 10, run on core 0
+                      Stack high-water mark of thread is recorded for later profile tuning
  * @param[out]    handle: Thread handle
  * @param         name: Thread name
  * @param         body: Thread body
@@ -162,6 +184,113 @@ void media_lib_thread_set_schedule_cb(media_lib_thread_sched_param_cb cb);
  */
 int media_lib_thread_create_from_scheduler(media_lib_thread_handle_t *handle, const char *name, void(*body)(void *arg), void *arg);
 
+/**
+ * @brief      Get final schedule setting for thread
+ *
+ * @note       Caller need prefill `thread_cfg` with default values
+ *             Schedule callback is applied firstly, then the matched entry in loaded profile (if any) overrides it
+ *             It is useful for modules which create thread by themselves but want to follow the same schedule setting
+ *
+ * @param         name: Thread name
+ * @param[in,out] thread_cfg: Thread schedule setting
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument
+ */
+int media_lib_thread_get_schedule_cfg(const char *name, media_lib_thread_cfg_t *thread_cfg);
+
+/**
+ * @brief      Load thread schedule profile from text
+ *
+ * @note       Each line describes one rule: `<pattern> <stack_size> <priority> <core_id> [int|ext]`
+ *               - pattern: Thread name, support wildcard `*` and `?`
+ *               - stack_size: Stack size in bytes, support suffix `k` (e.g. `20k`)
+ *               - int|ext: Put stack in internal RAM or external RAM (PSRAM)
+ *             Use `-` to keep original setting for any field, characters after `#` are treated as comment
+ *             Rules are matched in order, first matched one takes effect
+ *             Loading a new profile replaces the old one, recorded stack usage is kept
+ *             Example:
+ *               # pattern  stack  prio  core  mem
+ *               venc_0     20k    10    0     ext
+ *               aenc_*     40k    10    1
+ *               pc_task    25k    18    1     int
+ *
+ * @param         profile: Profile text (NULL terminated)
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument or syntax error
+ *                - ESP_ERR_NO_MEM: Not enough memory
+ */
+int media_lib_thread_load_profile(const char *profile);
+
+/**
+ * @brief      Clear loaded thread schedule profile
+ */
+void media_lib_thread_clear_profile(void);
+
+/**
+ * @brief      Get stack usage of thread created by scheduler
+ *
+ * @note       Stack high-water mark is sampled when thread destroyed or this API is called
+ *
+ * @param         name: Thread name
+ * @param[out]    info: Stack usage information
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument
+ *                - ESP_ERR_NOT_FOUND: Thread not recorded
+ */
+int media_lib_thread_get_stack_info(const char *name, media_lib_thread_stack_info_t *info);
+
+/**
+ * @brief      Dump thread schedule profile tightened by measured stack usage
+ *
+ * @note       Output has same syntax as `media_lib_thread_load_profile`, one line per recorded thread
+ *             Stack size is set to measured peak usage plus `margin` percent (aligned to 256 bytes)
+ *             Threads without measurement keep their original stack size
+ *
+ * @param            buf: Buffer to store profile text
+ * @param[in,out]     size: Buffer size as input, profile text length (excluding NULL terminator) as output
+ * @param             margin: Stack size margin in percent to add on peak usage
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument
+ *                - ESP_ERR_INVALID_SIZE: Buffer too small
+ */
+int media_lib_thread_dump_profile(char *buf, int *size, uint8_t margin);
+
+/**
+ * @brief      Run thread body on pooled worker
+ *
+ * @note       Idle worker created with same name is reused, otherwise new worker is created through
+ *             `media_lib_thread_create_from_scheduler` so schedule setting and stack record keep same
+ *             Worker waits for next run after body returns instead of being destroyed, so repeated
+ *             start and stop does not allocate and free thread stacks each time
+ *             Body must return when finished and must NOT call `media_lib_thread_destroy`
+ *
+ * @param[out]    handle: Worker thread handle (can be NULL)
+ * @param         name: Thread name
+ * @param         body: Thread body
+ * @param         arg: Thread argument
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument
+ *                - ESP_ERR_NO_MEM: Too many workers
+ *                - Others: Fail to create worker thread
+ */
+int media_lib_thread_create_pooled(media_lib_thread_handle_t *handle, const char *name, void(*body)(void *arg), void *arg);
+
+/**
+ * @brief      Release all pooled workers
+ *
+ * @note       Idle workers quit at once, busy workers quit after their body returns instead of waiting for reuse
+ */
+void media_lib_thread_pool_clear(void);
+
+/**
+ * @brief      Get pooled worker statistics
+ *
+ * @param[out]    stats: Statistics to store
+ * @return        - ESP_OK: On success
+ *                - ESP_ERR_INVALID_ARG: Invalid argument
+ */
+int media_lib_thread_pool_get_stats(media_lib_thread_pool_stats_t *stats);
+
 /**
  * @brief      Wrapper for thread destroy
  * @param         handle: Thread handle
@@ -257,6 +386,19 @@ int media_lib_mutex_unlock(media_lib_mutex_handle_t mutex);
  */
 int media_lib_mutex_destroy(media_lib_mutex_handle_t mutex);
 
+/**
+ * @brief      Create mutex only if not created yet
+ *
+ * @note       Safe to call from multiple threads concurrently, only one mutex is kept in `*mutex`
+ *             Used for lazily created module locks which have no dedicated init function
+ *
+ * @param[in,out]  mutex: Mutex handle storage, must be NULL initially
+ * @return       - 0: On success or mutex already created
+ *               - ESP_ERR_INVALID_ARG: Invalid argument
+ *               - Others: Mutex create fail
+ */
+int media_lib_mutex_create_once(media_lib_mutex_handle_t *mutex);
+
 /**
  * @brief      Wrapper for enter critical section
  * @return       - 0: On success
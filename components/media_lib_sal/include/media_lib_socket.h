@@ -212,6 +212,38 @@ int media_lib_socket_getsockopt(int s, int level, int optname, void *opval, sock
  */
 int media_lib_socket_getsockname(int s, struct sockaddr *name, socklen_t *namelen);
 
+/**
+ * @brief      Wrapper for batched sendmsg
+ *
+ * @note       Send multiple datagrams in one call to reduce per-packet socket overhead (e.g. RTP burst)
+ *             `msg_len` of each sent message is updated with bytes sent
+ *
+ * @param      s: Socket handle
+ * @param      msgvec: Array of messages to send
+ * @param      vlen: Number of messages
+ * @param      flags: Flags same as `sendmsg`
+ * @return     - >= 0: Number of messages sent
+ *             - -1: Fail to send first message, check `errno` for detail
+ *             - ESP_ERR_NOT_SUPPORTED: neither batched nor plain sendmsg wrapper registered
+ */
+int media_lib_socket_sendmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags);
+
+/**
+ * @brief      Wrapper for batched recvmsg
+ *
+ * @note       Only wait (when socket is blocking) for the first message, following messages are received only if ready
+ *             `msg_len` of each received message is updated with bytes received
+ *
+ * @param      s: Socket handle
+ * @param      msgvec: Array of messages to receive into
+ * @param      vlen: Number of messages
+ * @param      flags: Flags same as `recvmsg`
+ * @return     - >= 0: Number of messages received
+ *             - -1: Fail to receive first message, check `errno` for detail
+ *             - ESP_ERR_NOT_SUPPORTED: neither batched nor plain recvmsg wrapper registered
+ */
+int media_lib_socket_recvmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags);
+
 #ifdef __cplusplus
 }
 #endif
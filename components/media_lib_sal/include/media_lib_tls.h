@@ -79,6 +79,57 @@ int media_lib_tls_delete(media_lib_tls_handle_t tls);
  */
 int media_lib_tls_get_bytes_avail(media_lib_tls_handle_t tls);
 
+/**
+ * @brief      Create shared TLS configuration
+ *
+ * @note       CA chain, cipher suites and ALPN are prepared once and shared by all connections created from it
+ *             Buffers referenced by `cfg` must stay valid until the configuration is finally released
+ *             Returned handle has reference count 1
+ *
+ * @param      cfg: TLS client configuration
+ * @return     - NULL: Fail to create or wrapper function not registered
+ *             - Others: Shared TLS configuration handle
+ */
+media_lib_tls_cfg_handle_t media_lib_tls_cfg_create(const media_lib_tls_cfg_t *cfg);
+
+/**
+ * @brief      Add reference to shared TLS configuration
+ *
+ * @param      cfg: Shared TLS configuration handle
+ * @return     Input handle
+ */
+media_lib_tls_cfg_handle_t media_lib_tls_cfg_ref(media_lib_tls_cfg_handle_t cfg);
+
+/**
+ * @brief      Release reference of shared TLS configuration, destroyed when no reference left
+ *
+ * @param      cfg: Shared TLS configuration handle
+ */
+void media_lib_tls_cfg_unref(media_lib_tls_cfg_handle_t cfg);
+
+/**
+ * @brief      Create tls client instance use shared TLS configuration
+ *
+ * @note       Connection holds a reference of `cfg` until deleted
+ *
+ * @return     - NULL: Fail to create or wrapper function not registered
+ *             - Others: TLS handle
+ */
+media_lib_tls_handle_t media_lib_tls_new_with_cfg(const char *hostname, int hostlen, int port, media_lib_tls_cfg_handle_t cfg);
+
+/**
+ * @brief      Get TLS client statistics (session cache hit and miss, handshake duration)
+ * @return     - ESP_OK: On success
+ *             - ESP_ERR_INVALID_ARG: Invalid argument
+ *             - ESP_ERR_NOT_SUPPORTED: wrapper function not registered
+ */
+int media_lib_tls_get_stats(media_lib_tls_stats_t *stats);
+
+/**
+ * @brief      Clear TLS client session cache
+ */
+void media_lib_tls_clear_sessions(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -69,6 +70,44 @@ typedef struct {
     __media_lib_aes_crypt_cbc     aes_crypt_cbc;   /*!< AES-CBC encrypt/decrypt */
 } media_lib_crypt_t;
 
+typedef int (*__media_lib_aes_crypt_ctr)(media_lib_aes_handle_t ctx, size_t size, size_t *nc_off,
+                                        uint8_t nonce_counter[16], uint8_t stream_block[16],
+                                        const uint8_t *input, uint8_t *output);
+
+typedef void* media_lib_gcm_handle_t;
+typedef void (*__media_lib_gcm_init)(media_lib_gcm_handle_t *ctx);
+typedef void (*__media_lib_gcm_free)(media_lib_gcm_handle_t ctx);
+typedef int (*__media_lib_gcm_set_key)(media_lib_gcm_handle_t ctx, const uint8_t *key, uint16_t key_bits);
+typedef int (*__media_lib_gcm_start)(media_lib_gcm_handle_t ctx, bool decrypt_mode, const uint8_t *iv, size_t iv_len,
+                                     const uint8_t *aad, size_t aad_len);
+typedef int (*__media_lib_gcm_update)(media_lib_gcm_handle_t ctx, const uint8_t *input, size_t size, uint8_t *output);
+typedef int (*__media_lib_gcm_finish)(media_lib_gcm_handle_t ctx, uint8_t *tag, size_t tag_len);
+
+typedef void* media_lib_hmac_sha1_handle_t;
+typedef void (*__media_lib_hmac_sha1_init)(media_lib_hmac_sha1_handle_t *ctx);
+typedef void (*__media_lib_hmac_sha1_free)(media_lib_hmac_sha1_handle_t ctx);
+typedef int (*__media_lib_hmac_sha1_start)(media_lib_hmac_sha1_handle_t ctx, const uint8_t *key, size_t key_len);
+typedef int (*__media_lib_hmac_sha1_update)(media_lib_hmac_sha1_handle_t ctx, const uint8_t *input, size_t len);
+typedef int (*__media_lib_hmac_sha1_finish)(media_lib_hmac_sha1_handle_t ctx, uint8_t output[20]);
+
+/**
+ * @brief  Cipher wrapper functions used by SRTP and DTLS
+ */
+typedef struct {
+    __media_lib_aes_crypt_ctr     aes_crypt_ctr;      /*!< AES-CTR streaming encrypt/decrypt, use AES instance */
+    __media_lib_gcm_init          gcm_init;           /*!< AES-GCM lib init */
+    __media_lib_gcm_free          gcm_free;           /*!< AES-GCM lib free */
+    __media_lib_gcm_set_key       gcm_set_key;        /*!< AES-GCM set key */
+    __media_lib_gcm_start         gcm_start;          /*!< AES-GCM start with IV and additional data */
+    __media_lib_gcm_update        gcm_update;         /*!< AES-GCM encrypt/decrypt data */
+    __media_lib_gcm_finish        gcm_finish;         /*!< AES-GCM get authentication tag */
+    __media_lib_hmac_sha1_init    hmac_sha1_init;     /*!< HMAC-SHA1 lib init */
+    __media_lib_hmac_sha1_free    hmac_sha1_free;     /*!< HMAC-SHA1 lib free */
+    __media_lib_hmac_sha1_start   hmac_sha1_start;    /*!< HMAC-SHA1 start with key */
+    __media_lib_hmac_sha1_update  hmac_sha1_update;   /*!< HMAC-SHA1 add data */
+    __media_lib_hmac_sha1_finish  hmac_sha1_finish;   /*!< Get HMAC-SHA1 value */
+} media_lib_cipher_t;
+
 /**
  * @brief     Register Crypt related wrapper functions for media library
  *
@@ -80,6 +119,20 @@ typedef struct {
 */
 esp_err_t media_lib_crypt_register(media_lib_crypt_t *crypt_lib);
 
+/**
+ * @brief     Register cipher related wrapper functions for media library
+ *
+ * @note      Registered separately from `media_lib_crypt_t` so that existing crypt registration keeps working
+ *            Use it to route SRTP and DTLS ciphers to hardware accelerators or measure them
+ *
+ * @param      cipher_lib  Cipher wrapper function lists
+ *
+ * @return
+ *             - ESP_OK: on success
+ *             - ESP_ERR_INVALID_ARG: some members of cipher lib not set
+ */
+esp_err_t media_lib_cipher_register(media_lib_cipher_t *cipher_lib);
+
 #ifdef __cplusplus
 }
 #endif
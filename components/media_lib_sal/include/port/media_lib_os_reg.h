@@ -49,6 +49,10 @@ typedef int (*__media_lib_os_thread_create)(media_lib_thread_handle_t *handle, c
 typedef void (*__media_lib_os_thread_destroy)(media_lib_thread_handle_t handle);
 typedef bool (*__media_lib_os_thread_set_priority)(media_lib_thread_handle_t handle, int prio);
 typedef void (*__media_lib_os_thread_sleep)(uint32_t ms);
+typedef int (*__media_lib_os_thread_create_ex)(media_lib_thread_handle_t *handle, const char *name, void(*body)(void *arg), void *arg,
+                                              uint32_t stack_size, int prio, int core, bool stack_in_ext);
+typedef media_lib_thread_handle_t (*__media_lib_os_thread_get_self)(void);
+typedef uint32_t (*__media_lib_os_thread_get_stack_free)(media_lib_thread_handle_t handle);
 
 typedef void *media_lib_sema_handle_t;
 typedef int (*__media_lib_os_sema_create)(media_lib_sema_handle_t *sema);
@@ -108,6 +112,12 @@ typedef struct {
     __media_lib_os_event_group_clr_bits    group_clr_bits;      /*!< event group clear bits  wrapper */
     __media_lib_os_event_group_wait_bits   group_wait_bits;     /*!< event group wait for bits wrapper */
     __media_lib_os_event_group_destroy     group_destroy;       /*!< event group destroy wrapper */
+
+    /* Optional wrappers, can be NULL */
+    __media_lib_os_thread_create_ex        thread_create_ex;    /*!< thread create with stack location wrapper
+                                                                     fallback to `thread_create` if NULL */
+    __media_lib_os_thread_get_self         thread_get_self;     /*!< get current thread handle wrapper */
+    __media_lib_os_thread_get_stack_free   thread_stack_free;   /*!< get minimum free stack (bytes) ever reached, NULL for self */
 } media_lib_os_t;
 
 /**
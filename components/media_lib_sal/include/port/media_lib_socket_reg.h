@@ -40,6 +40,16 @@ typedef struct {
     int tv_usec;
 } media_lib_timeval;
 
+/**
+ * @brief      Message header for batched send and receive
+ *
+ * @note       Layout is same as `struct mmsghdr` on Linux, so that port can map to native `sendmmsg` and `recvmmsg`
+ */
+typedef struct {
+    struct msghdr msg_hdr;  /*!< Message header */
+    unsigned int  msg_len;  /*!< Number of bytes transmitted or received for this message */
+} media_lib_mmsghdr_t;
+
 typedef int (*__media_lib_socket_accept)(int s, struct sockaddr *addr, socklen_t *addrlen);
 typedef int (*__media_lib_socket_bind)(int s, const struct sockaddr *name, socklen_t namelen);
 typedef int (*__media_lib_socket_shutdown)(int s, int how);
@@ -65,6 +75,8 @@ typedef int (*__media_lib_socket_inet_pton)(int af, const char *src, void *dst);
 typedef int (*__media_lib_socket_setsockopt)(int s, int level, int optname, const void *opval, socklen_t optlen);
 typedef int (*__media_lib_socket_getsockopt)(int s, int level, int optname, void *opval, socklen_t *optlen);
 typedef int (*__media_lib_socket_getsockname)(int s, struct sockaddr *name, socklen_t *namelen);
+typedef int (*__media_lib_socket_sendmmsg)(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags);
+typedef int (*__media_lib_socket_recvmmsg)(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags);
 
 /**
  * @brief      Socket Wrapper Functions Group
@@ -78,7 +90,7 @@ typedef struct {
     __media_lib_socket_listen      sock_listen;      /*!< Socket listen Func Pointer */
     __media_lib_socket_recv        sock_recv;        /*!< Socket recv Func Pointer */
     __media_lib_socket_read        sock_read;        /*!< Socket read Func Pointer */
-    __media_lib_socket_readv       sock_readv;       /*!< Socket readb Func Pointer */
+    __media_lib_socket_readv       sock_readv;       /*!< Socket readv Func Pointer */
     __media_lib_socket_recvfrom    sock_recvfrom;    /*!< Socket recvfrom Func Pointer */
     __media_lib_socket_recvmsg     sock_recvmsg;     /*!< Socket recvmsg Func Pointer */
     __media_lib_socket_send        sock_send;        /*!< Socket send Func Pointer */
@@ -95,6 +107,10 @@ typedef struct {
     __media_lib_socket_setsockopt  sock_setsockopt;  /*!< Socket setspckopt Func Pointer */
     __media_lib_socket_getsockopt  sock_getsockopt;  /*!< Socket getsockopt Func Pointer */
     __media_lib_socket_getsockname sock_getsockname; /*!< Socket getsockname Func Pointer */
+
+    /* Optional functions, can be NULL */
+    __media_lib_socket_sendmmsg    sock_sendmmsg;    /*!< Socket batched sendmsg Func Pointer, loop `sock_sendmsg` if NULL */
+    __media_lib_socket_recvmmsg    sock_recvmmsg;    /*!< Socket batched recvmsg Func Pointer, loop `sock_recvmsg` if NULL */
 } media_lib_socket_t;
 
 /**
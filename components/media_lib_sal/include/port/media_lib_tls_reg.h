@@ -46,8 +46,24 @@ typedef struct {
     bool        use_global_ca_store;      /*!< Use a global ca_store for all the connections */
     bool        skip_common_name;         /*!< Skip any validation of server certificate CN field */
     int (*crt_bundle_attach)(void *conf); /*!< Function pointer to esp_crt_bundle_attach */
+    const char **alpn_protos;             /*!< Application protocols (NULL terminated list), NULL to disable ALPN */
+    const int   *ciphersuites_list;       /*!< Cipher suites (0 terminated list), NULL to use default */
+    bool         resume_session;          /*!< Resume session from client session cache keyed by hostname and port */
 } media_lib_tls_cfg_t;
 
+/**
+ * @brief      TLS client statistics
+ */
+typedef struct {
+    uint32_t session_hits;       /*!< Connections which offered a cached session for resumption */
+    uint32_t session_misses;     /*!< Connections which want resumption but no cached session found */
+    uint32_t handshake_count;    /*!< Successful client handshakes */
+    uint32_t handshake_fail;     /*!< Failed client handshakes */
+    uint32_t handshake_last_ms;  /*!< Duration of last successful handshake (including TCP connect) */
+    uint32_t handshake_max_ms;   /*!< Maximum handshake duration */
+    uint64_t handshake_total_ms; /*!< Total duration of successful handshakes */
+} media_lib_tls_stats_t;
+
 typedef struct {
     const char *cacert_buf;             /*!< Client CA certificate in a buffer */
     int         cacert_bytes;           /*!< Size of client CA certificate */
@@ -68,6 +84,13 @@ typedef int (*__media_lib_tls_read)(media_lib_tls_handle_t tls, void *data, size
 typedef int (*__media_lib_tls_getsockfd)(media_lib_tls_handle_t tls);
 typedef int (*__media_lib_tls_delete)(media_lib_tls_handle_t tls);
 typedef int (*__media_lib_tls_get_bytes_avail)(media_lib_tls_handle_t tls);
+typedef void *media_lib_tls_cfg_handle_t;
+typedef media_lib_tls_cfg_handle_t (*__media_lib_tls_cfg_create)(const media_lib_tls_cfg_t *cfg);
+typedef media_lib_tls_cfg_handle_t (*__media_lib_tls_cfg_ref)(media_lib_tls_cfg_handle_t cfg);
+typedef void (*__media_lib_tls_cfg_unref)(media_lib_tls_cfg_handle_t cfg);
+typedef media_lib_tls_handle_t (*__media_lib_tls_new_with_cfg)(const char *hostname, int hostlen, int port, media_lib_tls_cfg_handle_t cfg);
+typedef int (*__media_lib_tls_get_stats)(media_lib_tls_stats_t *stats);
+typedef void (*__media_lib_tls_clear_sessions)(void);
 
 typedef struct {
     __media_lib_tls_new             tls_new;             /*!< tls lib new */
@@ -79,6 +102,18 @@ typedef struct {
     __media_lib_tls_get_bytes_avail tls_get_bytes_avail; /*!< tls lib get bytes avail */
 } media_lib_tls_t;
 
+/**
+ * @brief  TLS extended wrapper functions for shared configuration and client session cache
+ */
+typedef struct {
+    __media_lib_tls_cfg_create      tls_cfg_create;      /*!< tls lib create refcounted shared configuration (parse CA etc once) */
+    __media_lib_tls_cfg_ref         tls_cfg_ref;         /*!< tls lib add reference of shared configuration */
+    __media_lib_tls_cfg_unref       tls_cfg_unref;       /*!< tls lib release reference of shared configuration */
+    __media_lib_tls_new_with_cfg    tls_new_with_cfg;    /*!< tls lib new client use shared configuration */
+    __media_lib_tls_get_stats       tls_get_stats;       /*!< tls lib get client statistics */
+    __media_lib_tls_clear_sessions  tls_clear_sessions;  /*!< tls lib clear client session cache */
+} media_lib_tls_ext_t;
+
 /**
  * @brief     Register tls related wrapper functions for media library
  *
@@ -90,6 +125,20 @@ typedef struct {
  */
 esp_err_t media_lib_tls_register(media_lib_tls_t *tls_lib);
 
+/**
+ * @brief     Register tls extended wrapper functions for media library
+ *
+ * @note      Registered separately from `media_lib_tls_t` so that existing tls registration keeps working
+ *            Extended APIs return fail or do nothing if not registered
+ *
+ * @param      tls_ext_lib  tls extended wrapper function lists
+ *
+ * @return
+ *             - ESP_OK: on success
+ *             - ESP_ERR_INVALID_ARG: some members of tls extended lib not set
+ */
+esp_err_t media_lib_tls_ext_register(media_lib_tls_ext_t *tls_ext_lib);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,12 +31,18 @@
 
 #ifdef CONFIG_MEDIA_PROTOCOL_LIB_ENABLE
 static media_lib_crypt_t media_crypt_lib;
+static media_lib_cipher_t media_cipher_lib;
 
 esp_err_t media_lib_crypt_register(media_lib_crypt_t *crypt_lib)
 {
     MEDIA_LIB_DEFAULT_INSTALLER(crypt_lib, &media_crypt_lib, media_lib_crypt_t);
 }
 
+esp_err_t media_lib_cipher_register(media_lib_cipher_t *cipher_lib)
+{
+    MEDIA_LIB_DEFAULT_INSTALLER(cipher_lib, &media_cipher_lib, media_lib_cipher_t);
+}
+
 void media_lib_md5_init(media_lib_md5_handle_t *ctx)
 {
     if (media_crypt_lib.md5_init) {
@@ -130,7 +136,7 @@ void media_lib_aes_free(media_lib_aes_handle_t ctx)
 int media_lib_aes_set_key(media_lib_aes_handle_t ctx, uint8_t *key, uint8_t key_bits)
 {
     if (media_crypt_lib.aes_set_key) {
-        media_crypt_lib.aes_set_key(ctx, key, key_bits);
+        return media_crypt_lib.aes_set_key(ctx, key, key_bits);
     }
     return ESP_ERR_NOT_SUPPORTED;
 }
@@ -138,7 +144,101 @@ int media_lib_aes_set_key(media_lib_aes_handle_t ctx, uint8_t *key, uint8_t key_
 int media_lib_aes_crypt_cbc(media_lib_aes_handle_t ctx, bool decrypt_mode, uint8_t iv[16], uint8_t *input, size_t size, uint8_t *output)
 {
     if (media_crypt_lib.aes_crypt_cbc) {
-        media_crypt_lib.aes_crypt_cbc(ctx, decrypt_mode, iv, input, size, output);
+        return media_crypt_lib.aes_crypt_cbc(ctx, decrypt_mode, iv, input, size, output);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_aes_crypt_ctr(media_lib_aes_handle_t ctx, size_t size, size_t *nc_off, uint8_t nonce_counter[16],
+                            uint8_t stream_block[16], const uint8_t *input, uint8_t *output)
+{
+    if (media_cipher_lib.aes_crypt_ctr) {
+        return media_cipher_lib.aes_crypt_ctr(ctx, size, nc_off, nonce_counter, stream_block, input, output);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void media_lib_gcm_init(media_lib_gcm_handle_t *ctx)
+{
+    if (media_cipher_lib.gcm_init) {
+        media_cipher_lib.gcm_init(ctx);
+    }
+}
+
+void media_lib_gcm_free(media_lib_gcm_handle_t ctx)
+{
+    if (media_cipher_lib.gcm_free) {
+        media_cipher_lib.gcm_free(ctx);
+    }
+}
+
+int media_lib_gcm_set_key(media_lib_gcm_handle_t ctx, const uint8_t *key, uint16_t key_bits)
+{
+    if (media_cipher_lib.gcm_set_key) {
+        return media_cipher_lib.gcm_set_key(ctx, key, key_bits);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_gcm_start(media_lib_gcm_handle_t ctx, bool decrypt_mode, const uint8_t *iv, size_t iv_len,
+                        const uint8_t *aad, size_t aad_len)
+{
+    if (media_cipher_lib.gcm_start) {
+        return media_cipher_lib.gcm_start(ctx, decrypt_mode, iv, iv_len, aad, aad_len);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_gcm_update(media_lib_gcm_handle_t ctx, const uint8_t *input, size_t size, uint8_t *output)
+{
+    if (media_cipher_lib.gcm_update) {
+        return media_cipher_lib.gcm_update(ctx, input, size, output);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_gcm_finish(media_lib_gcm_handle_t ctx, uint8_t *tag, size_t tag_len)
+{
+    if (media_cipher_lib.gcm_finish) {
+        return media_cipher_lib.gcm_finish(ctx, tag, tag_len);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void media_lib_hmac_sha1_init(media_lib_hmac_sha1_handle_t *ctx)
+{
+    if (media_cipher_lib.hmac_sha1_init) {
+        media_cipher_lib.hmac_sha1_init(ctx);
+    }
+}
+
+void media_lib_hmac_sha1_free(media_lib_hmac_sha1_handle_t ctx)
+{
+    if (media_cipher_lib.hmac_sha1_free) {
+        media_cipher_lib.hmac_sha1_free(ctx);
+    }
+}
+
+int media_lib_hmac_sha1_start(media_lib_hmac_sha1_handle_t ctx, const uint8_t *key, size_t key_len)
+{
+    if (media_cipher_lib.hmac_sha1_start) {
+        return media_cipher_lib.hmac_sha1_start(ctx, key, key_len);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_hmac_sha1_update(media_lib_hmac_sha1_handle_t ctx, const uint8_t *input, size_t len)
+{
+    if (media_cipher_lib.hmac_sha1_update) {
+        return media_cipher_lib.hmac_sha1_update(ctx, input, len);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int media_lib_hmac_sha1_finish(media_lib_hmac_sha1_handle_t ctx, uint8_t output[20])
+{
+    if (media_cipher_lib.hmac_sha1_finish) {
+        return media_cipher_lib.hmac_sha1_finish(ctx, output);
     }
     return ESP_ERR_NOT_SUPPORTED;
 }
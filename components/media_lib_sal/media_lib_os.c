@@ -25,6 +25,10 @@
  */
 
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include "media_lib_os_reg.h"
 #include "media_lib_common.h"
 #include "media_lib_os.h"
@@ -34,13 +38,60 @@
 #define MEDIA_LIB_DEFAULT_THREAD_CORE 0
 #define MEDIA_LIB_DEFAULT_THREAD_PRIORITY 10
 #define MEDIA_LIB_DEFAULT_THREAD_STACK_SIZE (4*1024)
+#define MEDIA_LIB_DEFAULT_STACK_IN_EXT      true
+
+#define THREAD_PATTERN_MAX_LEN   (32)
+#define THREAD_RECORD_MAX_NUM    (32)
+#define THREAD_STACK_ALIGN       (256)
+#define PROFILE_FIELD_KEEP       (-1)
+#define THREAD_WORKER_MAX_NUM    (16)
+
+typedef struct {
+    char     pattern[THREAD_PATTERN_MAX_LEN];
+    int32_t  stack_size;
+    int16_t  priority;
+    int16_t  core_id;
+    int8_t   stack_in_ext;
+} thread_profile_rule_t;
+
+typedef struct {
+    char                      name[THREAD_PATTERN_MAX_LEN];
+    media_lib_thread_handle_t handle;
+    media_lib_thread_cfg_t    cfg;
+    uint32_t                  peak_used;
+} thread_stack_record_t;
+
+typedef struct {
+    char                      name[THREAD_PATTERN_MAX_LEN];
+    media_lib_thread_handle_t thread;
+    media_lib_sema_handle_t   sema;
+    void                    (*body)(void *arg);
+    void                     *arg;
+    bool                      busy;
+    bool                      quit;
+} thread_worker_t;
 
 static media_lib_os_t media_os_lib;
 static media_lib_thread_sched_param_cb thread_sched_cb;
 
+static media_lib_mutex_handle_t thread_sched_lock;
+static thread_profile_rule_t   *profile_rules;
+static int                      profile_rule_num;
+static thread_stack_record_t    thread_records[THREAD_RECORD_MAX_NUM];
+static thread_worker_t          thread_workers[THREAD_WORKER_MAX_NUM];
+static media_lib_thread_pool_stats_t thread_pool_stats;
+
 esp_err_t media_lib_os_register(media_lib_os_t *os_lib)
 {
-    MEDIA_LIB_DEFAULT_INSTALLER(os_lib, &media_os_lib, media_lib_os_t);
+    // Wrappers after `group_destroy` are optional
+    if (media_lib_verify(os_lib, offsetof(media_lib_os_t, thread_create_ex)) == false) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(&media_os_lib, os_lib, sizeof(media_lib_os_t));
+    if (thread_sched_lock == NULL) {
+        media_lib_mutex_create(&thread_sched_lock);
+    }
+    return ESP_OK;
 }
 
 int media_lib_get_mem_lib(media_lib_mem_t* mem_lib)
@@ -172,27 +223,515 @@ int media_lib_thread_create(media_lib_thread_handle_t *handle, const char *name,
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+static void thread_sched_lock_acquire(void)
+{
+    if (thread_sched_lock) {
+        media_lib_mutex_lock(thread_sched_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+}
+
+static void thread_sched_lock_release(void)
+{
+    if (thread_sched_lock) {
+        media_lib_mutex_unlock(thread_sched_lock);
+    }
+}
+
+static bool thread_name_match(const char *pattern, const char *name)
+{
+    // Simple glob match only support `*` and `?`
+    const char *star = NULL;
+    const char *back = NULL;
+    while (*name) {
+        if (*pattern == '?' || *pattern == *name) {
+            pattern++;
+            name++;
+        } else if (*pattern == '*') {
+            star = pattern++;
+            back = name;
+        } else if (star) {
+            pattern = star + 1;
+            name = ++back;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') {
+        pattern++;
+    }
+    return *pattern == '\0';
+}
+
+static thread_stack_record_t *thread_record_find(const char *name, media_lib_thread_handle_t handle)
+{
+    for (int i = 0; i < THREAD_RECORD_MAX_NUM; i++) {
+        thread_stack_record_t *record = &thread_records[i];
+        if (record->name[0] == '\0') {
+            continue;
+        }
+        if (name && strcmp(record->name, name) == 0) {
+            return record;
+        }
+        if (name == NULL && handle && record->handle == handle) {
+            return record;
+        }
+    }
+    return NULL;
+}
+
+static void thread_record_sample(thread_stack_record_t *record)
+{
+    if (record->handle == NULL || media_os_lib.thread_stack_free == NULL) {
+        return;
+    }
+    uint32_t stack_free = media_os_lib.thread_stack_free(record->handle);
+    if (stack_free <= record->cfg.stack_size) {
+        uint32_t used = record->cfg.stack_size - stack_free;
+        if (used > record->peak_used) {
+            record->peak_used = used;
+        }
+    }
+}
+
+static void thread_record_add(const char *name, media_lib_thread_handle_t handle, media_lib_thread_cfg_t *cfg)
+{
+    thread_stack_record_t *record = thread_record_find(name, NULL);
+    if (record == NULL) {
+        for (int i = 0; i < THREAD_RECORD_MAX_NUM; i++) {
+            if (thread_records[i].name[0] == '\0') {
+                record = &thread_records[i];
+                strncpy(record->name, name, THREAD_PATTERN_MAX_LEN - 1);
+                break;
+            }
+        }
+        if (record == NULL) {
+            return;
+        }
+    }
+    // Peak usage only comparable under same stack size
+    if (record->cfg.stack_size != cfg->stack_size) {
+        record->peak_used = 0;
+    }
+    record->handle = handle;
+    record->cfg = *cfg;
+}
+
+static void thread_profile_apply(const char *name, media_lib_thread_cfg_t *thread_cfg)
+{
+    for (int i = 0; i < profile_rule_num; i++) {
+        thread_profile_rule_t *rule = &profile_rules[i];
+        if (thread_name_match(rule->pattern, name) == false) {
+            continue;
+        }
+        if (rule->stack_size != PROFILE_FIELD_KEEP) {
+            thread_cfg->stack_size = (uint32_t)rule->stack_size;
+        }
+        if (rule->priority != PROFILE_FIELD_KEEP) {
+            thread_cfg->priority = (uint8_t)rule->priority;
+        }
+        if (rule->core_id != PROFILE_FIELD_KEEP) {
+            thread_cfg->core_id = (uint8_t)rule->core_id;
+        }
+        if (rule->stack_in_ext != PROFILE_FIELD_KEEP) {
+            thread_cfg->stack_in_ext = (bool)rule->stack_in_ext;
+        }
+        break;
+    }
+}
+
+int media_lib_thread_get_schedule_cfg(const char *name, media_lib_thread_cfg_t *thread_cfg)
+{
+    if (name == NULL || thread_cfg == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (thread_sched_cb) {
+        thread_sched_cb(name, thread_cfg);
+    }
+    thread_sched_lock_acquire();
+    thread_profile_apply(name, thread_cfg);
+    thread_sched_lock_release();
+    return ESP_OK;
+}
+
+static int profile_parse_field(const char *field, int32_t *value, bool is_size)
+{
+    if (strcmp(field, "-") == 0) {
+        *value = PROFILE_FIELD_KEEP;
+        return ESP_OK;
+    }
+    char *end = NULL;
+    long v = strtol(field, &end, 0);
+    if (end == field || v < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (is_size && (*end == 'k' || *end == 'K')) {
+        v *= 1024;
+        end++;
+    }
+    if (*end != '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *value = (int32_t)v;
+    return ESP_OK;
+}
+
+static int profile_parse_line(char *line, thread_profile_rule_t *rule, bool *is_rule)
+{
+    char *fields[5] = { NULL };
+    int n = 0;
+    char *comment = strchr(line, '#');
+    if (comment) {
+        *comment = '\0';
+    }
+    char *p = line;
+    while (*p && n < 5) {
+        while (*p && isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        fields[n++] = p;
+        while (*p && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (*p) {
+            *p++ = '\0';
+        }
+    }
+    *is_rule = false;
+    if (n == 0) {
+        // Empty or comment line
+        return ESP_OK;
+    }
+    if (n < 4 || strlen(fields[0]) >= THREAD_PATTERN_MAX_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int32_t stack_size, priority, core_id;
+    if (profile_parse_field(fields[1], &stack_size, true) != ESP_OK ||
+        profile_parse_field(fields[2], &priority, false) != ESP_OK ||
+        profile_parse_field(fields[3], &core_id, false) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (priority > UINT8_MAX || core_id > UINT8_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(rule->pattern, fields[0]);
+    rule->stack_size = stack_size;
+    rule->priority = (int16_t)priority;
+    rule->core_id = (int16_t)core_id;
+    rule->stack_in_ext = PROFILE_FIELD_KEEP;
+    if (fields[4]) {
+        if (strcmp(fields[4], "ext") == 0) {
+            rule->stack_in_ext = 1;
+        } else if (strcmp(fields[4], "int") == 0) {
+            rule->stack_in_ext = 0;
+        } else if (strcmp(fields[4], "-") != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    *is_rule = true;
+    return ESP_OK;
+}
+
+int media_lib_thread_load_profile(const char *profile)
+{
+    if (profile == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Count lines to allocate rules once
+    int max_rules = 1;
+    for (const char *p = profile; *p; p++) {
+        if (*p == '\n') {
+            max_rules++;
+        }
+    }
+    char *text = media_lib_strdup(profile);
+    thread_profile_rule_t *rules = (thread_profile_rule_t *)media_lib_calloc(max_rules, sizeof(thread_profile_rule_t));
+    if (text == NULL || rules == NULL) {
+        media_lib_free(text);
+        media_lib_free(rules);
+        return ESP_ERR_NO_MEM;
+    }
+    int rule_num = 0;
+    int ret = ESP_OK;
+    char *line = text;
+    while (line) {
+        char *next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        bool is_rule = false;
+        ret = profile_parse_line(line, &rules[rule_num], &is_rule);
+        if (ret != ESP_OK) {
+            break;
+        }
+        if (is_rule) {
+            rule_num++;
+        }
+        line = next;
+    }
+    media_lib_free(text);
+    if (ret != ESP_OK) {
+        media_lib_free(rules);
+        return ret;
+    }
+    thread_sched_lock_acquire();
+    media_lib_free(profile_rules);
+    profile_rules = rules;
+    profile_rule_num = rule_num;
+    thread_sched_lock_release();
+    return ESP_OK;
+}
+
+void media_lib_thread_clear_profile(void)
+{
+    thread_sched_lock_acquire();
+    media_lib_free(profile_rules);
+    profile_rules = NULL;
+    profile_rule_num = 0;
+    thread_sched_lock_release();
+}
+
+int media_lib_thread_get_stack_info(const char *name, media_lib_thread_stack_info_t *info)
+{
+    if (name == NULL || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int ret = ESP_ERR_NOT_FOUND;
+    thread_sched_lock_acquire();
+    thread_stack_record_t *record = thread_record_find(name, NULL);
+    if (record) {
+        thread_record_sample(record);
+        info->stack_size = record->cfg.stack_size;
+        info->peak_used = record->peak_used;
+        info->stack_in_ext = record->cfg.stack_in_ext;
+        info->running = (record->handle != NULL);
+        ret = ESP_OK;
+    }
+    thread_sched_lock_release();
+    return ret;
+}
+
+int media_lib_thread_dump_profile(char *buf, int *size, uint8_t margin)
+{
+    if (buf == NULL || size == NULL || *size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int len = 0;
+    int ret = ESP_OK;
+    buf[0] = '\0';
+    thread_sched_lock_acquire();
+    for (int i = 0; i < THREAD_RECORD_MAX_NUM; i++) {
+        thread_stack_record_t *record = &thread_records[i];
+        if (record->name[0] == '\0') {
+            continue;
+        }
+        thread_record_sample(record);
+        uint32_t stack_size = record->cfg.stack_size;
+        if (record->peak_used) {
+            stack_size = record->peak_used + record->peak_used * margin / 100;
+            stack_size = (stack_size + THREAD_STACK_ALIGN - 1) & ~(THREAD_STACK_ALIGN - 1);
+        }
+        int n = snprintf(buf + len, *size - len, "%-16s %-6u %-4u %-4u %s\n", record->name,
+                         (unsigned)stack_size, record->cfg.priority, record->cfg.core_id,
+                         record->cfg.stack_in_ext ? "ext" : "int");
+        if (n < 0 || n >= *size - len) {
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        len += n;
+    }
+    thread_sched_lock_release();
+    if (ret == ESP_OK) {
+        *size = len;
+    }
+    return ret;
+}
+
 int media_lib_thread_create_from_scheduler(media_lib_thread_handle_t *handle, const char *name, void(*body)(void *arg), void *arg)
 {
     media_lib_thread_cfg_t thread_cfg = {
         .core_id = MEDIA_LIB_DEFAULT_THREAD_CORE,
         .priority = MEDIA_LIB_DEFAULT_THREAD_PRIORITY,
         .stack_size = MEDIA_LIB_DEFAULT_THREAD_STACK_SIZE,
+        .stack_in_ext = MEDIA_LIB_DEFAULT_STACK_IN_EXT,
     };
-    if (thread_sched_cb) {
-        thread_sched_cb(name, &thread_cfg);
+    media_lib_thread_get_schedule_cfg(name, &thread_cfg);
+    if (media_os_lib.thread_create_ex == NULL && media_os_lib.thread_create == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    media_lib_thread_handle_t thread = NULL;
+    // Hold lock so that thread exit immediately can still find its record
+    thread_sched_lock_acquire();
+    int ret;
+    if (media_os_lib.thread_create_ex) {
+        ret = media_os_lib.thread_create_ex(&thread, name, body, arg, thread_cfg.stack_size,
+                                            thread_cfg.priority, thread_cfg.core_id, thread_cfg.stack_in_ext);
+    } else {
+        // Port without stack location support, stack placed where port decides
+        ret = media_os_lib.thread_create(&thread, name, body, arg, thread_cfg.stack_size,
+                                         thread_cfg.priority, thread_cfg.core_id);
+    }
+    if (ret == ESP_OK && thread) {
+        thread_record_add(name, thread, &thread_cfg);
+    }
+    thread_sched_lock_release();
+    if (handle) {
+        *handle = thread;
     }
-    return media_lib_thread_create(handle, name, body, arg,
-                      thread_cfg.stack_size, thread_cfg.priority, thread_cfg.core_id);
+    return ret;
 }
 
 void media_lib_thread_destroy(media_lib_thread_handle_t handle)
 {
+    media_lib_thread_handle_t self = handle;
+    if (self == NULL && media_os_lib.thread_get_self) {
+        self = media_os_lib.thread_get_self();
+    }
+    if (self) {
+        thread_sched_lock_acquire();
+        thread_stack_record_t *record = thread_record_find(NULL, self);
+        if (record) {
+            thread_record_sample(record);
+            record->handle = NULL;
+        }
+        thread_sched_lock_release();
+    }
     if (media_os_lib.thread_destroy) {
         media_os_lib.thread_destroy(handle);
     }
 }
 
+static void thread_worker_body(void *arg)
+{
+    thread_worker_t *worker = (thread_worker_t *)arg;
+    while (1) {
+        media_lib_sema_lock(worker->sema, MEDIA_LIB_MAX_LOCK_TIME);
+        if (worker->quit) {
+            break;
+        }
+        worker->body(worker->arg);
+        thread_sched_lock_acquire();
+        // Sample after each run since pooled worker is rarely destroyed
+        thread_stack_record_t *record = thread_record_find(NULL, worker->thread);
+        if (record) {
+            thread_record_sample(record);
+        }
+        worker->body = NULL;
+        worker->arg = NULL;
+        worker->busy = false;
+        bool quit = worker->quit;
+        thread_sched_lock_release();
+        if (quit) {
+            // Pool cleared while running, release instead of waiting for reuse
+            break;
+        }
+    }
+    thread_sched_lock_acquire();
+    media_lib_sema_destroy(worker->sema);
+    memset(worker, 0, sizeof(thread_worker_t));
+    thread_sched_lock_release();
+    media_lib_thread_destroy(NULL);
+}
+
+int media_lib_thread_create_pooled(media_lib_thread_handle_t *handle, const char *name, void(*body)(void *arg), void *arg)
+{
+    if (name == NULL || body == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    thread_worker_t *worker = NULL;
+    thread_sched_lock_acquire();
+    // Reuse idle worker of same name so that stack and priority setting keep same
+    for (int i = 0; i < THREAD_WORKER_MAX_NUM; i++) {
+        thread_worker_t *w = &thread_workers[i];
+        if (w->thread && w->busy == false && w->quit == false && strcmp(w->name, name) == 0) {
+            worker = w;
+            break;
+        }
+    }
+    int ret = ESP_OK;
+    if (worker) {
+        worker->body = body;
+        worker->arg = arg;
+        worker->busy = true;
+        thread_pool_stats.reused++;
+    } else {
+        for (int i = 0; i < THREAD_WORKER_MAX_NUM; i++) {
+            if (thread_workers[i].name[0] == '\0') {
+                worker = &thread_workers[i];
+                break;
+            }
+        }
+        if (worker == NULL) {
+            thread_sched_lock_release();
+            return ESP_ERR_NO_MEM;
+        }
+        strncpy(worker->name, name, THREAD_PATTERN_MAX_LEN - 1);
+        worker->body = body;
+        worker->arg = arg;
+        worker->busy = true;
+        ret = media_lib_sema_create(&worker->sema);
+        if (ret == ESP_OK) {
+            // Lock is recursive, record of new thread is added under same lock
+            ret = media_lib_thread_create_from_scheduler(&worker->thread, name, thread_worker_body, worker);
+        }
+        if (ret != ESP_OK || worker->thread == NULL) {
+            if (worker->sema) {
+                media_lib_sema_destroy(worker->sema);
+            }
+            memset(worker, 0, sizeof(thread_worker_t));
+            thread_sched_lock_release();
+            return ret == ESP_OK ? ESP_FAIL : ret;
+        }
+        thread_pool_stats.created++;
+    }
+    if (handle) {
+        *handle = worker->thread;
+    }
+    media_lib_sema_unlock(worker->sema);
+    thread_sched_lock_release();
+    return ret;
+}
+
+void media_lib_thread_pool_clear(void)
+{
+    thread_sched_lock_acquire();
+    for (int i = 0; i < THREAD_WORKER_MAX_NUM; i++) {
+        thread_worker_t *worker = &thread_workers[i];
+        if (worker->thread && worker->quit == false) {
+            worker->quit = true;
+            // Busy worker checks quit flag after body returns
+            if (worker->busy == false) {
+                media_lib_sema_unlock(worker->sema);
+            }
+        }
+    }
+    thread_sched_lock_release();
+}
+
+int media_lib_thread_pool_get_stats(media_lib_thread_pool_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    thread_sched_lock_acquire();
+    *stats = thread_pool_stats;
+    stats->worker_num = 0;
+    stats->idle_num = 0;
+    for (int i = 0; i < THREAD_WORKER_MAX_NUM; i++) {
+        thread_worker_t *worker = &thread_workers[i];
+        if (worker->thread && worker->quit == false) {
+            stats->worker_num++;
+            if (worker->busy == false) {
+                stats->idle_num++;
+            }
+        }
+    }
+    thread_sched_lock_release();
+    return ESP_OK;
+}
+
 bool media_lib_thread_set_priority(media_lib_thread_handle_t handle, int prio)
 {
     if (media_os_lib.thread_set_prio) {
@@ -272,6 +811,27 @@ int media_lib_mutex_destroy(media_lib_mutex_handle_t mutex)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+int media_lib_mutex_create_once(media_lib_mutex_handle_t *mutex)
+{
+    if (mutex == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (__atomic_load_n(mutex, __ATOMIC_ACQUIRE)) {
+        return ESP_OK;
+    }
+    media_lib_mutex_handle_t lock = NULL;
+    int ret = media_lib_mutex_create(&lock);
+    if (ret != ESP_OK || lock == NULL) {
+        return ret != ESP_OK ? ret : ESP_ERR_NO_MEM;
+    }
+    // Publish only once, loser of the race destroy its own mutex
+    media_lib_mutex_handle_t expected = NULL;
+    if (__atomic_compare_exchange_n(mutex, &expected, lock, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false) {
+        media_lib_mutex_destroy(lock);
+    }
+    return ESP_OK;
+}
+
 int media_lib_enter_critical_section(void)
 {
     if (media_os_lib.leave_critical) {
@@ -24,6 +24,8 @@
  *
  */
 
+#include <stddef.h>
+#include <string.h>
 #include "media_lib_socket.h"
 #include "media_lib_socket_reg.h"
 #include "media_lib_common.h"
@@ -33,8 +35,12 @@ static media_lib_socket_t media_socket_lib;
 
 esp_err_t media_lib_socket_register(media_lib_socket_t *socket_lib)
 {
-    MEDIA_LIB_DEFAULT_INSTALLER(socket_lib, &media_socket_lib,
-                                media_lib_socket_t);
+    // Functions after `sock_getsockname` are optional
+    if (media_lib_verify(socket_lib, offsetof(media_lib_socket_t, sock_sendmmsg)) == false) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(&media_socket_lib, socket_lib, sizeof(media_lib_socket_t));
+    return ESP_OK;
 }
 
 int media_lib_socket_accept(int s, struct sockaddr *addr, socklen_t *addrlen)
@@ -243,4 +249,51 @@ int media_lib_socket_getsockname(int s, struct sockaddr *name, socklen_t *namele
     }
     return ESP_ERR_NOT_SUPPORTED;
 }
+
+int media_lib_socket_sendmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags)
+{
+    if (media_socket_lib.sock_sendmmsg) {
+        return media_socket_lib.sock_sendmmsg(s, msgvec, vlen, flags);
+    }
+    if (media_socket_lib.sock_sendmsg == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // No native batch API, loop in one call to save wrapper overhead
+    unsigned int sent = 0;
+    for (; sent < vlen; sent++) {
+        ssize_t ret = media_socket_lib.sock_sendmsg(s, &msgvec[sent].msg_hdr, flags);
+        if (ret < 0) {
+            break;
+        }
+        msgvec[sent].msg_len = (unsigned int)ret;
+    }
+    if (sent == 0 && vlen) {
+        return -1;
+    }
+    return (int)sent;
+}
+
+int media_lib_socket_recvmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags)
+{
+    if (media_socket_lib.sock_recvmmsg) {
+        return media_socket_lib.sock_recvmmsg(s, msgvec, vlen, flags);
+    }
+    if (media_socket_lib.sock_recvmsg == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    unsigned int received = 0;
+    for (; received < vlen; received++) {
+        // Only block for the first message, drain what is already queued afterwards
+        int recv_flags = received ? (flags | MSG_DONTWAIT) : flags;
+        ssize_t ret = media_socket_lib.sock_recvmsg(s, &msgvec[received].msg_hdr, recv_flags);
+        if (ret < 0) {
+            break;
+        }
+        msgvec[received].msg_len = (unsigned int)ret;
+    }
+    if (received == 0 && vlen) {
+        return -1;
+    }
+    return (int)received;
+}
 #endif
@@ -30,12 +30,18 @@
 
 #ifdef CONFIG_MEDIA_PROTOCOL_LIB_ENABLE
 static media_lib_tls_t media_tls_lib;
+static media_lib_tls_ext_t media_tls_ext_lib;
 
 esp_err_t media_lib_tls_register(media_lib_tls_t *tls_lib)
 {
     MEDIA_LIB_DEFAULT_INSTALLER(tls_lib, &media_tls_lib, media_lib_tls_t);
 }
 
+esp_err_t media_lib_tls_ext_register(media_lib_tls_ext_t *tls_ext_lib)
+{
+    MEDIA_LIB_DEFAULT_INSTALLER(tls_ext_lib, &media_tls_ext_lib, media_lib_tls_ext_t);
+}
+
 media_lib_tls_handle_t media_lib_tls_new(const char *hostname, int hostlen, int port, const media_lib_tls_cfg_t *cfg)
 {
     if (media_tls_lib.tls_new) {
@@ -95,4 +101,50 @@ int media_lib_tls_delete(media_lib_tls_handle_t tls)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+media_lib_tls_cfg_handle_t media_lib_tls_cfg_create(const media_lib_tls_cfg_t *cfg)
+{
+    if (media_tls_ext_lib.tls_cfg_create) {
+        return media_tls_ext_lib.tls_cfg_create(cfg);
+    }
+    return NULL;
+}
+
+media_lib_tls_cfg_handle_t media_lib_tls_cfg_ref(media_lib_tls_cfg_handle_t cfg)
+{
+    if (media_tls_ext_lib.tls_cfg_ref) {
+        return media_tls_ext_lib.tls_cfg_ref(cfg);
+    }
+    return NULL;
+}
+
+void media_lib_tls_cfg_unref(media_lib_tls_cfg_handle_t cfg)
+{
+    if (media_tls_ext_lib.tls_cfg_unref) {
+        media_tls_ext_lib.tls_cfg_unref(cfg);
+    }
+}
+
+media_lib_tls_handle_t media_lib_tls_new_with_cfg(const char *hostname, int hostlen, int port, media_lib_tls_cfg_handle_t cfg)
+{
+    if (media_tls_ext_lib.tls_new_with_cfg) {
+        return media_tls_ext_lib.tls_new_with_cfg(hostname, hostlen, port, cfg);
+    }
+    return NULL;
+}
+
+int media_lib_tls_get_stats(media_lib_tls_stats_t *stats)
+{
+    if (media_tls_ext_lib.tls_get_stats) {
+        return media_tls_ext_lib.tls_get_stats(stats);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void media_lib_tls_clear_sessions(void)
+{
+    if (media_tls_ext_lib.tls_clear_sessions) {
+        media_tls_ext_lib.tls_clear_sessions();
+    }
+}
+
 #endif
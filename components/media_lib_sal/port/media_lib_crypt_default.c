@@ -25,6 +25,8 @@
 #include "esp_log.h"
 #include "mbedtls/md5.h"
 #include "mbedtls/sha256.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/md.h"
 #include "media_lib_crypt_reg.h"
 #include "media_lib_adapter.h"
 #include "media_lib_os.h"
@@ -161,6 +163,117 @@ static int _aes_crypt_cbc(media_lib_aes_handle_t ctx, bool decrypt_mode, uint8_t
     return ret;
 }
 
+static int _aes_crypt_ctr(media_lib_aes_handle_t ctx, size_t size, size_t *nc_off, uint8_t nonce_counter[16],
+                          uint8_t stream_block[16], const uint8_t *input, uint8_t *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return esp_aes_crypt_ctr((esp_aes_context *)ctx, size, nc_off, nonce_counter, stream_block, input, output);
+}
+
+static void _gcm_init(media_lib_gcm_handle_t *ctx)
+{
+    mbedtls_gcm_context *gcm =
+        (mbedtls_gcm_context *)media_lib_malloc(sizeof(mbedtls_gcm_context));
+    if (gcm) {
+        mbedtls_gcm_init(gcm);
+        *ctx = gcm;
+    }
+}
+
+static void _gcm_free(media_lib_gcm_handle_t ctx)
+{
+    if (ctx) {
+        mbedtls_gcm_free((mbedtls_gcm_context *)ctx);
+        media_lib_free(ctx);
+    }
+}
+
+static int _gcm_set_key(media_lib_gcm_handle_t ctx, const uint8_t *key, uint16_t key_bits)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return mbedtls_gcm_setkey((mbedtls_gcm_context *)ctx, MBEDTLS_CIPHER_ID_AES, key, key_bits);
+}
+
+static int _gcm_start(media_lib_gcm_handle_t ctx, bool decrypt_mode, const uint8_t *iv, size_t iv_len,
+                      const uint8_t *aad, size_t aad_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    int mode = decrypt_mode ? MBEDTLS_GCM_DECRYPT : MBEDTLS_GCM_ENCRYPT;
+#if MBEDTLS_VERSION_MAJOR >= 3
+    int ret = mbedtls_gcm_starts((mbedtls_gcm_context *)ctx, mode, iv, iv_len);
+    if (ret == 0 && aad_len) {
+        ret = mbedtls_gcm_update_ad((mbedtls_gcm_context *)ctx, aad, aad_len);
+    }
+    return ret;
+#else
+    return mbedtls_gcm_starts((mbedtls_gcm_context *)ctx, mode, iv, iv_len, aad, aad_len);
+#endif
+}
+
+static int _gcm_update(media_lib_gcm_handle_t ctx, const uint8_t *input, size_t size, uint8_t *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+#if MBEDTLS_VERSION_MAJOR >= 3
+    size_t out_len = 0;
+    return mbedtls_gcm_update((mbedtls_gcm_context *)ctx, input, size, output, size, &out_len);
+#else
+    return mbedtls_gcm_update((mbedtls_gcm_context *)ctx, size, input, output);
+#endif
+}
+
+static int _gcm_finish(media_lib_gcm_handle_t ctx, uint8_t *tag, size_t tag_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+#if MBEDTLS_VERSION_MAJOR >= 3
+    size_t out_len = 0;
+    return mbedtls_gcm_finish((mbedtls_gcm_context *)ctx, NULL, 0, &out_len, tag, tag_len);
+#else
+    return mbedtls_gcm_finish((mbedtls_gcm_context *)ctx, tag, tag_len);
+#endif
+}
+
+static void _hmac_sha1_init(media_lib_hmac_sha1_handle_t *ctx)
+{
+    mbedtls_md_context_t *md =
+        (mbedtls_md_context_t *)media_lib_malloc(sizeof(mbedtls_md_context_t));
+    if (md == NULL) {
+        return;
+    }
+    mbedtls_md_init(md);
+    if (mbedtls_md_setup(md, mbedtls_md_info_from_type(MBEDTLS_MD_SHA1), 1) != 0) {
+        mbedtls_md_free(md);
+        media_lib_free(md);
+        return;
+    }
+    *ctx = md;
+}
+
+static void _hmac_sha1_free(media_lib_hmac_sha1_handle_t ctx)
+{
+    if (ctx) {
+        mbedtls_md_free((mbedtls_md_context_t *)ctx);
+        media_lib_free(ctx);
+    }
+}
+
+static int _hmac_sha1_start(media_lib_hmac_sha1_handle_t ctx, const uint8_t *key, size_t key_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return mbedtls_md_hmac_starts((mbedtls_md_context_t *)ctx, key, key_len);
+}
+
+static int _hmac_sha1_update(media_lib_hmac_sha1_handle_t ctx, const uint8_t *input, size_t len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return mbedtls_md_hmac_update((mbedtls_md_context_t *)ctx, input, len);
+}
+
+static int _hmac_sha1_finish(media_lib_hmac_sha1_handle_t ctx, uint8_t output[20])
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return mbedtls_md_hmac_finish((mbedtls_md_context_t *)ctx, output);
+}
+
 esp_err_t media_lib_add_default_crypt_adapter(void)
 {
     media_lib_crypt_t crypt_lib = {
@@ -179,6 +292,24 @@ esp_err_t media_lib_add_default_crypt_adapter(void)
         .aes_set_key = _aes_set_key,
         .aes_crypt_cbc = _aes_crypt_cbc,
     };
+    media_lib_cipher_t cipher_lib = {
+        .aes_crypt_ctr = _aes_crypt_ctr,
+        .gcm_init = _gcm_init,
+        .gcm_free = _gcm_free,
+        .gcm_set_key = _gcm_set_key,
+        .gcm_start = _gcm_start,
+        .gcm_update = _gcm_update,
+        .gcm_finish = _gcm_finish,
+        .hmac_sha1_init = _hmac_sha1_init,
+        .hmac_sha1_free = _hmac_sha1_free,
+        .hmac_sha1_start = _hmac_sha1_start,
+        .hmac_sha1_update = _hmac_sha1_update,
+        .hmac_sha1_finish = _hmac_sha1_finish,
+    };
+    esp_err_t ret = media_lib_cipher_register(&cipher_lib);
+    if (ret != ESP_OK) {
+        return ret;
+    }
     return media_lib_crypt_register(&crypt_lib);
 }
 #endif
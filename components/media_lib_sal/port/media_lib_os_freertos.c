@@ -165,15 +165,17 @@ BaseType_t __attribute__((weak)) xTaskCreateRestrictedPinnedToCore(
              __func__);
     return pdFALSE;
 }
-static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
-                          void(*body)(void *arg), void *arg, uint32_t stack_size,
-                          int prio, int core)
+static int _thread_create_ex(media_lib_thread_handle_t *handle, const char *name,
+                             void(*body)(void *arg), void *arg, uint32_t stack_size,
+                             int prio, int core, bool stack_in_ext)
 {
     StackType_t *task_stack = NULL;
     do {
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0))
+        // Always create with caps so that `vTaskDeleteWithCaps` can be used for all threads
+        UBaseType_t caps = stack_in_ext ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
         BaseType_t ret = xTaskCreatePinnedToCoreWithCaps(body, name, stack_size, arg, prio, (TaskHandle_t *)handle,
-                                                         core, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                                                         core, caps);
         if (ret != pdPASS) {
             ESP_LOGE(TAG, "Error creating RestrictedPinnedToCore %s", name);
             break;
@@ -206,10 +208,11 @@ static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
     return ESP_FAIL;
 }
 #else
-static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
-                          void(*body)(void *arg), void *arg, uint32_t stack_size,
-                          int prio, int core)
+static int _thread_create_ex(media_lib_thread_handle_t *handle, const char *name,
+                             void(*body)(void *arg), void *arg, uint32_t stack_size,
+                             int prio, int core, bool stack_in_ext)
 {
+    // Stack always in internal RAM when external stack not allowed
     if (xTaskCreatePinnedToCore(body, name, stack_size, arg, prio,
                                 (TaskHandle_t *)handle, core) != pdPASS) {
         ESP_LOGE(TAG, "Fail to create thread %s\n", name);
@@ -219,6 +222,13 @@ static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
 }
 #endif
 
+static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
+                          void(*body)(void *arg), void *arg, uint32_t stack_size,
+                          int prio, int core)
+{
+    return _thread_create_ex(handle, name, body, arg, stack_size, prio, core, true);
+}
+
 static void _thread_destroy(media_lib_thread_handle_t handle)
 {
 #if defined(CONFIG_SPIRAM_BOOT_INIT) &&              \
@@ -242,6 +252,17 @@ static void _thread_sleep(uint32_t ms)
     vTaskDelay(ms / portTICK_PERIOD_MS);
 }
 
+static media_lib_thread_handle_t _thread_get_self(void)
+{
+    return (media_lib_thread_handle_t)xTaskGetCurrentTaskHandle();
+}
+
+static uint32_t _thread_get_stack_free(media_lib_thread_handle_t handle)
+{
+    // Stack depth unit is byte for ESP-IDF FreeRTOS
+    return (uint32_t)uxTaskGetStackHighWaterMark((TaskHandle_t)handle);
+}
+
 static int _sema_create(media_lib_sema_handle_t *sema)
 {
     if (sema) {
@@ -356,7 +377,8 @@ static uint32_t _event_group_wait_bits(media_lib_event_grp_handle_t group,
 {
     RETURN_ON_NULL_HANDLE(group);
     if (timeout != portMAX_DELAY) {
-        timeout /= portTICK_PERIOD_MS;
+        // Round up so that a wait shorter than one tick still blocks instead of returning at once
+        timeout = (timeout + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
     }
     return (uint32_t)xEventGroupWaitBits((EventGroupHandle_t)group, bits, false,
                                          true, timeout);
@@ -518,6 +540,9 @@ esp_err_t media_lib_add_default_os_adapter(void)
         .thread_destroy = _thread_destroy,
         .thread_set_prio = _thread_set_priority,
         .thread_sleep = _thread_sleep,
+        .thread_create_ex = _thread_create_ex,
+        .thread_get_self = _thread_get_self,
+        .thread_stack_free = _thread_get_stack_free,
 
         .sema_create = _sema_create,
         .sema_lock   = _sema_lock_timeout,
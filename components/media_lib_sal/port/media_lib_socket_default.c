@@ -30,7 +30,7 @@
 #ifdef CONFIG_MEDIA_PROTOCOL_LIB_ENABLE
 static ssize_t _readv(int s, const struct iovec *iov, int iovcnt)
 {
-    return 0;
+    return lwip_readv(s, iov, iovcnt);
 }
 
 static ssize_t _recvmsg(int s, struct msghdr *message, int flags)
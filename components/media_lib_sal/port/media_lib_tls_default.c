@@ -22,13 +22,14 @@
  *
  */
 
+#include <stdio.h>
 #include <string.h>
 #include "esp_log.h"
 #include "media_lib_tls_reg.h"
 #include "media_lib_adapter.h"
 #include "media_lib_os.h"
 #include "esp_tls.h"
-#include "esp_log.h"
+#include "esp_timer.h"
 
 #if __has_include("esp_idf_version.h")
 #include "esp_idf_version.h"
@@ -43,12 +44,182 @@
 #endif
 
 #define TAG "TLS_Lib"
+
+#define TLS_SESSION_CACHE_NUM  (4)
+#define TLS_SESSION_KEY_LEN    (72)
+#define TLS_NOW_MS()           (uint32_t)(esp_timer_get_time() / 1000)
+
+#if CONFIG_ESP_TLS_USING_MBEDTLS && defined(CONFIG_MBEDTLS_CERTIFICATE_BUNDLE) && \
+    (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0))
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+#define TLS_SHARED_CA_SUPPORTED
+#endif
+
 typedef struct {
-    esp_tls_t* tls;
-    bool       is_server;
+    media_lib_tls_cfg_t cfg;
+#ifdef TLS_SHARED_CA_SUPPORTED
+    mbedtls_x509_crt    ca_chain;
+    bool                ca_parsed;
+#endif
+    int                 ref_count;
+} tls_shared_cfg_t;
+
+typedef struct {
+    esp_tls_t*        tls;
+    bool              is_server;
+    tls_shared_cfg_t *shared_cfg;
 } media_lib_tls_inst_t;
 
-static media_lib_tls_handle_t _tls_new(const char *hostname, int hostlen, int port, const media_lib_tls_cfg_t *cfg)
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+typedef struct {
+    esp_tls_client_session_t *session;
+    int                       ref_count;
+} tls_session_ref_t;
+
+typedef struct {
+    char               key[TLS_SESSION_KEY_LEN];
+    tls_session_ref_t *ref;
+    uint32_t           last_used;
+} tls_session_entry_t;
+
+static tls_session_entry_t tls_sessions[TLS_SESSION_CACHE_NUM];
+#endif
+
+static media_lib_mutex_handle_t tls_lock;
+static media_lib_tls_stats_t    tls_stats;
+
+#ifdef TLS_SHARED_CA_SUPPORTED
+// Shared configuration used by `tls_shared_ca_attach`, only set during connection setup in calling thread
+static __thread tls_shared_cfg_t *tls_attach_cfg;
+#endif
+
+static void tls_lib_lock(void)
+{
+    media_lib_mutex_lock(tls_lock, MEDIA_LIB_MAX_LOCK_TIME);
+}
+
+static void tls_lib_unlock(void)
+{
+    media_lib_mutex_unlock(tls_lock);
+}
+
+static void tls_stats_add_handshake(bool success, uint32_t duration)
+{
+    tls_lib_lock();
+    if (success == false) {
+        tls_stats.handshake_fail++;
+    } else {
+        tls_stats.handshake_count++;
+        tls_stats.handshake_last_ms = duration;
+        tls_stats.handshake_total_ms += duration;
+        if (duration > tls_stats.handshake_max_ms) {
+            tls_stats.handshake_max_ms = duration;
+        }
+    }
+    tls_lib_unlock();
+}
+
+#ifdef TLS_SHARED_CA_SUPPORTED
+static int tls_shared_ca_attach(void *conf)
+{
+    tls_shared_cfg_t *shared_cfg = tls_attach_cfg;
+    if (shared_cfg == NULL) {
+        return ESP_FAIL;
+    }
+    // Use CA chain parsed once in shared configuration
+    mbedtls_ssl_conf_ca_chain((mbedtls_ssl_config *)conf, &shared_cfg->ca_chain, NULL);
+    mbedtls_ssl_conf_authmode((mbedtls_ssl_config *)conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    return ESP_OK;
+}
+#endif
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+static void tls_session_unref_locked(tls_session_ref_t *ref)
+{
+    ref->ref_count--;
+    if (ref->ref_count == 0) {
+        esp_tls_free_client_session(ref->session);
+        free(ref);
+    }
+}
+
+static void tls_session_unref(tls_session_ref_t *ref)
+{
+    tls_lib_lock();
+    tls_session_unref_locked(ref);
+    tls_lib_unlock();
+}
+
+static tls_session_entry_t *tls_session_find(const char *key)
+{
+    for (int i = 0; i < TLS_SESSION_CACHE_NUM; i++) {
+        if (tls_sessions[i].ref && strcmp(tls_sessions[i].key, key) == 0) {
+            return &tls_sessions[i];
+        }
+    }
+    return NULL;
+}
+
+static tls_session_ref_t *tls_session_acquire(const char *key)
+{
+    tls_session_ref_t *ref = NULL;
+    tls_lib_lock();
+    tls_session_entry_t *entry = tls_session_find(key);
+    if (entry) {
+        // Hold reference so that session is kept even if replaced or cleared during handshake
+        ref = entry->ref;
+        ref->ref_count++;
+        entry->last_used = TLS_NOW_MS();
+        tls_stats.session_hits++;
+    } else {
+        tls_stats.session_misses++;
+    }
+    tls_lib_unlock();
+    return ref;
+}
+
+static void tls_session_save(const char *key, esp_tls_t *tls)
+{
+    esp_tls_client_session_t *session = esp_tls_get_client_session(tls);
+    if (session == NULL) {
+        return;
+    }
+    tls_session_ref_t *ref = calloc(1, sizeof(tls_session_ref_t));
+    if (ref == NULL) {
+        esp_tls_free_client_session(session);
+        return;
+    }
+    ref->session = session;
+    ref->ref_count = 1;
+    tls_lib_lock();
+    tls_session_entry_t *entry = tls_session_find(key);
+    if (entry == NULL) {
+        // Replace empty or least recently used one
+        entry = &tls_sessions[0];
+        for (int i = 0; i < TLS_SESSION_CACHE_NUM; i++) {
+            if (tls_sessions[i].ref == NULL) {
+                entry = &tls_sessions[i];
+                break;
+            }
+            if (tls_sessions[i].last_used < entry->last_used) {
+                entry = &tls_sessions[i];
+            }
+        }
+        strncpy(entry->key, key, TLS_SESSION_KEY_LEN - 1);
+        entry->key[TLS_SESSION_KEY_LEN - 1] = '\0';
+    }
+    if (entry->ref) {
+        tls_session_unref_locked(entry->ref);
+    }
+    entry->ref = ref;
+    entry->last_used = TLS_NOW_MS();
+    tls_lib_unlock();
+}
+#endif
+
+static media_lib_tls_handle_t _tls_client_connect(const char *hostname, int port, const media_lib_tls_cfg_t *cfg,
+                                                  tls_shared_cfg_t *shared_cfg)
 {
     esp_tls_cfg_t tls_cfg = {
         .cacert_buf = (const unsigned char *)cfg->cacert_buf,
@@ -66,34 +237,178 @@ static media_lib_tls_handle_t _tls_new(const char *hostname, int hostlen, int po
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0))
         .use_secure_element = cfg->use_secure_element,
         .crt_bundle_attach = cfg->crt_bundle_attach,
+#endif
+        .alpn_protos = cfg->alpn_protos,
+#if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0))
+        .ciphersuites_list = cfg->ciphersuites_list,
 #endif
     };
+#ifdef TLS_SHARED_CA_SUPPORTED
+    if (shared_cfg && shared_cfg->ca_parsed) {
+        tls_cfg.cacert_buf = NULL;
+        tls_cfg.cacert_bytes = 0;
+        tls_cfg.crt_bundle_attach = tls_shared_ca_attach;
+    }
+#endif
     media_lib_tls_inst_t * tls_lib = calloc(1, sizeof(media_lib_tls_inst_t));
     if (tls_lib == NULL) {
         ESP_LOGE(TAG, "No memory for instance");
         return NULL;
     }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    char session_key[TLS_SESSION_KEY_LEN];
+    tls_session_ref_t *session_ref = NULL;
+    snprintf(session_key, sizeof(session_key), "%s:%d", hostname, port);
+    if (cfg->resume_session) {
+        session_ref = tls_session_acquire(session_key);
+        if (session_ref) {
+            tls_cfg.client_session = session_ref->session;
+        }
+    }
+#endif
+#ifdef TLS_SHARED_CA_SUPPORTED
+    tls_attach_cfg = shared_cfg;
+#endif
+    uint32_t start_time = TLS_NOW_MS();
 #if (ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(4, 0, 0))
     esp_tls_t * tls = esp_tls_conn_new(hostname, strlen(hostname), port, &tls_cfg);
-    if (tls == NULL) {
-        ESP_LOGE(TAG, "Fail to connect client");
-        free(tls_lib);
-        return NULL;
-    }
 #else
     esp_tls_t* tls = esp_tls_init();
-    if (tls == NULL ||
-        esp_tls_conn_new_sync(hostname, strlen(hostname), port, &tls_cfg, tls) < 0) {
+    if (tls && esp_tls_conn_new_sync(hostname, strlen(hostname), port, &tls_cfg, tls) < 0) {
         esp_tls_conn_delete(tls);
-        free(tls_lib);
+        tls = NULL;
+    }
+#endif
+    uint32_t duration = TLS_NOW_MS() - start_time;
+#ifdef TLS_SHARED_CA_SUPPORTED
+    tls_attach_cfg = NULL;
+#endif
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    if (session_ref) {
+        tls_session_unref(session_ref);
+    }
+#endif
+    tls_stats_add_handshake(tls != NULL, duration);
+    if (tls == NULL) {
         ESP_LOGE(TAG, "Fail to connect client");
+        free(tls_lib);
         return NULL;
     }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    if (cfg->resume_session) {
+        tls_session_save(session_key, tls);
+    }
 #endif
     tls_lib->tls = tls;
+    tls_lib->shared_cfg = shared_cfg;
     return (media_lib_tls_handle_t)tls_lib;
 }
 
+static media_lib_tls_handle_t _tls_new(const char *hostname, int hostlen, int port, const media_lib_tls_cfg_t *cfg)
+{
+    return _tls_client_connect(hostname, port, cfg, NULL);
+}
+
+static media_lib_tls_cfg_handle_t _tls_cfg_create(const media_lib_tls_cfg_t *cfg)
+{
+    if (cfg == NULL) {
+        return NULL;
+    }
+    tls_shared_cfg_t *shared_cfg = calloc(1, sizeof(tls_shared_cfg_t));
+    if (shared_cfg == NULL) {
+        ESP_LOGE(TAG, "No memory for shared config");
+        return NULL;
+    }
+    shared_cfg->cfg = *cfg;
+    shared_cfg->ref_count = 1;
+#ifdef TLS_SHARED_CA_SUPPORTED
+    // Parse CA chain once and keep it in this configuration, certificate bundle or global CA store take precedence
+    if (cfg->cacert_buf && cfg->use_global_ca_store == false && cfg->crt_bundle_attach == NULL) {
+        mbedtls_x509_crt_init(&shared_cfg->ca_chain);
+        int ret = mbedtls_x509_crt_parse(&shared_cfg->ca_chain, (const unsigned char *)cfg->cacert_buf,
+                                         (size_t)cfg->cacert_bytes);
+        if (ret < 0) {
+            // Fallback to parse for each connection
+            ESP_LOGW(TAG, "Fail to parse CA chain ret -0x%x", -ret);
+            mbedtls_x509_crt_free(&shared_cfg->ca_chain);
+        } else {
+            shared_cfg->ca_parsed = true;
+        }
+    }
+#endif
+    return (media_lib_tls_cfg_handle_t)shared_cfg;
+}
+
+static media_lib_tls_cfg_handle_t _tls_cfg_ref(media_lib_tls_cfg_handle_t cfg)
+{
+    tls_shared_cfg_t *shared_cfg = (tls_shared_cfg_t *)cfg;
+    if (shared_cfg) {
+        tls_lib_lock();
+        shared_cfg->ref_count++;
+        tls_lib_unlock();
+    }
+    return cfg;
+}
+
+static void _tls_cfg_unref(media_lib_tls_cfg_handle_t cfg)
+{
+    tls_shared_cfg_t *shared_cfg = (tls_shared_cfg_t *)cfg;
+    if (shared_cfg == NULL) {
+        return;
+    }
+    tls_lib_lock();
+    shared_cfg->ref_count--;
+    bool destroy = (shared_cfg->ref_count == 0);
+    tls_lib_unlock();
+    if (destroy) {
+#ifdef TLS_SHARED_CA_SUPPORTED
+        if (shared_cfg->ca_parsed) {
+            mbedtls_x509_crt_free(&shared_cfg->ca_chain);
+        }
+#endif
+        free(shared_cfg);
+    }
+}
+
+static media_lib_tls_handle_t _tls_new_with_cfg(const char *hostname, int hostlen, int port, media_lib_tls_cfg_handle_t cfg)
+{
+    tls_shared_cfg_t *shared_cfg = (tls_shared_cfg_t *)cfg;
+    if (shared_cfg == NULL) {
+        return NULL;
+    }
+    _tls_cfg_ref(cfg);
+    media_lib_tls_handle_t tls = _tls_client_connect(hostname, port, &shared_cfg->cfg, shared_cfg);
+    if (tls == NULL) {
+        _tls_cfg_unref(cfg);
+    }
+    return tls;
+}
+
+static int _tls_get_stats(media_lib_tls_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    tls_lib_lock();
+    *stats = tls_stats;
+    tls_lib_unlock();
+    return ESP_OK;
+}
+
+static void _tls_clear_sessions(void)
+{
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    tls_lib_lock();
+    for (int i = 0; i < TLS_SESSION_CACHE_NUM; i++) {
+        if (tls_sessions[i].ref) {
+            tls_session_unref_locked(tls_sessions[i].ref);
+        }
+        memset(&tls_sessions[i], 0, sizeof(tls_session_entry_t));
+    }
+    tls_lib_unlock();
+#endif
+}
+
 static media_lib_tls_handle_t _tls_new_server(int fd, const media_lib_tls_server_cfg_t *cfg)
 {
 #ifndef CONFIG_ESP_TLS_SERVER
@@ -178,6 +493,9 @@ static int _tls_delete(media_lib_tls_handle_t tls)
         } else {
             esp_tls_conn_delete(tls_lib->tls);
         }
+        if (tls_lib->shared_cfg) {
+            _tls_cfg_unref(tls_lib->shared_cfg);
+        }
         free(tls);
     } else {
         return ESP_ERR_INVALID_ARG;
@@ -197,6 +515,7 @@ static int _tls_get_bytes_avail(media_lib_tls_handle_t tls)
 
 esp_err_t media_lib_add_default_tls_adapter(void)
 {
+    media_lib_mutex_create_once(&tls_lock);
     media_lib_tls_t tls_lib = {
         .tls_new = _tls_new,
         .tls_new_server = _tls_new_server,
@@ -206,6 +525,18 @@ esp_err_t media_lib_add_default_tls_adapter(void)
         .tls_delete = _tls_delete,
         .tls_get_bytes_avail = _tls_get_bytes_avail,
     };
-    return media_lib_tls_register(&tls_lib);
+    esp_err_t ret = media_lib_tls_register(&tls_lib);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    media_lib_tls_ext_t tls_ext_lib = {
+        .tls_cfg_create = _tls_cfg_create,
+        .tls_cfg_ref = _tls_cfg_ref,
+        .tls_cfg_unref = _tls_cfg_unref,
+        .tls_new_with_cfg = _tls_new_with_cfg,
+        .tls_get_stats = _tls_get_stats,
+        .tls_clear_sessions = _tls_clear_sessions,
+    };
+    return media_lib_tls_ext_register(&tls_ext_lib);
 }
 #endif
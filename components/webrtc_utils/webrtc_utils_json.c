@@ -0,0 +1,330 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <string.h>
+#include "webrtc_utils_json.h"
+
+#define JSON_MAX_DEPTH (32)
+
+typedef struct {
+    char *cur;
+    char *end;
+} json_scan_t;
+
+static void skip_space(json_scan_t *s)
+{
+    while (s->cur < s->end && (*s->cur == ' ' || *s->cur == '\t' || *s->cur == '\r' || *s->cur == '\n')) {
+        s->cur++;
+    }
+}
+
+static esp_err_t scan_string(json_scan_t *s, webrtc_utils_json_slice_t *slice)
+{
+    // Current position must be opening quote
+    char *start = ++s->cur;
+    while (s->cur < s->end) {
+        if (*s->cur == '\\') {
+            s->cur += 2;
+            continue;
+        }
+        if (*s->cur == '"') {
+            if (slice) {
+                slice->str = start;
+                slice->len = (int)(s->cur - start);
+            }
+            s->cur++;
+            return ESP_OK;
+        }
+        s->cur++;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t scan_value(json_scan_t *s, webrtc_utils_json_slice_t *slice, bool *is_str)
+{
+    skip_space(s);
+    if (s->cur >= s->end) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (*s->cur == '"') {
+        if (is_str) {
+            *is_str = true;
+        }
+        return scan_string(s, slice);
+    }
+    if (is_str) {
+        *is_str = false;
+    }
+    char *start = s->cur;
+    if (*s->cur == '{' || *s->cur == '[') {
+        // Skip nested container by bracket depth, strings are skipped as whole
+        int depth = 0;
+        while (s->cur < s->end) {
+            char c = *s->cur;
+            if (c == '"') {
+                if (scan_string(s, NULL) != ESP_OK) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                continue;
+            }
+            s->cur++;
+            if (c == '{' || c == '[') {
+                if (++depth > JSON_MAX_DEPTH) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    break;
+                }
+            }
+        }
+        if (depth) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    } else {
+        // Number or literal
+        while (s->cur < s->end && *s->cur != ',' && *s->cur != '}' && *s->cur != ']' &&
+               *s->cur != ' ' && *s->cur != '\t' && *s->cur != '\r' && *s->cur != '\n') {
+            s->cur++;
+        }
+        if (s->cur == start) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (slice) {
+        slice->str = start;
+        slice->len = (int)(s->cur - start);
+    }
+    return ESP_OK;
+}
+
+esp_err_t webrtc_utils_json_find(char *json, int len, webrtc_utils_json_field_t *fields, int num)
+{
+    if (json == NULL || len <= 0 || (fields == NULL && num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < num; i++) {
+        fields[i].value.str = NULL;
+        fields[i].value.len = 0;
+        fields[i].is_str = false;
+    }
+    // Input may come from C string with length larger than actual content
+    char *nul = memchr(json, '\0', len);
+    json_scan_t s = {
+        .cur = json,
+        .end = nul ? nul : json + len,
+    };
+    skip_space(&s);
+    if (s.cur >= s.end || *s.cur != '{') {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s.cur++;
+    skip_space(&s);
+    if (s.cur < s.end && *s.cur == '}') {
+        return ESP_OK;
+    }
+    while (s.cur < s.end) {
+        webrtc_utils_json_slice_t key;
+        skip_space(&s);
+        if (s.cur >= s.end || *s.cur != '"' || scan_string(&s, &key) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        skip_space(&s);
+        if (s.cur >= s.end || *s.cur != ':') {
+            return ESP_ERR_INVALID_ARG;
+        }
+        s.cur++;
+        webrtc_utils_json_field_t *field = NULL;
+        for (int i = 0; i < num; i++) {
+            // First occurrence wins as cJSON_GetObjectItem does
+            if (fields[i].value.str == NULL && webrtc_utils_json_equal(&key, fields[i].key)) {
+                field = &fields[i];
+                break;
+            }
+        }
+        webrtc_utils_json_slice_t value;
+        bool is_str = false;
+        if (scan_value(&s, &value, &is_str) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (field) {
+            field->value = value;
+            field->is_str = is_str;
+        }
+        skip_space(&s);
+        if (s.cur >= s.end) {
+            break;
+        }
+        if (*s.cur == '}') {
+            return ESP_OK;
+        }
+        if (*s.cur != ',') {
+            break;
+        }
+        s.cur++;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int parse_hex4(const char *p, const char *end)
+{
+    if (end - p < 4) {
+        return -1;
+    }
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hex_value(p[i]);
+        if (h < 0) {
+            return -1;
+        }
+        v = (v << 4) | h;
+    }
+    return v;
+}
+
+static int put_utf8(char *dst, uint32_t code)
+{
+    if (code < 0x80) {
+        dst[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        dst[0] = (char)(0xC0 | (code >> 6));
+        dst[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        dst[0] = (char)(0xE0 | (code >> 12));
+        dst[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        dst[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    dst[0] = (char)(0xF0 | (code >> 18));
+    dst[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    dst[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    dst[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+esp_err_t webrtc_utils_json_unescape(webrtc_utils_json_slice_t *value)
+{
+    if (value == NULL || value->str == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    char *src = value->str;
+    char *end = value->str + value->len;
+    // Fast path to first escape, no copy needed before it
+    char *dst = memchr(src, '\\', value->len);
+    if (dst == NULL) {
+        value->str[value->len] = '\0';
+        return ESP_OK;
+    }
+    src = dst;
+    while (src < end) {
+        if (*src != '\\') {
+            *dst++ = *src++;
+            continue;
+        }
+        if (++src >= end) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        switch (*src++) {
+            case '"':
+                *dst++ = '"';
+                break;
+            case '\\':
+                *dst++ = '\\';
+                break;
+            case '/':
+                *dst++ = '/';
+                break;
+            case 'b':
+                *dst++ = '\b';
+                break;
+            case 'f':
+                *dst++ = '\f';
+                break;
+            case 'n':
+                *dst++ = '\n';
+                break;
+            case 'r':
+                *dst++ = '\r';
+                break;
+            case 't':
+                *dst++ = '\t';
+                break;
+            case 'u': {
+                int code = parse_hex4(src, end);
+                if (code < 0) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                src += 4;
+                uint32_t code_point = (uint32_t)code;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // Surrogate pair
+                    int low = -1;
+                    if (end - src >= 6 && src[0] == '\\' && src[1] == 'u') {
+                        low = parse_hex4(src + 2, end);
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return ESP_ERR_INVALID_ARG;
+                    }
+                    src += 6;
+                    code_point = 0x10000 + (((uint32_t)code - 0xD800) << 10) + ((uint32_t)low - 0xDC00);
+                }
+                dst += put_utf8(dst, code_point);
+                break;
+            }
+            default:
+                return ESP_ERR_INVALID_ARG;
+        }
+    }
+    *dst = '\0';
+    value->len = (int)(dst - value->str);
+    return ESP_OK;
+}
+
+bool webrtc_utils_json_equal(const webrtc_utils_json_slice_t *value, const char *str)
+{
+    if (value == NULL || value->str == NULL || str == NULL) {
+        return false;
+    }
+    int len = strlen(str);
+    return (value->len == len && memcmp(value->str, str, len) == 0);
+}
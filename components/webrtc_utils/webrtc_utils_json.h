@@ -0,0 +1,98 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  JSON value slice which points into the parsed buffer
+ */
+typedef struct {
+    char *str;    /*!< Start of value, for string value quotes are excluded */
+    int   len;    /*!< Length of value */
+} webrtc_utils_json_slice_t;
+
+/**
+ * @brief  JSON field to lookup
+ */
+typedef struct {
+    const char               *key;     /*!< Key to lookup in top level object */
+    webrtc_utils_json_slice_t value;   /*!< Found value, `str` is NULL if key not found */
+    bool                      is_str;  /*!< Whether value is string (still escaped until unescaped) */
+} webrtc_utils_json_field_t;
+
+/**
+ * @brief  Scan top level JSON object and locate wanted fields without memory allocation
+ *
+ * @note  Values are slices of the input buffer, nested object and array values are returned as raw text
+ *        Key matching is done on raw key text, escaped keys are not supported
+ *
+ * @param[in]      json    JSON text (not required to be NUL terminated)
+ * @param[in]      len     Length of JSON text
+ * @param[in,out]  fields  Fields to lookup, found values are filled into it
+ * @param[in]      num     Number of fields
+ *
+ * @return
+ *       - ESP_OK               On success (missing keys are not treated as error)
+ *       - ESP_ERR_INVALID_ARG  Invalid argument or malformed JSON
+ */
+esp_err_t webrtc_utils_json_find(char *json, int len, webrtc_utils_json_field_t *fields, int num);
+
+/**
+ * @brief  Unescape JSON string value in place and terminate it with NUL
+ *
+ * @note  Unescaped string is never longer than escaped one, so NUL is written over closing quote at most
+ *        Call it only after all wanted fields are located, since it modifies the input buffer
+ *
+ * @param[in,out]  value  String slice to unescape, length is updated after unescape
+ *
+ * @return
+ *       - ESP_OK               On success
+ *       - ESP_ERR_INVALID_ARG  Invalid argument or bad escape sequence
+ */
+esp_err_t webrtc_utils_json_unescape(webrtc_utils_json_slice_t *value);
+
+/**
+ * @brief  Check whether string slice equals to `str`
+ *
+ * @param[in]  value  Slice to compare
+ * @param[in]  str    NUL terminated string
+ *
+ * @return
+ *       - true   Equal
+ *       - false  Not equal or slice not set
+ */
+bool webrtc_utils_json_equal(const webrtc_utils_json_slice_t *value, const char *str);
+
+#ifdef __cplusplus
+}
+#endif
@@ -30,6 +30,13 @@
     esp_webrtc_send_custom_data(webrtc, ESP_WEBRTC_CUSTOM_DATA_VIA_SIGNALING, (uint8_t *)cmd, strlen(cmd))
 #define ELEMS(arr) sizeof(arr)/sizeof(arr[0])
 
+#ifdef CONFIG_DOORBELL_MAX_VIEWERS
+#define MAX_VIEWERS CONFIG_DOORBELL_MAX_VIEWERS
+#else
+#define MAX_VIEWERS (1)
+#endif
+#define VIEWER_IDX(ctx) ((int)(intptr_t)(ctx))
+
 typedef enum {
     DOOR_BELL_STATE_NONE,
     DOOR_BELL_STATE_RINGING,
@@ -51,15 +58,17 @@ typedef struct {
 
 typedef struct {
     esp_peer_data_channel_info_t info;
+    esp_webrtc_handle_t          webrtc;
     int send_count;
     int recv_count;
     bool used;
 } user_data_ch_t;
 
-static esp_webrtc_handle_t webrtc;
+static esp_webrtc_handle_t webrtc[MAX_VIEWERS];
+static door_bell_state_t   viewer_state[MAX_VIEWERS];
 static door_bell_state_t   door_bell_state;
 static bool                monitor_key;
-static user_data_ch_t      user_ch[2];
+static user_data_ch_t      user_ch[2 * MAX_VIEWERS];
 static bool data_running = false;
 
 extern const uint8_t ring_music_start[] asm("_binary_ring_aac_start");
@@ -87,12 +96,29 @@ int play_tone_int(int t)
     return play_tone((door_bell_tone_type_t)t);
 }
 
-static void door_bell_change_state(door_bell_state_t state)
+static void send_cmd_to_all(const char *cmd)
+{
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        if (webrtc[i]) {
+            SEND_CMD(webrtc[i], cmd);
+        }
+    }
+}
+
+static void door_bell_change_state(int idx, door_bell_state_t state)
 {
-    door_bell_state = state;
-    if (state == DOOR_BELL_STATE_CONNECTING || state == DOOR_BELL_STATE_NONE) {
+    viewer_state[idx] = state;
+    // Door bell state follows the most active viewer
+    door_bell_state_t top_state = DOOR_BELL_STATE_NONE;
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        if (viewer_state[i] > top_state) {
+            top_state = viewer_state[i];
+        }
+    }
+    if (state == DOOR_BELL_STATE_CONNECTING || top_state == DOOR_BELL_STATE_NONE) {
         stop_music();
     }
+    door_bell_state = top_state;
 }
 
 #ifdef CONFIG_DOORBELL_SUPPORT_PEDESTRIAN_DETECT
@@ -107,7 +133,7 @@ int pedestrian_detected(esp_capture_rgn_t *rgn, void *ctx)
 {
     char region_str[128];
     snprintf(region_str, sizeof(region_str) - 1, "PEDESTRIAN_DETECTED");
-    SEND_CMD(webrtc, region_str);
+    send_cmd_to_all(region_str);
     return 0;
 }
 #endif
@@ -118,24 +144,25 @@ static int door_bell_on_cmd(esp_webrtc_custom_data_via_t via, uint8_t *data, int
     if (via != ESP_WEBRTC_CUSTOM_DATA_VIA_SIGNALING) {
         return 0;
     }
-    if (size == 0 || webrtc == NULL) {
+    int idx = VIEWER_IDX(ctx);
+    if (size == 0 || idx >= MAX_VIEWERS || webrtc[idx] == NULL) {
         return 0;
     }
-    ESP_LOGI(TAG, "Receive command %.*s", size, (char *)data);
+    ESP_LOGI(TAG, "Receive command %.*s from viewer %d", size, (char *)data, idx);
     const char *cmd = (const char *)data;
     if (SAME_STR(cmd, DOOR_BELL_OPEN_DOOR_CMD)) {
         // Reply with door OPENED
-        SEND_CMD(webrtc, DOOR_BELL_DOOR_OPENED_CMD);
+        SEND_CMD(webrtc[idx], DOOR_BELL_DOOR_OPENED_CMD);
         // Only play tome when connection not build up
         if (door_bell_state < DOOR_BELL_STATE_CONNECTING) {
             play_tone(DOOR_BELL_TONE_OPEN_DOOR);
         }
     } else if (SAME_STR(cmd, DOOR_BELL_CALL_ACCEPTED_CMD)) {
-        door_bell_change_state(DOOR_BELL_STATE_CONNECTING);
-        esp_webrtc_enable_peer_connection(webrtc, true);
+        door_bell_change_state(idx, DOOR_BELL_STATE_CONNECTING);
+        esp_webrtc_enable_peer_connection(webrtc[idx], true);
     } else if (SAME_STR(cmd, DOOR_BELL_CALL_DENIED_CMD)) {
-        esp_webrtc_enable_peer_connection(webrtc, false);
-        door_bell_change_state(DOOR_BELL_STATE_NONE);
+        esp_webrtc_enable_peer_connection(webrtc[idx], false);
+        door_bell_change_state(idx, DOOR_BELL_STATE_NONE);
     }
     return 0;
 }
@@ -145,17 +172,18 @@ int close_data_channel(int id)
     if (id < ELEMS(user_ch) && user_ch[id].used) {
         ESP_LOGI(TAG, "Start to Close data channel %s", user_ch[id].info.label);
         esp_peer_handle_t peer_handle = NULL;
-        esp_webrtc_get_peer_connection(webrtc, &peer_handle);
+        esp_webrtc_get_peer_connection(user_ch[id].webrtc, &peer_handle);
         esp_peer_close_data_channel(peer_handle, user_ch[id].info.label);
     }
     return 0;
 }
 
-static void add_channel(esp_peer_data_channel_info_t *ch)
+static void add_channel(esp_webrtc_handle_t owner, esp_peer_data_channel_info_t *ch)
 {
     for (int i = 0; i < ELEMS(user_ch); i++) {
         if (user_ch[i].used == false) {
             user_ch[i].used = true;
+            user_ch[i].webrtc = owner;
             char def_label[2] = "0";
             def_label[0] += i;
             user_ch[i].info.label = strdup(ch->label ? ch->label : def_label);
@@ -167,20 +195,20 @@ static void add_channel(esp_peer_data_channel_info_t *ch)
     }
 }
 
-user_data_ch_t *get_channel(uint16_t stream_id)
+user_data_ch_t *get_channel(esp_webrtc_handle_t owner, uint16_t stream_id)
 {
     for (int i = 0; i < ELEMS(user_ch); i++) {
-        if (user_ch[i].used && user_ch[i].info.stream_id == stream_id) {
+        if (user_ch[i].used && user_ch[i].webrtc == owner && user_ch[i].info.stream_id == stream_id) {
             return &user_ch[i];
         }
     }
     return NULL;
 }
 
-static void remove_channel(esp_peer_data_channel_info_t *ch)
+static void remove_channel(esp_webrtc_handle_t owner, esp_peer_data_channel_info_t *ch)
 {
     for (int i = 0; i < ELEMS(user_ch); i++) {
-        if (user_ch[i].used && user_ch[i].info.stream_id == ch->stream_id) {
+        if (user_ch[i].used && user_ch[i].webrtc == owner && user_ch[i].info.stream_id == ch->stream_id) {
             user_ch[i].used = false;
             ESP_LOGI(TAG, "Removed %s id %d finished", user_ch[i].info.label, ch->stream_id);
             free((char*)user_ch[i].info.label);
@@ -200,7 +228,7 @@ static void data_thread_hdlr(void *arg)
     int last_send_time = -SEND_PERIOD;
     int str_len = 8192;
     char *str = calloc(1, 8192);
-    while (webrtc) {
+    while (webrtc[0]) {
         bool need_send = false;
         for (int i = 0; i < ELEMS(user_ch); i++) {
             if (user_ch[i].used && time >= last_send_time + SEND_PERIOD) {
@@ -223,7 +251,7 @@ static void data_thread_hdlr(void *arg)
                     .size = str_len,
                 };
                 esp_peer_handle_t peer_handle = NULL;
-                esp_webrtc_get_peer_connection(webrtc, &peer_handle);
+                esp_webrtc_get_peer_connection(user_ch[i].webrtc, &peer_handle);
                 esp_peer_send_data(peer_handle, &data_frame);
                 printf("Send string %.*s", n, str);
             }
@@ -239,7 +267,7 @@ static void data_thread_hdlr(void *arg)
 static int webrtc_data_channel_opened(esp_peer_data_channel_info_t *ch, void *ctx)
 {
     ESP_LOGI(TAG, "Channel %s opened stream id %d", ch->label ? ch->label : "NULL", ch->stream_id);
-    add_channel(ch);
+    add_channel(webrtc[VIEWER_IDX(ctx)], ch);
     return 0;
 }
 
@@ -264,7 +292,7 @@ static bool verify_data(uint8_t *data, int size)
 
 static int webrtc_on_data(esp_peer_data_frame_t *frame, void *ctx)
 {
-    user_data_ch_t *ch = get_channel(frame->stream_id);
+    user_data_ch_t *ch = get_channel(webrtc[VIEWER_IDX(ctx)], frame->stream_id);
     char *line_end = strchr((char*)frame->data, '\n');
     if (line_end == NULL) {
         return -1;
@@ -287,16 +315,17 @@ static int webrtc_on_data(esp_peer_data_frame_t *frame, void *ctx)
 
 static int webrtc_data_channel_closed(esp_peer_data_channel_info_t *ch, void *ctx)
 {
-    remove_channel(ch);
+    remove_channel(webrtc[VIEWER_IDX(ctx)], ch);
     return 0;
 }
 
 static int webrtc_event_handler(esp_webrtc_event_t *event, void *ctx)
 {
+    int idx = VIEWER_IDX(ctx);
     if (event->type == ESP_WEBRTC_EVENT_CONNECTED) {
-        door_bell_change_state(DOOR_BELL_STATE_CONNECTED);
+        door_bell_change_state(idx, DOOR_BELL_STATE_CONNECTED);
     } else if (event->type == ESP_WEBRTC_EVENT_CONNECT_FAILED || event->type == ESP_WEBRTC_EVENT_DISCONNECTED) {
-        door_bell_change_state(DOOR_BELL_STATE_NONE);
+        door_bell_change_state(idx, DOOR_BELL_STATE_NONE);
     }
     return 0;
 }
@@ -304,7 +333,8 @@ static int webrtc_event_handler(esp_webrtc_event_t *event, void *ctx)
 void send_cmd(char *cmd)
 {
     if (SAME_STR(cmd, "ring")) {
-        SEND_CMD(webrtc, DOOR_BELL_RING_CMD);
+        // Ring all viewers, each of them can accept the call
+        send_cmd_to_all(DOOR_BELL_RING_CMD);
         ESP_LOGI(TAG, "Ring button on state %d", door_bell_state);
         if (door_bell_state < DOOR_BELL_STATE_CONNECTING) {
             door_bell_state = DOOR_BELL_STATE_RINGING;
@@ -340,20 +370,8 @@ static void key_monitor_thread(void *arg)
     media_lib_thread_destroy(NULL);
 }
 
-int start_webrtc(char *url)
+static int open_viewer(int idx, char *url, esp_webrtc_media_provider_t *media_provider)
 {
-    if (network_is_connected() == false) {
-        ESP_LOGE(TAG, "Wifi not connected yet");
-        return -1;
-    }
-    if (webrtc) {
-        esp_webrtc_close(webrtc);
-        webrtc = NULL;
-    }
-    monitor_key = true;
-    media_lib_thread_handle_t key_thread;
-    media_lib_thread_create_from_scheduler(&key_thread, "Key", key_monitor_thread, NULL);
-
     esp_peer_default_cfg_t peer_cfg = {
         .agent_recv_timeout = 500,
     };
@@ -376,7 +394,8 @@ int start_webrtc(char *url)
                 .height = VIDEO_HEIGHT,
                 .fps = VIDEO_FPS,
             },
-            .audio_dir = ESP_PEER_MEDIA_DIR_SEND_RECV,
+            // Player is shared, only first viewer can talk back
+            .audio_dir = (idx == 0) ? ESP_PEER_MEDIA_DIR_SEND_RECV : ESP_PEER_MEDIA_DIR_SEND_ONLY,
             .video_dir = ESP_PEER_MEDIA_DIR_SEND_ONLY,
             .on_custom_data = door_bell_on_cmd,
             // Add following data channel callback for more accurate control over data channel
@@ -388,6 +407,7 @@ int start_webrtc(char *url)
             .no_auto_reconnect = true, // No auto connect peer when signaling connected
             .extra_cfg = &peer_cfg,
             .extra_size = sizeof(peer_cfg),
+            .ctx = (void *)(intptr_t)idx,
         },
         .signaling_cfg = {
             .signal_url = url,
@@ -395,44 +415,74 @@ int start_webrtc(char *url)
         .peer_impl = esp_peer_get_default_impl(),
         .signaling_impl = esp_signaling_get_http_impl(),
     };
-    int ret = esp_webrtc_open(&cfg, &webrtc);
+    int ret = esp_webrtc_open(&cfg, &webrtc[idx]);
     if (ret != 0) {
-        ESP_LOGE(TAG, "Fail to open webrtc");
+        ESP_LOGE(TAG, "Fail to open webrtc for viewer %d", idx);
         return ret;
     }
+    // All viewers share same capture, encode once and send to every viewer
+    esp_webrtc_set_media_provider(webrtc[idx], media_provider);
+    esp_webrtc_set_fanout(webrtc[idx], true);
+#ifdef CONFIG_DOORBELL_SUPPORT_PEDESTRIAN_DETECT
+    // Disable auto capture
+    esp_webrtc_set_no_auto_capture(webrtc[idx], true);
+#endif
+
+    // Set event handler
+    esp_webrtc_set_event_handler(webrtc[idx], webrtc_event_handler, (void *)(intptr_t)idx);
+
+    // Default disable auto connect of peer connection
+    esp_webrtc_enable_peer_connection(webrtc[idx], false);
+    // Prepare peer connection in background so that call setup faster
+    esp_webrtc_set_prewarm(webrtc[idx], true, 0);
+    return 0;
+}
+
+int start_webrtc(char *url)
+{
+    if (network_is_connected() == false) {
+        ESP_LOGE(TAG, "Wifi not connected yet");
+        return -1;
+    }
+    stop_webrtc();
+    monitor_key = true;
+    media_lib_thread_handle_t key_thread;
+    media_lib_thread_create_from_scheduler(&key_thread, "Key", key_monitor_thread, NULL);
+
     // Set media provider
     esp_webrtc_media_provider_t media_provider = {};
     media_sys_get_provider(&media_provider);
-    esp_webrtc_set_media_provider(webrtc, &media_provider);
+    int ret = 0;
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        ret = open_viewer(i, url, &media_provider);
+        if (ret != 0) {
+            stop_webrtc();
+            return ret;
+        }
+    }
 
 #ifdef CONFIG_DOORBELL_SUPPORT_PEDESTRIAN_DETECT
-    // Disable auto capture
-    esp_webrtc_set_no_auto_capture(webrtc, true);
     // Pre-configuration for all sink
     esp_capture_sink_cfg_t sink_cfg = {
         .audio_info = {
 #ifdef WEBRTC_SUPPORT_OPUS
             .format_id = ESP_CAPTURE_FMT_ID_OPUS,
+            .sample_rate = 16000,
+            .channel = 2,
 #else
             .format_id = ESP_CAPTURE_FMT_ID_G711A,
+            .sample_rate = 8000,
+            .channel = 1,
 #endif
-            .sample_rate = cfg.peer_cfg.audio_info.sample_rate,
-            .channel = cfg.peer_cfg.audio_info.channel,
             .bits_per_sample = 16,
         },
         .video_info = {
             .format_id = ESP_CAPTURE_FMT_ID_H264,
-            .width = cfg.peer_cfg.video_info.width,
-            .height = cfg.peer_cfg.video_info.height,
-            .fps = cfg.peer_cfg.video_info.fps,
+            .width = VIDEO_WIDTH,
+            .height = VIDEO_HEIGHT,
+            .fps = VIDEO_FPS,
         },
     };
-    if (cfg.peer_cfg.audio_dir == ESP_PEER_MEDIA_DIR_RECV_ONLY) {
-        sink_cfg.audio_info.format_id = ESP_CAPTURE_FMT_ID_NONE;
-    }
-    if (cfg.peer_cfg.video_dir == ESP_PEER_MEDIA_DIR_RECV_ONLY) {
-        sink_cfg.video_info.format_id = ESP_CAPTURE_FMT_ID_NONE;
-    }
     esp_capture_sink_handle_t main_sink = NULL;
     esp_capture_sink_setup(media_provider.capture, 0, &sink_cfg, &main_sink);
 
@@ -449,20 +499,18 @@ int start_webrtc(char *url)
     esp_capture_sink_enable(detect_sink, ESP_CAPTURE_RUN_MODE_ALWAYS);
 #endif
 
-    // Set event handler
-    esp_webrtc_set_event_handler(webrtc, webrtc_event_handler, NULL);
-
-    // Default disable auto connect of peer connection
-    esp_webrtc_enable_peer_connection(webrtc, false);
-
     media_lib_thread_handle_t data_thread;
     media_lib_thread_create_from_scheduler(&data_thread, "data", data_thread_hdlr, NULL);
 
-    // Start webrtc
-    ret = esp_webrtc_start(webrtc);
-    if (ret != 0) {
-        ESP_LOGE(TAG, "Fail to start webrtc");
-    } else {
+    // Start webrtc, each viewer has its own signaling session
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        ret = esp_webrtc_start(webrtc[i]);
+        if (ret != 0) {
+            ESP_LOGE(TAG, "Fail to start webrtc for viewer %d", i);
+            break;
+        }
+    }
+    if (ret == 0) {
         play_tone(DOOR_BELL_TONE_JOIN_SUCCESS);
 #ifdef CONFIG_DOORBELL_SUPPORT_PEDESTRIAN_DETECT
         esp_capture_start(media_provider.capture);
@@ -477,31 +525,43 @@ int start_webrtc(char *url)
 
 void query_webrtc(void)
 {
-    if (webrtc) {
-        esp_webrtc_query(webrtc);
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        if (webrtc[i]) {
+            esp_webrtc_query(webrtc[i]);
+        }
     }
 }
 
 int stop_webrtc(void)
 {
-    if (webrtc) {
-        monitor_key = false;
-        esp_webrtc_handle_t handle = webrtc;
-        webrtc = NULL;
-        ESP_LOGI(TAG, "Start to close webrtc %p", handle);
+    if (webrtc[0] == NULL) {
+        return 0;
+    }
+    monitor_key = false;
+    esp_webrtc_handle_t handles[MAX_VIEWERS];
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        handles[i] = webrtc[i];
+        webrtc[i] = NULL;
+    }
+    ESP_LOGI(TAG, "Start to close webrtc");
 
 #ifdef CONFIG_DOORBELL_SUPPORT_PEDESTRIAN_DETECT
-       stop_pedestrian_detection();
-       esp_webrtc_media_provider_t media_provider = {};
-       media_sys_get_provider(&media_provider);
-       esp_capture_stop(media_provider.capture);
-       detect_sink = NULL;
+    stop_pedestrian_detection();
+    esp_webrtc_media_provider_t media_provider = {};
+    media_sys_get_provider(&media_provider);
+    esp_capture_stop(media_provider.capture);
+    detect_sink = NULL;
 #endif
-        esp_webrtc_close(handle);
-        // Wait for data running exit
-        while (data_running) {
-            media_lib_thread_sleep(10);
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        if (handles[i]) {
+            esp_webrtc_close(handles[i]);
         }
+        viewer_state[i] = DOOR_BELL_STATE_NONE;
+    }
+    door_bell_state = DOOR_BELL_STATE_NONE;
+    // Wait for data running exit
+    while (data_running) {
+        media_lib_thread_sleep(10);
     }
     return 0;
 }
@@ -11,25 +11,66 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_http_server.h"
 #include "esp_https_server.h"
 #include "esp_log.h"
 #include "cJSON.h"
+#include "webrtc_utils_json.h"
 #include "esp_peer_signaling.h"
 #include "webrtc_http_server.h"
 #include "media_lib_socket.h"
 
 #define MAX_CONTENT_LEN          (16 * 1024)
 #define MAX_SIGNALING_QUEUE_SIZE 10
+#define MAX_CLIENT_ID_LEN        (32)
+#define DEFAULT_CLIENT_ID        "default"
+
+#ifdef CONFIG_DOORBELL_MAX_VIEWERS
+#define MAX_SIGNALING_SESSION    CONFIG_DOORBELL_MAX_VIEWERS
+#else
+#define MAX_SIGNALING_SESSION    (1)
+#endif
 
 static const char *TAG = "WEBRTC_HTTP";
 
+/**
+ * @brief  Signaling session, one for each WebRTC instance
+ *         Browser client is bound to an idle session when its event stream is connected
+ */
+typedef struct {
+    bool                     used;
+    char                     client_id[MAX_CLIENT_ID_LEN];
+    esp_peer_signaling_cfg_t cfg;
+    QueueHandle_t            queue;
+    httpd_req_t             *event_stream_req;
+    bool                     event_stream_connected;
+    bool                     event_stream_stopping;
+} signaling_session_t;
+
 static httpd_handle_t server = NULL;
-static QueueHandle_t signaling_queue = NULL;
-static esp_peer_signaling_cfg_t sig_cfg = { 0 };
-static bool event_stream_connected = false;
-static bool event_stream_stopping  = false;
-static httpd_req_t *event_stream_req = NULL;
+static signaling_session_t sessions[MAX_SIGNALING_SESSION];
+static SemaphoreHandle_t session_lock = NULL;
+
+static void get_client_id(httpd_req_t *req, char *client_id)
+{
+    char query[64];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "id", client_id, MAX_CLIENT_ID_LEN) != ESP_OK ||
+        client_id[0] == '\0') {
+        strcpy(client_id, DEFAULT_CLIENT_ID);
+    }
+}
+
+static signaling_session_t *find_session(const char *client_id)
+{
+    for (int i = 0; i < MAX_SIGNALING_SESSION; i++) {
+        if (sessions[i].used && strcmp(sessions[i].client_id, client_id) == 0) {
+            return &sessions[i];
+        }
+    }
+    return NULL;
+}
 
 static int send_event_stream_msg(httpd_req_t *req, char *data)
 {
@@ -46,14 +87,15 @@ static int send_event_stream_msg(httpd_req_t *req, char *data)
 
 static void signaling_msg_send_task(void *arg)
 {
+    signaling_session_t *session = (signaling_session_t *)arg;
     uint32_t hear_beat = esp_timer_get_time() / 1000;
-    while (!event_stream_stopping) {
+    while (!session->event_stream_stopping) {
         char *msg = NULL;
         int ret = 0;
-        if (xQueueReceive(signaling_queue, &msg, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (xQueueReceive(session->queue, &msg, pdMS_TO_TICKS(100)) == pdTRUE) {
             if (msg) {
-                printf("Received %s\n", msg);
-                ret = send_event_stream_msg(event_stream_req, msg);
+                printf("Send to %s: %s\n", session->client_id, msg);
+                ret = send_event_stream_msg(session->event_stream_req, msg);
                 free(msg);
                 if (ret != 0) {
                     break;
@@ -63,18 +105,22 @@ static void signaling_msg_send_task(void *arg)
         // Send heart beat to check peer disappered or not
         if (esp_timer_get_time() / 1000 - hear_beat > 5000) {
             hear_beat = esp_timer_get_time() / 1000;
-            ret = send_event_stream_msg(event_stream_req, "{\"type\":\"heartbeat\"}");
+            ret = send_event_stream_msg(session->event_stream_req, "{\"type\":\"heartbeat\"}");
             if (ret != 0) {
                 ESP_LOGE(TAG, "Failed to send heartbeat ret %d", ret);
                 break;
             }
         }
     }
-    httpd_req_async_handler_complete(event_stream_req);
-    event_stream_req = NULL;
-    event_stream_connected = false;
-    event_stream_stopping = false;
-    ESP_LOGI(TAG, "Event Stream hdlr Quit");
+    httpd_req_async_handler_complete(session->event_stream_req);
+    ESP_LOGI(TAG, "Event Stream of %s Quit", session->client_id);
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    // Release session so that other client can use it
+    session->event_stream_req = NULL;
+    session->client_id[0] = '\0';
+    session->event_stream_connected = false;
+    session->event_stream_stopping = false;
+    xSemaphoreGive(session_lock);
     vTaskDelete(NULL);
 }
 
@@ -86,22 +132,57 @@ static esp_err_t webrtc_signal_get_handler(httpd_req_t *req)
     httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
     httpd_resp_set_hdr(req, "Connection", "keep-alive");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    if (event_stream_connected) {
-        // Send initial connection message
-        send_event_stream_msg(req, "{\"error\":\"Only allow one listener\"}");
+    char client_id[MAX_CLIENT_ID_LEN];
+    get_client_id(req, client_id);
+
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    signaling_session_t *session = find_session(client_id);
+    if (session) {
+        xSemaphoreGive(session_lock);
+        send_event_stream_msg(req, "{\"error\":\"Client already listening\"}");
         return 0;
     }
-    send_event_stream_msg(req, "{\"type\":\"connected\"}");
-    event_stream_connected = true;
-    httpd_req_async_handler_begin(req, &event_stream_req);
-    if (event_stream_req) {
-        // Keep the connection open for SSE and process messages from queue
-        xTaskCreate(signaling_msg_send_task, "signal_hdlr", 4096, NULL, 5, NULL);
+    // Bind client to an idle session
+    for (int i = 0; i < MAX_SIGNALING_SESSION; i++) {
+        if (sessions[i].used && sessions[i].client_id[0] == '\0' && sessions[i].event_stream_connected == false) {
+            session = &sessions[i];
+            break;
+        }
+    }
+    if (session == NULL) {
+        xSemaphoreGive(session_lock);
+        send_event_stream_msg(req, "{\"error\":\"Too many viewers\"}");
+        return 0;
     }
+    strcpy(session->client_id, client_id);
+    session->event_stream_connected = true;
+    xSemaphoreGive(session_lock);
 
+    ESP_LOGI(TAG, "Client %s connected", client_id);
+    send_event_stream_msg(req, "{\"type\":\"connected\"}");
+    httpd_req_async_handler_begin(req, &session->event_stream_req);
+    if (session->event_stream_req == NULL ||
+        xTaskCreate(signaling_msg_send_task, "signal_hdlr", 4096, session, 5, NULL) != pdPASS) {
+        if (session->event_stream_req) {
+            httpd_req_async_handler_complete(session->event_stream_req);
+            session->event_stream_req = NULL;
+        }
+        xSemaphoreTake(session_lock, portMAX_DELAY);
+        session->client_id[0] = '\0';
+        session->event_stream_connected = false;
+        xSemaphoreGive(session_lock);
+    }
     return ESP_OK;
 }
 
+static esp_err_t get_string_field(webrtc_utils_json_field_t *field)
+{
+    if (field->value.str == NULL || field->is_str == false) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return webrtc_utils_json_unescape(&field->value);
+}
+
 // Handler for POST /webrtc/signal
 static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
 {
@@ -127,7 +208,6 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
     }
 
     int ret = ESP_OK;
-    cJSON *root = NULL;
 
     int readed = 0;
     while (readed < req->content_len) {
@@ -143,18 +223,39 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
     }
     buf[readed] = '\0';
 
-    printf("Get post %s\n", buf);
+    char client_id[MAX_CLIENT_ID_LEN];
+    get_client_id(req, client_id);
+    printf("Get post from %s %s\n", client_id, buf);
     ret = ESP_OK;
-    // Parse JSON message
-    root = cJSON_Parse(buf);
-    if (!root) {
+    signaling_session_t *session = find_session(client_id);
+    if (session == NULL) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Client not listening");
+        ret = ESP_FAIL;
+        goto _exit;
+    }
+    esp_peer_signaling_cfg_t *sig_cfg = &session->cfg;
+    // Parse JSON message in place, string values are unescaped into the receive buffer
+    enum {
+        FIELD_TYPE,
+        FIELD_SDP,
+        FIELD_CANDIDATE,
+        FIELD_DATA,
+        FIELD_MAX,
+    };
+    webrtc_utils_json_field_t fields[FIELD_MAX] = {
+        [FIELD_TYPE] = { .key = "type" },
+        [FIELD_SDP] = { .key = "sdp" },
+        [FIELD_CANDIDATE] = { .key = "candidate" },
+        [FIELD_DATA] = { .key = "data" },
+    };
+    if (webrtc_utils_json_find(buf, readed, fields, FIELD_MAX) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
         ret = ESP_FAIL;
         goto _exit;
     }
 
-    cJSON *type = cJSON_GetObjectItem(root, "type");
-    if (!type || !type->valuestring) {
+    webrtc_utils_json_field_t *type = &fields[FIELD_TYPE];
+    if (get_string_field(type) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing type");
         ret = ESP_FAIL;
         goto _exit;
@@ -162,67 +263,72 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
 
     esp_peer_signaling_msg_t msg = { 0 };
 
-    if (strcmp(type->valuestring, "offer") == 0) {
-        cJSON *sdp = cJSON_GetObjectItem(root, "sdp");
-        if (!sdp || !sdp->valuestring) {
+    if (webrtc_utils_json_equal(&type->value, "offer")) {
+        webrtc_utils_json_field_t *sdp = &fields[FIELD_SDP];
+        if (get_string_field(sdp) != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing SDP");
             ret = ESP_FAIL;
             goto _exit;
         }
         msg.type = ESP_PEER_SIGNALING_MSG_SDP;
-        msg.data = (uint8_t *)sdp->valuestring;
-        msg.size = strlen(sdp->valuestring);
-    } else if (strcmp(type->valuestring, "answer") == 0) {
-        cJSON *sdp = cJSON_GetObjectItem(root, "sdp");
-        if (!sdp || !sdp->valuestring) {
+        msg.data = (uint8_t *)sdp->value.str;
+        msg.size = sdp->value.len;
+    } else if (webrtc_utils_json_equal(&type->value, "answer")) {
+        webrtc_utils_json_field_t *sdp = &fields[FIELD_SDP];
+        if (get_string_field(sdp) != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing SDP");
             ret = ESP_FAIL;
             goto _exit;
         }
         msg.type = ESP_PEER_SIGNALING_MSG_SDP;
-        msg.data = (uint8_t *)sdp->valuestring;
-        msg.size = strlen(sdp->valuestring);
+        msg.data = (uint8_t *)sdp->value.str;
+        msg.size = sdp->value.len;
 
         // Extract ICE candidates from SDP and send them separately
-        char *sdp_str = strdup(sdp->valuestring);
-        if (sdp_str) {
-            char *line = strtok(sdp_str, "\r\n");
-            while (line != NULL) {
-                if (strncmp(line, "a=candidate:", 11) == 0) {
-                    esp_peer_signaling_msg_t candidate_msg = { 0 };
-                    candidate_msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
-                    candidate_msg.data = (uint8_t *)line;
-                    candidate_msg.size = strlen(line);
-
-                    // Send candidate to peer
-                    sig_cfg.on_msg(&candidate_msg, sig_cfg.ctx);
-                }
-                line = strtok(NULL, "\r\n");
+        char *line = sdp->value.str;
+        char *sdp_end = sdp->value.str + sdp->value.len;
+        while (line < sdp_end) {
+            char *line_end = line;
+            while (line_end < sdp_end && *line_end != '\r' && *line_end != '\n') {
+                line_end++;
             }
-            free(sdp_str);
+            if (line_end - line > 11 && strncmp(line, "a=candidate:", 11) == 0) {
+                // Terminate line temporarily, SDP is restored after candidate notified
+                char saved = *line_end;
+                *line_end = '\0';
+                esp_peer_signaling_msg_t candidate_msg = { 0 };
+                candidate_msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
+                candidate_msg.data = (uint8_t *)line;
+                candidate_msg.size = line_end - line;
+
+                // Send candidate to peer
+                sig_cfg->on_msg(&candidate_msg, sig_cfg->ctx);
+                *line_end = saved;
+            }
+            line = line_end + 1;
         }
-    } else if (strcmp(type->valuestring, "candidate") == 0) {
-        cJSON *candidate = cJSON_GetObjectItem(root, "candidate");
-        if (!candidate || !candidate->valuestring) {
+    } else if (webrtc_utils_json_equal(&type->value, "candidate")) {
+        webrtc_utils_json_field_t *candidate = &fields[FIELD_CANDIDATE];
+        if (get_string_field(candidate) != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing candidate string");
             ret = ESP_FAIL;
             goto _exit;
         }
         msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
-        msg.data = (uint8_t *)candidate->valuestring;
-        msg.size = strlen(candidate->valuestring);
-    } else if (strcmp(type->valuestring, "bye") == 0) {
+        msg.data = (uint8_t *)candidate->value.str;
+        msg.size = candidate->value.len;
+    } else if (webrtc_utils_json_equal(&type->value, "bye")) {
         msg.type = ESP_PEER_SIGNALING_MSG_BYE;
-    } else if (strcmp(type->valuestring, "customized") == 0) {
-        cJSON *data = cJSON_GetObjectItem(root, "data");
-        if (!data || !data->valuestring) {
+    } else if (webrtc_utils_json_equal(&type->value, "customized")) {
+        webrtc_utils_json_field_t *data = &fields[FIELD_DATA];
+        if (get_string_field(data) != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing data for customized message");
             ret = ESP_FAIL;
             goto _exit;
         }
         msg.type = ESP_PEER_SIGNALING_MSG_CUSTOMIZED;
-        msg.data = (uint8_t *)data->valuestring;
-        msg.size = strlen(data->valuestring);
+        msg.data = (uint8_t *)data->value.str;
+        msg.size = data->value.len;
     } else {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown message type");
         ret = ESP_FAIL;
@@ -230,12 +336,11 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
     }
     if (msg.type) {
         // Notify for received message
-        sig_cfg.on_msg(&msg, sig_cfg.ctx);
+        sig_cfg->on_msg(&msg, sig_cfg->ctx);
     }
     httpd_resp_sendstr(req, "OK");
 _exit:
     free(buf);
-    cJSON_Delete(root);
     return ret;
 }
 
@@ -326,32 +431,64 @@ static esp_err_t init_http_server(void)
     return ESP_OK;
 }
 
+static int get_session_num(void)
+{
+    int num = 0;
+    for (int i = 0; i < MAX_SIGNALING_SESSION; i++) {
+        if (sessions[i].used) {
+            num++;
+        }
+    }
+    return num;
+}
+
 static esp_err_t webrtc_http_server_init(esp_peer_signaling_cfg_t *cfg, esp_peer_signaling_handle_t *h)
 {
+    if (session_lock == NULL) {
+        session_lock = xSemaphoreCreateMutex();
+        if (session_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    signaling_session_t *session = NULL;
+    for (int i = 0; i < MAX_SIGNALING_SESSION; i++) {
+        if (sessions[i].used == false) {
+            session = &sessions[i];
+            break;
+        }
+    }
+    if (session == NULL) {
+        ESP_LOGE(TAG, "Only support %d signaling sessions", MAX_SIGNALING_SESSION);
+        return ESP_ERR_NO_MEM;
+    }
     // Create signaling queue
-    signaling_queue = xQueueCreate(MAX_SIGNALING_QUEUE_SIZE, sizeof(char *));
-    if (!signaling_queue) {
+    session->queue = xQueueCreate(MAX_SIGNALING_QUEUE_SIZE, sizeof(char *));
+    if (!session->queue) {
         ESP_LOGE(TAG, "Failed to create signaling queue");
         return ESP_FAIL;
     }
 
-    // Initialize HTTP server
-    esp_err_t ret = init_http_server();
-    if (ret != ESP_OK) {
-        vQueueDelete(signaling_queue);
-        signaling_queue = NULL;
-        return ret;
+    // Initialize HTTP server for first session only
+    if (server == NULL) {
+        esp_err_t ret = init_http_server();
+        if (ret != ESP_OK) {
+            vQueueDelete(session->queue);
+            session->queue = NULL;
+            return ret;
+        }
     }
-    sig_cfg = *cfg;
+    session->cfg = *cfg;
+    session->client_id[0] = '\0';
+    session->used = true;
     esp_peer_signaling_ice_info_t ice_info = {
         .is_initiator = true,
         .server_info.stun_url = "stun:stun.l.google.com:19302",
     };
     // Notify for rule
-    sig_cfg.on_ice_info(&ice_info, cfg->ctx);
-    sig_cfg.on_connected(cfg->ctx);
-    *h = (esp_peer_signaling_handle_t)signaling_queue;
-    ESP_LOGI(TAG, "Success to init http server");
+    session->cfg.on_ice_info(&ice_info, cfg->ctx);
+    session->cfg.on_connected(cfg->ctx);
+    *h = (esp_peer_signaling_handle_t)session;
+    ESP_LOGI(TAG, "Success to init signaling session %d", (int)(session - sessions));
     return ESP_OK;
 }
 
@@ -382,7 +519,8 @@ static int resend_all_candidate(esp_peer_signaling_handle_t sig, char *str)
 
 static int webrtc_http_server_send_msg(esp_peer_signaling_handle_t sig, esp_peer_signaling_msg_t *msg)
 {
-    if (signaling_queue == NULL || sig != signaling_queue || msg == NULL) {
+    signaling_session_t *session = (signaling_session_t *)sig;
+    if (session == NULL || session->used == false || msg == NULL) {
         return -1;
     }
     cJSON *msg_root = cJSON_CreateObject();
@@ -415,7 +553,7 @@ static int webrtc_http_server_send_msg(esp_peer_signaling_handle_t sig, esp_peer
     cJSON_Delete(msg_root);
     if (json_str) {
         // When send into queue it will be released when received
-        if (xQueueSend(signaling_queue, &json_str, pdMS_TO_TICKS(100)) != pdTRUE) {
+        if (xQueueSend(session->queue, &json_str, pdMS_TO_TICKS(100)) != pdTRUE) {
             ESP_LOGW(TAG, "Failed to send message to signaling queue");
             free(json_str);
         }
@@ -429,36 +567,38 @@ static int webrtc_http_server_send_msg(esp_peer_signaling_handle_t sig, esp_peer
 // Cleanup function
 static int webrtc_http_server_deinit(esp_peer_signaling_handle_t sig)
 {
-    if (signaling_queue == NULL || sig != signaling_queue) {
+    signaling_session_t *session = (signaling_session_t *)sig;
+    if (session == NULL || session->used == false) {
         return -1;
     }
-    ESP_LOGI(TAG, "Start to stop https server");
-    if (signaling_queue) {
-        // Clear and delete the queue
-        char *msg = NULL;
-        while (xQueueReceive(signaling_queue, &msg, 0) == pdTRUE) {
-            if (msg) {
-                free(msg);
-            }
+    ESP_LOGI(TAG, "Start to stop signaling session %d", (int)(session - sessions));
+    // Clear queue
+    char *msg = NULL;
+    while (xQueueReceive(session->queue, &msg, 0) == pdTRUE) {
+        if (msg) {
+            free(msg);
         }
     }
-    if (event_stream_connected) {
-        event_stream_stopping = true;
+    if (session->event_stream_connected) {
+        session->event_stream_stopping = true;
         ESP_LOGI(TAG, "Wait event stream stopped");
         // Wait for event stream to disconnected
-        while (event_stream_connected) {
+        while (session->event_stream_connected) {
             vTaskDelay(pdMS_TO_TICKS(100));
         }
     }
-    if (server) {
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    session->used = false;
+    xSemaphoreGive(session_lock);
+    vQueueDelete(session->queue);
+    session->queue = NULL;
+    // Stop server when all sessions stopped
+    if (get_session_num() == 0 && server) {
+        ESP_LOGI(TAG, "Start to stop https server");
         httpd_ssl_stop(server);
         server = NULL;
+        ESP_LOGI(TAG, "End to stop https server");
     }
-    if (signaling_queue) {
-        vQueueDelete(signaling_queue);
-        signaling_queue = NULL;
-    }
-    ESP_LOGI(TAG, "End to stop https server");
     return 0;
 }
 
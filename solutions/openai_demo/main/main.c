@@ -231,12 +231,14 @@ static void capture_scheduler(const char *name, esp_capture_thread_schedule_cfg_
         .stack_size = schedule_cfg->stack_size,
         .priority = schedule_cfg->priority,
         .core_id = schedule_cfg->core_id,
+        .stack_in_ext = true,
     };
-    schedule_cfg->stack_in_ext = true;
-    thread_scheduler(name, &cfg);
+    // Apply schedule callback and loaded schedule profile
+    media_lib_thread_get_schedule_cfg(name, &cfg);
     schedule_cfg->stack_size = cfg.stack_size;
     schedule_cfg->priority = cfg.priority;
     schedule_cfg->core_id = cfg.core_id;
+    schedule_cfg->stack_in_ext = cfg.stack_in_ext;
 }
 
 void app_main(void)
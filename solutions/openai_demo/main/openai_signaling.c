@@ -192,6 +192,7 @@ static int openai_signaling_send_msg(esp_peer_signaling_handle_t h, esp_peer_sig
 static int openai_signaling_stop(esp_peer_signaling_handle_t h)
 {
     openai_signaling_t *sig = (openai_signaling_t *)h;
+    https_pool_flush();
     sig->cfg.on_close(sig->cfg.ctx);
     SAFE_FREE(sig->remote_sdp);
     SAFE_FREE(sig->ephemeral_token);
@@ -259,6 +259,8 @@ int start_webrtc(char *url)
 
     // Default disable auto connect of peer connection
     esp_webrtc_enable_peer_connection(webrtc, false);
+    // Prepare peer connection in background so that call setup faster
+    esp_webrtc_set_prewarm(webrtc, true, 0);
 
     // Start webrtc
     ret = esp_webrtc_start(webrtc);
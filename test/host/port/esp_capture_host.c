@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <string.h>
+#include "esp_capture_host.h"
+
+esp_capture_err_t esp_capture_start(esp_capture_handle_t capture)
+{
+    pthread_mutex_lock(&capture->lock);
+    capture->started = true;
+    capture->start_num++;
+    pthread_mutex_unlock(&capture->lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_err_t esp_capture_stop(esp_capture_handle_t capture)
+{
+    pthread_mutex_lock(&capture->lock);
+    capture->started = false;
+    capture->stop_num++;
+    // Stopped capture drops what is not fetched yet
+    for (int i = 0; i < ESP_CAPTURE_HOST_SINK_NUM; i++) {
+        capture->sinks[i].rd = capture->sinks[i].wr;
+    }
+    pthread_mutex_unlock(&capture->lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_err_t esp_capture_sink_setup(esp_capture_handle_t capture, uint8_t sink_idx, esp_capture_sink_cfg_t *sink_info,
+                                         esp_capture_sink_handle_t *sink)
+{
+    if (sink_idx >= ESP_CAPTURE_HOST_SINK_NUM) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    capture->sinks[sink_idx].capture = capture;
+    *sink = &capture->sinks[sink_idx];
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_err_t esp_capture_sink_enable(esp_capture_sink_handle_t sink, esp_capture_run_mode_t run_type)
+{
+    pthread_mutex_lock(&sink->capture->lock);
+    sink->enabled = (run_type != ESP_CAPTURE_RUN_MODE_DISABLE);
+    pthread_mutex_unlock(&sink->capture->lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_err_t esp_capture_sink_acquire_frame(esp_capture_sink_handle_t sink, esp_capture_stream_frame_t *frame,
+                                                 bool no_wait)
+{
+    esp_capture_err_t ret = ESP_CAPTURE_ERR_NOT_ENOUGH;
+    pthread_mutex_lock(&sink->capture->lock);
+    if (sink->capture->started && sink->enabled && sink->rd != sink->wr) {
+        esp_capture_host_frame_t *f = &sink->queue[sink->rd % ESP_CAPTURE_HOST_QUEUE_SIZE];
+        if (f->type == frame->stream_type) {
+            sink->rd++;
+            // H264 like payload so that fan-out can tell key frame
+            memset(sink->data, 0xAA, f->size);
+            sink->data[0] = sink->data[1] = 0;
+            sink->data[2] = 1;
+            sink->data[3] = f->key ? 5 : 1;
+            sink->data[4] = (uint8_t)f->pts;
+            frame->pts = f->pts;
+            frame->data = sink->data;
+            frame->size = f->size;
+            ret = ESP_CAPTURE_ERR_OK;
+        }
+    }
+    pthread_mutex_unlock(&sink->capture->lock);
+    return ret;
+}
+
+esp_capture_err_t esp_capture_sink_release_frame(esp_capture_sink_handle_t sink, esp_capture_stream_frame_t *frame)
+{
+    return ESP_CAPTURE_ERR_OK;
+}
+
+void esp_capture_host_init(struct esp_capture_t *capture)
+{
+    memset(capture, 0, sizeof(struct esp_capture_t));
+    pthread_mutex_init(&capture->lock, NULL);
+}
+
+void esp_capture_host_push(struct esp_capture_t *capture, int sink_idx, esp_capture_stream_type_t type, uint32_t pts,
+                           int size, bool key)
+{
+    struct esp_capture_sink_t *sink = &capture->sinks[sink_idx];
+    pthread_mutex_lock(&capture->lock);
+    if (sink->wr - sink->rd < ESP_CAPTURE_HOST_QUEUE_SIZE) {
+        esp_capture_host_frame_t *f = &sink->queue[sink->wr % ESP_CAPTURE_HOST_QUEUE_SIZE];
+        f->type = type;
+        f->pts = pts;
+        f->size = size;
+        f->key = key;
+        sink->wr++;
+    }
+    pthread_mutex_unlock(&capture->lock);
+}
+
+bool esp_capture_host_started(struct esp_capture_t *capture)
+{
+    pthread_mutex_lock(&capture->lock);
+    bool started = capture->started;
+    pthread_mutex_unlock(&capture->lock);
+    return started;
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include "esp_capture_sink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_CAPTURE_HOST_SINK_NUM    (3)
+#define ESP_CAPTURE_HOST_QUEUE_SIZE  (16)
+#define ESP_CAPTURE_HOST_FRAME_MAX   (4096)
+
+/**
+ * @brief  Fake capture, frames are queued by test and only delivered when capture started and sink enabled
+ */
+typedef struct {
+    esp_capture_stream_type_t type;
+    uint32_t                  pts;
+    int                       size;
+    bool                      key;
+} esp_capture_host_frame_t;
+
+struct esp_capture_sink_t {
+    struct esp_capture_t     *capture;
+    bool                      enabled;
+    esp_capture_host_frame_t  queue[ESP_CAPTURE_HOST_QUEUE_SIZE];
+    int                       rd;
+    int                       wr;
+    uint8_t                   data[ESP_CAPTURE_HOST_FRAME_MAX];
+};
+
+struct esp_capture_t {
+    struct esp_capture_sink_t sinks[ESP_CAPTURE_HOST_SINK_NUM];
+    pthread_mutex_t           lock;
+    bool                      started;
+    int                       start_num;
+    int                       stop_num;
+};
+
+/**
+ * @brief  Initialize fake capture
+ *
+ * @param[in]  capture  Fake capture to initialize
+ */
+void esp_capture_host_init(struct esp_capture_t *capture);
+
+/**
+ * @brief  Queue one frame into sink of fake capture
+ *
+ * @note  Video payload is H264 like, NAL type is 5 for key frame and 1 otherwise
+ *        Frame is dropped when queue is full
+ *
+ * @param[in]  capture   Fake capture
+ * @param[in]  sink_idx  Sink index
+ * @param[in]  type      Stream type
+ * @param[in]  pts       Frame PTS
+ * @param[in]  size      Frame size
+ * @param[in]  key       Whether video key frame
+ */
+void esp_capture_host_push(struct esp_capture_t *capture, int sink_idx, esp_capture_stream_type_t type, uint32_t pts,
+                           int size, bool key);
+
+/**
+ * @brief  Check whether fake capture is started
+ *
+ * @param[in]  capture  Fake capture
+ *
+ * @return
+ *       - true   Capture started
+ *       - false  Capture stopped
+ */
+bool esp_capture_host_started(struct esp_capture_t *capture);
+
+#ifdef __cplusplus
+}
+#endif
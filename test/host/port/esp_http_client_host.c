@@ -0,0 +1,487 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "esp_http_client.h"
+
+#define HOST_HTTP_MAX_HEADER  (16)
+#define HOST_HTTP_HOST_SIZE   (64)
+#define HOST_HTTP_LINE_SIZE   (1024)
+#define HOST_HTTP_RECV_SIZE   (2048)
+#define HOST_HTTP_DEFAULT_BUF (512)
+
+typedef struct {
+    char *key;
+    char *value;
+} host_http_header_t;
+
+struct esp_http_client {
+    http_event_handle_cb      event_handler;
+    void                     *user_data;
+    int                       timeout_ms;
+    int                       buffer_size;
+    bool                      keep_alive_enable;
+    char                     *url;
+    esp_http_client_method_t  method;
+    const char               *post_data;
+    int                       post_len;
+    host_http_header_t        headers[HOST_HTTP_MAX_HEADER];
+    int                       sock;
+    char                      conn_host[HOST_HTTP_HOST_SIZE];
+    int                       conn_port;
+    uint8_t                   recv_buf[HOST_HTTP_RECV_SIZE];
+    int                       recv_rd;
+    int                       recv_wr;
+    int                       status;
+    int64_t                   content_length;
+    bool                      chunked;
+    bool                      server_close;
+};
+
+static const char *method_name[] = {
+    [HTTP_METHOD_GET] = "GET",
+    [HTTP_METHOD_POST] = "POST",
+    [HTTP_METHOD_PUT] = "PUT",
+    [HTTP_METHOD_PATCH] = "PATCH",
+    [HTTP_METHOD_DELETE] = "DELETE",
+};
+
+static void dispatch_event(esp_http_client_handle_t client, esp_http_client_event_id_t id, void *data, int len)
+{
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = client,
+        .data = data,
+        .data_len = len,
+        .user_data = client->user_data,
+    };
+    if (client->event_handler) {
+        client->event_handler(&evt);
+    }
+}
+
+static bool split_url(const char *url, char *host, int *port, const char **path)
+{
+    if (strncmp(url, "http://", 7) != 0) {
+        return false;
+    }
+    const char *h = url + 7;
+    const char *end = h + strcspn(h, ":/");
+    if (end == h || end - h >= HOST_HTTP_HOST_SIZE) {
+        return false;
+    }
+    memcpy(host, h, end - h);
+    host[end - h] = '\0';
+    *port = 80;
+    if (*end == ':') {
+        *port = atoi(end + 1);
+        end += strcspn(end, "/");
+    }
+    *path = *end ? end : "/";
+    return true;
+}
+
+static int host_connect(esp_http_client_handle_t client, const char *host, int port)
+{
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host, port_str, &hints, &res) != 0) {
+        return -1;
+    }
+    int sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (sock >= 0 && connect(sock, res->ai_addr, res->ai_addrlen) != 0) {
+        close(sock);
+        sock = -1;
+    }
+    freeaddrinfo(res);
+    if (sock < 0) {
+        return -1;
+    }
+    struct timeval tv = {
+        .tv_sec = client->timeout_ms / 1000,
+        .tv_usec = (client->timeout_ms % 1000) * 1000,
+    };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    client->sock = sock;
+    strcpy(client->conn_host, host);
+    client->conn_port = port;
+    client->recv_rd = client->recv_wr = 0;
+    dispatch_event(client, HTTP_EVENT_ON_CONNECTED, NULL, 0);
+    return 0;
+}
+
+static int send_all(int sock, const char *data, int len)
+{
+    while (len > 0) {
+        int ret = send(sock, data, len, MSG_NOSIGNAL);
+        if (ret <= 0) {
+            return -1;
+        }
+        data += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+static int fill_recv(esp_http_client_handle_t client)
+{
+    if (client->recv_rd == client->recv_wr) {
+        client->recv_rd = client->recv_wr = 0;
+    }
+    int ret = recv(client->sock, client->recv_buf + client->recv_wr, HOST_HTTP_RECV_SIZE - client->recv_wr, 0);
+    if (ret <= 0) {
+        return -1;
+    }
+    client->recv_wr += ret;
+    return ret;
+}
+
+static int read_line(esp_http_client_handle_t client, char *line, int size)
+{
+    int len = 0;
+    while (1) {
+        while (client->recv_rd < client->recv_wr) {
+            char c = (char)client->recv_buf[client->recv_rd++];
+            if (c == '\n') {
+                if (len && line[len - 1] == '\r') {
+                    len--;
+                }
+                line[len] = '\0';
+                return len;
+            }
+            if (len >= size - 1) {
+                return -1;
+            }
+            line[len++] = c;
+        }
+        if (fill_recv(client) < 0) {
+            return -1;
+        }
+    }
+}
+
+static int read_data(esp_http_client_handle_t client, uint8_t *data, int size)
+{
+    if (client->recv_rd == client->recv_wr && fill_recv(client) < 0) {
+        return -1;
+    }
+    int len = client->recv_wr - client->recv_rd;
+    if (len > size) {
+        len = size;
+    }
+    memcpy(data, client->recv_buf + client->recv_rd, len);
+    client->recv_rd += len;
+    return len;
+}
+
+static int deliver_body(esp_http_client_handle_t client, int64_t size, uint8_t *buf)
+{
+    // Body given to user in pieces of at most buffer size same as IDF client
+    while (size > 0) {
+        int len = read_data(client, buf, size > client->buffer_size ? client->buffer_size : (int)size);
+        if (len < 0) {
+            return -1;
+        }
+        dispatch_event(client, HTTP_EVENT_ON_DATA, buf, len);
+        size -= len;
+    }
+    return 0;
+}
+
+static int read_chunked_body(esp_http_client_handle_t client, uint8_t *buf)
+{
+    char line[HOST_HTTP_LINE_SIZE];
+    while (1) {
+        if (read_line(client, line, sizeof(line)) < 0) {
+            return -1;
+        }
+        char *end = NULL;
+        long size = strtol(line, &end, 16);
+        if (end == line || size < 0) {
+            return -1;
+        }
+        if (size == 0) {
+            break;
+        }
+        if (deliver_body(client, size, buf) != 0 || read_line(client, line, sizeof(line)) != 0) {
+            return -1;
+        }
+    }
+    // Skip trailers
+    int len;
+    while ((len = read_line(client, line, sizeof(line))) > 0);
+    return len;
+}
+
+static int read_response(esp_http_client_handle_t client)
+{
+    char line[HOST_HTTP_LINE_SIZE];
+    if (read_line(client, line, sizeof(line)) < 0 || sscanf(line, "HTTP/1.%*d %d", &client->status) != 1) {
+        return -1;
+    }
+    client->content_length = -1;
+    client->chunked = false;
+    client->server_close = false;
+    while (1) {
+        int len = read_line(client, line, sizeof(line));
+        if (len < 0) {
+            return -1;
+        }
+        if (len == 0) {
+            break;
+        }
+        char *colon = strchr(line, ':');
+        if (colon == NULL) {
+            continue;
+        }
+        *colon = '\0';
+        char *value = colon + 1;
+        while (*value == ' ') {
+            value++;
+        }
+        if (strcasecmp(line, "Content-Length") == 0) {
+            client->content_length = atoll(value);
+        } else if (strcasecmp(line, "Transfer-Encoding") == 0 && strcasecmp(value, "chunked") == 0) {
+            client->chunked = true;
+        } else if (strcasecmp(line, "Connection") == 0 && strcasecmp(value, "close") == 0) {
+            client->server_close = true;
+        }
+        esp_http_client_event_t evt = {
+            .event_id = HTTP_EVENT_ON_HEADER,
+            .client = client,
+            .user_data = client->user_data,
+            .header_key = line,
+            .header_value = value,
+        };
+        client->event_handler(&evt);
+    }
+    if (client->chunked) {
+        client->content_length = -1;
+    }
+    uint8_t *buf = malloc(client->buffer_size);
+    if (buf == NULL) {
+        return -1;
+    }
+    int ret = 0;
+    if (client->chunked) {
+        ret = read_chunked_body(client, buf);
+    } else if (client->content_length > 0) {
+        ret = deliver_body(client, client->content_length, buf);
+    }
+    free(buf);
+    return ret;
+}
+
+static int send_request(esp_http_client_handle_t client, const char *host, int port, const char *path)
+{
+    int size = HOST_HTTP_LINE_SIZE;
+    for (int i = 0; i < HOST_HTTP_MAX_HEADER; i++) {
+        if (client->headers[i].key) {
+            size += strlen(client->headers[i].key) + strlen(client->headers[i].value) + 4;
+        }
+    }
+    char *req = malloc(size + strlen(path));
+    if (req == NULL) {
+        return -1;
+    }
+    int len = sprintf(req, "%s %s HTTP/1.1\r\nHost: %s:%d\r\n", method_name[client->method], path, host, port);
+    for (int i = 0; i < HOST_HTTP_MAX_HEADER; i++) {
+        if (client->headers[i].key) {
+            len += sprintf(req + len, "%s: %s\r\n", client->headers[i].key, client->headers[i].value);
+        }
+    }
+    if (client->post_data) {
+        len += sprintf(req + len, "Content-Length: %d\r\n", client->post_len);
+    }
+    if (client->keep_alive_enable == false) {
+        len += sprintf(req + len, "Connection: close\r\n");
+    }
+    len += sprintf(req + len, "\r\n");
+    int ret = send_all(client->sock, req, len);
+    free(req);
+    if (ret == 0 && client->post_data) {
+        ret = send_all(client->sock, client->post_data, client->post_len);
+    }
+    return ret;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    esp_http_client_handle_t client = calloc(1, sizeof(struct esp_http_client));
+    if (client == NULL) {
+        return NULL;
+    }
+    client->event_handler = config->event_handler;
+    client->user_data = config->user_data;
+    client->timeout_ms = config->timeout_ms;
+    client->buffer_size = config->buffer_size ? config->buffer_size : HOST_HTTP_DEFAULT_BUF;
+    client->keep_alive_enable = config->keep_alive_enable;
+    client->sock = -1;
+    if (config->url) {
+        esp_http_client_set_url(client, config->url);
+    }
+    return client;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    char host[HOST_HTTP_HOST_SIZE];
+    int port;
+    const char *path;
+    if (client->url == NULL || split_url(client->url, host, &port, &path) == false) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (client->sock >= 0 && (strcmp(host, client->conn_host) || port != client->conn_port)) {
+        esp_http_client_close(client);
+    }
+    if (client->sock < 0 && host_connect(client, host, port) != 0) {
+        dispatch_event(client, HTTP_EVENT_ERROR, NULL, 0);
+        return ESP_FAIL;
+    }
+    if (send_request(client, host, port, path) != 0) {
+        esp_http_client_close(client);
+        return ESP_FAIL;
+    }
+    dispatch_event(client, HTTP_EVENT_HEADER_SENT, NULL, 0);
+    if (read_response(client) != 0) {
+        // Peer closed kept connection or timeout
+        esp_http_client_close(client);
+        return ESP_FAIL;
+    }
+    dispatch_event(client, HTTP_EVENT_ON_FINISH, NULL, 0);
+    if (client->server_close || client->keep_alive_enable == false) {
+        esp_http_client_close(client);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    char *dup = strdup(url);
+    if (dup == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    free(client->url);
+    client->url = dup;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len)
+{
+    client->post_data = data;
+    client->post_len = len;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    if (value == NULL) {
+        return esp_http_client_delete_header(client, key);
+    }
+    host_http_header_t *slot = NULL;
+    for (int i = 0; i < HOST_HTTP_MAX_HEADER; i++) {
+        host_http_header_t *h = &client->headers[i];
+        if (h->key && strcasecmp(h->key, key) == 0) {
+            slot = h;
+            break;
+        }
+        if (h->key == NULL && slot == NULL) {
+            slot = h;
+        }
+    }
+    if (slot == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    free(slot->key);
+    free(slot->value);
+    slot->key = strdup(key);
+    slot->value = strdup(value);
+    return (slot->key && slot->value) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key)
+{
+    for (int i = 0; i < HOST_HTTP_MAX_HEADER; i++) {
+        host_http_header_t *h = &client->headers[i];
+        if (h->key && strcasecmp(h->key, key) == 0) {
+            free(h->key);
+            free(h->value);
+            h->key = h->value = NULL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    client->method = method;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client, void *data)
+{
+    client->user_data = data;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms)
+{
+    client->timeout_ms = timeout_ms;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    if (client->sock >= 0) {
+        close(client->sock);
+        client->sock = -1;
+        dispatch_event(client, HTTP_EVENT_DISCONNECTED, NULL, 0);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_http_client_close(client);
+    for (int i = 0; i < HOST_HTTP_MAX_HEADER; i++) {
+        free(client->headers[i].key);
+        free(client->headers[i].value);
+    }
+    free(client->url);
+    free(client);
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client->status;
+}
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client)
+{
+    return client->content_length;
+}
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client)
+{
+    return client->chunked;
+}
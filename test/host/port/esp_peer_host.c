@@ -0,0 +1,275 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "esp_timer.h"
+#include "esp_peer_default.h"
+#include "esp_peer_host.h"
+
+#define HOST_AUDIO_QUEUE_SIZE  (32)
+#define HOST_AUDIO_FRAME_MAX   (1024)
+
+typedef struct {
+    uint32_t  pts;
+    int       size;
+    uint8_t   data[HOST_AUDIO_FRAME_MAX];
+} host_audio_frame_t;
+
+typedef struct {
+    esp_peer_cfg_t         cfg;
+    bool                   opened;
+    int                    pending_state;
+    bool                   sdp_pending;
+    char                  *local_sdp;
+    int                    open_cost;       /*!< Sleep inside `esp_peer_open` in ms */
+    int                    gather_cost;     /*!< Delay of local SDP after `esp_peer_new_connection` in ms */
+    int                    handshake_cost;  /*!< Delay of connected state after remote SDP in ms */
+    int64_t                sdp_time;
+    int64_t                connect_time;
+    host_audio_frame_t     audio[HOST_AUDIO_QUEUE_SIZE];
+    int                    audio_rd;
+    int                    audio_wr;
+    esp_peer_host_stats_t  stats;
+} host_peer_t;
+
+static host_peer_t host_peer = {
+    .pending_state = -1,
+};
+static pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const esp_peer_ops_t host_ops;
+
+const esp_peer_ops_t *esp_peer_get_default_impl(void)
+{
+    return &host_ops;
+}
+
+int esp_peer_open(esp_peer_cfg_t *cfg, const esp_peer_ops_t *ops, esp_peer_handle_t *peer)
+{
+    if (cfg == NULL || peer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&host_lock);
+    if (host_peer.opened) {
+        pthread_mutex_unlock(&host_lock);
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    host_peer.cfg = *cfg;
+    host_peer.opened = true;
+    host_peer.pending_state = -1;
+    host_peer.sdp_pending = false;
+    host_peer.connect_time = 0;
+    host_peer.audio_rd = host_peer.audio_wr = 0;
+    memset(&host_peer.stats, 0, sizeof(esp_peer_host_stats_t));
+    int open_cost = host_peer.open_cost;
+    pthread_mutex_unlock(&host_lock);
+    // Stands for RTP buffers, send pool and DTLS context allocation
+    if (open_cost) {
+        usleep(open_cost * 1000);
+    }
+    *peer = &host_peer;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_new_connection(esp_peer_handle_t peer)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.sdp_pending = (host_peer.local_sdp != NULL);
+    host_peer.sdp_time = esp_timer_get_time() + host_peer.gather_cost * 1000;
+    host_peer.stats.new_connection_num++;
+    pthread_mutex_unlock(&host_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_create_data_channel(esp_peer_handle_t peer, esp_peer_data_channel_cfg_t *ch_cfg)
+{
+    return ESP_PEER_ERR_NOT_SUPPORT;
+}
+
+int esp_peer_close_data_channel(esp_peer_handle_t peer, const char *label)
+{
+    return ESP_PEER_ERR_NOT_SUPPORT;
+}
+
+int esp_peer_update_ice_info(esp_peer_handle_t peer, esp_peer_role_t role, esp_peer_ice_server_cfg_t *server, int server_num)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_send_msg(esp_peer_handle_t peer, esp_peer_msg_t *msg)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.stats.msg_received++;
+    if (msg->type == ESP_PEER_MSG_TYPE_SDP && host_peer.handshake_cost) {
+        // Connectivity check and DTLS handshake start once remote SDP applied
+        host_peer.connect_time = esp_timer_get_time() + host_peer.handshake_cost * 1000;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_send_video(esp_peer_handle_t peer, esp_peer_video_frame_t *frame)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.stats.video_sent++;
+    pthread_mutex_unlock(&host_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_send_audio(esp_peer_handle_t peer, esp_peer_audio_frame_t *info)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.stats.audio_sent++;
+    host_peer.stats.audio_bytes += info->size;
+    pthread_mutex_unlock(&host_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_send_data(esp_peer_handle_t peer, esp_peer_data_frame_t *frame)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_main_loop(esp_peer_handle_t peer)
+{
+    esp_peer_cfg_t *cfg = &host_peer.cfg;
+    pthread_mutex_lock(&host_lock);
+    host_peer.stats.main_loop_num++;
+    int64_t now = esp_timer_get_time();
+    if (host_peer.connect_time && now >= host_peer.connect_time) {
+        host_peer.connect_time = 0;
+        host_peer.pending_state = ESP_PEER_STATE_CONNECTED;
+    }
+    int state = host_peer.pending_state;
+    host_peer.pending_state = -1;
+    char *sdp = NULL;
+    if (host_peer.sdp_pending && now >= host_peer.sdp_time) {
+        // Local SDP reported once all candidates gathered
+        sdp = host_peer.local_sdp;
+        host_peer.sdp_pending = false;
+    }
+    pthread_mutex_unlock(&host_lock);
+    // Callbacks run without lock held, they may send through peer again
+    if (state >= 0) {
+        cfg->on_state((esp_peer_state_t)state, cfg->ctx);
+        if (state == ESP_PEER_STATE_CONNECTED && cfg->on_audio_info && cfg->audio_info.codec) {
+            esp_peer_audio_stream_info_t info = cfg->audio_info;
+            cfg->on_audio_info(&info, cfg->ctx);
+        }
+    }
+    if (sdp && cfg->on_msg) {
+        esp_peer_msg_t msg = {
+            .type = ESP_PEER_MSG_TYPE_SDP,
+            .data = (uint8_t *)sdp,
+            .size = strlen(sdp),
+        };
+        cfg->on_msg(&msg, cfg->ctx);
+    }
+    while (1) {
+        pthread_mutex_lock(&host_lock);
+        if (host_peer.audio_rd == host_peer.audio_wr) {
+            pthread_mutex_unlock(&host_lock);
+            break;
+        }
+        host_audio_frame_t *f = &host_peer.audio[host_peer.audio_rd % HOST_AUDIO_QUEUE_SIZE];
+        pthread_mutex_unlock(&host_lock);
+        esp_peer_audio_frame_t frame = {
+            .pts = f->pts,
+            .data = f->data,
+            .size = f->size,
+        };
+        cfg->on_audio_data(&frame, cfg->ctx);
+        pthread_mutex_lock(&host_lock);
+        host_peer.audio_rd++;
+        pthread_mutex_unlock(&host_lock);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_disconnect(esp_peer_handle_t peer)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_query(esp_peer_handle_t peer)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_close(esp_peer_handle_t peer)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.opened = false;
+    pthread_mutex_unlock(&host_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pre_generate_cert(void)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+void esp_peer_host_set_state(esp_peer_state_t state)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.pending_state = (int)state;
+    pthread_mutex_unlock(&host_lock);
+}
+
+int esp_peer_host_recv_audio(uint32_t pts, const uint8_t *data, int size)
+{
+    if (size > HOST_AUDIO_FRAME_MAX) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int ret = ESP_PEER_ERR_OVER_LIMITED;
+    pthread_mutex_lock(&host_lock);
+    if (host_peer.audio_wr - host_peer.audio_rd < HOST_AUDIO_QUEUE_SIZE) {
+        host_audio_frame_t *f = &host_peer.audio[host_peer.audio_wr % HOST_AUDIO_QUEUE_SIZE];
+        f->pts = pts;
+        f->size = size;
+        memcpy(f->data, data, size);
+        host_peer.audio_wr++;
+        ret = ESP_PEER_ERR_NONE;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+void esp_peer_host_set_cost(int open_ms, int gather_ms, int handshake_ms)
+{
+    pthread_mutex_lock(&host_lock);
+    host_peer.open_cost = open_ms;
+    host_peer.gather_cost = gather_ms;
+    host_peer.handshake_cost = handshake_ms;
+    pthread_mutex_unlock(&host_lock);
+}
+
+void esp_peer_host_set_local_sdp(const char *sdp)
+{
+    pthread_mutex_lock(&host_lock);
+    free(host_peer.local_sdp);
+    host_peer.local_sdp = sdp ? strdup(sdp) : NULL;
+    pthread_mutex_unlock(&host_lock);
+}
+
+bool esp_peer_host_opened(void)
+{
+    pthread_mutex_lock(&host_lock);
+    bool opened = host_peer.opened;
+    pthread_mutex_unlock(&host_lock);
+    return opened;
+}
+
+void esp_peer_host_get_stats(esp_peer_host_stats_t *stats)
+{
+    pthread_mutex_lock(&host_lock);
+    *stats = host_peer.stats;
+    pthread_mutex_unlock(&host_lock);
+}
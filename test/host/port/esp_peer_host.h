@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_peer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Counters of fake peer
+ */
+typedef struct {
+    int  main_loop_num;      /*!< Times `esp_peer_main_loop` called */
+    int  audio_sent;         /*!< Audio frames sent */
+    int  audio_bytes;        /*!< Audio bytes sent */
+    int  video_sent;         /*!< Video frames sent */
+    int  msg_received;       /*!< Messages from remote passed by `esp_peer_send_msg` */
+    int  new_connection_num; /*!< Times `esp_peer_new_connection` called */
+} esp_peer_host_stats_t;
+
+/**
+ * @brief  Fake of `esp_peer` API for host test, replaces both wrapper and default peer core
+ *
+ * @note  Only one peer opened at a time
+ *        Remote events are queued by test and delivered inside `esp_peer_main_loop` same as peer core
+ *        which only reads its sockets there, so delivery latency equals how fast main loop is polled
+ */
+
+/**
+ * @brief  Queue peer state change, audio info of remote is reported with `ESP_PEER_STATE_CONNECTED`
+ *
+ * @param[in]  state  New peer state
+ */
+void esp_peer_host_set_state(esp_peer_state_t state);
+
+/**
+ * @brief  Queue one received audio frame
+ *
+ * @param[in]  pts   Frame PTS
+ * @param[in]  data  Frame data
+ * @param[in]  size  Frame size
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE          On success
+ *       - ESP_PEER_ERR_INVALID_ARG   Frame too big
+ *       - ESP_PEER_ERR_OVER_LIMITED  Receive queue full
+ */
+int esp_peer_host_recv_audio(uint32_t pts, const uint8_t *data, int size);
+
+/**
+ * @brief  Set local SDP reported through `on_msg` after `esp_peer_new_connection`
+ *
+ * @param[in]  sdp  Local SDP, NULL to not report
+ */
+void esp_peer_host_set_local_sdp(const char *sdp);
+
+/**
+ * @brief  Set simulated cost of connection setup steps, all 0 by default
+ *
+ * @param[in]  open_ms       Time spent inside `esp_peer_open`
+ * @param[in]  gather_ms     Time from `esp_peer_new_connection` to local SDP reported
+ * @param[in]  handshake_ms  Time from remote SDP received to `ESP_PEER_STATE_CONNECTED` reported, 0 to not report
+ */
+void esp_peer_host_set_cost(int open_ms, int gather_ms, int handshake_ms);
+
+/**
+ * @brief  Check whether fake peer is opened
+ *
+ * @return
+ *       - true   Peer opened
+ *       - false  No peer opened
+ */
+bool esp_peer_host_opened(void);
+
+/**
+ * @brief  Get counters of fake peer
+ *
+ * @param[out]  stats  Counters
+ */
+void esp_peer_host_get_stats(esp_peer_host_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
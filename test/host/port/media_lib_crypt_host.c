@@ -0,0 +1,391 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/core_names.h>
+#include "media_lib_crypt_reg.h"
+#include "media_lib_crypt_host.h"
+
+/**
+ * @brief  Host crypt adapter on OpenSSL, behaves same as mbedtls based default adapter
+ *         GCM tag is computed in both directions and compared by caller
+ */
+
+#define RETURN_ON_NULL_HANDLE(h)                                               \
+    if (h == NULL)   {                                                         \
+        return ESP_ERR_INVALID_ARG;                                            \
+    }
+
+#define GCM_SCRATCH_SIZE (256)
+
+typedef struct {
+    EVP_CIPHER_CTX *enc;
+    EVP_CIPHER_CTX *dec;
+} host_aes_t;
+
+typedef struct {
+    EVP_CIPHER_CTX *enc;
+    EVP_CIPHER_CTX *dec;
+    uint8_t         key[32];
+    int             key_bits;
+    bool            decrypt;
+} host_gcm_t;
+
+static void _md_init(void **ctx)
+{
+    *ctx = EVP_MD_CTX_new();
+}
+
+static void _md_free(void *ctx)
+{
+    EVP_MD_CTX_free((EVP_MD_CTX *)ctx);
+}
+
+static int _md_update(void *ctx, const unsigned char *input, size_t len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return EVP_DigestUpdate((EVP_MD_CTX *)ctx, input, len) == 1 ? 0 : -1;
+}
+
+static int _md_finish(void *ctx, unsigned char *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return EVP_DigestFinal_ex((EVP_MD_CTX *)ctx, output, NULL) == 1 ? 0 : -1;
+}
+
+static int _md5_start(media_lib_md5_handle_t ctx)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return EVP_DigestInit_ex((EVP_MD_CTX *)ctx, EVP_md5(), NULL) == 1 ? 0 : -1;
+}
+
+static int _md5_finish(media_lib_md5_handle_t ctx, unsigned char output[16])
+{
+    return _md_finish(ctx, output);
+}
+
+static int _sha256_start(media_lib_sha256_handle_t ctx)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return EVP_DigestInit_ex((EVP_MD_CTX *)ctx, EVP_sha256(), NULL) == 1 ? 0 : -1;
+}
+
+static int _sha256_finish(media_lib_sha256_handle_t ctx, unsigned char output[32])
+{
+    return _md_finish(ctx, output);
+}
+
+static const EVP_CIPHER *aes_cipher(int key_bits, bool gcm)
+{
+    switch (key_bits) {
+        case 128:
+            return gcm ? EVP_aes_128_gcm() : EVP_aes_128_ecb();
+        case 192:
+            return gcm ? EVP_aes_192_gcm() : EVP_aes_192_ecb();
+        case 256:
+            return gcm ? EVP_aes_256_gcm() : EVP_aes_256_ecb();
+        default:
+            return NULL;
+    }
+}
+
+static void _aes_init(media_lib_aes_handle_t *ctx)
+{
+    host_aes_t *aes = calloc(1, sizeof(host_aes_t));
+    if (aes == NULL) {
+        return;
+    }
+    aes->enc = EVP_CIPHER_CTX_new();
+    aes->dec = EVP_CIPHER_CTX_new();
+    if (aes->enc == NULL || aes->dec == NULL) {
+        EVP_CIPHER_CTX_free(aes->enc);
+        EVP_CIPHER_CTX_free(aes->dec);
+        free(aes);
+        return;
+    }
+    *ctx = aes;
+}
+
+static void _aes_free(media_lib_aes_handle_t ctx)
+{
+    host_aes_t *aes = (host_aes_t *)ctx;
+    if (aes) {
+        EVP_CIPHER_CTX_free(aes->enc);
+        EVP_CIPHER_CTX_free(aes->dec);
+        free(aes);
+    }
+}
+
+static int _aes_set_key(media_lib_aes_handle_t ctx, uint8_t *key, uint8_t key_bits)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_aes_t *aes = (host_aes_t *)ctx;
+    // Wrapper passes key bits in uint8_t, 256 wraps to 0
+    int bits = key_bits ? key_bits : 256;
+    const EVP_CIPHER *cipher = aes_cipher(bits, false);
+    if (cipher == NULL || EVP_EncryptInit_ex(aes->enc, cipher, NULL, key, NULL) != 1 ||
+        EVP_DecryptInit_ex(aes->dec, cipher, NULL, key, NULL) != 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    EVP_CIPHER_CTX_set_padding(aes->enc, 0);
+    EVP_CIPHER_CTX_set_padding(aes->dec, 0);
+    return 0;
+}
+
+static int aes_crypt_block(EVP_CIPHER_CTX *c, const uint8_t input[16], uint8_t output[16])
+{
+    int len = 0;
+    return EVP_CipherUpdate(c, output, &len, input, 16) == 1 && len == 16 ? 0 : -1;
+}
+
+static int _aes_crypt_cbc(media_lib_aes_handle_t ctx, bool decrypt_mode, uint8_t iv[16], uint8_t *input,
+                          size_t size, uint8_t *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_aes_t *aes = (host_aes_t *)ctx;
+    if (size % 16) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t block[16];
+    for (size_t i = 0; i < size; i += 16) {
+        if (decrypt_mode) {
+            // Keep ciphertext as next IV since output may overlap input
+            uint8_t next_iv[16];
+            memcpy(next_iv, input + i, 16);
+            if (aes_crypt_block(aes->dec, input + i, block) != 0) {
+                return -1;
+            }
+            for (int j = 0; j < 16; j++) {
+                output[i + j] = block[j] ^ iv[j];
+            }
+            memcpy(iv, next_iv, 16);
+            continue;
+        }
+        for (int j = 0; j < 16; j++) {
+            block[j] = input[i + j] ^ iv[j];
+        }
+        if (aes_crypt_block(aes->enc, block, output + i) != 0) {
+            return -1;
+        }
+        memcpy(iv, output + i, 16);
+    }
+    return 0;
+}
+
+static int _aes_crypt_ctr(media_lib_aes_handle_t ctx, size_t size, size_t *nc_off, uint8_t nonce_counter[16],
+                          uint8_t stream_block[16], const uint8_t *input, uint8_t *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_aes_t *aes = (host_aes_t *)ctx;
+    size_t n = *nc_off;
+    if (n > 15) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < size; i++) {
+        if (n == 0) {
+            if (aes_crypt_block(aes->enc, nonce_counter, stream_block) != 0) {
+                return -1;
+            }
+            for (int j = 15; j >= 0; j--) {
+                if (++nonce_counter[j] != 0) {
+                    break;
+                }
+            }
+        }
+        output[i] = input[i] ^ stream_block[n];
+        n = (n + 1) & 0x0F;
+    }
+    *nc_off = n;
+    return 0;
+}
+
+static void _gcm_init(media_lib_gcm_handle_t *ctx)
+{
+    host_gcm_t *gcm = calloc(1, sizeof(host_gcm_t));
+    if (gcm == NULL) {
+        return;
+    }
+    gcm->enc = EVP_CIPHER_CTX_new();
+    gcm->dec = EVP_CIPHER_CTX_new();
+    if (gcm->enc == NULL || gcm->dec == NULL) {
+        EVP_CIPHER_CTX_free(gcm->enc);
+        EVP_CIPHER_CTX_free(gcm->dec);
+        free(gcm);
+        return;
+    }
+    *ctx = gcm;
+}
+
+static void _gcm_free(media_lib_gcm_handle_t ctx)
+{
+    host_gcm_t *gcm = (host_gcm_t *)ctx;
+    if (gcm) {
+        EVP_CIPHER_CTX_free(gcm->enc);
+        EVP_CIPHER_CTX_free(gcm->dec);
+        free(gcm);
+    }
+}
+
+static int _gcm_set_key(media_lib_gcm_handle_t ctx, const uint8_t *key, uint16_t key_bits)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_gcm_t *gcm = (host_gcm_t *)ctx;
+    if (aes_cipher(key_bits, true) == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(gcm->key, key, key_bits / 8);
+    gcm->key_bits = key_bits;
+    return 0;
+}
+
+static int gcm_init_ctx(EVP_CIPHER_CTX *c, host_gcm_t *gcm, bool encrypt, const uint8_t *iv, size_t iv_len)
+{
+    const EVP_CIPHER *cipher = aes_cipher(gcm->key_bits, true);
+    if (EVP_CipherInit_ex(c, cipher, NULL, NULL, NULL, encrypt) != 1 ||
+        EVP_CIPHER_CTX_ctrl(c, EVP_CTRL_GCM_SET_IVLEN, (int)iv_len, NULL) != 1 ||
+        EVP_CipherInit_ex(c, NULL, NULL, gcm->key, iv, encrypt) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+static int _gcm_start(media_lib_gcm_handle_t ctx, bool decrypt_mode, const uint8_t *iv, size_t iv_len,
+                      const uint8_t *aad, size_t aad_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_gcm_t *gcm = (host_gcm_t *)ctx;
+    if (gcm->key_bits == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Tag is always computed by encrypt context, decrypt context only produces plaintext
+    gcm->decrypt = decrypt_mode;
+    if (gcm_init_ctx(gcm->enc, gcm, true, iv, iv_len) != 0) {
+        return -1;
+    }
+    if (decrypt_mode && gcm_init_ctx(gcm->dec, gcm, false, iv, iv_len) != 0) {
+        return -1;
+    }
+    int len = 0;
+    if (aad_len && EVP_EncryptUpdate(gcm->enc, NULL, &len, aad, (int)aad_len) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+static int _gcm_update(media_lib_gcm_handle_t ctx, const uint8_t *input, size_t size, uint8_t *output)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_gcm_t *gcm = (host_gcm_t *)ctx;
+    int len = 0;
+    if (gcm->decrypt == false) {
+        return EVP_EncryptUpdate(gcm->enc, output, &len, input, (int)size) == 1 ? 0 : -1;
+    }
+    if (EVP_DecryptUpdate(gcm->dec, output, &len, input, (int)size) != 1) {
+        return -1;
+    }
+    // Encrypt plaintext again so that tag covers original ciphertext
+    uint8_t scratch[GCM_SCRATCH_SIZE];
+    for (size_t i = 0; i < size; i += GCM_SCRATCH_SIZE) {
+        int n = size - i > GCM_SCRATCH_SIZE ? GCM_SCRATCH_SIZE : (int)(size - i);
+        if (EVP_EncryptUpdate(gcm->enc, scratch, &len, output + i, n) != 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int _gcm_finish(media_lib_gcm_handle_t ctx, uint8_t *tag, size_t tag_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    host_gcm_t *gcm = (host_gcm_t *)ctx;
+    uint8_t last[16];
+    int len = 0;
+    if (EVP_EncryptFinal_ex(gcm->enc, last, &len) != 1 ||
+        EVP_CIPHER_CTX_ctrl(gcm->enc, EVP_CTRL_GCM_GET_TAG, (int)tag_len, tag) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+static void _hmac_sha1_init(media_lib_hmac_sha1_handle_t *ctx)
+{
+    EVP_MAC *mac = EVP_MAC_fetch(NULL, "HMAC", NULL);
+    if (mac == NULL) {
+        return;
+    }
+    *ctx = EVP_MAC_CTX_new(mac);
+    EVP_MAC_free(mac);
+}
+
+static void _hmac_sha1_free(media_lib_hmac_sha1_handle_t ctx)
+{
+    EVP_MAC_CTX_free((EVP_MAC_CTX *)ctx);
+}
+
+static int _hmac_sha1_start(media_lib_hmac_sha1_handle_t ctx, const uint8_t *key, size_t key_len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, "SHA1", 0),
+        OSSL_PARAM_construct_end(),
+    };
+    return EVP_MAC_init((EVP_MAC_CTX *)ctx, key, key_len, params) == 1 ? 0 : -1;
+}
+
+static int _hmac_sha1_update(media_lib_hmac_sha1_handle_t ctx, const uint8_t *input, size_t len)
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    return EVP_MAC_update((EVP_MAC_CTX *)ctx, input, len) == 1 ? 0 : -1;
+}
+
+static int _hmac_sha1_finish(media_lib_hmac_sha1_handle_t ctx, uint8_t output[20])
+{
+    RETURN_ON_NULL_HANDLE(ctx);
+    size_t len = 0;
+    return EVP_MAC_final((EVP_MAC_CTX *)ctx, output, &len, 20) == 1 && len == 20 ? 0 : -1;
+}
+
+esp_err_t media_lib_add_host_crypt_adapter(void)
+{
+    media_lib_crypt_t crypt_lib = {
+        .md5_init = _md_init,
+        .md5_free = _md_free,
+        .md5_start = _md5_start,
+        .md5_update = _md_update,
+        .md5_finish = _md5_finish,
+        .sha256_init = _md_init,
+        .sha256_free = _md_free,
+        .sha256_start = _sha256_start,
+        .sha256_update = _md_update,
+        .sha256_finish = _sha256_finish,
+        .aes_init = _aes_init,
+        .aes_free = _aes_free,
+        .aes_set_key = _aes_set_key,
+        .aes_crypt_cbc = _aes_crypt_cbc,
+    };
+    media_lib_cipher_t cipher_lib = {
+        .aes_crypt_ctr = _aes_crypt_ctr,
+        .gcm_init = _gcm_init,
+        .gcm_free = _gcm_free,
+        .gcm_set_key = _gcm_set_key,
+        .gcm_start = _gcm_start,
+        .gcm_update = _gcm_update,
+        .gcm_finish = _gcm_finish,
+        .hmac_sha1_init = _hmac_sha1_init,
+        .hmac_sha1_free = _hmac_sha1_free,
+        .hmac_sha1_start = _hmac_sha1_start,
+        .hmac_sha1_update = _hmac_sha1_update,
+        .hmac_sha1_finish = _hmac_sha1_finish,
+    };
+    esp_err_t ret = media_lib_cipher_register(&cipher_lib);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return media_lib_crypt_register(&crypt_lib);
+}
@@ -0,0 +1,349 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include "media_lib_os_reg.h"
+#include "media_lib_os_adapter_host.h"
+
+/**
+ * @brief  Host OS adapter on pthread, behaves same as FreeRTOS adapter for media_lib_os users
+ */
+
+#define HOST_MAX_WAIT (0xFFFFFFFF)
+
+#define RETURN_ON_NULL_HANDLE(h)                                               \
+    if (h == NULL)   {                                                         \
+        return ESP_ERR_INVALID_ARG;                                            \
+    }
+
+typedef struct {
+    pthread_t   tid;
+    void      (*body)(void *arg);
+    void       *arg;
+} host_thread_t;
+
+typedef struct {
+    pthread_mutex_t  lock;
+    pthread_cond_t   cond;
+    uint32_t         value;
+} host_sync_t;
+
+static __thread host_thread_t *cur_thread;
+
+static void *_malloc_align(size_t size, uint8_t align)
+{
+    void *ptr = NULL;
+    if (align < sizeof(void *)) {
+        align = sizeof(void *);
+    }
+    if (posix_memalign(&ptr, align, size) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static int _get_stack_frame(void **addr, int n)
+{
+    return 0;
+}
+
+static void *thread_entry(void *arg)
+{
+    host_thread_t *thread = (host_thread_t *)arg;
+    cur_thread = thread;
+    thread->body(thread->arg);
+    // Body returned without destroying itself
+    cur_thread = NULL;
+    free(thread);
+    return NULL;
+}
+
+static int _thread_create(media_lib_thread_handle_t *handle, const char *name, void (*body)(void *arg), void *arg,
+                          uint32_t stack_size, int prio, int core)
+{
+    host_thread_t *thread = calloc(1, sizeof(host_thread_t));
+    if (thread == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    thread->body = body;
+    thread->arg = arg;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    // Handle must be valid before thread runs, thread may query itself at once
+    if (handle) {
+        *handle = thread;
+    }
+    int ret = pthread_create(&thread->tid, &attr, thread_entry, thread);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
+        if (handle) {
+            *handle = NULL;
+        }
+        free(thread);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static void _thread_destroy(media_lib_thread_handle_t handle)
+{
+    // Only self destroy is supported, same as how media_lib users quit their threads
+    if (handle == NULL || handle == cur_thread) {
+        host_thread_t *thread = cur_thread;
+        cur_thread = NULL;
+        free(thread);
+        pthread_exit(NULL);
+    }
+}
+
+static bool _thread_set_priority(media_lib_thread_handle_t handle, int prio)
+{
+    return true;
+}
+
+static void _thread_sleep(uint32_t ms)
+{
+    struct timespec ts = {
+        .tv_sec = ms / 1000,
+        .tv_nsec = (long)(ms % 1000) * 1000000,
+    };
+    nanosleep(&ts, NULL);
+}
+
+static media_lib_thread_handle_t _thread_get_self(void)
+{
+    return (media_lib_thread_handle_t)cur_thread;
+}
+
+static void deadline_after(struct timespec *ts, clockid_t clock, uint32_t ms)
+{
+    clock_gettime(clock, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+static host_sync_t *sync_create(void)
+{
+    host_sync_t *sync = calloc(1, sizeof(host_sync_t));
+    if (sync == NULL) {
+        return NULL;
+    }
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&sync->lock, NULL);
+    pthread_cond_init(&sync->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return sync;
+}
+
+static int sync_destroy(host_sync_t *sync)
+{
+    RETURN_ON_NULL_HANDLE(sync);
+    pthread_cond_destroy(&sync->cond);
+    pthread_mutex_destroy(&sync->lock);
+    free(sync);
+    return ESP_OK;
+}
+
+static int sync_wait(host_sync_t *sync, uint32_t timeout)
+{
+    // Called with sync lock held
+    if (timeout == HOST_MAX_WAIT) {
+        return pthread_cond_wait(&sync->cond, &sync->lock);
+    }
+    struct timespec ts;
+    deadline_after(&ts, CLOCK_MONOTONIC, timeout);
+    return pthread_cond_timedwait(&sync->cond, &sync->lock, &ts);
+}
+
+static int _sema_create(media_lib_sema_handle_t *sema)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    *sema = sync_create();
+    return *sema ? ESP_OK : ESP_FAIL;
+}
+
+static int _sema_lock(media_lib_sema_handle_t sema, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    host_sync_t *sync = (host_sync_t *)sema;
+    pthread_mutex_lock(&sync->lock);
+    int ret = 0;
+    while (sync->value == 0 && ret != ETIMEDOUT) {
+        ret = sync_wait(sync, timeout);
+    }
+    bool taken = sync->value > 0;
+    if (taken) {
+        sync->value--;
+    }
+    pthread_mutex_unlock(&sync->lock);
+    return taken ? ESP_OK : ESP_FAIL;
+}
+
+static int _sema_unlock(media_lib_sema_handle_t sema)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    host_sync_t *sync = (host_sync_t *)sema;
+    pthread_mutex_lock(&sync->lock);
+    // Counting semaphore with max count 1
+    sync->value = 1;
+    pthread_cond_signal(&sync->cond);
+    pthread_mutex_unlock(&sync->lock);
+    return ESP_OK;
+}
+
+static int _sema_destroy(media_lib_sema_handle_t sema)
+{
+    return sync_destroy((host_sync_t *)sema);
+}
+
+static int _mutex_create(media_lib_mutex_handle_t *mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    pthread_mutex_t *lock = malloc(sizeof(pthread_mutex_t));
+    if (lock == NULL) {
+        return ESP_FAIL;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    *mutex = lock;
+    return ESP_OK;
+}
+
+static int _mutex_lock(media_lib_mutex_handle_t mutex, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    if (timeout == HOST_MAX_WAIT) {
+        return pthread_mutex_lock((pthread_mutex_t *)mutex) == 0 ? ESP_OK : ESP_FAIL;
+    }
+    struct timespec ts;
+    deadline_after(&ts, CLOCK_REALTIME, timeout);
+    return pthread_mutex_timedlock((pthread_mutex_t *)mutex, &ts) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static int _mutex_unlock(media_lib_mutex_handle_t mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    return pthread_mutex_unlock((pthread_mutex_t *)mutex) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static int _mutex_destroy(media_lib_mutex_handle_t mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    pthread_mutex_destroy((pthread_mutex_t *)mutex);
+    free(mutex);
+    return ESP_OK;
+}
+
+static int _enter_critical(void)
+{
+    return ESP_OK;
+}
+
+static int _leave_critical(void)
+{
+    return ESP_OK;
+}
+
+static int _event_group_create(media_lib_event_grp_handle_t *group)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    *group = sync_create();
+    return *group ? ESP_OK : ESP_FAIL;
+}
+
+static uint32_t _event_group_set_bits(media_lib_event_grp_handle_t group, uint32_t bits)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    host_sync_t *sync = (host_sync_t *)group;
+    pthread_mutex_lock(&sync->lock);
+    sync->value |= bits;
+    uint32_t value = sync->value;
+    pthread_cond_broadcast(&sync->cond);
+    pthread_mutex_unlock(&sync->lock);
+    return value;
+}
+
+static uint32_t _event_group_clr_bits(media_lib_event_grp_handle_t group, uint32_t bits)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    host_sync_t *sync = (host_sync_t *)group;
+    pthread_mutex_lock(&sync->lock);
+    // Return value before clear, same as FreeRTOS
+    uint32_t value = sync->value;
+    sync->value &= ~bits;
+    pthread_mutex_unlock(&sync->lock);
+    return value;
+}
+
+static uint32_t _event_group_wait_bits(media_lib_event_grp_handle_t group, uint32_t bits, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    host_sync_t *sync = (host_sync_t *)group;
+    pthread_mutex_lock(&sync->lock);
+    int ret = 0;
+    while ((sync->value & bits) != bits && timeout && ret != ETIMEDOUT) {
+        ret = sync_wait(sync, timeout);
+    }
+    uint32_t value = sync->value;
+    pthread_mutex_unlock(&sync->lock);
+    return value;
+}
+
+static int _event_group_destroy(media_lib_event_grp_handle_t group)
+{
+    return sync_destroy((host_sync_t *)group);
+}
+
+esp_err_t media_lib_add_host_os_adapter(void)
+{
+    media_lib_os_t os_lib = {
+        .malloc = malloc,
+        .free = free,
+        .calloc = calloc,
+        .realloc = realloc,
+        .strdup = strdup,
+        .malloc_align = _malloc_align,
+        .free_align = free,
+        .get_stack_frame = _get_stack_frame,
+        .thread_create = _thread_create,
+        .thread_destroy = _thread_destroy,
+        .thread_set_prio = _thread_set_priority,
+        .thread_sleep = _thread_sleep,
+        .sema_create = _sema_create,
+        .sema_lock = _sema_lock,
+        .sema_unlock = _sema_unlock,
+        .sema_destroy = _sema_destroy,
+        .mutex_create = _mutex_create,
+        .mutex_lock = _mutex_lock,
+        .mutex_unlock = _mutex_unlock,
+        .mutex_destroy = _mutex_destroy,
+        .enter_critical = _enter_critical,
+        .leave_critical = _leave_critical,
+        .group_create = _event_group_create,
+        .group_set_bits = _event_group_set_bits,
+        .group_clr_bits = _event_group_clr_bits,
+        .group_wait_bits = _event_group_wait_bits,
+        .group_destroy = _event_group_destroy,
+        .thread_get_self = _thread_get_self,
+    };
+    return media_lib_os_register(&os_lib);
+}
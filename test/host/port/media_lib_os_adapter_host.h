@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Register pthread based OS adapter for host test
+ *
+ * @note  Event group waits for all bits and does not clear on exit, same as FreeRTOS adapter
+ *        Thread body must call `media_lib_thread_destroy(NULL)` or return to quit
+ *
+ * @return
+ *       - ESP_OK               On success
+ *       - ESP_ERR_INVALID_ARG  Registration rejected
+ */
+esp_err_t media_lib_add_host_os_adapter(void);
+
+#ifdef __cplusplus
+}
+#endif
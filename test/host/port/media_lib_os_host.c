@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "media_lib_os.h"
+
+/**
+ * @brief  Host realization of media_lib OS API used by esp_peer modules
+ */
+
+void *media_lib_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *media_lib_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+void media_lib_free(void *ptr)
+{
+    free(ptr);
+}
+
+int media_lib_mutex_create(media_lib_mutex_handle_t *mutex)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    pthread_mutex_t *lock = malloc(sizeof(pthread_mutex_t));
+    if (lock == NULL) {
+        return -1;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    *mutex = lock;
+    return 0;
+}
+
+int media_lib_mutex_destroy(media_lib_mutex_handle_t mutex)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    pthread_mutex_destroy((pthread_mutex_t *)mutex);
+    free(mutex);
+    return 0;
+}
+
+int media_lib_mutex_create_once(media_lib_mutex_handle_t *mutex)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    if (__atomic_load_n(mutex, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    media_lib_mutex_handle_t lock = NULL;
+    if (media_lib_mutex_create(&lock) != 0) {
+        return -1;
+    }
+    media_lib_mutex_handle_t expected = NULL;
+    if (__atomic_compare_exchange_n(mutex, &expected, lock, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false) {
+        media_lib_mutex_destroy(lock);
+    }
+    return 0;
+}
+
+int media_lib_mutex_lock(media_lib_mutex_handle_t mutex, uint32_t timeout)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    // Host tests always wait forever
+    (void)timeout;
+    return pthread_mutex_lock((pthread_mutex_t *)mutex) == 0 ? 0 : -1;
+}
+
+int media_lib_mutex_unlock(media_lib_mutex_handle_t mutex)
+{
+    if (mutex == NULL) {
+        return -1;
+    }
+    return pthread_mutex_unlock((pthread_mutex_t *)mutex) == 0 ? 0 : -1;
+}
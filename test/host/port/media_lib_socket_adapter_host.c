@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include "media_lib_socket_reg.h"
+#include "media_lib_socket_adapter_host.h"
+
+_Static_assert(sizeof(media_lib_mmsghdr_t) == sizeof(struct mmsghdr), "mmsghdr layout mismatch");
+_Static_assert(offsetof(media_lib_mmsghdr_t, msg_len) == offsetof(struct mmsghdr, msg_len), "mmsghdr layout mismatch");
+
+static int _accept(int s, struct sockaddr *addr, socklen_t *addrlen)
+{
+    return accept(s, addr, addrlen);
+}
+
+static int _getsockname(int s, struct sockaddr *name, socklen_t *namelen)
+{
+    return getsockname(s, name, namelen);
+}
+
+static ssize_t _recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+    return recvfrom(s, mem, len, flags, from, fromlen);
+}
+
+static int _ioctl(int s, long cmd, void *argp)
+{
+    return ioctl(s, cmd, argp);
+}
+
+static int _fcntl(int s, int cmd, int val)
+{
+    return fcntl(s, cmd, val);
+}
+
+static int _select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, media_lib_timeval *timeout)
+{
+    struct timeval tm;
+    if (timeout) {
+        tm.tv_sec = timeout->tv_sec;
+        tm.tv_usec = timeout->tv_usec;
+    }
+    return select(maxfdp1, readset, writeset, exceptset, timeout ? &tm : NULL);
+}
+
+static int _sendmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags)
+{
+    return sendmmsg(s, (struct mmsghdr *)msgvec, vlen, flags);
+}
+
+static int _recvmmsg(int s, media_lib_mmsghdr_t *msgvec, unsigned int vlen, int flags)
+{
+    // Native call waits for all messages by default, keep same behavior as loop fallback
+    return recvmmsg(s, (struct mmsghdr *)msgvec, vlen, flags | MSG_WAITFORONE, NULL);
+}
+
+esp_err_t media_lib_add_host_socket_adapter(bool native_batch)
+{
+    media_lib_socket_t sock_lib = {
+        .sock_accept = _accept,
+        .sock_bind = bind,
+        .sock_shutdown = shutdown,
+        .sock_close = close,
+        .sock_connect = connect,
+        .sock_listen = listen,
+        .sock_recv = recv,
+        .sock_read = read,
+        .sock_readv = readv,
+        .sock_recvfrom = _recvfrom,
+        .sock_recvmsg = recvmsg,
+        .sock_send = send,
+        .sock_sendmsg = sendmsg,
+        .sock_sendto = sendto,
+        .sock_open = socket,
+        .sock_write = write,
+        .sock_writev = writev,
+        .sock_select = _select,
+        .sock_ioctl = _ioctl,
+        .sock_fcntl = _fcntl,
+        .sock_inet_ntop = inet_ntop,
+        .sock_inet_pton = inet_pton,
+        .sock_setsockopt = setsockopt,
+        .sock_getsockopt = getsockopt,
+        .sock_getsockname = _getsockname,
+    };
+    if (native_batch) {
+        sock_lib.sock_sendmmsg = _sendmmsg;
+        sock_lib.sock_recvmmsg = _recvmmsg;
+    }
+    return media_lib_socket_register(&sock_lib);
+}
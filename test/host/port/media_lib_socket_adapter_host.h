@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Register Linux socket adapter for host test
+ *
+ * @note  Batched calls map to native `sendmmsg` and `recvmmsg`, `recvmmsg` adds `MSG_WAITFORONE`
+ *        so that only first message is waited same as loop fallback of `media_lib_socket`
+ *
+ * @param[in]  native_batch  Register native batched calls, false to leave them NULL and use loop fallback
+ *
+ * @return
+ *       - ESP_OK               On success
+ *       - ESP_ERR_INVALID_ARG  Registration rejected
+ */
+esp_err_t media_lib_add_host_socket_adapter(bool native_batch);
+
+#ifdef __cplusplus
+}
+#endif
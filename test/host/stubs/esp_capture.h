@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Subset of esp_capture API used by fan-out and esp_webrtc, realized by test as fake capture
+ */
+typedef struct esp_capture_t *esp_capture_handle_t;
+
+typedef enum {
+    ESP_CAPTURE_ERR_OK          = 0,
+    ESP_CAPTURE_ERR_NOT_ENOUGH  = -6,
+    ESP_CAPTURE_ERR_INVALID_ARG = -2,
+} esp_capture_err_t;
+
+typedef enum {
+    ESP_CAPTURE_FMT_ID_NONE  = 0,
+    ESP_CAPTURE_FMT_ID_G711A = 0x101,
+    ESP_CAPTURE_FMT_ID_G711U = 0x102,
+    ESP_CAPTURE_FMT_ID_OPUS  = 0x103,
+    ESP_CAPTURE_FMT_ID_H264  = 0x201,
+    ESP_CAPTURE_FMT_ID_MJPEG = 0x202,
+} esp_capture_format_id_t;
+
+typedef enum {
+    ESP_CAPTURE_STREAM_TYPE_NONE  = 0,
+    ESP_CAPTURE_STREAM_TYPE_AUDIO = 1,
+    ESP_CAPTURE_STREAM_TYPE_VIDEO = 2,
+} esp_capture_stream_type_t;
+
+typedef struct {
+    esp_capture_format_id_t format_id;
+    uint32_t                sample_rate;
+    uint8_t                 channel;
+    uint8_t                 bits_per_sample;
+} esp_capture_audio_info_t;
+
+typedef struct {
+    esp_capture_format_id_t format_id;
+    uint16_t                width;
+    uint16_t                height;
+    uint8_t                 fps;
+} esp_capture_video_info_t;
+
+typedef struct {
+    esp_capture_stream_type_t stream_type;
+    uint32_t                  pts;
+    uint8_t                  *data;
+    int                       size;
+} esp_capture_stream_frame_t;
+
+esp_capture_err_t esp_capture_start(esp_capture_handle_t capture);
+
+esp_capture_err_t esp_capture_stop(esp_capture_handle_t capture);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_capture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Subset of esp_capture sink API used by fan-out and esp_webrtc, realized by test as fake capture
+ */
+typedef struct esp_capture_sink_t *esp_capture_sink_handle_t;
+
+typedef enum {
+    ESP_CAPTURE_RUN_MODE_DISABLE = 0,
+    ESP_CAPTURE_RUN_MODE_ALWAYS  = 1,
+    ESP_CAPTURE_RUN_MODE_ONESHOT = 2,
+} esp_capture_run_mode_t;
+
+typedef struct {
+    esp_capture_audio_info_t audio_info;
+    esp_capture_video_info_t video_info;
+} esp_capture_sink_cfg_t;
+
+esp_capture_err_t esp_capture_sink_setup(esp_capture_handle_t capture, uint8_t sink_idx, esp_capture_sink_cfg_t *sink_info,
+                                         esp_capture_sink_handle_t *sink);
+
+esp_capture_err_t esp_capture_sink_enable(esp_capture_sink_handle_t sink, esp_capture_run_mode_t run_type);
+
+esp_capture_err_t esp_capture_sink_acquire_frame(esp_capture_sink_handle_t sink, esp_capture_stream_frame_t *frame,
+                                                 bool no_wait);
+
+esp_capture_err_t esp_capture_sink_release_frame(esp_capture_sink_handle_t sink, esp_capture_stream_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Codec device handle only referenced by esp_webrtc headers on host test build
+ */
+typedef void *esp_codec_dev_handle_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Subset of `esp_http_client` used by `https_client`, implemented over plain TCP in `port/esp_http_client_host.c`
+ *
+ * @note  Only `http://` is supported, body of chunked response is decoded before `HTTP_EVENT_ON_DATA` same as IDF
+ */
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_EVENT_ERROR,
+    HTTP_EVENT_ON_CONNECTED,
+    HTTP_EVENT_HEADER_SENT,
+    HTTP_EVENT_ON_HEADER,
+    HTTP_EVENT_ON_DATA,
+    HTTP_EVENT_ON_FINISH,
+    HTTP_EVENT_DISCONNECTED,
+    HTTP_EVENT_REDIRECT,
+} esp_http_client_event_id_t;
+
+typedef struct {
+    esp_http_client_event_id_t  event_id;
+    esp_http_client_handle_t    client;
+    void                       *data;
+    int                         data_len;
+    void                       *user_data;
+    char                       *header_key;
+    char                       *header_value;
+} esp_http_client_event_t;
+
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t *evt);
+
+typedef enum {
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_PUT,
+    HTTP_METHOD_PATCH,
+    HTTP_METHOD_DELETE,
+} esp_http_client_method_t;
+
+typedef struct {
+    const char            *url;
+    http_event_handle_cb   event_handler;
+    int                    timeout_ms;
+    int                    buffer_size;
+    int                    buffer_size_tx;
+    bool                   disable_auto_redirect;
+    bool                   keep_alive_enable;
+    int                    keep_alive_idle;
+    int                    keep_alive_interval;
+    int                    keep_alive_count;
+    void                  *user_data;
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url);
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len);
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key);
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method);
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client, void *data);
+
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms);
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client);
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_tls_last_error *esp_tls_error_handle_t;
+
+/**
+ * @brief  Host test build has no TLS layer, no error is ever recorded
+ */
+static inline esp_err_t esp_tls_get_and_clear_last_error(esp_tls_error_handle_t h, int *esp_tls_code, int *esp_tls_flags)
+{
+    if (esp_tls_code) {
+        *esp_tls_code = 0;
+    }
+    if (esp_tls_flags) {
+        *esp_tls_flags = 0;
+    }
+    return ESP_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include "test_common.h"
+#include "esp_peer_types.h"
+#include "esp_webrtc_bwe.h"
+
+#define GROUP_INTERVAL  (20)
+#define REPORT_INTERVAL (1000)
+
+/**
+ * @brief  Feed delay samples for `duration` ms, queue delay grows `ramp` ms on each group
+ *         Loss report with `fraction_lost` and `sent_bitrate` is fed every second
+ */
+static uint32_t feed_trace(webrtc_bwe_handle_t bwe, uint32_t start, uint32_t duration, int ramp,
+                           uint8_t fraction_lost, uint32_t sent_bitrate)
+{
+    uint32_t queue_delay = 0;
+    uint32_t now = start;
+    for (uint32_t t = 0; t < duration; t += GROUP_INTERVAL) {
+        now = start + t;
+        webrtc_bwe_on_delay(bwe, now, now + 30 + queue_delay);
+        queue_delay += ramp;
+        if (t % REPORT_INTERVAL == 0) {
+            webrtc_bwe_on_loss_report(bwe, fraction_lost, sent_bitrate, now);
+        }
+    }
+    return now;
+}
+
+static int test_bwe_open(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 200000,
+        .max_bitrate = 100000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, webrtc_bwe_open(&cfg, &bwe));
+    cfg.max_bitrate = 0;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, webrtc_bwe_open(&cfg, &bwe));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, webrtc_bwe_open(NULL, &bwe));
+    // Start from max bitrate when not set
+    cfg.max_bitrate = 2000000;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    TEST_ASSERT_EQUAL(2000000, webrtc_bwe_get_target(bwe));
+    webrtc_bwe_close(bwe);
+    TEST_ASSERT_EQUAL(0, webrtc_bwe_get_target(NULL));
+    return 0;
+}
+
+static int test_bwe_stable_path(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 100000,
+        .max_bitrate = 4000000,
+        .start_bitrate = 500000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    // Constant transit and no loss, target only probes up to headroom of what really sent
+    uint32_t sent = 600000;
+    feed_trace(bwe, 1000, 10000, 0, 0, sent);
+    uint32_t target = webrtc_bwe_get_target(bwe);
+    TEST_ASSERT(target > 500000);
+    TEST_ASSERT(target <= sent * 3 / 2 + 10000);
+    webrtc_bwe_close(bwe);
+    return 0;
+}
+
+static int test_bwe_delay_overuse(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 100000,
+        .max_bitrate = 4000000,
+        .start_bitrate = 2000000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    uint32_t sent = 2000000;
+    uint32_t now = feed_trace(bwe, 1000, 2000, 0, 0, sent);
+    uint32_t stable = webrtc_bwe_get_target(bwe);
+    // Bottleneck queue grows 4ms on every 20ms group without any loss
+    feed_trace(bwe, now + GROUP_INTERVAL, 2000, 4, 0, sent);
+    uint32_t congested = webrtc_bwe_get_target(bwe);
+    TEST_ASSERT(congested < stable);
+    TEST_ASSERT(congested <= sent * 85 / 100);
+    TEST_ASSERT(congested >= cfg.min_bitrate);
+    webrtc_bwe_close(bwe);
+    return 0;
+}
+
+static int test_bwe_jitter_no_overuse(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 100000,
+        .max_bitrate = 1000000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    // Zero-mean jitter of +-5ms must not be taken as congestion
+    uint32_t now = 1000;
+    for (int i = 0; i < 500; i++) {
+        now += GROUP_INTERVAL;
+        int jitter = (i & 1) ? 5 : -5;
+        webrtc_bwe_on_delay(bwe, now, now + 30 + jitter);
+    }
+    TEST_ASSERT_EQUAL(cfg.max_bitrate, webrtc_bwe_get_target(bwe));
+    webrtc_bwe_close(bwe);
+    return 0;
+}
+
+static int test_bwe_loss(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 300000,
+        .max_bitrate = 1000000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    // 25% loss cuts rate by 12.5% on each report
+    webrtc_bwe_on_loss_report(bwe, 64, 1000000, 1000);
+    TEST_ASSERT_EQUAL(875000, webrtc_bwe_get_target(bwe));
+    // Loss between low and high threshold holds rate
+    webrtc_bwe_on_loss_report(bwe, 12, 1000000, 2000);
+    TEST_ASSERT_EQUAL(875000, webrtc_bwe_get_target(bwe));
+    // Sustained heavy loss never goes below minimum
+    for (int i = 0; i < 50; i++) {
+        webrtc_bwe_on_loss_report(bwe, 128, 1000000, 3000 + i * 1000);
+    }
+    TEST_ASSERT_EQUAL(cfg.min_bitrate, webrtc_bwe_get_target(bwe));
+    // Recover slowly once loss is gone, limited by maximum
+    for (int i = 0; i < 100; i++) {
+        webrtc_bwe_on_loss_report(bwe, 0, 1000000, 60000 + i * 1000);
+    }
+    TEST_ASSERT_EQUAL(cfg.max_bitrate, webrtc_bwe_get_target(bwe));
+    webrtc_bwe_close(bwe);
+    return 0;
+}
+
+static int test_bwe_timestamp_wrap(void)
+{
+    webrtc_bwe_handle_t bwe = NULL;
+    webrtc_bwe_handle_t ref = NULL;
+    webrtc_bwe_cfg_t cfg = {
+        .min_bitrate = 100000,
+        .max_bitrate = 4000000,
+        .start_bitrate = 2000000,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &bwe));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_bwe_open(&cfg, &ref));
+    // Millisecond clock wraps in the middle of trace, must behave same as unwrapped trace
+    uint32_t start = 0xFFFFFFFF - 1000;
+    uint32_t now = feed_trace(bwe, start, 3000, 0, 0, 2000000);
+    uint32_t ref_now = feed_trace(ref, 1000, 3000, 0, 0, 2000000);
+    TEST_ASSERT_EQUAL(webrtc_bwe_get_target(ref), webrtc_bwe_get_target(bwe));
+    feed_trace(bwe, now + GROUP_INTERVAL, 2000, 4, 0, 2000000);
+    feed_trace(ref, ref_now + GROUP_INTERVAL, 2000, 4, 0, 2000000);
+    TEST_ASSERT_EQUAL(webrtc_bwe_get_target(ref), webrtc_bwe_get_target(bwe));
+    TEST_ASSERT(webrtc_bwe_get_target(bwe) <= 2000000 * 85 / 100);
+    // Reset returns to start bitrate
+    webrtc_bwe_reset(bwe);
+    TEST_ASSERT_EQUAL(2000000, webrtc_bwe_get_target(bwe));
+    webrtc_bwe_close(bwe);
+    webrtc_bwe_close(ref);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_bwe_open, failed);
+    TEST_RUN(test_bwe_stable_path, failed);
+    TEST_RUN(test_bwe_delay_overuse, failed);
+    TEST_RUN(test_bwe_jitter_no_overuse, failed);
+    TEST_RUN(test_bwe_loss, failed);
+    TEST_RUN(test_bwe_timestamp_wrap, failed);
+    return failed;
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief  Fail current test case when condition not met
+ */
+#define TEST_ASSERT(cond) do {                                               \
+    if (!(cond)) {                                                           \
+        printf("%s:%d: assert failed: %s\n", __FILE__, __LINE__, #cond);     \
+        return -1;                                                           \
+    }                                                                        \
+} while (0)
+
+/**
+ * @brief  Fail current test case when two integers differ
+ */
+#define TEST_ASSERT_EQUAL(expect, actual) do {                               \
+    long long _e = (long long)(expect);                                      \
+    long long _a = (long long)(actual);                                      \
+    if (_e != _a) {                                                          \
+        printf("%s:%d: expect %s == %lld, actual %lld\n", __FILE__, __LINE__, \
+               #actual, _e, _a);                                             \
+        return -1;                                                           \
+    }                                                                        \
+} while (0)
+
+/**
+ * @brief  Fail current test case when two memory blocks differ
+ */
+#define TEST_ASSERT_EQUAL_MEM(expect, actual, len) do {                      \
+    if (memcmp((expect), (actual), (len)) != 0) {                            \
+        printf("%s:%d: memory mismatch: %s\n", __FILE__, __LINE__, #actual); \
+        return -1;                                                           \
+    }                                                                        \
+} while (0)
+
+/**
+ * @brief  Run one test case and count failure
+ */
+#define TEST_RUN(func, failed) do {                                          \
+    int _ret = func();                                                       \
+    printf("%-40s %s\n", #func, _ret == 0 ? "PASS" : "FAIL");               \
+    if (_ret != 0) {                                                         \
+        (failed)++;                                                          \
+    }                                                                        \
+} while (0)
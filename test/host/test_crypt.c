@@ -0,0 +1,291 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include "test_common.h"
+#include "media_lib_crypt.h"
+#include "media_lib_crypt_host.h"
+
+#define ARRAY_NUM(a) (int)(sizeof(a) / sizeof(a[0]))
+
+static int hex_to_bin(const char *hex, uint8_t *bin, int size)
+{
+    int n = 0;
+    while (*hex && n < size) {
+        if (*hex == ' ') {
+            hex++;
+            continue;
+        }
+        unsigned int v = 0;
+        sscanf(hex, "%2x", &v);
+        bin[n++] = (uint8_t)v;
+        hex += 2;
+    }
+    return n;
+}
+
+static int test_crypt_register(void)
+{
+    // Incomplete wrapper list is rejected
+    media_lib_cipher_t cipher_lib = { 0 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, media_lib_cipher_register(&cipher_lib));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, media_lib_cipher_register(NULL));
+    media_lib_gcm_handle_t gcm = NULL;
+    media_lib_gcm_init(&gcm);
+    TEST_ASSERT(gcm == NULL);
+    uint8_t key[16] = { 0 };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, media_lib_gcm_set_key(gcm, key, 128));
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_add_host_crypt_adapter());
+    return 0;
+}
+
+/**
+ * @brief  RFC 7714 section 16.1.1 AEAD_AES_128_GCM SRTP packet protection
+ */
+static int test_crypt_gcm_rfc7714(void)
+{
+    uint8_t key[16], salt[12], expect_iv[12];
+    uint8_t packet[80], expect[80];
+    hex_to_bin("000102030405060708090a0b0c0d0e0f", key, sizeof(key));
+    hex_to_bin("517569642070726f2071756f", salt, sizeof(salt));
+    hex_to_bin("51753c6580c2726f20718414", expect_iv, sizeof(expect_iv));
+    int size = hex_to_bin("8040f17b8041f8d35501a0b2"
+                          "47616c6c696120657374206f6d6e697320646976697361"
+                          "20696e207061727465732074726573", packet, sizeof(packet));
+    int expect_size = hex_to_bin("8040f17b8041f8d35501a0b2"
+                                 "f24de3a3fb34de6cacba861c9d7e4bcabe633bd50d294e6f42a5f47a51c7d19b36de3adf8833"
+                                 "899d7f27beb16a9152cf765ee4390cce", expect, sizeof(expect));
+    TEST_ASSERT_EQUAL(12 + 38, size);
+    TEST_ASSERT_EQUAL(size + 16, expect_size);
+
+    // IV = (00 00 || SSRC || ROC || SEQ) XOR salt (RFC 7714 section 8.1)
+    uint8_t iv[12] = { 0 };
+    memcpy(iv + 2, packet + 8, 4);
+    memcpy(iv + 10, packet + 2, 2);
+    for (int i = 0; i < 12; i++) {
+        iv[i] ^= salt[i];
+    }
+    TEST_ASSERT_EQUAL_MEM(expect_iv, iv, sizeof(iv));
+
+    media_lib_gcm_handle_t gcm = NULL;
+    media_lib_gcm_init(&gcm);
+    TEST_ASSERT(gcm != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_set_key(gcm, key, 128));
+    // Encrypt payload in place, RTP header is additional data, feed in uneven pieces
+    uint8_t protected[80];
+    memcpy(protected, packet, size);
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_start(gcm, false, iv, sizeof(iv), protected, 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, protected + 12, 7, protected + 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, protected + 19, size - 19, protected + 19));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_finish(gcm, protected + size, 16));
+    TEST_ASSERT_EQUAL_MEM(expect, protected, expect_size);
+
+    // Decrypt computes tag over ciphertext, caller compares it
+    uint8_t tag[16];
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_start(gcm, true, iv, sizeof(iv), protected, 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, protected + 12, size - 12, protected + 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_finish(gcm, tag, sizeof(tag)));
+    TEST_ASSERT_EQUAL_MEM(packet, protected, size);
+    TEST_ASSERT_EQUAL_MEM(expect + size, tag, sizeof(tag));
+
+    // Any flipped bit in ciphertext gives different tag
+    memcpy(protected, expect, expect_size);
+    protected[20] ^= 0x01;
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_start(gcm, true, iv, sizeof(iv), protected, 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, protected + 12, size - 12, protected + 12));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_finish(gcm, tag, sizeof(tag)));
+    TEST_ASSERT(memcmp(expect + size, tag, sizeof(tag)) != 0);
+    media_lib_gcm_free(gcm);
+    return 0;
+}
+
+/**
+ * @brief  GCM specification test case 4 (AES-128, 60 bytes with additional data)
+ */
+static int test_crypt_gcm_spec(void)
+{
+    uint8_t key[16], iv[12], aad[20], plain[60], cipher[60], tag[16];
+    hex_to_bin("feffe9928665731c6d6a8f9467308308", key, sizeof(key));
+    hex_to_bin("cafebabefacedbaddecaf888", iv, sizeof(iv));
+    hex_to_bin("feedfacedeadbeeffeedfacedeadbeefabaddad2", aad, sizeof(aad));
+    hex_to_bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+               "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", plain, sizeof(plain));
+    hex_to_bin("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+               "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", cipher, sizeof(cipher));
+    hex_to_bin("5bc94fbc3221a5db94fae95ae7121a47", tag, sizeof(tag));
+    media_lib_gcm_handle_t gcm = NULL;
+    media_lib_gcm_init(&gcm);
+    TEST_ASSERT(gcm != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_set_key(gcm, key, 128));
+    uint8_t out[60], out_tag[16];
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_start(gcm, false, iv, sizeof(iv), aad, sizeof(aad)));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, plain, 32, out));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_update(gcm, plain + 32, 28, out + 32));
+    TEST_ASSERT_EQUAL(0, media_lib_gcm_finish(gcm, out_tag, sizeof(out_tag)));
+    TEST_ASSERT_EQUAL_MEM(cipher, out, sizeof(cipher));
+    TEST_ASSERT_EQUAL_MEM(tag, out_tag, sizeof(tag));
+    media_lib_gcm_free(gcm);
+    return 0;
+}
+
+/**
+ * @brief  RFC 2202 HMAC-SHA1 test cases
+ */
+static int test_crypt_hmac_sha1_rfc2202(void)
+{
+    typedef struct {
+        uint8_t     key_byte;
+        int         key_len;
+        const char *key_str;
+        uint8_t     data_byte;
+        int         data_len;
+        const char *data_str;
+        const char *digest;
+    } hmac_case_t;
+    const hmac_case_t cases[] = {
+        {0x0b, 20, NULL, 0, 0, "Hi There", "b617318655057264e28bc0b6fb378c8ef146be00"},
+        {0, 0, "Jefe", 0, 0, "what do ya want for nothing?", "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"},
+        {0xaa, 20, NULL, 0xdd, 50, NULL, "125d7342b9ac11cd91a39af48aa17b4f63f175d3"},
+        {0, 25, NULL, 0xcd, 50, NULL, "4c9007f4026250c6bc8414f9bf50c86c2d7235da"},
+        {0x0c, 20, NULL, 0, 0, "Test With Truncation", "4c1a03424b55e07fe7f27be1d58bb9324a9a5a04"},
+        {0xaa, 80, NULL, 0, 0, "Test Using Larger Than Block-Size Key - Hash Key First",
+         "aa4ae5e15272d00e95705637ce8a3b55ed402112"},
+        {0xaa, 80, NULL, 0, 0, "Test Using Larger Than Block-Size Key and Larger Than One Block-Size Data",
+         "e8e99d0f45237d786d6bbaa7965c7808bbff1a91"},
+    };
+    media_lib_hmac_sha1_handle_t hmac = NULL;
+    media_lib_hmac_sha1_init(&hmac);
+    TEST_ASSERT(hmac != NULL);
+    for (int i = 0; i < ARRAY_NUM(cases); i++) {
+        const hmac_case_t *c = &cases[i];
+        uint8_t key[80], data[80], expect[20], digest[20];
+        int key_len = c->key_len;
+        if (c->key_str) {
+            key_len = strlen(c->key_str);
+            memcpy(key, c->key_str, key_len);
+        } else if (c->key_byte) {
+            memset(key, c->key_byte, key_len);
+        } else {
+            // Case 4 key is 0x01 .. 0x19
+            for (int j = 0; j < key_len; j++) {
+                key[j] = (uint8_t)(j + 1);
+            }
+        }
+        int data_len = c->data_len;
+        if (c->data_str) {
+            data_len = strlen(c->data_str);
+            memcpy(data, c->data_str, data_len);
+        } else {
+            memset(data, c->data_byte, data_len);
+        }
+        hex_to_bin(c->digest, expect, sizeof(expect));
+        // Same context is restarted for every case, data fed in two parts
+        TEST_ASSERT_EQUAL(0, media_lib_hmac_sha1_start(hmac, key, key_len));
+        TEST_ASSERT_EQUAL(0, media_lib_hmac_sha1_update(hmac, data, data_len / 3));
+        TEST_ASSERT_EQUAL(0, media_lib_hmac_sha1_update(hmac, data + data_len / 3, data_len - data_len / 3));
+        TEST_ASSERT_EQUAL(0, media_lib_hmac_sha1_finish(hmac, digest));
+        if (memcmp(expect, digest, sizeof(digest)) != 0) {
+            printf("RFC 2202 HMAC-SHA1 case %d mismatch\n", i + 1);
+            return -1;
+        }
+    }
+    media_lib_hmac_sha1_free(hmac);
+    return 0;
+}
+
+/**
+ * @brief  RFC 3711 appendix B.2 AES-CM keystream, split over calls to check counter continuity
+ */
+static int test_crypt_aes_ctr_rfc3711(void)
+{
+    uint8_t key[16], nonce[16], expect[48];
+    hex_to_bin("2b7e151628aed2a6abf7158809cf4f3c", key, sizeof(key));
+    hex_to_bin("f0f1f2f3f4f5f6f7f8f9fafbfcfd0000", nonce, sizeof(nonce));
+    hex_to_bin("e03ead0935c95e80e166b16dd92b4eb4"
+               "d23513162b02d0f72a43a2fe4a5f97ab"
+               "41e95b3bb0a2e8dd477901e4fca894c0", expect, sizeof(expect));
+    media_lib_aes_handle_t aes = NULL;
+    media_lib_aes_init(&aes);
+    TEST_ASSERT(aes != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_aes_set_key(aes, key, 128));
+    uint8_t zero[48] = { 0 };
+    uint8_t keystream[48];
+    uint8_t stream_block[16];
+    size_t nc_off = 0;
+    TEST_ASSERT_EQUAL(0, media_lib_aes_crypt_ctr(aes, 5, &nc_off, nonce, stream_block, zero, keystream));
+    TEST_ASSERT_EQUAL(5, nc_off);
+    TEST_ASSERT_EQUAL(0, media_lib_aes_crypt_ctr(aes, 43, &nc_off, nonce, stream_block, zero + 5, keystream + 5));
+    TEST_ASSERT_EQUAL(0, nc_off);
+    TEST_ASSERT_EQUAL_MEM(expect, keystream, sizeof(expect));
+    media_lib_aes_free(aes);
+    return 0;
+}
+
+/**
+ * @brief  NIST SP 800-38A F.2.1 and F.2.2 CBC-AES128
+ */
+static int test_crypt_aes_cbc(void)
+{
+    uint8_t key[16], iv[16], plain[32], cipher[32], out[32];
+    hex_to_bin("2b7e151628aed2a6abf7158809cf4f3c", key, sizeof(key));
+    hex_to_bin("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51", plain, sizeof(plain));
+    hex_to_bin("7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2", cipher, sizeof(cipher));
+    media_lib_aes_handle_t aes = NULL;
+    media_lib_aes_init(&aes);
+    TEST_ASSERT(aes != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_aes_set_key(aes, key, 128));
+    hex_to_bin("000102030405060708090a0b0c0d0e0f", iv, sizeof(iv));
+    TEST_ASSERT_EQUAL(0, media_lib_aes_crypt_cbc(aes, false, iv, plain, sizeof(plain), out));
+    TEST_ASSERT_EQUAL_MEM(cipher, out, sizeof(cipher));
+    // IV is updated to last cipher block for chaining
+    TEST_ASSERT_EQUAL_MEM(cipher + 16, iv, 16);
+    hex_to_bin("000102030405060708090a0b0c0d0e0f", iv, sizeof(iv));
+    TEST_ASSERT_EQUAL(0, media_lib_aes_crypt_cbc(aes, true, iv, out, sizeof(out), out));
+    TEST_ASSERT_EQUAL_MEM(plain, out, sizeof(plain));
+    media_lib_aes_free(aes);
+    return 0;
+}
+
+static int test_crypt_digest(void)
+{
+    uint8_t expect[32], digest[32];
+    media_lib_md5_handle_t md5 = NULL;
+    media_lib_md5_init(&md5);
+    TEST_ASSERT(md5 != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_md5_start(md5));
+    TEST_ASSERT_EQUAL(0, media_lib_md5_update(md5, (const unsigned char *)"abc", 3));
+    TEST_ASSERT_EQUAL(0, media_lib_md5_finish(md5, digest));
+    hex_to_bin("900150983cd24fb0d6963f7d28e17f72", expect, 16);
+    TEST_ASSERT_EQUAL_MEM(expect, digest, 16);
+    media_lib_md5_free(md5);
+
+    media_lib_sha256_handle_t sha256 = NULL;
+    media_lib_sha256_init(&sha256);
+    TEST_ASSERT(sha256 != NULL);
+    TEST_ASSERT_EQUAL(0, media_lib_sha256_start(sha256));
+    TEST_ASSERT_EQUAL(0, media_lib_sha256_update(sha256, (const unsigned char *)"abc", 3));
+    TEST_ASSERT_EQUAL(0, media_lib_sha256_finish(sha256, digest));
+    hex_to_bin("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", expect, 32);
+    TEST_ASSERT_EQUAL_MEM(expect, digest, 32);
+    media_lib_sha256_free(sha256);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_crypt_register, failed);
+    if (failed) {
+        return failed;
+    }
+    TEST_RUN(test_crypt_gcm_rfc7714, failed);
+    TEST_RUN(test_crypt_gcm_spec, failed);
+    TEST_RUN(test_crypt_hmac_sha1_rfc2202, failed);
+    TEST_RUN(test_crypt_aes_ctr_rfc3711, failed);
+    TEST_RUN(test_crypt_aes_cbc, failed);
+    TEST_RUN(test_crypt_digest, failed);
+    return failed;
+}
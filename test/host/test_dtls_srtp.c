@@ -0,0 +1,367 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "dtls_srtp.h"
+
+#define PIPE_QUEUE_SIZE   (64)
+#define PIPE_MTU          (1600)
+#define RECV_WAIT         (10)
+#define WRITE_NUM         (200)
+#define WRITE_SIZE        (100)
+
+/**
+ * @brief  One direction of in-memory datagram link
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    uint8_t         data[PIPE_QUEUE_SIZE][PIPE_MTU];
+    int             size[PIPE_QUEUE_SIZE];
+    int             rp;
+    int             num;
+} pipe_t;
+
+typedef struct {
+    pipe_t      *in;
+    pipe_t      *out;
+    dtls_srtp_t *dtls;
+    int          sent_bytes;   /*!< Bytes put on link, used to tell full from abbreviated handshake */
+} endpoint_t;
+
+typedef struct {
+    pipe_t     a_to_b;
+    pipe_t     b_to_a;
+    endpoint_t client;
+    endpoint_t server;
+} link_t;
+
+typedef struct {
+    endpoint_t *ep;
+    bool        stop;
+    int         received;
+} reader_t;
+
+// Referenced by DTLS module for profiling
+void measure_start(const char *tag)
+{
+}
+
+void measure_stop(const char *tag)
+{
+}
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static void pipe_init(pipe_t *pipe)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pipe->lock, NULL);
+    pthread_cond_init(&pipe->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pipe->rp = pipe->num = 0;
+}
+
+static void pipe_deinit(pipe_t *pipe)
+{
+    pthread_cond_destroy(&pipe->cond);
+    pthread_mutex_destroy(&pipe->lock);
+}
+
+static int udp_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    // Bio callbacks get DTLS instance, endpoint is its user context
+    endpoint_t *ep = (endpoint_t *)((dtls_srtp_t *)ctx)->ctx;
+    pipe_t *pipe = ep->out;
+    if (len > PIPE_MTU) {
+        return -1;
+    }
+    pthread_mutex_lock(&pipe->lock);
+    // Drop like UDP when queue full
+    if (pipe->num < PIPE_QUEUE_SIZE) {
+        int wp = (pipe->rp + pipe->num) % PIPE_QUEUE_SIZE;
+        memcpy(pipe->data[wp], buf, len);
+        pipe->size[wp] = (int)len;
+        pipe->num++;
+        pthread_cond_signal(&pipe->cond);
+    }
+    pthread_mutex_unlock(&pipe->lock);
+    __atomic_add_fetch(&ep->sent_bytes, (int)len, __ATOMIC_ACQ_REL);
+    return (int)len;
+}
+
+static int udp_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    endpoint_t *ep = (endpoint_t *)((dtls_srtp_t *)ctx)->ctx;
+    pipe_t *pipe = ep->in;
+    pthread_mutex_lock(&pipe->lock);
+    if (pipe->num == 0) {
+        // Same as socket polled with short timeout inside peer main loop
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += RECV_WAIT * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&pipe->cond, &pipe->lock, &ts);
+    }
+    int ret = MBEDTLS_ERR_SSL_WANT_READ;
+    if (pipe->num) {
+        ret = pipe->size[pipe->rp] < (int)len ? pipe->size[pipe->rp] : (int)len;
+        memcpy(buf, pipe->data[pipe->rp], ret);
+        pipe->rp = (pipe->rp + 1) % PIPE_QUEUE_SIZE;
+        pipe->num--;
+    }
+    pthread_mutex_unlock(&pipe->lock);
+    return ret;
+}
+
+static dtls_srtp_t *endpoint_open(endpoint_t *ep, dtls_srtp_role_t role)
+{
+    dtls_srtp_cfg_t cfg = {
+        .role = DTLS_SRTP_ROLE_SERVER,
+        .udp_send = udp_send,
+        .udp_recv = udp_recv,
+        .ctx = ep,
+    };
+    ep->dtls = dtls_srtp_init(&cfg);
+    if (ep->dtls && role == DTLS_SRTP_ROLE_CLIENT) {
+        // Client skips CA verify only when switched by reset, same as peer does
+        dtls_srtp_reset_session(ep->dtls, DTLS_SRTP_ROLE_CLIENT);
+    }
+    return ep->dtls;
+}
+
+static void endpoint_close(endpoint_t *ep)
+{
+    if (ep->dtls) {
+        dtls_srtp_deinit(ep->dtls);
+        media_lib_free(ep->dtls);
+        ep->dtls = NULL;
+    }
+}
+
+static int link_open(link_t *link)
+{
+    pipe_init(&link->a_to_b);
+    pipe_init(&link->b_to_a);
+    link->client = (endpoint_t) { .in = &link->b_to_a, .out = &link->a_to_b };
+    link->server = (endpoint_t) { .in = &link->a_to_b, .out = &link->b_to_a };
+    TEST_ASSERT(endpoint_open(&link->server, DTLS_SRTP_ROLE_SERVER) != NULL);
+    TEST_ASSERT(endpoint_open(&link->client, DTLS_SRTP_ROLE_CLIENT) != NULL);
+    return 0;
+}
+
+static void link_close(link_t *link)
+{
+    endpoint_close(&link->client);
+    endpoint_close(&link->server);
+    pipe_deinit(&link->a_to_b);
+    pipe_deinit(&link->b_to_a);
+}
+
+static void set_remote_fingerprint(endpoint_t *ep, endpoint_t *peer)
+{
+    char fingerprint[DTLS_SRTP_FINGERPRINT_LENGTH + 8];
+    snprintf(fingerprint, sizeof(fingerprint), "sha-256 %s", dtls_srtp_get_local_fingerprint(peer->dtls));
+    dtls_srtp_set_remote_fingerprint(ep, fingerprint, strlen(fingerprint));
+}
+
+static void *server_handshake(void *arg)
+{
+    endpoint_t *ep = (endpoint_t *)arg;
+    intptr_t ret = dtls_srtp_handshake(ep->dtls);
+    return (void *)ret;
+}
+
+static int link_handshake(link_t *link)
+{
+    pthread_t thread;
+    void *server_ret = NULL;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, server_handshake, &link->server));
+    int ret = dtls_srtp_handshake(link->client.dtls);
+    pthread_join(thread, &server_ret);
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_EQUAL(0, (intptr_t)server_ret);
+    TEST_ASSERT_EQUAL(DTLS_SRTP_STATE_CONNECTED, link->client.dtls->state);
+    TEST_ASSERT_EQUAL(DTLS_SRTP_STATE_CONNECTED, link->server.dtls->state);
+    return 0;
+}
+
+static int transfer(endpoint_t *from, endpoint_t *to)
+{
+    uint8_t data[WRITE_SIZE], recv[WRITE_SIZE * 2];
+    for (int i = 0; i < WRITE_SIZE; i++) {
+        data[i] = (uint8_t)i;
+    }
+    TEST_ASSERT_EQUAL(WRITE_SIZE, dtls_srtp_write(from->dtls, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(WRITE_SIZE, dtls_srtp_read(to->dtls, recv, sizeof(recv)));
+    TEST_ASSERT_EQUAL_MEM(data, recv, WRITE_SIZE);
+    return 0;
+}
+
+static void *reader_thread(void *arg)
+{
+    reader_t *r = (reader_t *)arg;
+    uint8_t buf[4096];
+    while (__atomic_load_n(&r->stop, __ATOMIC_ACQUIRE) == false) {
+        // Holds read side until no more datagram arrives within receive wait
+        int ret = dtls_srtp_read(r->ep->dtls, buf, sizeof(buf));
+        if (ret > 0) {
+            __atomic_add_fetch(&r->received, ret, __ATOMIC_ACQ_REL);
+        }
+    }
+    return NULL;
+}
+
+static int test_dtls_srtp_handshake(void)
+{
+    link_t *link = calloc(1, sizeof(link_t));
+    TEST_ASSERT(link != NULL);
+    TEST_ASSERT_EQUAL(0, link_open(link));
+    TEST_ASSERT_EQUAL(0, link_handshake(link));
+    TEST_ASSERT_EQUAL(0, transfer(&link->client, &link->server));
+    TEST_ASSERT_EQUAL(0, transfer(&link->server, &link->client));
+    // SRTP keys of both sides match
+    uint8_t rtp[256] = { 0x80, 0x60, 0x00, 0x01, 0, 0, 0, 1, 0x12, 0x34, 0x56, 0x78 };
+    int bytes = 12 + 160;
+    dtls_srtp_encrypt_rtp_packet(link->server.dtls, rtp, sizeof(rtp), &bytes);
+    TEST_ASSERT(bytes > 12 + 160);
+    TEST_ASSERT_EQUAL(0, dtls_srtp_decrypt_rtp_packet(link->client.dtls, rtp, &bytes));
+    TEST_ASSERT_EQUAL(12 + 160, bytes);
+    printf("    connection ID %s\n", link->server.dtls->cid_negotiated ? "negotiated" : "not negotiated");
+    link_close(link);
+    free(link);
+    return 0;
+}
+
+static int test_dtls_srtp_write_latency(void)
+{
+    link_t *link = calloc(1, sizeof(link_t));
+    TEST_ASSERT(link != NULL);
+    TEST_ASSERT_EQUAL(0, link_open(link));
+    TEST_ASSERT_EQUAL(0, link_handshake(link));
+    reader_t server_reader = { .ep = &link->server };
+    reader_t client_reader = { .ep = &link->client };
+    pthread_t server_thread, client_thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&server_thread, NULL, reader_thread, &server_reader));
+    TEST_ASSERT_EQUAL(0, pthread_create(&client_thread, NULL, reader_thread, &client_reader));
+    uint8_t data[WRITE_SIZE] = { 0 };
+    int64_t sum = 0, max = 0;
+    for (int i = 0; i < WRITE_NUM; i++) {
+        // Server reader sits in read waiting for inbound data while data channel sends
+        int64_t start = now_us();
+        int ret = dtls_srtp_write(link->server.dtls, data, sizeof(data));
+        int64_t cost = now_us() - start;
+        TEST_ASSERT_EQUAL(WRITE_SIZE, ret);
+        sum += cost;
+        if (cost > max) {
+            max = cost;
+        }
+        usleep(1000);
+    }
+    for (int t = 0; t < 1000 && __atomic_load_n(&client_reader.received, __ATOMIC_ACQUIRE) < WRITE_NUM * WRITE_SIZE;
+         t += 10) {
+        usleep(10 * 1000);
+    }
+    __atomic_store_n(&server_reader.stop, true, __ATOMIC_RELEASE);
+    __atomic_store_n(&client_reader.stop, true, __ATOMIC_RELEASE);
+    pthread_join(server_thread, NULL);
+    pthread_join(client_thread, NULL);
+    bool cid = link->server.dtls->cid_negotiated;
+    printf("    write while reading (cid %d): avg %dus max %dus over %d writes\n", cid, (int)(sum / WRITE_NUM),
+           (int)max, WRITE_NUM);
+    TEST_ASSERT_EQUAL(WRITE_NUM * WRITE_SIZE, client_reader.received);
+    if (cid == false) {
+        // Application data write does not wait for pending read, serialized write would wait half receive wait
+        TEST_ASSERT(sum / WRITE_NUM < RECV_WAIT * 1000 / 4);
+    }
+    link_close(link);
+    free(link);
+    return 0;
+}
+
+static int test_dtls_srtp_cid_keep(void)
+{
+    link_t *link = calloc(1, sizeof(link_t));
+    TEST_ASSERT(link != NULL);
+    TEST_ASSERT_EQUAL(0, link_open(link));
+    TEST_ASSERT_EQUAL(0, link_handshake(link));
+    // Peer is recognized by certificate kept in session
+    if (link->server.dtls->cid_negotiated == false || link->server.dtls->session_fingerprint[0] == '\0' ||
+        link->client.dtls->session_fingerprint[0] == '\0') {
+        printf("    connection ID or peer certificate keeping not enabled in mbedtls, skip\n");
+        link_close(link);
+        free(link);
+        return 0;
+    }
+    set_remote_fingerprint(&link->client, &link->server);
+    set_remote_fingerprint(&link->server, &link->client);
+    int client_sent = link->client.sent_bytes;
+    int server_sent = link->server.sent_bytes;
+    // Transport path change with same role and peer keeps session and SRTP keys
+    dtls_srtp_reset_session(link->client.dtls, DTLS_SRTP_ROLE_CLIENT);
+    dtls_srtp_reset_session(link->server.dtls, DTLS_SRTP_ROLE_SERVER);
+    TEST_ASSERT(link->client.dtls->session_kept && link->server.dtls->session_kept);
+    TEST_ASSERT_EQUAL(0, dtls_srtp_handshake(link->client.dtls));
+    TEST_ASSERT_EQUAL(0, dtls_srtp_handshake(link->server.dtls));
+    TEST_ASSERT_EQUAL(client_sent, link->client.sent_bytes);
+    TEST_ASSERT_EQUAL(server_sent, link->server.sent_bytes);
+    TEST_ASSERT_EQUAL(0, transfer(&link->client, &link->server));
+    TEST_ASSERT_EQUAL(0, transfer(&link->server, &link->client));
+    // Role change always does full handshake
+    dtls_srtp_reset_session(link->client.dtls, DTLS_SRTP_ROLE_SERVER);
+    TEST_ASSERT(link->client.dtls->session_kept == false);
+    link_close(link);
+    free(link);
+    return 0;
+}
+
+static int test_dtls_srtp_resume(void)
+{
+    link_t *link = calloc(1, sizeof(link_t));
+    TEST_ASSERT(link != NULL);
+    TEST_ASSERT_EQUAL(0, link_open(link));
+    // Without remote fingerprint client does not look up cached session
+    TEST_ASSERT_EQUAL(0, link_handshake(link));
+    int full_bytes = link->server.sent_bytes;
+    link_close(link);
+    // New instances to same peer, client offers session cached by peer fingerprint
+    memset(link, 0, sizeof(link_t));
+    TEST_ASSERT_EQUAL(0, link_open(link));
+    set_remote_fingerprint(&link->client, &link->server);
+    TEST_ASSERT_EQUAL(0, link_handshake(link));
+    int resume_bytes = link->server.sent_bytes;
+    TEST_ASSERT_EQUAL(0, transfer(&link->client, &link->server));
+    link_close(link);
+    free(link);
+    printf("    server handshake bytes full %d resumed %d\n", full_bytes, resume_bytes);
+#if defined(MBEDTLS_SSL_CACHE_C) && defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+    // Abbreviated handshake carries no certificate and key exchange
+    TEST_ASSERT(resume_bytes < full_bytes / 2);
+#endif
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_dtls_srtp_handshake, failed);
+    TEST_RUN(test_dtls_srtp_write_latency, failed);
+    TEST_RUN(test_dtls_srtp_cid_keep, failed);
+    TEST_RUN(test_dtls_srtp_resume, failed);
+    return failed;
+}
@@ -0,0 +1,210 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "test_common.h"
+#include "esp_peer_types.h"
+#include "media_lib_os.h"
+#include "media_lib_os_adapter_host.h"
+#include "esp_capture_host.h"
+#include "esp_webrtc_fanout.h"
+
+#define RACE_LOOP  (20)
+#define GOP_SIZE   (1000)
+#define FRAME_SIZE (200)
+
+typedef struct {
+    int      frames;
+    int      key_frames;
+    uint32_t first_pts;
+    uint32_t last_pts;
+} viewer_t;
+
+static void viewer_on_frame(esp_capture_stream_frame_t *frame, void *ctx)
+{
+    viewer_t *v = (viewer_t *)ctx;
+    if (frame->stream_type != ESP_CAPTURE_STREAM_TYPE_VIDEO) {
+        return;
+    }
+    if (frame->data[3] == 5) {
+        __atomic_add_fetch(&v->key_frames, 1, __ATOMIC_ACQ_REL);
+    }
+    if (__atomic_load_n(&v->frames, __ATOMIC_ACQUIRE) == 0) {
+        __atomic_store_n(&v->first_pts, frame->pts, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&v->last_pts, frame->pts, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&v->frames, 1, __ATOMIC_ACQ_REL);
+}
+
+static bool wait_frames(viewer_t *v, int num, int timeout_ms)
+{
+    // Send task polls every 20ms
+    for (int t = 0; t < timeout_ms; t += 5) {
+        if (__atomic_load_n(&v->frames, __ATOMIC_ACQUIRE) >= num) {
+            return true;
+        }
+        usleep(5000);
+    }
+    return false;
+}
+
+static int test_fanout_share_capture(void)
+{
+    struct esp_capture_t capture;
+    esp_capture_host_init(&capture);
+    esp_capture_sink_cfg_t sink_cfg = { 0 };
+    viewer_t a = { 0 }, b = { 0 };
+    webrtc_fanout_handle_t fanout = NULL, fanout_b = NULL;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &a, &fanout));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &b, &fanout_b));
+    // Viewers of same capture share one fan-out
+    TEST_ASSERT(fanout == fanout_b);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &a, true, true));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &b, true, true));
+    TEST_ASSERT_EQUAL(1, capture.start_num);
+    esp_capture_host_push(&capture, 0, ESP_CAPTURE_STREAM_TYPE_VIDEO, 0, 100, true);
+    TEST_ASSERT(wait_frames(&a, 1, 500) && wait_frames(&b, 1, 500));
+    // Capture keeps running until last viewer gone
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &a, false, true));
+    TEST_ASSERT(esp_capture_host_started(&capture));
+    esp_capture_host_push(&capture, 0, ESP_CAPTURE_STREAM_TYPE_VIDEO, 33, 100, false);
+    TEST_ASSERT(wait_frames(&b, 2, 500));
+    TEST_ASSERT_EQUAL(1, a.frames);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &b, false, true));
+    TEST_ASSERT(esp_capture_host_started(&capture) == false);
+    webrtc_fanout_detach(fanout, &a);
+    webrtc_fanout_detach(fanout, &b);
+    return 0;
+}
+
+typedef struct {
+    webrtc_fanout_handle_t fanout;
+    void                  *ctx;
+} stop_arg_t;
+
+static void *stop_thread(void *arg)
+{
+    stop_arg_t *s = (stop_arg_t *)arg;
+    webrtc_fanout_set_active(s->fanout, s->ctx, false, true);
+    return NULL;
+}
+
+static int test_fanout_restart_race(void)
+{
+    struct esp_capture_t capture;
+    esp_capture_host_init(&capture);
+    esp_capture_sink_cfg_t sink_cfg = { 0 };
+    viewer_t a = { 0 }, b = { 0 };
+    webrtc_fanout_handle_t fanout = NULL;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &a, &fanout));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &b, &fanout));
+    for (int i = 0; i < RACE_LOOP; i++) {
+        viewer_t *first = (i & 1) ? &b : &a;
+        viewer_t *second = (i & 1) ? &a : &b;
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, first, true, true));
+        // Last viewer leaves and waits for send task, new viewer joins in that window
+        stop_arg_t s = { .fanout = fanout, .ctx = first };
+        pthread_t thread;
+        TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, stop_thread, &s));
+        usleep((i % 4) * 1000);
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, second, true, true));
+        pthread_join(thread, NULL);
+        // Stop of first viewer must not tear down capture of second one
+        TEST_ASSERT(esp_capture_host_started(&capture));
+        int frames = __atomic_load_n(&second->frames, __ATOMIC_ACQUIRE);
+        esp_capture_host_push(&capture, 0, ESP_CAPTURE_STREAM_TYPE_VIDEO, i, 100, true);
+        TEST_ASSERT(wait_frames(second, frames + 1, 500));
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, second, false, true));
+        TEST_ASSERT(esp_capture_host_started(&capture) == false);
+    }
+    TEST_ASSERT_EQUAL(capture.start_num, capture.stop_num);
+    webrtc_fanout_detach(fanout, &a);
+    webrtc_fanout_detach(fanout, &b);
+    return 0;
+}
+
+static int push_video(struct esp_capture_t *capture, viewer_t *v, uint32_t pts, bool key)
+{
+    // Wait each frame through send task so that cache state is settled before next step
+    int frames = __atomic_load_n(&v->frames, __ATOMIC_ACQUIRE);
+    esp_capture_host_push(capture, 0, ESP_CAPTURE_STREAM_TYPE_VIDEO, pts, FRAME_SIZE, key);
+    TEST_ASSERT(wait_frames(v, frames + 1, 500));
+    return 0;
+}
+
+static int test_fanout_gop_cache(void)
+{
+    struct esp_capture_t capture;
+    esp_capture_host_init(&capture);
+    esp_capture_sink_cfg_t sink_cfg = { 0 };
+    viewer_t a = { 0 }, b = { 0 }, c = { 0 };
+    webrtc_fanout_handle_t fanout = NULL;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &a, &fanout));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &b, &fanout));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_attach(&capture, &sink_cfg, NULL, 0, viewer_on_frame, &c, &fanout));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_gop_cache(fanout, GOP_SIZE));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &a, true, true));
+    // New viewer waits for key frame, nothing cached before it either
+    esp_capture_host_push(&capture, 0, ESP_CAPTURE_STREAM_TYPE_VIDEO, 0, FRAME_SIZE, false);
+    usleep(50 * 1000);
+    TEST_ASSERT_EQUAL(0, a.frames);
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &b) == false);
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 33, true));
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 66, false));
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 99, false));
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &b));
+
+    // Late viewer gets GOP from last key frame before current frame
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &b, true, true));
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 132, false));
+    TEST_ASSERT(wait_frames(&b, 4, 500));
+    TEST_ASSERT_EQUAL(4, b.frames);
+    TEST_ASSERT_EQUAL(1, b.key_frames);
+    TEST_ASSERT_EQUAL(33, b.first_pts);
+    TEST_ASSERT_EQUAL(132, b.last_pts);
+    TEST_ASSERT_EQUAL(1, webrtc_fanout_get_gop_flushed(fanout));
+
+    // Cache holds 5 frames of GOP_SIZE, next one overflows and drops partial GOP
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 165, false));
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &c));
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 198, false));
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &c) == false);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_fanout_set_active(fanout, &c, true, true));
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 231, false));
+    // Invalid cache is not flushed, viewer waits for key frame
+    usleep(50 * 1000);
+    TEST_ASSERT_EQUAL(0, c.frames);
+    TEST_ASSERT_EQUAL(0, push_video(&capture, &a, 264, true));
+    TEST_ASSERT(wait_frames(&c, 1, 500));
+    TEST_ASSERT_EQUAL(1, c.key_frames);
+    TEST_ASSERT_EQUAL(264, c.first_pts);
+    TEST_ASSERT_EQUAL(1, webrtc_fanout_get_gop_flushed(fanout));
+    // Cache rebuilt from new key frame
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &c));
+
+    // Stop of capture makes cache stale
+    webrtc_fanout_set_active(fanout, &a, false, true);
+    webrtc_fanout_set_active(fanout, &b, false, true);
+    webrtc_fanout_set_active(fanout, &c, false, true);
+    TEST_ASSERT(webrtc_fanout_gop_ready(fanout, &a) == false);
+    webrtc_fanout_detach(fanout, &a);
+    webrtc_fanout_detach(fanout, &b);
+    webrtc_fanout_detach(fanout, &c);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    media_lib_add_host_os_adapter();
+    TEST_RUN(test_fanout_share_capture, failed);
+    TEST_RUN(test_fanout_restart_race, failed);
+    TEST_RUN(test_fanout_gop_cache, failed);
+    media_lib_thread_pool_clear();
+    return failed;
+}
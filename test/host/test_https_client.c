@@ -0,0 +1,344 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "test_common.h"
+#include "media_lib_os_adapter_host.h"
+#include "https_client.h"
+
+#define REQ_HEAD_SIZE   (2048)
+#define POST_MAX_SIZE   (1024)
+#define BODY_LIMIT      (1024)
+
+/**
+ * @brief  Local HTTP/1.1 server, response is selected by request path:
+ *         `/plain/<size>`            Body with Content-Length
+ *         `/chunked/<size>/<chunk>`  Chunked body split into chunks of given size
+ *         `/close/<size>`            Body with Content-Length then connection closed
+ */
+typedef struct {
+    int   listen_sock;
+    int   port;
+    int   accepted;
+    char  post_data[POST_MAX_SIZE];
+    int   post_size;
+} test_server_t;
+
+typedef struct {
+    test_server_t *server;
+    int            sock;
+} server_conn_t;
+
+typedef struct {
+    char *data;
+    int   size;
+    int   body_num;
+} body_ctx_t;
+
+static test_server_t server;
+
+static char pattern(int i)
+{
+    return 'a' + i % 26;
+}
+
+static int send_all(int sock, const char *data, int len)
+{
+    while (len > 0) {
+        int ret = send(sock, data, len, MSG_NOSIGNAL);
+        if (ret <= 0) {
+            return -1;
+        }
+        data += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+static int read_request(server_conn_t *conn, char *path, int path_size)
+{
+    char head[REQ_HEAD_SIZE];
+    int len = 0;
+    // Byte by byte so that nothing of request body is consumed
+    while (len < 4 || memcmp(head + len - 4, "\r\n\r\n", 4)) {
+        if (len >= REQ_HEAD_SIZE - 1 || recv(conn->sock, head + len, 1, 0) != 1) {
+            return -1;
+        }
+        len++;
+    }
+    head[len] = '\0';
+    char fmt[32];
+    snprintf(fmt, sizeof(fmt), "%%*s %%%ds", path_size - 1);
+    if (sscanf(head, fmt, path) != 1) {
+        return -1;
+    }
+    char *cl = strstr(head, "Content-Length: ");
+    int body_size = cl ? atoi(cl + 16) : 0;
+    if (body_size >= POST_MAX_SIZE) {
+        return -1;
+    }
+    test_server_t *s = conn->server;
+    for (int got = 0; got < body_size;) {
+        int ret = recv(conn->sock, s->post_data + got, body_size - got, 0);
+        if (ret <= 0) {
+            return -1;
+        }
+        got += ret;
+    }
+    s->post_data[body_size] = '\0';
+    s->post_size = body_size;
+    return 0;
+}
+
+static int send_response(int sock, const char *path, bool *close_conn)
+{
+    int size = 0, chunk = 0;
+    char head[256];
+    char *body = NULL;
+    int ret = -1;
+    if (sscanf(path, "/chunked/%d/%d", &size, &chunk) == 2 && chunk > 0) {
+        body = malloc(size + 1);
+        for (int i = 0; i < size; i++) {
+            body[i] = pattern(i);
+        }
+        int len = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+                                               "Transfer-Encoding: chunked\r\n\r\n");
+        ret = send_all(sock, head, len);
+        // Each chunk sent separately so that size line, data and trailing CRLF arrive apart
+        for (int pos = 0; ret == 0 && pos < size; pos += chunk) {
+            int n = size - pos < chunk ? size - pos : chunk;
+            len = snprintf(head, sizeof(head), "%x\r\n", n);
+            ret = send_all(sock, head, len);
+            ret |= send_all(sock, body + pos, n);
+            ret |= send_all(sock, "\r\n", 2);
+        }
+        if (ret == 0) {
+            ret = send_all(sock, "0\r\n\r\n", 5);
+        }
+    } else if (sscanf(path, "/plain/%d", &size) == 1 || sscanf(path, "/close/%d", &size) == 1) {
+        *close_conn = (strncmp(path, "/close/", 7) == 0);
+        body = malloc(size + 1);
+        for (int i = 0; i < size; i++) {
+            body[i] = pattern(i);
+        }
+        int len = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n%s\r\n",
+                           size, *close_conn ? "Connection: close\r\n" : "");
+        ret = send_all(sock, head, len);
+        if (ret == 0) {
+            ret = send_all(sock, body, size);
+        }
+    } else {
+        const char *resp = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+        ret = send_all(sock, resp, strlen(resp));
+    }
+    free(body);
+    return ret;
+}
+
+static void *conn_thread(void *arg)
+{
+    server_conn_t *conn = (server_conn_t *)arg;
+    char path[128];
+    bool close_conn = false;
+    // Serve requests on kept connection until client closes it
+    while (close_conn == false && read_request(conn, path, sizeof(path)) == 0) {
+        if (send_response(conn->sock, path, &close_conn) != 0) {
+            break;
+        }
+    }
+    close(conn->sock);
+    free(conn);
+    return NULL;
+}
+
+static void *server_thread(void *arg)
+{
+    test_server_t *s = (test_server_t *)arg;
+    while (1) {
+        int sock = accept(s->listen_sock, NULL, NULL);
+        if (sock < 0) {
+            break;
+        }
+        __atomic_add_fetch(&s->accepted, 1, __ATOMIC_ACQ_REL);
+        server_conn_t *conn = calloc(1, sizeof(server_conn_t));
+        conn->server = s;
+        conn->sock = sock;
+        pthread_t thread;
+        pthread_create(&thread, NULL, conn_thread, conn);
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+static int server_start(test_server_t *s)
+{
+    s->listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(s->listen_sock >= 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    TEST_ASSERT_EQUAL(0, bind(s->listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(s->listen_sock, 4));
+    TEST_ASSERT_EQUAL(0, getsockname(s->listen_sock, (struct sockaddr *)&addr, &addr_len));
+    s->port = ntohs(addr.sin_port);
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, server_thread, s));
+    pthread_detach(thread);
+    return 0;
+}
+
+static void on_body(http_resp_t *resp, void *ctx)
+{
+    body_ctx_t *b = (body_ctx_t *)ctx;
+    free(b->data);
+    b->data = malloc(resp->size + 1);
+    memcpy(b->data, resp->data, resp->size + 1);
+    b->size = resp->size;
+    b->body_num++;
+}
+
+static int do_request(const char *method, const char *path, char *post, uint32_t max_body_size, body_ctx_t *body)
+{
+    char url[128];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d%s", server.port, path);
+    https_request_cfg_t cfg = {
+        .keep_alive_enable = true,
+        .max_body_size = max_body_size,
+    };
+    int status = 0;
+    https_request_t req = {
+        .method = method,
+        .url = url,
+        .data = post,
+        .body_cb = on_body,
+        .ctx = body,
+        .status = &status,
+    };
+    memset(body, 0, sizeof(body_ctx_t));
+    int ret = https_request_advance(&cfg, &req);
+    if (ret == 0 && status != 200) {
+        ret = -1;
+    }
+    return ret;
+}
+
+static int check_body(const char *path, int size)
+{
+    body_ctx_t body;
+    TEST_ASSERT_EQUAL(0, do_request("GET", path, NULL, 0, &body));
+    // Empty body is not reported
+    TEST_ASSERT_EQUAL(size ? 1 : 0, body.body_num);
+    TEST_ASSERT_EQUAL(size, body.size);
+    for (int i = 0; i < size; i++) {
+        if (body.data[i] != pattern(i)) {
+            printf("    %s mismatch at %d\n", path, i);
+            free(body.data);
+            return -1;
+        }
+    }
+    // Body is string terminated for SDP and JSON parsers
+    TEST_ASSERT(size == 0 || body.data[size] == '\0');
+    free(body.data);
+    return 0;
+}
+
+static int test_https_plain_body(void)
+{
+    const int sizes[] = { 0, 1, 100, 5000, 40000 };
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/plain/%d", sizes[i]);
+        TEST_ASSERT_EQUAL(0, check_body(path, sizes[i]));
+    }
+    return 0;
+}
+
+static int test_https_chunked_body(void)
+{
+    // Chunk smaller, equal and bigger than client buffer, split at odd positions
+    const int cases[][2] = {
+        { 0, 1 }, { 1, 1 }, { 100, 7 }, { 5000, 1000 }, { 40000, 4096 }, { 10000, 10000 }, { 60000, 333 },
+    };
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/chunked/%d/%d", cases[i][0], cases[i][1]);
+        TEST_ASSERT_EQUAL(0, check_body(path, cases[i][0]));
+    }
+    return 0;
+}
+
+static int test_https_body_limit(void)
+{
+    body_ctx_t body;
+    // Exactly at limit is accepted
+    TEST_ASSERT_EQUAL(0, do_request("GET", "/plain/1024", NULL, BODY_LIMIT, &body));
+    TEST_ASSERT_EQUAL(BODY_LIMIT, body.size);
+    free(body.data);
+    TEST_ASSERT_EQUAL(0, do_request("GET", "/chunked/1024/100", NULL, BODY_LIMIT, &body));
+    TEST_ASSERT_EQUAL(BODY_LIMIT, body.size);
+    free(body.data);
+    // Over limit fails without partial body reported
+    TEST_ASSERT(do_request("GET", "/plain/1025", NULL, BODY_LIMIT, &body) != 0);
+    TEST_ASSERT_EQUAL(0, body.body_num);
+    TEST_ASSERT(do_request("GET", "/chunked/1025/100", NULL, BODY_LIMIT, &body) != 0);
+    TEST_ASSERT_EQUAL(0, body.body_num);
+    // Default limit applies when not set
+    TEST_ASSERT(do_request("GET", "/chunked/70000/4096", NULL, 0, &body) != 0);
+    TEST_ASSERT_EQUAL(0, body.body_num);
+    return 0;
+}
+
+static int test_https_chunked_keep_alive(void)
+{
+    https_pool_flush();
+    https_pool_stats_t start, end;
+    https_pool_get_stats(&start);
+    int accepted = __atomic_load_n(&server.accepted, __ATOMIC_ACQUIRE);
+    body_ctx_t body;
+    // WHIP answer in chunks then following requests on same kept connection
+    char offer[] = "v=0\r\no=- 0 0 IN IP4 127.0.0.1\r\n";
+    TEST_ASSERT_EQUAL(0, do_request("POST", "/chunked/800/64", offer, 0, &body));
+    TEST_ASSERT_EQUAL(800, body.size);
+    free(body.data);
+    TEST_ASSERT_EQUAL(strlen(offer), server.post_size);
+    TEST_ASSERT_EQUAL(0, strcmp(offer, server.post_data));
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(0, check_body((i & 1) ? "/plain/300" : "/chunked/300/50", 300));
+    }
+    https_pool_get_stats(&end);
+    // Chunked body fully consumed, connection stays usable
+    TEST_ASSERT_EQUAL(1, __atomic_load_n(&server.accepted, __ATOMIC_ACQUIRE) - accepted);
+    TEST_ASSERT_EQUAL(4, end.reused - start.reused);
+    // Server closes after response, next request retried on new connection
+    TEST_ASSERT_EQUAL(0, check_body("/close/200", 200));
+    TEST_ASSERT_EQUAL(0, check_body("/chunked/200/30", 200));
+    TEST_ASSERT_EQUAL(2, __atomic_load_n(&server.accepted, __ATOMIC_ACQUIRE) - accepted);
+    https_pool_flush();
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    media_lib_add_host_os_adapter();
+    if (server_start(&server) != 0) {
+        return 1;
+    }
+    TEST_RUN(test_https_plain_body, failed);
+    TEST_RUN(test_https_chunked_body, failed);
+    TEST_RUN(test_https_body_limit, failed);
+    TEST_RUN(test_https_chunked_keep_alive, failed);
+    https_pool_flush();
+    close(server.listen_sock);
+    return failed;
+}
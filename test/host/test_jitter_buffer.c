@@ -0,0 +1,316 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "esp_peer_jitter_buffer.h"
+
+#define FRAME_INTERVAL  (33)
+#define TRACE_FRAMES    (900)
+#define TRACE_WINDOW    (128)
+#define BASE_TRANSIT    (40)
+#define PTS_START       (0xFFFFFFFF - 5000)
+#define EMPTY_WAIT      (0xFFFF)
+
+/**
+ * @brief  Arrival trace of one frame, times are on receiver clock
+ */
+typedef struct {
+    uint32_t  pts;
+    uint32_t  arrival;
+} trace_frame_t;
+
+typedef struct {
+    int       released;
+    int       out_of_order;
+    int       corrupted;
+    uint32_t  last_pts;
+    uint32_t  now;
+    uint32_t  release_time[TRACE_FRAMES];
+} release_ctx_t;
+
+static uint32_t rand_next(uint32_t *seed)
+{
+    // xorshift32
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+/**
+ * @brief  Build Wi-Fi like arrival trace: small random jitter plus periodic stalls
+ *         after which queued frames arrive in one burst, arrival keeps sending order
+ */
+static void build_trace(trace_frame_t *trace, int num, uint32_t seed, int jitter, int stall_period, int stall)
+{
+    uint32_t last = 0;
+    for (int i = 0; i < num; i++) {
+        uint32_t send = 10000 + i * FRAME_INTERVAL;
+        uint32_t transit = BASE_TRANSIT + (jitter ? rand_next(&seed) % (jitter + 1) : 0);
+        if (stall_period && i % stall_period == stall_period - 1) {
+            transit += stall;
+        }
+        uint32_t arrival = send + transit;
+        // Frames queued behind a stall are delivered right after it
+        if (i && (int32_t)(arrival - last) < 1) {
+            arrival = last + 1;
+        }
+        trace[i].pts = PTS_START + i * FRAME_INTERVAL;
+        trace[i].arrival = arrival;
+        last = arrival;
+    }
+}
+
+/**
+ * @brief  95th percentile of relative transit in last window, computed same way as definition
+ */
+static int trace_p95(trace_frame_t *trace, int num)
+{
+    int start = num > TRACE_WINDOW ? num - TRACE_WINDOW : 0;
+    int n = num - start;
+    int32_t *v = malloc(n * sizeof(int32_t));
+    int32_t min = 0x7FFFFFFF;
+    for (int i = 0; i < n; i++) {
+        v[i] = (int32_t)(trace[start + i].arrival - trace[start + i].pts);
+        if (v[i] < min) {
+            min = v[i];
+        }
+    }
+    // Sort descending, take the (n / 20 + 1)-th largest
+    for (int i = 1; i < n; i++) {
+        int32_t x = v[i];
+        int j = i;
+        while (j > 0 && v[j - 1] < x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    int p95 = v[n / 20] - min;
+    free(v);
+    return p95;
+}
+
+static void on_frame(uint32_t pts, uint8_t *data, int size, void *ctx)
+{
+    release_ctx_t *rel = (release_ctx_t *)ctx;
+    if (rel->released && (int32_t)(pts - rel->last_pts) <= 0) {
+        rel->out_of_order++;
+    }
+    if (size != 4 || memcmp(data, &pts, 4) != 0) {
+        rel->corrupted++;
+    }
+    if (rel->released < TRACE_FRAMES) {
+        rel->release_time[rel->released] = rel->now;
+    }
+    rel->last_pts = pts;
+    rel->released++;
+}
+
+/**
+ * @brief  Play trace with millisecond step, poll is driven by returned wait time like a playback task
+ *         Keep playing `tail` ms after last arrival so that buffered frames can drain
+ */
+static int play_trace(esp_peer_jitter_buffer_handle_t jb, trace_frame_t *trace, int num, uint32_t tail,
+                      release_ctx_t *rel)
+{
+    int next = 0;
+    uint32_t now = trace[0].arrival;
+    uint32_t next_poll = now;
+    uint32_t end = trace[num - 1].arrival + tail + 1;
+    for (; now != end; now++) {
+        while (next < num && trace[next].arrival == now) {
+            TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE,
+                              esp_peer_jitter_buffer_put(jb, trace[next].pts, (uint8_t *)&trace[next].pts, 4, now));
+            next++;
+            // New frame may be due earlier than scheduled wake up
+            next_poll = now;
+        }
+        if ((int32_t)(now - next_poll) >= 0) {
+            rel->now = now;
+            int wait = esp_peer_jitter_buffer_poll(jb, now, on_frame, rel);
+            TEST_ASSERT(wait > 0);
+            next_poll = now + (wait == EMPTY_WAIT ? 1000 : wait);
+        }
+    }
+    TEST_ASSERT_EQUAL(num, next);
+    return 0;
+}
+
+static int test_jitter_buffer_fixed(void)
+{
+    esp_peer_jitter_buffer_handle_t jb = NULL;
+    esp_peer_jitter_buffer_cfg_t cfg = {
+        .mode = ESP_PEER_JITTER_MODE_FIXED,
+        .fixed_delay = 60,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, esp_peer_jitter_buffer_create(NULL, &jb));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_create(&cfg, &jb));
+    static trace_frame_t trace[TRACE_FRAMES];
+    static release_ctx_t rel;
+    memset(&rel, 0, sizeof(rel));
+    // No network jitter, every frame is released exactly fixed delay after arrival
+    build_trace(trace, 100, 1, 0, 0, 0);
+    TEST_ASSERT_EQUAL(0, play_trace(jb, trace, 100, 1000, &rel));
+    TEST_ASSERT_EQUAL(100, rel.released);
+    TEST_ASSERT_EQUAL(0, rel.out_of_order);
+    TEST_ASSERT_EQUAL(0, rel.corrupted);
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(trace[i].arrival + cfg.fixed_delay, rel.release_time[i]);
+    }
+    esp_peer_jitter_buffer_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_get_stats(jb, &stats));
+    TEST_ASSERT_EQUAL(100, stats.assembled);
+    TEST_ASSERT_EQUAL(100, stats.released);
+    TEST_ASSERT_EQUAL(0, stats.late);
+    TEST_ASSERT_EQUAL(0, stats.jitter);
+    TEST_ASSERT_EQUAL(60, stats.target_delay);
+    esp_peer_jitter_buffer_destroy(jb);
+    return 0;
+}
+
+static int test_jitter_buffer_adaptive_trace(void)
+{
+    static trace_frame_t trace[TRACE_FRAMES];
+    static release_ctx_t fixed_rel;
+    static release_ctx_t adaptive_rel;
+    memset(&fixed_rel, 0, sizeof(fixed_rel));
+    memset(&adaptive_rel, 0, sizeof(adaptive_rel));
+    // Up to 20ms random jitter with 120ms stall every 3 seconds
+    build_trace(trace, TRACE_FRAMES, 0xC0FFEE, 20, 90, 120);
+
+    esp_peer_jitter_buffer_handle_t fixed = NULL;
+    esp_peer_jitter_buffer_cfg_t cfg = {
+        .mode = ESP_PEER_JITTER_MODE_FIXED,
+        .fixed_delay = 10,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_create(&cfg, &fixed));
+    TEST_ASSERT_EQUAL(0, play_trace(fixed, trace, TRACE_FRAMES, 1000, &fixed_rel));
+    esp_peer_jitter_buffer_stats_t fixed_stats;
+    esp_peer_jitter_buffer_get_stats(fixed, &fixed_stats);
+    esp_peer_jitter_buffer_destroy(fixed);
+
+    esp_peer_jitter_buffer_handle_t adaptive = NULL;
+    cfg.mode = ESP_PEER_JITTER_MODE_ADAPTIVE;
+    cfg.min_delay = 10;
+    cfg.max_delay = 300;
+    cfg.margin = 10;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_create(&cfg, &adaptive));
+    TEST_ASSERT_EQUAL(0, play_trace(adaptive, trace, TRACE_FRAMES, 1000, &adaptive_rel));
+    esp_peer_jitter_buffer_stats_t stats;
+    esp_peer_jitter_buffer_get_stats(adaptive, &stats);
+    esp_peer_jitter_buffer_destroy(adaptive);
+
+    printf("Fixed late %u, adaptive late %u jitter %u target %u\n", (unsigned)fixed_stats.late,
+           (unsigned)stats.late, stats.jitter, stats.target_delay);
+    TEST_ASSERT_EQUAL(TRACE_FRAMES, adaptive_rel.released);
+    TEST_ASSERT_EQUAL(0, adaptive_rel.out_of_order);
+    TEST_ASSERT_EQUAL(0, adaptive_rel.corrupted);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    // Reported jitter is 95th percentile of relative transit over measure window
+    TEST_ASSERT_EQUAL(trace_p95(trace, TRACE_FRAMES), stats.jitter);
+    TEST_ASSERT(stats.target_delay >= stats.jitter + cfg.margin);
+    TEST_ASSERT(stats.target_delay <= cfg.max_delay);
+    // Adaptive delay absorbs most jitter which small fixed delay can not
+    TEST_ASSERT(stats.late * 4 < fixed_stats.late);
+    // Playout keeps frame pacing once adapted, no release comes earlier than its frame interval
+    int smooth = 0;
+    for (int i = TRACE_FRAMES / 2; i < TRACE_FRAMES; i++) {
+        int32_t gap = (int32_t)(adaptive_rel.release_time[i] - adaptive_rel.release_time[i - 1]);
+        if (gap >= FRAME_INTERVAL - 1 && gap <= FRAME_INTERVAL + 1) {
+            smooth++;
+        }
+    }
+    TEST_ASSERT(smooth * 10 >= (TRACE_FRAMES / 2) * 9);
+    return 0;
+}
+
+static int test_jitter_buffer_decrease(void)
+{
+    static trace_frame_t trace[TRACE_FRAMES];
+    static release_ctx_t rel;
+    memset(&rel, 0, sizeof(rel));
+    esp_peer_jitter_buffer_handle_t jb = NULL;
+    esp_peer_jitter_buffer_cfg_t cfg = {
+        .mode = ESP_PEER_JITTER_MODE_ADAPTIVE,
+        .max_delay = 200,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_create(&cfg, &jb));
+    // Two 150ms stalls at start then clean network
+    build_trace(trace, TRACE_FRAMES, 7, 0, 0, 0);
+    trace[9].arrival += 150;
+    trace[19].arrival += 150;
+    for (int i = 1; i < TRACE_FRAMES; i++) {
+        if ((int32_t)(trace[i].arrival - trace[i - 1].arrival) < 1) {
+            trace[i].arrival = trace[i - 1].arrival + 1;
+        }
+    }
+    // Stall raises target at once
+    TEST_ASSERT_EQUAL(0, play_trace(jb, trace, 20, 0, &rel));
+    esp_peer_jitter_buffer_stats_t stats;
+    esp_peer_jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT_EQUAL(150, stats.jitter);
+    TEST_ASSERT_EQUAL(150, stats.target_delay);
+    // Then drops back gradually instead of following each frame
+    TEST_ASSERT_EQUAL(0, play_trace(jb, trace + 20, 40, 0, &rel));
+    esp_peer_jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT(stats.target_delay > stats.jitter);
+    TEST_ASSERT(stats.target_delay < 150);
+    // Until stalls leave measure window
+    TEST_ASSERT_EQUAL(0, play_trace(jb, trace + 60, TRACE_WINDOW + 100, 1000, &rel));
+    esp_peer_jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT_EQUAL(0, stats.jitter);
+    TEST_ASSERT_EQUAL(0, stats.target_delay);
+    TEST_ASSERT_EQUAL(60 + TRACE_WINDOW + 100, rel.released);
+    TEST_ASSERT_EQUAL(0, rel.out_of_order);
+    esp_peer_jitter_buffer_destroy(jb);
+    return 0;
+}
+
+static int test_jitter_buffer_overflow_reset(void)
+{
+    esp_peer_jitter_buffer_handle_t jb = NULL;
+    esp_peer_jitter_buffer_cfg_t cfg = {
+        .mode = ESP_PEER_JITTER_MODE_FIXED,
+        .fixed_delay = 100,
+        .max_frames = 4,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_create(&cfg, &jb));
+    for (uint32_t i = 0; i < 6; i++) {
+        uint32_t pts = i * FRAME_INTERVAL;
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_jitter_buffer_put(jb, pts, (uint8_t *)&pts, 4, pts));
+    }
+    esp_peer_jitter_buffer_stats_t stats;
+    esp_peer_jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT_EQUAL(2, stats.dropped);
+    // Oldest frames are dropped, first kept one due at its pts plus fixed delay
+    release_ctx_t *rel = calloc(1, sizeof(release_ctx_t));
+    TEST_ASSERT(rel != NULL);
+    TEST_ASSERT_EQUAL(2 * FRAME_INTERVAL + 100 - 10, esp_peer_jitter_buffer_poll(jb, 10, on_frame, rel));
+    TEST_ASSERT_EQUAL(FRAME_INTERVAL, esp_peer_jitter_buffer_poll(jb, 2 * FRAME_INTERVAL + 100, on_frame, rel));
+    TEST_ASSERT_EQUAL(1, rel->released);
+    TEST_ASSERT_EQUAL(2 * FRAME_INTERVAL, rel->last_pts);
+    esp_peer_jitter_buffer_reset(jb);
+    TEST_ASSERT_EQUAL(EMPTY_WAIT, esp_peer_jitter_buffer_poll(jb, 1000, on_frame, rel));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, esp_peer_jitter_buffer_poll(jb, 1000, NULL, NULL));
+    free(rel);
+    esp_peer_jitter_buffer_destroy(jb);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_jitter_buffer_fixed, failed);
+    TEST_RUN(test_jitter_buffer_adaptive_trace, failed);
+    TEST_RUN(test_jitter_buffer_decrease, failed);
+    TEST_RUN(test_jitter_buffer_overflow_reset, failed);
+    return failed;
+}
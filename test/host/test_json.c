@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include "test_common.h"
+#include "webrtc_utils_json.h"
+
+#define FIELD_NUM(fields) (int)(sizeof(fields) / sizeof(fields[0]))
+
+static int test_json_find_basic(void)
+{
+    char json[] = " {\"type\" : \"offer\", \"id\":123,\"ok\":true, \"obj\":{\"a\":[1,\"}\"]}, \"none\":null } ";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "type"},
+        {.key = "id"},
+        {.key = "ok"},
+        {.key = "obj"},
+        {.key = "none"},
+        {.key = "missing"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, strlen(json), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(fields[0].is_str);
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[0].value, "offer"));
+    TEST_ASSERT(fields[1].is_str == false);
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[1].value, "123"));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[2].value, "true"));
+    // Nested value is returned as raw text, string content must not close container
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[3].value, "{\"a\":[1,\"}\"]}"));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[4].value, "null"));
+    TEST_ASSERT(fields[5].value.str == NULL);
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[5].value, "") == false);
+    return 0;
+}
+
+static int test_json_find_signaling(void)
+{
+    char json[] = "{\"type\":\"answer\",\"sdp\":\"v=0\\r\\no=- 1 1 IN IP4 0.0.0.0\\r\\n\"}";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "sdp"},
+        {.key = "type"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, strlen(json), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[1].value, "answer"));
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_unescape(&fields[0].value));
+    TEST_ASSERT_EQUAL(strlen("v=0\r\no=- 1 1 IN IP4 0.0.0.0\r\n"), fields[0].value.len);
+    TEST_ASSERT(strcmp(fields[0].value.str, "v=0\r\no=- 1 1 IN IP4 0.0.0.0\r\n") == 0);
+    return 0;
+}
+
+static int test_json_find_first_wins(void)
+{
+    char json[] = "{\"k\":\"first\",\"k\":\"second\"}";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "k"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, strlen(json), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[0].value, "first"));
+    return 0;
+}
+
+static int test_json_find_length(void)
+{
+    // Only scan given length, buffer need not be NUL terminated
+    char json[] = "{\"a\":1}garbage";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "a"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, 7, fields, FIELD_NUM(fields)));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[0].value, "1"));
+    // Length larger than C string content stops at NUL
+    char padded[32] = "{\"a\":\"b\"}";
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(padded, sizeof(padded), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(webrtc_utils_json_equal(&fields[0].value, "b"));
+    // Truncated object is malformed
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, webrtc_utils_json_find(json, 6, fields, FIELD_NUM(fields)));
+    return 0;
+}
+
+static int test_json_find_empty(void)
+{
+    char json[] = " { } ";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "a"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, strlen(json), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(fields[0].value.str == NULL);
+    return 0;
+}
+
+static int test_json_find_malformed(void)
+{
+    const char *bad[] = {
+        "",
+        "[1,2]",
+        "{\"a\" 1}",
+        "{\"a\":}",
+        "{\"a\":\"open}",
+        "{\"a\":{\"b\":1}",
+        "{\"a\":[1,2}",
+        "{\"a\":1 \"b\":2}",
+        "{a:1}",
+        "{\"a\":1,",
+    };
+    for (int i = 0; i < FIELD_NUM(bad); i++) {
+        char json[64];
+        strcpy(json, bad[i]);
+        webrtc_utils_json_field_t fields[] = {
+            {.key = "a"},
+        };
+        int len = strlen(json);
+        int ret = webrtc_utils_json_find(json, len ? len : 1, fields, FIELD_NUM(fields));
+        if (ret != ESP_ERR_INVALID_ARG) {
+            printf("Malformed JSON accepted: %s\n", bad[i]);
+            return -1;
+        }
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, webrtc_utils_json_find(NULL, 1, NULL, 0));
+    return 0;
+}
+
+static int test_json_find_depth(void)
+{
+    char json[128] = "{\"a\":";
+    int len = strlen(json);
+    for (int i = 0; i < 40; i++) {
+        json[len++] = '[';
+    }
+    for (int i = 0; i < 40; i++) {
+        json[len++] = ']';
+    }
+    json[len++] = '}';
+    json[len] = '\0';
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "a"},
+    };
+    // Too deep nesting is rejected instead of scanned without bound
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, webrtc_utils_json_find(json, len, fields, FIELD_NUM(fields)));
+    return 0;
+}
+
+static int test_json_unescape(void)
+{
+    char json[] = "{\"s\":\"q\\\"b\\\\s\\/n\\n\\t\\u00e9\\u20ac\\ud83d\\ude00\"}";
+    webrtc_utils_json_field_t fields[] = {
+        {.key = "s"},
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_find(json, strlen(json), fields, FIELD_NUM(fields)));
+    TEST_ASSERT(fields[0].is_str);
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_unescape(&fields[0].value));
+    const char expect[] = "q\"b\\s/n\n\t\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+    TEST_ASSERT_EQUAL(sizeof(expect) - 1, fields[0].value.len);
+    TEST_ASSERT_EQUAL_MEM(expect, fields[0].value.str, sizeof(expect));
+    return 0;
+}
+
+static int test_json_unescape_invalid(void)
+{
+    const char *bad[] = {
+        "a\\x",
+        "\\u12",
+        "\\u12G4",
+        "\\ud83d",
+        "\\ud83d\\u0041",
+        "tail\\",
+    };
+    for (int i = 0; i < FIELD_NUM(bad); i++) {
+        char buf[32];
+        strcpy(buf, bad[i]);
+        webrtc_utils_json_slice_t value = {
+            .str = buf,
+            .len = strlen(buf),
+        };
+        if (webrtc_utils_json_unescape(&value) != ESP_ERR_INVALID_ARG) {
+            printf("Bad escape accepted: %s\n", bad[i]);
+            return -1;
+        }
+    }
+    // No escape only terminates string
+    char plain[] = "abc\"";
+    webrtc_utils_json_slice_t value = {
+        .str = plain,
+        .len = 3,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, webrtc_utils_json_unescape(&value));
+    TEST_ASSERT(strcmp(plain, "abc") == 0);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_json_find_basic, failed);
+    TEST_RUN(test_json_find_signaling, failed);
+    TEST_RUN(test_json_find_first_wins, failed);
+    TEST_RUN(test_json_find_length, failed);
+    TEST_RUN(test_json_find_empty, failed);
+    TEST_RUN(test_json_find_malformed, failed);
+    TEST_RUN(test_json_find_depth, failed);
+    TEST_RUN(test_json_unescape, failed);
+    TEST_RUN(test_json_unescape_invalid, failed);
+    return failed;
+}
@@ -0,0 +1,409 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <malloc.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "webrtc_utils_json.h"
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+#define SDP_MAX_SIZE     (8192)
+#define FRAME_MAX_SIZE   (3 * SDP_MAX_SIZE)
+#define MAX_FRAME_NUM    (16)
+#define CANDIDATE_NUM    (8)
+#define BENCH_LOOP       (2000)
+
+enum {
+    MSG_NONE,
+    MSG_SDP,
+    MSG_CANDIDATE,
+    MSG_BYE,
+};
+
+typedef struct {
+    int         type;
+    const char *data;
+    int         size;
+} parsed_t;
+
+/**
+ * @brief  Websocket frames of one call in apprtc format, peer messages are JSON strings inside `msg`
+ *         Local signaling sends same inner objects without `msg` wrapper
+ */
+typedef struct {
+    char     *frames[MAX_FRAME_NUM];
+    int       sizes[MAX_FRAME_NUM];
+    parsed_t  expect[MAX_FRAME_NUM];
+    int       num;
+    int       total_size;
+} transcript_t;
+
+static char sdp[SDP_MAX_SIZE];
+static char candidates[CANDIDATE_NUM][128];
+static transcript_t transcript;
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static int build_sdp(char *out, int size)
+{
+    // Shape of browser offer with audio and video, about 5KB
+    static const char *video_codecs[] = { "VP8", "VP9", "VP9", "H264", "H264", "H264", "H264", "AV1", "H265", "H265" };
+    int len = snprintf(out, size, "v=0\r\no=- 4611731400430051336 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n"
+                                  "a=group:BUNDLE 0 1 2\r\na=extmap-allow-mixed\r\na=msid-semantic: WMS stream\r\n"
+                                  "m=audio 9 UDP/TLS/RTP/SAVPF 111 63 9 0 8 13 110 126\r\nc=IN IP4 0.0.0.0\r\n"
+                                  "a=rtcp:9 IN IP4 0.0.0.0\r\na=ice-ufrag:8hhY\r\na=ice-pwd:asd88fgpdd777uzjYhagZg+l\r\n"
+                                  "a=ice-options:trickle\r\na=fingerprint:sha-256 D2:FA:0E:C3:22:59:5E:14:95:69:92:3D:13:B4:"
+                                  "84:24:2C:C2:A2:C0:3E:FD:34:8E:5E:EA:6F:AF:52:CE:E6:0F\r\na=setup:actpass\r\na=mid:0\r\n"
+                                  "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\na=sendrecv\r\na=rtcp-mux\r\n"
+                                  "a=rtpmap:111 opus/48000/2\r\na=rtcp-fb:111 transport-cc\r\n"
+                                  "a=fmtp:111 minptime=10;useinbandfec=1\r\na=rtpmap:8 PCMA/8000\r\na=rtpmap:0 PCMU/8000\r\n"
+                                  "a=ssrc:3570614608 cname:4TOk42mSjXCkVIa6\r\n"
+                                  "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102 103 104 105 106 107 108 109 110 111 112 113 114 115\r\nc=IN IP4 0.0.0.0\r\n"
+                                  "a=rtcp:9 IN IP4 0.0.0.0\r\na=ice-ufrag:8hhY\r\na=ice-pwd:asd88fgpdd777uzjYhagZg+l\r\n"
+                                  "a=setup:actpass\r\na=mid:1\r\na=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+                                  "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+                                  "a=extmap:4 urn:3gpp:video-orientation\r\n"
+                                  "a=extmap:5 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+                                  "a=sendrecv\r\na=rtcp-mux\r\na=rtcp-rsize\r\n");
+    for (int i = 0; i < (int)(sizeof(video_codecs) / sizeof(video_codecs[0])) && len < size; i++) {
+        int pt = 96 + i * 2;
+        len += snprintf(out + len, size - len, "a=rtpmap:%d %s/90000\r\na=rtcp-fb:%d goog-remb\r\n"
+                                               "a=rtcp-fb:%d transport-cc\r\na=rtcp-fb:%d ccm fir\r\n"
+                                               "a=rtcp-fb:%d nack\r\na=rtcp-fb:%d nack pli\r\n"
+                                               "a=fmtp:%d level-asymmetry-allowed=1;packetization-mode=1;"
+                                               "profile-level-id=42e01f\r\na=rtpmap:%d rtx/90000\r\na=fmtp:%d apt=%d\r\n",
+                        pt, video_codecs[i], pt, pt, pt, pt, pt, pt, pt + 1, pt + 1, pt);
+    }
+    for (int i = 0; i < CANDIDATE_NUM && len < size; i++) {
+        len += snprintf(out + len, size - len, "a=%s\r\n", candidates[i]);
+    }
+    if (len < size) {
+        len += snprintf(out + len, size - len, "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+                                               "c=IN IP4 0.0.0.0\r\na=mid:2\r\na=sctp-port:5000\r\n"
+                                               "a=max-message-size:262144\r\n");
+    }
+    return len < size ? len : -1;
+}
+
+static int json_escape(const char *in, char *out, int size)
+{
+    int len = 0;
+    for (; *in && len < size - 2; in++) {
+        if (*in == '"' || *in == '\\') {
+            out[len++] = '\\';
+            out[len++] = *in;
+        } else if (*in == '\r' || *in == '\n') {
+            out[len++] = '\\';
+            out[len++] = *in == '\r' ? 'r' : 'n';
+        } else {
+            out[len++] = *in;
+        }
+    }
+    out[len] = '\0';
+    return *in ? -1 : len;
+}
+
+static int add_frame(const char *inner, bool wrap, parsed_t expect)
+{
+    TEST_ASSERT(transcript.num < MAX_FRAME_NUM);
+    char *frame = malloc(FRAME_MAX_SIZE);
+    TEST_ASSERT(frame != NULL);
+    int len;
+    if (wrap) {
+        char *escaped = malloc(FRAME_MAX_SIZE);
+        TEST_ASSERT(escaped != NULL);
+        TEST_ASSERT(json_escape(inner, escaped, FRAME_MAX_SIZE) > 0);
+        len = snprintf(frame, FRAME_MAX_SIZE, "{\"msg\":\"%s\",\"error\":\"\"}", escaped);
+        free(escaped);
+    } else {
+        len = snprintf(frame, FRAME_MAX_SIZE, "%s", inner);
+    }
+    TEST_ASSERT(len < FRAME_MAX_SIZE);
+    transcript.frames[transcript.num] = frame;
+    transcript.sizes[transcript.num] = len;
+    transcript.expect[transcript.num] = expect;
+    transcript.total_size += len;
+    transcript.num++;
+    return 0;
+}
+
+static int build_transcript(bool wrap)
+{
+    static char inner[FRAME_MAX_SIZE];
+    static char escaped[FRAME_MAX_SIZE];
+    for (int i = 0; i < CANDIDATE_NUM; i++) {
+        snprintf(candidates[i], sizeof(candidates[i]),
+                 "candidate:%u %d udp %u 192.168.%d.%d %d typ %s generation 0 ufrag 8hhY network-id %d",
+                 842163049u + i * 7919, 1, 2122260223u - i * 256, i, 10 + i, 50000 + i * 3, i < 4 ? "host" : "srflx", i);
+    }
+    int sdp_len = build_sdp(sdp, sizeof(sdp));
+    TEST_ASSERT(sdp_len > 4000);
+    TEST_ASSERT(json_escape(sdp, escaped, sizeof(escaped)) > 0);
+    TEST_ASSERT(snprintf(inner, sizeof(inner), "{\"type\":\"offer\",\"sdp\":\"%s\"}", escaped) < (int)sizeof(inner));
+    TEST_ASSERT_EQUAL(0, add_frame(inner, wrap, (parsed_t) { MSG_SDP, sdp, sdp_len }));
+    for (int i = 0; i < CANDIDATE_NUM; i++) {
+        snprintf(inner, sizeof(inner), "{\"type\":\"candidate\",\"label\":0,\"id\":\"0\",\"candidate\":\"%s\"}", candidates[i]);
+        TEST_ASSERT_EQUAL(0, add_frame(inner, wrap, (parsed_t) { MSG_CANDIDATE, candidates[i], strlen(candidates[i]) }));
+    }
+    TEST_ASSERT_EQUAL(0, add_frame("{\"type\":\"bye\"}", wrap, (parsed_t) { MSG_BYE, NULL, 0 }));
+    return 0;
+}
+
+static void free_transcript(void)
+{
+    for (int i = 0; i < transcript.num; i++) {
+        free(transcript.frames[i]);
+    }
+    memset(&transcript, 0, sizeof(transcript));
+}
+
+static int parse_slice(char *text, int len, parsed_t *out)
+{
+    // Same steps as `on_text` of apprtc signaling
+    enum {
+        FIELD_TYPE,
+        FIELD_SDP,
+        FIELD_CANDIDATE,
+        FIELD_MSG,
+        FIELD_MAX,
+    };
+    webrtc_utils_json_field_t fields[FIELD_MAX] = {
+        [FIELD_TYPE] = { .key = "type" },
+        [FIELD_SDP] = { .key = "sdp" },
+        [FIELD_CANDIDATE] = { .key = "candidate" },
+        [FIELD_MSG] = { .key = "msg" },
+    };
+    out->type = MSG_NONE;
+    if (webrtc_utils_json_find(text, len, fields, FIELD_MAX) != ESP_OK) {
+        return -1;
+    }
+    webrtc_utils_json_field_t *msg = &fields[FIELD_MSG];
+    if (msg->value.str) {
+        if (msg->is_str == false || webrtc_utils_json_unescape(&msg->value) != ESP_OK ||
+            webrtc_utils_json_find(msg->value.str, msg->value.len, fields, FIELD_MSG) != ESP_OK) {
+            return -1;
+        }
+    }
+    webrtc_utils_json_field_t *method = &fields[FIELD_TYPE];
+    webrtc_utils_json_field_t *value = NULL;
+    if (webrtc_utils_json_equal(&method->value, "offer") || webrtc_utils_json_equal(&method->value, "answer")) {
+        out->type = MSG_SDP;
+        value = &fields[FIELD_SDP];
+    } else if (webrtc_utils_json_equal(&method->value, "candidate")) {
+        out->type = MSG_CANDIDATE;
+        value = &fields[FIELD_CANDIDATE];
+    } else if (webrtc_utils_json_equal(&method->value, "bye")) {
+        out->type = MSG_BYE;
+    }
+    out->data = NULL;
+    out->size = 0;
+    if (value) {
+        if (value->value.str == NULL || webrtc_utils_json_unescape(&value->value) != ESP_OK) {
+            return -1;
+        }
+        out->data = value->value.str;
+        out->size = value->value.len;
+    }
+    return 0;
+}
+
+static int check_parsed(parsed_t *got, parsed_t *expect)
+{
+    TEST_ASSERT_EQUAL(expect->type, got->type);
+    TEST_ASSERT_EQUAL(expect->size, got->size);
+    if (expect->size) {
+        TEST_ASSERT_EQUAL_MEM(expect->data, got->data, expect->size);
+    }
+    return 0;
+}
+
+#ifdef HAVE_CJSON
+static size_t heap_cur;
+static size_t heap_peak;
+static int    alloc_num;
+
+static void *count_malloc(size_t size)
+{
+    size_t *p = malloc(size + sizeof(size_t) * 2);
+    if (p == NULL) {
+        return NULL;
+    }
+    p[0] = size;
+    heap_cur += size;
+    alloc_num++;
+    if (heap_cur > heap_peak) {
+        heap_peak = heap_cur;
+    }
+    return p + 2;
+}
+
+static void count_free(void *ptr)
+{
+    if (ptr) {
+        size_t *p = (size_t *)ptr - 2;
+        heap_cur -= p[0];
+        free(p);
+    }
+}
+
+static int parse_cjson(const char *text, parsed_t *out, cJSON **roots)
+{
+    // Same steps as original cJSON based `on_text`
+    out->type = MSG_NONE;
+    roots[0] = cJSON_Parse(text);
+    roots[1] = NULL;
+    if (roots[0] == NULL) {
+        return -1;
+    }
+    cJSON *msg = cJSON_GetObjectItem(roots[0], "msg");
+    if (msg) {
+        msg = roots[1] = cJSON_Parse(msg->valuestring);
+    } else {
+        msg = roots[0];
+    }
+    cJSON *method = cJSON_GetObjectItem(msg, "type");
+    if (method == NULL || method->valuestring == NULL) {
+        return -1;
+    }
+    cJSON *value = NULL;
+    if (strcmp(method->valuestring, "offer") == 0 || strcmp(method->valuestring, "answer") == 0) {
+        out->type = MSG_SDP;
+        value = cJSON_GetObjectItem(msg, "sdp");
+    } else if (strcmp(method->valuestring, "candidate") == 0) {
+        out->type = MSG_CANDIDATE;
+        value = cJSON_GetObjectItem(msg, "candidate");
+    } else if (strcmp(method->valuestring, "bye") == 0) {
+        out->type = MSG_BYE;
+    }
+    out->data = NULL;
+    out->size = 0;
+    if (value) {
+        out->data = value->valuestring;
+        out->size = strlen(value->valuestring);
+    }
+    return 0;
+}
+
+static void free_cjson(cJSON **roots)
+{
+    cJSON_Delete(roots[1]);
+    cJSON_Delete(roots[0]);
+}
+
+static int bench_cjson(int *cost, int *peak, int *allocs)
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = count_malloc,
+        .free_fn = count_free,
+    };
+    cJSON_InitHooks(&hooks);
+    parsed_t got;
+    cJSON *roots[2];
+    heap_cur = heap_peak = 0;
+    alloc_num = 0;
+    // Check result and heap once per frame
+    for (int i = 0; i < transcript.num; i++) {
+        heap_peak = heap_cur;
+        TEST_ASSERT_EQUAL(0, parse_cjson(transcript.frames[i], &got, roots));
+        TEST_ASSERT_EQUAL(0, check_parsed(&got, &transcript.expect[i]));
+        free_cjson(roots);
+        if ((int)heap_peak > *peak) {
+            *peak = (int)heap_peak;
+        }
+    }
+    *allocs = alloc_num;
+    TEST_ASSERT_EQUAL(0, heap_cur);
+    int64_t start = now_us();
+    for (int n = 0; n < BENCH_LOOP; n++) {
+        for (int i = 0; i < transcript.num; i++) {
+            parse_cjson(transcript.frames[i], &got, roots);
+            free_cjson(roots);
+        }
+    }
+    *cost = (int)((now_us() - start) * 1000 / BENCH_LOOP);
+    cJSON_InitHooks(NULL);
+    return 0;
+}
+#endif  /* HAVE_CJSON */
+
+static int bench_slice(int *cost)
+{
+    // Websocket receive buffer is parsed in place, work on a copy so that every loop sees same input
+    char *work = malloc(FRAME_MAX_SIZE);
+    TEST_ASSERT(work != NULL);
+    parsed_t got;
+    for (int i = 0; i < transcript.num; i++) {
+        memcpy(work, transcript.frames[i], transcript.sizes[i] + 1);
+        size_t heap_start = mallinfo2().uordblks;
+        TEST_ASSERT_EQUAL(0, parse_slice(work, transcript.sizes[i], &got));
+        // Nothing allocated, values point into receive buffer
+        TEST_ASSERT_EQUAL(heap_start, mallinfo2().uordblks);
+        TEST_ASSERT(got.data == NULL || (got.data >= work && got.data < work + transcript.sizes[i]));
+        TEST_ASSERT_EQUAL(0, check_parsed(&got, &transcript.expect[i]));
+    }
+    // Copy is included in measured time, cJSON reads input without copy
+    int64_t start = now_us();
+    for (int n = 0; n < BENCH_LOOP; n++) {
+        for (int i = 0; i < transcript.num; i++) {
+            memcpy(work, transcript.frames[i], transcript.sizes[i] + 1);
+            parse_slice(work, transcript.sizes[i], &got);
+        }
+    }
+    *cost = (int)((now_us() - start) * 1000 / BENCH_LOOP);
+    free(work);
+    return 0;
+}
+
+static int run_bench(bool wrap)
+{
+    TEST_ASSERT_EQUAL(0, build_transcript(wrap));
+    int slice_cost = 0;
+    int ret = bench_slice(&slice_cost);
+    if (ret == 0) {
+        printf("    %s: %d frames %d bytes, tokenizer %dus per transcript, heap peak 0\n", wrap ? "apprtc" : "local",
+               transcript.num, transcript.total_size, slice_cost / 1000);
+    }
+#ifdef HAVE_CJSON
+    int cjson_cost = 0, peak = 0, allocs = 0;
+    if (ret == 0) {
+        ret = bench_cjson(&cjson_cost, &peak, &allocs);
+    }
+    if (ret == 0) {
+        printf("    %s: cJSON %dus per transcript, heap peak %d bytes, %d allocations\n", wrap ? "apprtc" : "local",
+               cjson_cost / 1000, peak, allocs);
+    }
+#endif  /* HAVE_CJSON */
+    free_transcript();
+    return ret;
+}
+
+static int test_json_bench_apprtc(void)
+{
+    return run_bench(true);
+}
+
+static int test_json_bench_local(void)
+{
+    return run_bench(false);
+}
+
+int main(void)
+{
+    int failed = 0;
+#ifndef HAVE_CJSON
+    printf("cJSON not found on host, only tokenizer is measured\n");
+#endif  /* HAVE_CJSON */
+    TEST_RUN(test_json_bench_apprtc, failed);
+    TEST_RUN(test_json_bench_local, failed);
+    return failed;
+}
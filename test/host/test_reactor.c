@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "esp_peer_types.h"
+#include "media_lib_os.h"
+#include "media_lib_os_adapter_host.h"
+#include "esp_webrtc_reactor.h"
+
+#define BENCH_CLIENT_NUM  (4)
+#define BENCH_WAKEUP_NUM  (4000)
+#define LOCK_ORDER_LOOP   (2000)
+
+typedef struct {
+    webrtc_reactor_client_handle_t  handle;
+    uint32_t                        next;        /*!< Return value of run callback */
+    uint32_t                        sleep_us;    /*!< Busy time inside run callback */
+    pthread_mutex_t                *dispatch;    /*!< Lock taken inside run callback when set */
+    int64_t                         wake_time;   /*!< Wakeup time to measure latency, 0 if none pending */
+    int64_t                         latency_sum;
+    int64_t                         latency_max;
+    int                             latency_num;
+    int                             run_num;
+    bool                            in_run;
+} test_client_t;
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static uint32_t client_run(void *ctx)
+{
+    test_client_t *c = (test_client_t *)ctx;
+    __atomic_store_n(&c->in_run, true, __ATOMIC_RELEASE);
+    int64_t wake_time = __atomic_exchange_n(&c->wake_time, 0, __ATOMIC_ACQ_REL);
+    if (wake_time) {
+        int64_t latency = now_us() - wake_time;
+        c->latency_sum += latency;
+        c->latency_num++;
+        if (latency > c->latency_max) {
+            c->latency_max = latency;
+        }
+    }
+    if (c->dispatch) {
+        pthread_mutex_lock(c->dispatch);
+        pthread_mutex_unlock(c->dispatch);
+    }
+    if (c->sleep_us) {
+        usleep(c->sleep_us);
+    }
+    __atomic_add_fetch(&c->run_num, 1, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&c->in_run, false, __ATOMIC_RELEASE);
+    return c->next;
+}
+
+static int run_num(test_client_t *c)
+{
+    return __atomic_load_n(&c->run_num, __ATOMIC_ACQUIRE);
+}
+
+static int test_reactor_deadline(void)
+{
+    test_client_t c = { .next = 20 };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &c, &c.handle));
+    usleep(400 * 1000);
+    int num = run_num(&c);
+    webrtc_reactor_detach(c.handle);
+    // Run once at attach then every 20ms, no extra run without wakeup
+    printf("    deadline runs in 400ms: %d\n", num);
+    TEST_ASSERT(num >= 12 && num <= 22);
+    return 0;
+}
+
+static int test_reactor_wakeup_bench(void)
+{
+    test_client_t clients[BENCH_CLIENT_NUM] = { 0 };
+    for (int i = 0; i < BENCH_CLIENT_NUM; i++) {
+        clients[i].next = WEBRTC_REACTOR_MAX_WAIT;
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &clients[i], &clients[i].handle));
+    }
+    usleep(10 * 1000);
+    uint32_t wakeup_start, run_start, wakeup_end, run_end;
+    webrtc_reactor_get_stats(&wakeup_start, &run_start);
+    // Mimic frame sending of several connections, each send wakes its own client
+    for (int i = 0; i < BENCH_WAKEUP_NUM; i++) {
+        test_client_t *c = &clients[i % BENCH_CLIENT_NUM];
+        int64_t expect = 0;
+        __atomic_compare_exchange_n(&c->wake_time, &expect, now_us(), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        webrtc_reactor_wakeup(c->handle);
+        if (i % BENCH_CLIENT_NUM == BENCH_CLIENT_NUM - 1) {
+            usleep(250);
+        }
+    }
+    usleep(20 * 1000);
+    webrtc_reactor_get_stats(&wakeup_end, &run_end);
+    int64_t sum = 0, max = 0;
+    int num = 0;
+    for (int i = 0; i < BENCH_CLIENT_NUM; i++) {
+        // Every wakeup is served, pending one would show as unfinished measurement
+        TEST_ASSERT_EQUAL(0, __atomic_load_n(&clients[i].wake_time, __ATOMIC_ACQUIRE));
+        sum += clients[i].latency_sum;
+        num += clients[i].latency_num;
+        if (clients[i].latency_max > max) {
+            max = clients[i].latency_max;
+        }
+    }
+    for (int i = 0; i < BENCH_CLIENT_NUM; i++) {
+        webrtc_reactor_detach(clients[i].handle);
+    }
+    printf("    %d wakeups: reactor wakeups %u runs %u latency avg %dus max %dus\n", BENCH_WAKEUP_NUM,
+           (unsigned)(wakeup_end - wakeup_start), (unsigned)(run_end - run_start),
+           num ? (int)(sum / num) : 0, (int)max);
+    TEST_ASSERT(num > 0);
+    // Wakeups arriving during a pass are coalesced, never more runs than wakeups
+    TEST_ASSERT(run_end - run_start <= BENCH_WAKEUP_NUM);
+    TEST_ASSERT(sum / num < 5000);
+    return 0;
+}
+
+typedef struct {
+    test_client_t   *client;
+    pthread_mutex_t *dispatch;
+    bool             stop;
+    int              loop;
+} sender_arg_t;
+
+static void *sender_thread(void *arg)
+{
+    sender_arg_t *s = (sender_arg_t *)arg;
+    // Fan-out dispatch wakes connection while holding its dispatch lock
+    while (__atomic_load_n(&s->stop, __ATOMIC_ACQUIRE) == false) {
+        pthread_mutex_lock(s->dispatch);
+        webrtc_reactor_wakeup(s->client->handle);
+        pthread_mutex_unlock(s->dispatch);
+        s->loop++;
+    }
+    return NULL;
+}
+
+static int test_reactor_lock_order(void)
+{
+    // Run callback waits for dispatch lock, sender holds dispatch lock and wakes, app pauses and resumes
+    pthread_mutex_t dispatch = PTHREAD_MUTEX_INITIALIZER;
+    test_client_t c = { .next = 1, .dispatch = &dispatch };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &c, &c.handle));
+    sender_arg_t s = { .client = &c, .dispatch = &dispatch };
+    pthread_t sender;
+    TEST_ASSERT_EQUAL(0, pthread_create(&sender, NULL, sender_thread, &s));
+    for (int i = 0; i < LOCK_ORDER_LOOP; i++) {
+        webrtc_reactor_pause(c.handle, true);
+        TEST_ASSERT(__atomic_load_n(&c.in_run, __ATOMIC_ACQUIRE) == false);
+        webrtc_reactor_pause(c.handle, false);
+    }
+    __atomic_store_n(&s.stop, true, __ATOMIC_RELEASE);
+    pthread_join(sender, NULL);
+    webrtc_reactor_detach(c.handle);
+    printf("    %d pause loops, sender wakeups %d runs %d\n", LOCK_ORDER_LOOP, s.loop, run_num(&c));
+    TEST_ASSERT(run_num(&c) > 0);
+    return 0;
+}
+
+static int test_reactor_pause(void)
+{
+    test_client_t c = { .next = 1, .sleep_us = 2000 };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &c, &c.handle));
+    usleep(20 * 1000);
+    webrtc_reactor_pause(c.handle, true);
+    // Callback is finished once pause returned and not run again
+    TEST_ASSERT(__atomic_load_n(&c.in_run, __ATOMIC_ACQUIRE) == false);
+    int paused_num = run_num(&c);
+    webrtc_reactor_wakeup(c.handle);
+    usleep(30 * 1000);
+    TEST_ASSERT_EQUAL(paused_num, run_num(&c));
+    webrtc_reactor_pause(c.handle, false);
+    usleep(30 * 1000);
+    TEST_ASSERT(run_num(&c) > paused_num);
+    webrtc_reactor_detach(c.handle);
+    return 0;
+}
+
+static int test_reactor_detach_wait(void)
+{
+    test_client_t slow = { .next = 0, .sleep_us = 20000 };
+    test_client_t other = { .next = 5 };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &slow, &slow.handle));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, webrtc_reactor_attach(client_run, &other, &other.handle));
+    usleep(5 * 1000);
+    // Detach while slow callback likely running, it must be finished after return
+    webrtc_reactor_detach(slow.handle);
+    TEST_ASSERT(__atomic_load_n(&slow.in_run, __ATOMIC_ACQUIRE) == false);
+    int num = run_num(&slow);
+    usleep(50 * 1000);
+    TEST_ASSERT_EQUAL(num, run_num(&slow));
+    TEST_ASSERT(run_num(&other) > 0);
+    webrtc_reactor_detach(other.handle);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    media_lib_add_host_os_adapter();
+    TEST_RUN(test_reactor_deadline, failed);
+    TEST_RUN(test_reactor_wakeup_bench, failed);
+    TEST_RUN(test_reactor_lock_order, failed);
+    TEST_RUN(test_reactor_pause, failed);
+    TEST_RUN(test_reactor_detach_wait, failed);
+    media_lib_thread_pool_clear();
+    return failed;
+}
@@ -0,0 +1,377 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include "test_common.h"
+#include "esp_peer_rtx_cache.h"
+
+#define TEST_SSRC        (0x11223344)
+#define TEST_MAX_PACKET  (1200)
+#define TEST_MAX_NACK    (256)
+#define SIM_PACKETS      (3000)
+#define SIM_INTERVAL     (2)
+#define SIM_NACK_PERIOD  (20)
+#define SIM_START_SEQ    (65000)
+
+/**
+ * @brief  Gilbert-Elliott loss model, state changes and loss decisions use deterministic PRNG
+ */
+typedef struct {
+    uint32_t  seed;
+    bool      bad;
+    uint16_t  p_good_to_bad;  /* Per mille */
+    uint16_t  p_bad_to_good;  /* Per mille */
+    uint16_t  loss_good;      /* Per mille */
+    uint16_t  loss_bad;       /* Per mille */
+} loss_model_t;
+
+typedef struct {
+    uint32_t  time;
+    int       num;
+    uint16_t  seq[TEST_MAX_NACK];
+} nack_event_t;
+
+typedef struct {
+    int  retransmitted;
+    int  corrupted;
+} sim_ctx_t;
+
+static uint32_t rand_next(uint32_t *seed)
+{
+    // xorshift32
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+static bool loss_model_drop(loss_model_t *m)
+{
+    uint32_t r = rand_next(&m->seed) % 1000;
+    if (m->bad) {
+        m->bad = r >= m->p_bad_to_good;
+    } else {
+        m->bad = r < m->p_good_to_bad;
+    }
+    r = rand_next(&m->seed) % 1000;
+    return r < (m->bad ? m->loss_bad : m->loss_good);
+}
+
+static int packet_size(uint16_t seq)
+{
+    return 100 + (seq * 37) % (TEST_MAX_PACKET - 100);
+}
+
+static int build_rtp(uint8_t *rtp, uint32_t ssrc, uint16_t seq)
+{
+    int size = packet_size(seq);
+    rtp[0] = 0x80;
+    rtp[1] = 96;
+    rtp[2] = seq >> 8;
+    rtp[3] = seq & 0xFF;
+    memset(rtp + 4, 0, 4);
+    rtp[8] = ssrc >> 24;
+    rtp[9] = (ssrc >> 16) & 0xFF;
+    rtp[10] = (ssrc >> 8) & 0xFF;
+    rtp[11] = ssrc & 0xFF;
+    for (int i = 12; i < size; i++) {
+        rtp[i] = (uint8_t)(seq + i);
+    }
+    return size;
+}
+
+static bool verify_rtp(const uint8_t *rtp, int size, uint16_t *seq)
+{
+    uint8_t expect[TEST_MAX_PACKET];
+    *seq = (uint16_t)((rtp[2] << 8) | rtp[3]);
+    int expect_size = build_rtp(expect, TEST_SSRC, *seq);
+    return size == expect_size && memcmp(rtp, expect, size) == 0;
+}
+
+static void write_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static void write_u32(uint8_t *p, uint32_t v)
+{
+    write_u16(p, v >> 16);
+    write_u16(p + 2, v & 0xFFFF);
+}
+
+/**
+ * @brief  Build generic NACK (RFC4585) for sequences in sending order
+ */
+static int build_nack(uint8_t *rtcp, uint32_t media_ssrc, const uint16_t *seq, int num)
+{
+    int len = 12;
+    int i = 0;
+    while (i < num) {
+        uint16_t pid = seq[i++];
+        uint16_t blp = 0;
+        while (i < num && (uint16_t)(seq[i] - pid) <= 16) {
+            blp |= 1 << ((uint16_t)(seq[i] - pid) - 1);
+            i++;
+        }
+        write_u16(rtcp + len, pid);
+        write_u16(rtcp + len + 2, blp);
+        len += 4;
+    }
+    rtcp[0] = 0x80 | 1;
+    rtcp[1] = 205;
+    write_u16(rtcp + 2, len / 4 - 1);
+    write_u32(rtcp + 4, 0xAABBCCDD);
+    write_u32(rtcp + 8, media_ssrc);
+    return len;
+}
+
+static void on_retransmit(const uint8_t *rtp, int size, void *ctx)
+{
+    sim_ctx_t *sim = (sim_ctx_t *)ctx;
+    uint16_t seq = 0;
+    if (verify_rtp(rtp, size, &seq) == false) {
+        sim->corrupted++;
+        return;
+    }
+    sim->retransmitted++;
+}
+
+/**
+ * @brief  Send RTP over lossy link, receiver NACKs gaps periodically
+ *         NACK reaches sender after `rtt` plus random delay up to `rtt_jitter`
+ */
+static int simulate(esp_peer_rtx_cache_cfg_t *cfg, loss_model_t *model, uint32_t rtt, uint32_t rtt_jitter,
+                    int *lost, esp_peer_rtx_cache_stats_t *stats, sim_ctx_t *sim)
+{
+    esp_peer_rtx_cache_handle_t cache = NULL;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_create(cfg, &cache));
+    static nack_event_t events[SIM_PACKETS * SIM_INTERVAL / SIM_NACK_PERIOD + 1];
+    int event_num = 0;
+    int event_head = 0;
+    nack_event_t pending = { 0 };
+    uint8_t rtp[TEST_MAX_PACKET];
+    uint8_t rtcp[12 + TEST_MAX_NACK * 4];
+    *lost = 0;
+    for (int i = 0; i < SIM_PACKETS; i++) {
+        uint32_t now = 1000 + i * SIM_INTERVAL;
+        // Deliver NACKs which reached sender
+        while (event_head < event_num && events[event_head].time <= now) {
+            nack_event_t *ev = &events[event_head++];
+            int len = build_nack(rtcp, TEST_SSRC, ev->seq, ev->num);
+            esp_peer_rtx_cache_on_rtcp(cache, rtcp, len, now, on_retransmit, sim);
+        }
+        uint16_t seq = (uint16_t)(SIM_START_SEQ + i);
+        int size = build_rtp(rtp, TEST_SSRC, seq);
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, size, now));
+        if (loss_model_drop(model) && pending.num < TEST_MAX_NACK) {
+            pending.seq[pending.num++] = seq;
+            (*lost)++;
+        }
+        if ((now + SIM_INTERVAL) % SIM_NACK_PERIOD == 0 && pending.num) {
+            pending.time = now + rtt + rand_next(&model->seed) % (rtt_jitter + 1);
+            events[event_num++] = pending;
+            pending.num = 0;
+        }
+    }
+    // Remaining losses at end of trace are never NACKed
+    *lost -= pending.num;
+    while (event_head < event_num) {
+        nack_event_t *ev = &events[event_head++];
+        int len = build_nack(rtcp, TEST_SSRC, ev->seq, ev->num);
+        esp_peer_rtx_cache_on_rtcp(cache, rtcp, len, ev->time, on_retransmit, sim);
+    }
+    uint8_t num = 1;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get_stats(cache, stats, &num));
+    TEST_ASSERT_EQUAL(1, num);
+    esp_peer_rtx_cache_destroy(cache);
+    return 0;
+}
+
+static int test_rtx_cache_basic(void)
+{
+    esp_peer_rtx_cache_handle_t cache = NULL;
+    esp_peer_rtx_cache_cfg_t cfg = {
+        .cache_size = 16 * 1024,
+        .slot_num = 100,
+        .max_age = 500,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, esp_peer_rtx_cache_create(NULL, &cache));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_create(&cfg, &cache));
+    uint8_t rtp[TEST_MAX_PACKET];
+    uint8_t out[TEST_MAX_PACKET];
+    int size = build_rtp(rtp, TEST_SSRC, 65535);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, size, 0));
+    int wrap_size = build_rtp(rtp, TEST_SSRC, 0);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, wrap_size, 10));
+    // Too small buffer reports required size
+    int out_size = 20;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_OVER_LIMITED, esp_peer_rtx_cache_get(cache, TEST_SSRC, 65535, 20, out, &out_size));
+    TEST_ASSERT_EQUAL(size, out_size);
+    out_size = sizeof(out);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get(cache, TEST_SSRC, 65535, 20, out, &out_size));
+    uint16_t seq = 0;
+    TEST_ASSERT(verify_rtp(out, out_size, &seq));
+    TEST_ASSERT_EQUAL(65535, seq);
+    out_size = sizeof(out);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get(cache, TEST_SSRC, 0, 20, out, &out_size));
+    TEST_ASSERT_EQUAL(wrap_size, out_size);
+    // Unknown SSRC and sequence
+    out_size = sizeof(out);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NOT_EXISTS, esp_peer_rtx_cache_get(cache, 0x1234, 0, 20, out, &out_size));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NOT_EXISTS, esp_peer_rtx_cache_get(cache, TEST_SSRC, 1, 20, out, &out_size));
+    // Packet older than max age is not served
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NOT_EXISTS, esp_peer_rtx_cache_get(cache, TEST_SSRC, 65535, 600, out, &out_size));
+    // Not RTP version 2
+    rtp[0] = 0x40;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_INVALID_ARG, esp_peer_rtx_cache_add(cache, rtp, wrap_size, 30));
+    esp_peer_rtx_cache_destroy(cache);
+    return 0;
+}
+
+static int test_rtx_cache_slot_and_streams(void)
+{
+    esp_peer_rtx_cache_handle_t cache = NULL;
+    esp_peer_rtx_cache_cfg_t cfg = {
+        .cache_size = 64 * 1024,
+        .slot_num = 16,
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_create(&cfg, &cache));
+    uint8_t rtp[TEST_MAX_PACKET];
+    uint8_t out[TEST_MAX_PACKET];
+    // Sequence 16 reuses slot of sequence 0
+    for (uint16_t seq = 0; seq <= 16; seq++) {
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, build_rtp(rtp, TEST_SSRC, seq), 0));
+    }
+    int out_size = sizeof(out);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NOT_EXISTS, esp_peer_rtx_cache_get(cache, TEST_SSRC, 0, 0, out, &out_size));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get(cache, TEST_SSRC, 16, 0, out, &out_size));
+    esp_peer_rtx_cache_stats_t stats[ESP_PEER_RTX_CACHE_MAX_STREAM + 1];
+    uint8_t num = 1;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get_stats(cache, stats, &num));
+    TEST_ASSERT_EQUAL(17, stats[0].inserted);
+    TEST_ASSERT_EQUAL(1, stats[0].evicted_slot);
+    TEST_ASSERT_EQUAL(16, stats[0].cached_packets);
+    // Limited stream number
+    for (uint32_t i = 1; i < ESP_PEER_RTX_CACHE_MAX_STREAM; i++) {
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, build_rtp(rtp, TEST_SSRC + i, 0), 0));
+    }
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_OVER_LIMITED,
+                      esp_peer_rtx_cache_add(cache, rtp, build_rtp(rtp, TEST_SSRC + 100, 0), 0));
+    num = ESP_PEER_RTX_CACHE_MAX_STREAM + 1;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get_stats(cache, stats, &num));
+    TEST_ASSERT_EQUAL(ESP_PEER_RTX_CACHE_MAX_STREAM, num);
+    esp_peer_rtx_cache_destroy(cache);
+    return 0;
+}
+
+static int test_rtx_cache_compound_rtcp(void)
+{
+    esp_peer_rtx_cache_handle_t cache = NULL;
+    esp_peer_rtx_cache_cfg_t cfg = { 0 };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_create(&cfg, &cache));
+    uint8_t rtp[TEST_MAX_PACKET];
+    for (uint16_t seq = 100; seq < 140; seq++) {
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_add(cache, rtp, build_rtp(rtp, TEST_SSRC, seq), 0));
+    }
+    // Receiver report followed by NACK, one NACK for unknown stream is skipped
+    uint8_t rtcp[128];
+    uint8_t rr[8] = {0x80, 201, 0, 1, 0xAA, 0xBB, 0xCC, 0xDD};
+    memcpy(rtcp, rr, sizeof(rr));
+    uint16_t lost[] = {101, 105, 117, 118, 139, 140};
+    int len = sizeof(rr);
+    len += build_nack(rtcp + len, TEST_SSRC, lost, sizeof(lost) / sizeof(lost[0]));
+    len += build_nack(rtcp + len, 0x5555, lost, 1);
+    sim_ctx_t sim = { 0 };
+    // 140 is not sent yet
+    TEST_ASSERT_EQUAL(5, esp_peer_rtx_cache_on_rtcp(cache, rtcp, len, 0, NULL, NULL));
+    esp_peer_rtx_cache_stats_t stats;
+    uint8_t num = 1;
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_rtx_cache_get_stats(cache, &stats, &num));
+    TEST_ASSERT_EQUAL(5, stats.nack_hit);
+    TEST_ASSERT_EQUAL(1, stats.nack_miss);
+    // Truncated packet stops parsing without over read
+    TEST_ASSERT_EQUAL(0, esp_peer_rtx_cache_on_rtcp(cache, rtcp, sizeof(rr) + 8, 0, on_retransmit, &sim));
+    TEST_ASSERT_EQUAL(0, sim.retransmitted);
+    esp_peer_rtx_cache_destroy(cache);
+    return 0;
+}
+
+static int test_rtx_cache_nack_loss_model(void)
+{
+    // Bursty loss around 3%, cache keeps more than one RTT of packets so every NACK is served
+    loss_model_t model = {
+        .seed = 0x12345678,
+        .p_good_to_bad = 10,
+        .p_bad_to_good = 300,
+        .loss_good = 5,
+        .loss_bad = 500,
+    };
+    esp_peer_rtx_cache_cfg_t cfg = {
+        .cache_size = 200 * 1024,
+        .slot_num = 512,
+        .max_age = 1000,
+    };
+    sim_ctx_t sim = { 0 };
+    esp_peer_rtx_cache_stats_t stats;
+    int lost = 0;
+    TEST_ASSERT_EQUAL(0, simulate(&cfg, &model, 100, 0, &lost, &stats, &sim));
+    printf("Lost %d of %d packets, hit %u miss %u\n", lost, SIM_PACKETS,
+           (unsigned)stats.nack_hit, (unsigned)stats.nack_miss);
+    TEST_ASSERT(lost > SIM_PACKETS / 100);
+    TEST_ASSERT_EQUAL(0, sim.corrupted);
+    TEST_ASSERT_EQUAL(lost, stats.nack_hit);
+    TEST_ASSERT_EQUAL(0, stats.nack_miss);
+    TEST_ASSERT_EQUAL(lost, sim.retransmitted);
+    TEST_ASSERT_EQUAL(SIM_PACKETS, stats.inserted);
+    TEST_ASSERT(stats.cached_bytes <= cfg.cache_size);
+    return 0;
+}
+
+static int test_rtx_cache_nack_over_budget(void)
+{
+    // Same loss with RTT varying from 100ms to 700ms, budget holds about 400ms of packets
+    // so that NACKs arriving late are reported as miss instead of served with wrong packet
+    loss_model_t model = {
+        .seed = 0x87654321,
+        .p_good_to_bad = 10,
+        .p_bad_to_good = 300,
+        .loss_good = 5,
+        .loss_bad = 500,
+    };
+    esp_peer_rtx_cache_cfg_t cfg = {
+        .cache_size = 128 * 1024,
+        .slot_num = 512,
+        .max_age = 1000,
+    };
+    sim_ctx_t sim = { 0 };
+    esp_peer_rtx_cache_stats_t stats;
+    int lost = 0;
+    TEST_ASSERT_EQUAL(0, simulate(&cfg, &model, 100, 600, &lost, &stats, &sim));
+    printf("Lost %d of %d packets, hit %u miss %u\n", lost, SIM_PACKETS,
+           (unsigned)stats.nack_hit, (unsigned)stats.nack_miss);
+    TEST_ASSERT_EQUAL(0, sim.corrupted);
+    TEST_ASSERT_EQUAL(lost, stats.nack_hit + stats.nack_miss);
+    TEST_ASSERT(stats.nack_hit > 0);
+    TEST_ASSERT(stats.nack_miss > 0);
+    TEST_ASSERT(stats.evicted_budget > 0);
+    TEST_ASSERT_EQUAL(stats.nack_hit, sim.retransmitted);
+    TEST_ASSERT(stats.cached_bytes <= cfg.cache_size);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_rtx_cache_basic, failed);
+    TEST_RUN(test_rtx_cache_slot_and_streams, failed);
+    TEST_RUN(test_rtx_cache_compound_rtcp, failed);
+    TEST_RUN(test_rtx_cache_nack_loss_model, failed);
+    TEST_RUN(test_rtx_cache_nack_over_budget, failed);
+    return failed;
+}
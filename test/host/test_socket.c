@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "media_lib_socket.h"
+#include "media_lib_socket_adapter_host.h"
+
+#define RTP_PACKET_SIZE   (1200)
+#define BURST_NUM         (32)
+#define AUDIO_PACKET_SIZE (172)
+#define BENCH_PACKETS     (64000)
+#define BENCH_REPEAT      (3)
+
+typedef struct {
+    int tx;
+    int rx;
+} udp_pair_t;
+
+typedef struct {
+    uint8_t             data[BURST_NUM][RTP_PACKET_SIZE];
+    struct iovec        iov[BURST_NUM];
+    media_lib_mmsghdr_t msg[BURST_NUM];
+} burst_t;
+
+static burst_t send_burst;
+static burst_t recv_burst;
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static int udp_pair_open(udp_pair_t *p)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    p->rx = media_lib_socket_open(AF_INET, SOCK_DGRAM, 0);
+    p->tx = media_lib_socket_open(AF_INET, SOCK_DGRAM, 0);
+    TEST_ASSERT(p->rx >= 0 && p->tx >= 0);
+    TEST_ASSERT_EQUAL(0, media_lib_socket_bind(p->rx, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, media_lib_socket_getsockname(p->rx, (struct sockaddr *)&addr, &addr_len));
+    TEST_ASSERT_EQUAL(0, media_lib_socket_connect(p->tx, (struct sockaddr *)&addr, sizeof(addr)));
+    // Receive side never blocks so that lost packet shows as count mismatch not hang
+    int flags = media_lib_socket_fcntl(p->rx, F_GETFL, 0);
+    TEST_ASSERT_EQUAL(0, media_lib_socket_fcntl(p->rx, F_SETFL, flags | O_NONBLOCK));
+    return 0;
+}
+
+static void udp_pair_close(udp_pair_t *p)
+{
+    media_lib_socket_close(p->tx);
+    media_lib_socket_close(p->rx);
+}
+
+static void burst_init(burst_t *b, int size)
+{
+    memset(b->msg, 0, sizeof(b->msg));
+    for (int i = 0; i < BURST_NUM; i++) {
+        b->iov[i].iov_base = b->data[i];
+        b->iov[i].iov_len = size;
+        b->msg[i].msg_hdr.msg_iov = &b->iov[i];
+        b->msg[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+static void burst_fill(burst_t *b, uint32_t seq)
+{
+    for (int i = 0; i < BURST_NUM; i++) {
+        uint32_t s = seq + i;
+        memcpy(b->data[i], &s, sizeof(s));
+    }
+}
+
+static int burst_check(burst_t *b, int num, uint32_t seq, int size)
+{
+    for (int i = 0; i < num; i++) {
+        uint32_t s;
+        memcpy(&s, b->data[i], sizeof(s));
+        TEST_ASSERT_EQUAL(seq + i, s);
+        TEST_ASSERT_EQUAL(size, b->msg[i].msg_len);
+    }
+    return 0;
+}
+
+static int run_bench(bool batch, int size, int *rate)
+{
+    udp_pair_t p;
+    TEST_ASSERT_EQUAL(0, udp_pair_open(&p));
+    burst_init(&send_burst, size);
+    burst_init(&recv_burst, size);
+    int64_t start = now_us();
+    // Packetized key frame sent as burst then drained by receiver
+    for (uint32_t seq = 0; seq < BENCH_PACKETS; seq += BURST_NUM) {
+        burst_fill(&send_burst, seq);
+        int received = 0;
+        if (batch) {
+            TEST_ASSERT_EQUAL(BURST_NUM, media_lib_socket_sendmmsg(p.tx, send_burst.msg, BURST_NUM, 0));
+            received = media_lib_socket_recvmmsg(p.rx, recv_burst.msg, BURST_NUM, 0);
+        } else {
+            for (int i = 0; i < BURST_NUM; i++) {
+                TEST_ASSERT_EQUAL(size, media_lib_socket_sendmsg(p.tx, &send_burst.msg[i].msg_hdr, 0));
+            }
+            for (; received < BURST_NUM; received++) {
+                ssize_t ret = media_lib_socket_recvmsg(p.rx, &recv_burst.msg[received].msg_hdr, 0);
+                if (ret < 0) {
+                    break;
+                }
+                recv_burst.msg[received].msg_len = (unsigned int)ret;
+            }
+        }
+        // Loopback delivers before send returns, whole burst must be ready
+        TEST_ASSERT_EQUAL(BURST_NUM, received);
+        TEST_ASSERT_EQUAL(0, burst_check(&recv_burst, received, seq, size));
+    }
+    int64_t elapse = now_us() - start;
+    udp_pair_close(&p);
+    int cur = (int)((int64_t)BENCH_PACKETS * 1000000 / elapse);
+    // Keep best of repeated runs to filter scheduling noise
+    if (cur > *rate) {
+        *rate = cur;
+    }
+    return 0;
+}
+
+static int bench_size(int size)
+{
+    int single = 0, fallback = 0, native = 0;
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_add_host_socket_adapter(false));
+        TEST_ASSERT_EQUAL(0, run_bench(false, size, &single));
+        TEST_ASSERT_EQUAL(0, run_bench(true, size, &fallback));
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_add_host_socket_adapter(true));
+        TEST_ASSERT_EQUAL(0, run_bench(true, size, &native));
+    }
+    printf("    %d bytes in bursts of %d, packets/sec: single %d, batch loop %d, batch native %d (%+d%%)\n",
+           size, BURST_NUM, single, fallback, native, (native - single) * 100 / single);
+    return 0;
+}
+
+static int test_socket_batch_bench(void)
+{
+    // Video RTP burst of key frame and small audio packets where call overhead weighs more
+    TEST_ASSERT_EQUAL(0, bench_size(RTP_PACKET_SIZE));
+    TEST_ASSERT_EQUAL(0, bench_size(AUDIO_PACKET_SIZE));
+    return 0;
+}
+
+static int check_recv_partial(bool native)
+{
+    // Fewer datagrams queued than requested, return what is ready instead of waiting for all
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_add_host_socket_adapter(native));
+    udp_pair_t p;
+    TEST_ASSERT_EQUAL(0, udp_pair_open(&p));
+    burst_init(&send_burst, RTP_PACKET_SIZE);
+    burst_init(&recv_burst, RTP_PACKET_SIZE);
+    burst_fill(&send_burst, 100);
+    TEST_ASSERT_EQUAL(5, media_lib_socket_sendmmsg(p.tx, send_burst.msg, 5, 0));
+    // Blocking receive only waits for first message
+    int flags = media_lib_socket_fcntl(p.rx, F_GETFL, 0);
+    TEST_ASSERT_EQUAL(0, media_lib_socket_fcntl(p.rx, F_SETFL, flags & ~O_NONBLOCK));
+    TEST_ASSERT_EQUAL(5, media_lib_socket_recvmmsg(p.rx, recv_burst.msg, BURST_NUM, 0));
+    TEST_ASSERT_EQUAL(0, burst_check(&recv_burst, 5, 100, RTP_PACKET_SIZE));
+    // Nothing queued on non-blocking socket
+    TEST_ASSERT_EQUAL(-1, media_lib_socket_recvmmsg(p.rx, recv_burst.msg, BURST_NUM, MSG_DONTWAIT));
+    TEST_ASSERT(errno == EAGAIN || errno == EWOULDBLOCK);
+    udp_pair_close(&p);
+    return 0;
+}
+
+static int test_socket_recv_partial(void)
+{
+    TEST_ASSERT_EQUAL(0, check_recv_partial(false));
+    TEST_ASSERT_EQUAL(0, check_recv_partial(true));
+    return 0;
+}
+
+static int test_socket_readv(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_add_host_socket_adapter(true));
+    udp_pair_t p;
+    TEST_ASSERT_EQUAL(0, udp_pair_open(&p));
+    uint8_t packet[RTP_PACKET_SIZE];
+    for (int i = 0; i < RTP_PACKET_SIZE; i++) {
+        packet[i] = (uint8_t)i;
+    }
+    TEST_ASSERT_EQUAL(RTP_PACKET_SIZE, media_lib_socket_send(p.tx, packet, RTP_PACKET_SIZE, 0));
+    // RTP header and payload scattered to separate buffers
+    uint8_t header[12];
+    uint8_t payload[RTP_PACKET_SIZE];
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = sizeof(header) },
+        { .iov_base = payload, .iov_len = sizeof(payload) },
+    };
+    TEST_ASSERT_EQUAL(RTP_PACKET_SIZE, media_lib_socket_readv(p.rx, iov, 2));
+    TEST_ASSERT_EQUAL_MEM(packet, header, sizeof(header));
+    TEST_ASSERT_EQUAL_MEM(packet + sizeof(header), payload, RTP_PACKET_SIZE - sizeof(header));
+    udp_pair_close(&p);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    TEST_RUN(test_socket_readv, failed);
+    TEST_RUN(test_socket_recv_partial, failed);
+    TEST_RUN(test_socket_batch_bench, failed);
+    return failed;
+}
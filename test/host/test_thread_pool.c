@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <malloc.h>
+#include <unistd.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_os_adapter_host.h"
+
+#define SOAK_LOOP      (10000)
+#define PLAIN_LOOP     (2000)
+#define PARALLEL_NUM   (4)
+
+typedef struct {
+    media_lib_sema_handle_t done;
+    media_lib_sema_handle_t release;  /*!< Body waits for it when set */
+    int                     run_num;
+    bool                    self_destroy;
+} task_arg_t;
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static size_t heap_used(void)
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks;
+}
+
+static void task_body(void *arg)
+{
+    task_arg_t *t = (task_arg_t *)arg;
+    if (t->release) {
+        media_lib_sema_lock(t->release, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+    __atomic_add_fetch(&t->run_num, 1, __ATOMIC_ACQ_REL);
+    media_lib_sema_unlock(t->done);
+    if (t->self_destroy) {
+        media_lib_thread_destroy(NULL);
+    }
+}
+
+static int test_thread_pool_soak(void)
+{
+    task_arg_t t = { 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_create(&t.done));
+    media_lib_thread_pool_stats_t start, end;
+    media_lib_thread_pool_get_stats(&start);
+    size_t heap_start = 0;
+    int64_t start_time = now_us();
+    for (int i = 0; i < SOAK_LOOP; i++) {
+        // Start and stop like a session task, worker is back to idle before next start
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_thread_create_pooled(NULL, "soak", task_body, &t));
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_lock(t.done, 1000));
+        // Wait until worker marks itself idle so that next start reuses it
+        media_lib_thread_pool_stats_t stats;
+        do {
+            media_lib_thread_pool_get_stats(&stats);
+        } while (stats.idle_num != stats.worker_num);
+        if (i == 100) {
+            heap_start = heap_used();
+        }
+    }
+    int pooled_cost = (int)((now_us() - start_time) / SOAK_LOOP);
+    size_t heap_end = heap_used();
+    media_lib_thread_pool_get_stats(&end);
+    TEST_ASSERT_EQUAL(SOAK_LOOP, t.run_num);
+
+    // Same start and stop with a new thread each time for reference
+    task_arg_t plain = { .done = t.done, .self_destroy = true };
+    start_time = now_us();
+    for (int i = 0; i < PLAIN_LOOP; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_thread_create(NULL, "plain", task_body, &plain, 4096, 5, 0));
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_lock(t.done, 1000));
+    }
+    int plain_cost = (int)((now_us() - start_time) / PLAIN_LOOP);
+    media_lib_sema_destroy(t.done);
+    printf("    %d pooled runs: created %u reused %u, heap grow %d bytes, start to finish %dus (new thread %dus)\n",
+           SOAK_LOOP, (unsigned)(end.created - start.created), (unsigned)(end.reused - start.reused),
+           (int)(heap_end - heap_start), pooled_cost, plain_cost);
+    // One worker serves all runs and nothing is allocated per run
+    TEST_ASSERT_EQUAL(1, end.created - start.created);
+    TEST_ASSERT_EQUAL(SOAK_LOOP - 1, end.reused - start.reused);
+    TEST_ASSERT(heap_end <= heap_start + 1024);
+    return 0;
+}
+
+static int test_thread_pool_parallel(void)
+{
+    task_arg_t t = { 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_create(&t.done));
+    TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_create(&t.release));
+    media_lib_thread_pool_stats_t start, stats;
+    media_lib_thread_pool_get_stats(&start);
+    // Busy worker is never handed out, each parallel run gets its own worker
+    for (int i = 0; i < PARALLEL_NUM; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_thread_create_pooled(NULL, "parallel", task_body, &t));
+    }
+    media_lib_thread_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL(PARALLEL_NUM, stats.created - start.created);
+    for (int i = 0; i < PARALLEL_NUM; i++) {
+        media_lib_sema_unlock(t.release);
+        TEST_ASSERT_EQUAL(ESP_OK, media_lib_sema_lock(t.done, 1000));
+    }
+    TEST_ASSERT_EQUAL(PARALLEL_NUM, t.run_num);
+    do {
+        media_lib_thread_pool_get_stats(&stats);
+    } while (stats.idle_num != stats.worker_num);
+    TEST_ASSERT(stats.worker_num >= PARALLEL_NUM);
+    // Cleared workers quit, pool starts from empty
+    media_lib_thread_pool_clear();
+    media_lib_thread_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.worker_num);
+    usleep(10 * 1000);
+    media_lib_sema_destroy(t.release);
+    media_lib_sema_destroy(t.done);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    media_lib_add_host_os_adapter();
+    TEST_RUN(test_thread_pool_soak, failed);
+    TEST_RUN(test_thread_pool_parallel, failed);
+    return failed;
+}
@@ -0,0 +1,465 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_os_adapter_host.h"
+#include "esp_capture_host.h"
+#include "esp_peer_host.h"
+#include "esp_peer_default.h"
+#include "esp_webrtc.h"
+
+#define LATENCY_NUM       (100)
+#define MEASURE_TIME      (1000)
+#define POLL_INTERVAL     (10)
+#define AUDIO_FRAME_SIZE  (160)
+#define AUDIO_INTERVAL    (20)
+#define SDP_MAX_SIZE      (1024)
+#define OPEN_COST         (30)
+#define GATHER_COST       (150)
+#define HANDSHAKE_COST    (40)
+
+/**
+ * @brief  Fake player, records arrival of rendered audio
+ */
+typedef struct {
+    int      audio_num;
+    int64_t  audio_time;
+} host_player_t;
+
+/**
+ * @brief  Fake signaling, ICE info and connected event reported at start
+ */
+typedef struct {
+    esp_peer_signaling_cfg_t cfg;
+    int                      sent_num;
+    char                     sent_sdp[SDP_MAX_SIZE];  /*!< Last sent SDP */
+} host_signaling_t;
+
+typedef struct {
+    struct esp_capture_t capture;
+    host_player_t        player;
+    esp_webrtc_handle_t  rtc;
+} session_t;
+
+static host_signaling_t *cur_signaling;
+
+int av_render_add_audio_stream(av_render_handle_t render, av_render_audio_info_t *audio_info)
+{
+    return 0;
+}
+
+int av_render_add_video_stream(av_render_handle_t render, av_render_video_info_t *video_info)
+{
+    return 0;
+}
+
+int av_render_add_audio_data(av_render_handle_t render, av_render_audio_data_t *audio_data)
+{
+    host_player_t *player = (host_player_t *)render;
+    __atomic_store_n(&player->audio_time, esp_timer_get_time(), __ATOMIC_RELEASE);
+    __atomic_add_fetch(&player->audio_num, 1, __ATOMIC_ACQ_REL);
+    return 0;
+}
+
+int av_render_add_video_data(av_render_handle_t render, av_render_video_data_t *video_data)
+{
+    return 0;
+}
+
+int av_render_reset(av_render_handle_t render)
+{
+    return 0;
+}
+
+static int signaling_start(esp_peer_signaling_cfg_t *cfg, esp_peer_signaling_handle_t *handle)
+{
+    host_signaling_t *sig = calloc(1, sizeof(host_signaling_t));
+    if (sig == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    sig->cfg = *cfg;
+    cur_signaling = sig;
+    esp_peer_signaling_ice_info_t ice_info = {
+        .is_initiator = true,
+    };
+    cfg->on_ice_info(&ice_info, cfg->ctx);
+    cfg->on_connected(cfg->ctx);
+    *handle = sig;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int signaling_send_msg(esp_peer_signaling_handle_t handle, esp_peer_signaling_msg_t *msg)
+{
+    host_signaling_t *sig = (host_signaling_t *)handle;
+    if (msg->type == ESP_PEER_SIGNALING_MSG_SDP && msg->size < SDP_MAX_SIZE) {
+        memcpy(sig->sent_sdp, msg->data, msg->size);
+        sig->sent_sdp[msg->size] = '\0';
+    }
+    __atomic_add_fetch(&sig->sent_num, 1, __ATOMIC_ACQ_REL);
+    return ESP_PEER_ERR_NONE;
+}
+
+static int signaling_stop(esp_peer_signaling_handle_t handle)
+{
+    cur_signaling = NULL;
+    free(handle);
+    return ESP_PEER_ERR_NONE;
+}
+
+static const esp_peer_signaling_impl_t host_signaling_impl = {
+    .start = signaling_start,
+    .send_msg = signaling_send_msg,
+    .stop = signaling_stop,
+};
+
+static int64_t now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+static bool wait_capture_started(session_t *s, int timeout_ms)
+{
+    for (int t = 0; t < timeout_ms; t++) {
+        if (esp_capture_host_started(&s->capture)) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static int session_create(session_t *s, bool shared_loop, uint8_t ptime, bool no_auto_reconnect)
+{
+    memset(s, 0, sizeof(session_t));
+    esp_capture_host_init(&s->capture);
+    esp_webrtc_cfg_t cfg = {
+        .signaling_impl = &host_signaling_impl,
+        .peer_impl = esp_peer_get_default_impl(),
+        .peer_cfg = {
+            .audio_info = {
+                .codec = ESP_PEER_AUDIO_CODEC_G711A,
+                .sample_rate = 8000,
+                .channel = 1,
+                .ptime = ptime,
+            },
+            .audio_dir = ESP_PEER_MEDIA_DIR_SEND_RECV,
+            .video_dir = ESP_PEER_MEDIA_DIR_NONE,
+            .no_auto_reconnect = no_auto_reconnect,
+        },
+    };
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_open(&cfg, &s->rtc));
+    esp_webrtc_media_provider_t provider = {
+        .capture = &s->capture,
+        .player = &s->player,
+    };
+    esp_webrtc_set_media_provider(s->rtc, &provider);
+    esp_webrtc_set_shared_loop(s->rtc, shared_loop);
+    return 0;
+}
+
+static int session_open(session_t *s, bool shared_loop, uint8_t ptime)
+{
+    TEST_ASSERT_EQUAL(0, session_create(s, shared_loop, ptime, false));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_start(s->rtc));
+    TEST_ASSERT(esp_peer_host_opened());
+    esp_peer_host_set_state(ESP_PEER_STATE_CONNECTED);
+    // Stream starts from main loop once connected
+    TEST_ASSERT(wait_capture_started(s, 500));
+    return 0;
+}
+
+static void session_close(session_t *s)
+{
+    esp_webrtc_close(s->rtc);
+}
+
+static int test_webrtc_recv_latency(void)
+{
+    session_t s;
+    TEST_ASSERT_EQUAL(0, session_open(&s, false, 0));
+    uint8_t payload[AUDIO_FRAME_SIZE] = { 0 };
+    int64_t sum = 0, max = 0;
+    srand(1);
+    for (int i = 0; i < LATENCY_NUM; i++) {
+        // Arrive at random phase of main loop poll
+        usleep(1000 + rand() % (POLL_INTERVAL * 1000));
+        int num = __atomic_load_n(&s.player.audio_num, __ATOMIC_ACQUIRE);
+        int64_t start = now_us();
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_peer_host_recv_audio(i * AUDIO_INTERVAL, payload, sizeof(payload)));
+        for (int t = 0; t < 500 && __atomic_load_n(&s.player.audio_num, __ATOMIC_ACQUIRE) == num; t++) {
+            usleep(200);
+        }
+        TEST_ASSERT_EQUAL(num + 1, __atomic_load_n(&s.player.audio_num, __ATOMIC_ACQUIRE));
+        int64_t latency = __atomic_load_n(&s.player.audio_time, __ATOMIC_ACQUIRE) - start;
+        sum += latency;
+        if (latency > max) {
+            max = latency;
+        }
+    }
+    session_close(&s);
+    printf("    receive to render latency avg %dus max %dus over %d frames\n",
+           (int)(sum / LATENCY_NUM), (int)max, LATENCY_NUM);
+    // Received packet waits at most one poll interval
+    TEST_ASSERT(sum / LATENCY_NUM <= POLL_INTERVAL * 1000);
+    TEST_ASSERT(max <= POLL_INTERVAL * 3 * 1000);
+    return 0;
+}
+
+static int measure_wakeups(session_t *s, bool sending, int *audio_sent)
+{
+    esp_peer_host_stats_t start, end;
+    esp_peer_host_get_stats(&start);
+    int64_t start_time = now_us();
+    for (int t = 0; t < MEASURE_TIME; t += AUDIO_INTERVAL) {
+        if (sending) {
+            esp_capture_host_push(&s->capture, 0, ESP_CAPTURE_STREAM_TYPE_AUDIO, t, AUDIO_FRAME_SIZE, false);
+        }
+        usleep(AUDIO_INTERVAL * 1000);
+    }
+    esp_peer_host_get_stats(&end);
+    int elapse = (int)((now_us() - start_time) / 1000);
+    *audio_sent = end.audio_sent - start.audio_sent;
+    // Normalize to wakeups per measure time
+    return (end.main_loop_num - start.main_loop_num) * MEASURE_TIME / elapse;
+}
+
+static int check_wakeups(bool shared_loop)
+{
+    session_t s;
+    TEST_ASSERT_EQUAL(0, session_open(&s, shared_loop, 0));
+    int audio_sent = 0;
+    int idle = measure_wakeups(&s, false, &audio_sent);
+    TEST_ASSERT_EQUAL(0, audio_sent);
+    int sending = measure_wakeups(&s, true, &audio_sent);
+    session_close(&s);
+    printf("    %s loop wakeups in %dms: idle %d sending %d (audio sent %d)\n", shared_loop ? "shared" : "own",
+           MEASURE_TIME, idle, sending, audio_sent);
+    int limit = MEASURE_TIME / POLL_INTERVAL * 12 / 10;
+    // Poll period bounds wakeups, sent frames do not add wakeups on top of it
+    TEST_ASSERT(idle > 0 && idle <= limit);
+    TEST_ASSERT(audio_sent >= MEASURE_TIME / AUDIO_INTERVAL / 2);
+    TEST_ASSERT(sending <= limit);
+    return 0;
+}
+
+static int test_webrtc_idle_wakeup(void)
+{
+    return check_wakeups(false);
+}
+
+static int test_webrtc_shared_loop_wakeup(void)
+{
+    return check_wakeups(true);
+}
+
+static bool wait_sdp_sent(int timeout_ms)
+{
+    for (int t = 0; t < timeout_ms; t++) {
+        if (cur_signaling && __atomic_load_n(&cur_signaling->sent_num, __ATOMIC_ACQUIRE) > 0) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static int check_local_sdp(uint8_t ptime, const char *sdp, const char *expect)
+{
+    session_t s;
+    esp_peer_host_set_local_sdp(sdp);
+    TEST_ASSERT_EQUAL(0, session_open(&s, false, ptime));
+    // Local SDP reported by peer from main loop goes out through signaling
+    TEST_ASSERT(wait_sdp_sent(500));
+    int ret = strcmp(expect, cur_signaling->sent_sdp);
+    if (ret) {
+        printf("    ptime %d sent sdp:\n%s\n", ptime, cur_signaling->sent_sdp);
+    }
+    session_close(&s);
+    esp_peer_host_set_local_sdp(NULL);
+    TEST_ASSERT_EQUAL(0, ret);
+    return 0;
+}
+
+static int test_webrtc_ptime_local_sdp(void)
+{
+    const char *sdp = "v=0\r\n"
+                      "m=audio 9 UDP/TLS/RTP/SAVPF 8\r\n"
+                      "a=rtpmap:8 PCMA/8000\r\n"
+                      "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+                      "a=sctp-port:5000\r\n";
+    const char *sdp_ptime = "v=0\r\n"
+                            "m=audio 9 UDP/TLS/RTP/SAVPF 8\r\n"
+                            "a=rtpmap:8 PCMA/8000\r\n"
+                            "a=ptime:40\r\n"
+                            "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+                            "a=sctp-port:5000\r\n";
+    // Attribute goes to end of audio section, not session or other media level
+    TEST_ASSERT_EQUAL(0, check_local_sdp(40, sdp, sdp_ptime));
+    // Unsupported ptime aligned down to multiple of frame duration
+    TEST_ASSERT_EQUAL(0, check_local_sdp(50, sdp, sdp_ptime));
+    // Default ptime does not touch SDP
+    TEST_ASSERT_EQUAL(0, check_local_sdp(20, sdp, sdp));
+    TEST_ASSERT_EQUAL(0, check_local_sdp(0, sdp, sdp));
+    // Audio section last without final line break
+    TEST_ASSERT_EQUAL(0, check_local_sdp(60, "v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=rtpmap:8 PCMA/8000",
+                                         "v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=rtpmap:8 PCMA/8000\r\na=ptime:60\r\n"));
+    // Existing attribute kept
+    const char *has_ptime = "v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=ptime:20\r\n";
+    TEST_ASSERT_EQUAL(0, check_local_sdp(40, has_ptime, has_ptime));
+    return 0;
+}
+
+static int check_remote_ptime(const char *remote_sdp, int expect_ptime)
+{
+    session_t s;
+    TEST_ASSERT_EQUAL(0, session_open(&s, false, 60));
+    if (remote_sdp) {
+        esp_peer_signaling_msg_t msg = {
+            .type = ESP_PEER_SIGNALING_MSG_SDP,
+            .data = (uint8_t *)remote_sdp,
+            .size = strlen(remote_sdp),
+        };
+        TEST_ASSERT(cur_signaling != NULL);
+        cur_signaling->cfg.on_msg(&msg, cur_signaling->cfg.ctx);
+    }
+    esp_peer_host_stats_t start, end;
+    esp_peer_host_get_stats(&start);
+    // Frames of 120ms, whole number of packets for all allowed ptime
+    int frame_num = 6;
+    for (int i = 0; i < frame_num; i++) {
+        esp_capture_host_push(&s.capture, 0, ESP_CAPTURE_STREAM_TYPE_AUDIO, i * AUDIO_INTERVAL, AUDIO_FRAME_SIZE, false);
+    }
+    int expect_packets = frame_num * AUDIO_INTERVAL / expect_ptime;
+    for (int t = 0; t < 500; t++) {
+        esp_peer_host_get_stats(&end);
+        if (end.audio_bytes - start.audio_bytes >= frame_num * AUDIO_FRAME_SIZE) {
+            break;
+        }
+        usleep(1000);
+    }
+    session_close(&s);
+    // Consecutive G711 frames concatenate into packet of negotiated ptime
+    TEST_ASSERT_EQUAL(frame_num * AUDIO_FRAME_SIZE, end.audio_bytes - start.audio_bytes);
+    TEST_ASSERT_EQUAL(expect_packets, end.audio_sent - start.audio_sent);
+    return 0;
+}
+
+static int test_webrtc_ptime_remote_sdp(void)
+{
+    TEST_ASSERT_EQUAL(0, check_remote_ptime(NULL, 60));
+    // Remote limits in audio section lower send ptime
+    TEST_ASSERT_EQUAL(0, check_remote_ptime("v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=maxptime:40\r\n", 40));
+    TEST_ASSERT_EQUAL(0, check_remote_ptime("v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=ptime:20\r\n", 20));
+    // Remote preferring longer packet does not raise it, limits of other media ignored
+    TEST_ASSERT_EQUAL(0, check_remote_ptime("v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=ptime:120\r\n"
+                                            "m=video 9 UDP/TLS/RTP/SAVPF 96\r\na=maxptime:20\r\n", 60));
+    return 0;
+}
+
+static int sent_num(void)
+{
+    return cur_signaling ? __atomic_load_n(&cur_signaling->sent_num, __ATOMIC_ACQUIRE) : 0;
+}
+
+static int measure_time_to_media(bool prewarm, int *cost)
+{
+    const char *offer = "v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=rtpmap:8 PCMA/8000\r\n";
+    const char *answer = "v=0\r\nm=audio 9 UDP/TLS/RTP/SAVPF 8\r\na=rtpmap:8 PCMA/8000\r\n";
+    session_t s;
+    esp_peer_host_set_local_sdp(offer);
+    esp_peer_host_set_cost(OPEN_COST, GATHER_COST, HANDSHAKE_COST);
+    // Same setup as doorbell, peer connection waits for call accepted
+    TEST_ASSERT_EQUAL(0, session_create(&s, false, 0, true));
+    esp_webrtc_enable_peer_connection(s.rtc, false);
+    if (prewarm) {
+        TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_set_prewarm(s.rtc, true, 0));
+    }
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_start(s.rtc));
+    TEST_ASSERT(esp_peer_host_opened() == prewarm);
+    // Idle until call arrives, pre-warmed SDP is held not sent
+    usleep((OPEN_COST + GATHER_COST + 100) * 1000);
+    TEST_ASSERT_EQUAL(0, sent_num());
+
+    int64_t start = now_us();
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_enable_peer_connection(s.rtc, true));
+    TEST_ASSERT(wait_sdp_sent(1000));
+    int sdp_cost = (int)((now_us() - start) / 1000);
+    esp_peer_signaling_msg_t msg = {
+        .type = ESP_PEER_SIGNALING_MSG_SDP,
+        .data = (uint8_t *)answer,
+        .size = strlen(answer),
+    };
+    cur_signaling->cfg.on_msg(&msg, cur_signaling->cfg.ctx);
+    TEST_ASSERT(wait_capture_started(&s, 1000));
+    *cost = (int)((now_us() - start) / 1000);
+    int sent = sent_num();
+    esp_peer_host_stats_t stats;
+    esp_peer_host_get_stats(&stats);
+    session_close(&s);
+    esp_peer_host_set_cost(0, 0, 0);
+    esp_peer_host_set_local_sdp(NULL);
+    printf("    %s: offer sent in %dms, time to media %dms\n", prewarm ? "pre-warmed" : "cold", sdp_cost, *cost);
+    // Held SDP sent once, no gathering again on accept
+    TEST_ASSERT_EQUAL(1, sent);
+    TEST_ASSERT_EQUAL(1, stats.new_connection_num);
+    return 0;
+}
+
+static int test_webrtc_prewarm_time_to_media(void)
+{
+    int cold = 0, warm = 0;
+    TEST_ASSERT_EQUAL(0, measure_time_to_media(false, &cold));
+    TEST_ASSERT_EQUAL(0, measure_time_to_media(true, &warm));
+    // Cold start pays open and gathering, pre-warmed one only SDP exchange and handshake
+    TEST_ASSERT(cold >= OPEN_COST + GATHER_COST + HANDSHAKE_COST);
+    TEST_ASSERT(warm >= HANDSHAKE_COST);
+    TEST_ASSERT(warm < OPEN_COST + GATHER_COST);
+    return 0;
+}
+
+static int test_webrtc_prewarm_refresh(void)
+{
+    session_t s;
+    esp_peer_host_set_local_sdp("v=0\r\n");
+    TEST_ASSERT_EQUAL(0, session_create(&s, false, 0, true));
+    esp_webrtc_enable_peer_connection(s.rtc, false);
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_set_prewarm(s.rtc, true, 100));
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_start(s.rtc));
+    usleep(450 * 1000);
+    esp_peer_host_stats_t stats;
+    esp_peer_host_get_stats(&stats);
+    int sent = sent_num();
+    // Disable pre-warm releases idle peer
+    TEST_ASSERT_EQUAL(ESP_PEER_ERR_NONE, esp_webrtc_set_prewarm(s.rtc, false, 0));
+    bool opened = esp_peer_host_opened();
+    session_close(&s);
+    esp_peer_host_set_local_sdp(NULL);
+    printf("    gathered %d times in 450ms with 100ms refresh\n", stats.new_connection_num);
+    // Candidates gathered again before they expire, still nothing sent until call accepted
+    TEST_ASSERT(stats.new_connection_num >= 4);
+    TEST_ASSERT_EQUAL(0, sent);
+    TEST_ASSERT(opened == false);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    media_lib_add_host_os_adapter();
+    TEST_RUN(test_webrtc_recv_latency, failed);
+    TEST_RUN(test_webrtc_idle_wakeup, failed);
+    TEST_RUN(test_webrtc_shared_loop_wakeup, failed);
+    TEST_RUN(test_webrtc_ptime_local_sdp, failed);
+    TEST_RUN(test_webrtc_ptime_remote_sdp, failed);
+    TEST_RUN(test_webrtc_prewarm_time_to_media, failed);
+    TEST_RUN(test_webrtc_prewarm_refresh, failed);
+    return failed;
+}